@@ -98,6 +98,11 @@
 #define configTOTAL_HEAP_SIZE                   10240
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
+/* Create the tasks, queues and mutexes of the application and the MQTT network
+ * buffer from compile-time sized static buffers, see app_memory.c. Dynamic
+ * allocation stays enabled for the Wi-Fi, lwIP, MQTT and TLS libraries. */
+#define STATIC_ALLOCATION_ENABLE                (1)
+
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
@@ -106,10 +111,19 @@
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
+/* The run time counter is a free running hardware timer, see radar_diag.c.
+ * It does not run in Deep Sleep, so the CPU loads exclude the Deep Sleep time.
+ * The status record is formatted by radar_diag.c as well, so the formatting
+ * functions of FreeRTOS stay disabled. */
+extern void radar_diag_timer_init(void);
+extern uint32_t radar_diag_timer_read(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() radar_diag_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()         radar_diag_timer_read()
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
 #define configMAX_CO_ROUTINE_PRIORITIES         2
@@ -205,12 +219,38 @@ standard names - or at least those used in the unmodified vector table. */
 #define HEAP_ALLOCATION_TYPE5                   (5)     /* heap_5.c*/
 #define NO_HEAP_ALLOCATION                      (0)
 
+/* Serve pvPortMalloc() and the mbedTLS allocations from the fixed-block
+ * size classes of mem_pool.c instead of heap_3, see MEM_POOL_CLASS_LIST in
+ * mem_pool.h. The pools reserve their blocks statically, size them for the
+ * application before enabling them. */
+#define MEM_POOL_ENABLE                         (0)
+
+#if MEM_POOL_ENABLE
+#define configHEAP_ALLOCATION_SCHEME            (NO_HEAP_ALLOCATION)
+#else
 #define configHEAP_ALLOCATION_SCHEME            (HEAP_ALLOCATION_TYPE3)
+#endif
+
+/* Low power mode of the application. When set to 1, the idle task suppresses
+ * the tick and enters CPU Sleep or System Deep Sleep through low_power.c, which
+ * calls vApplicationSleep() of the RTOS abstraction library and counts the time
+ * spent asleep. Deep Sleep needs "System Idle Power Mode" set to "System Deep
+ * Sleep" in the device configurator, and the Wi-Fi host wake interrupt. The
+ * radar IRQ, the Wi-Fi host wake, the network stack timers (MQTT keep-alive)
+ * and the LED task are then the only wake sources. */
+#define LOW_POWER_ENABLE                        (0)
+
+#if LOW_POWER_ENABLE
+
+extern void vApplicationSleep( uint32_t xExpectedIdleTime );
+extern void low_power_sleep( uint32_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xIdleTime ) low_power_sleep( xIdleTime )
+#define configUSE_TICKLESS_IDLE                 2
 
 /* Check if the ModusToolbox Device Configurator Power personality parameter
  * "System Idle Power Mode" is set to either "CPU Sleep" or "System Deep Sleep".
  */
-#if defined(CY_CFG_PWR_SYS_IDLE_MODE) && \
+#elif defined(CY_CFG_PWR_SYS_IDLE_MODE) && \
     ((CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_SLEEP) || \
      (CY_CFG_PWR_SYS_IDLE_MODE == CY_CFG_PWR_MODE_DEEPSLEEP))
 
@@ -232,6 +272,9 @@ extern void vApplicationSleep( uint32_t xExpectedIdleTime );
 /* Deep Sleep Latency Configuration */
 #if( CY_CFG_PWR_DEEPSLEEP_LATENCY > 0 )
 #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   CY_CFG_PWR_DEEPSLEEP_LATENCY
+#elif LOW_POWER_ENABLE
+/* Shorter idle periods are not worth the tick correction, see low_power.c */
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   5
 #endif
 
 /* Allocate newlib reeentrancy structures for each RTOS task.
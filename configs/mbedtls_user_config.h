@@ -29,6 +29,8 @@
 #ifndef MBEDTLS_USER_CONFIG_HEADER
 #define MBEDTLS_USER_CONFIG_HEADER
 
+/* MEM_POOL_ENABLE of the application */
+#include "FreeRTOSConfig.h"
 
 /**
  * \def MBEDTLS_HAVE_TIME_DATE
@@ -83,6 +85,18 @@
 //#define MBEDTLS_PLATFORM_NV_SEED_ALT
 //#define MBEDTLS_PLATFORM_SETUP_TEARDOWN_ALT
 
+/**
+ * \def MBEDTLS_PLATFORM_MEMORY
+ *
+ * Enable the memory allocation layer with MEM_POOL_ENABLE, so that main.c can
+ * route the mbed TLS allocations to the fixed-block pools of mem_pool.c with
+ * mbedtls_platform_set_calloc_free(). Otherwise calloc() and free() of the C
+ * library are called directly.
+ */
+#if MEM_POOL_ENABLE
+#define MBEDTLS_PLATFORM_MEMORY
+#endif
+
 /**
  * \def MBEDTLS_ENTROPY_HARDWARE_ALT
  *
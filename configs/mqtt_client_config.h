@@ -55,6 +55,47 @@
  */
 #define MQTT_MESSAGES_QOS                 ( 1 )
 
+/* Set this macro to 1 to coalesce radar events into one JSON array payload
+ * per publish, else 0 to publish every event as its own message. A batch is
+ * flushed 'MQTT_PUB_BATCH_WINDOW_MS' milliseconds after its first event, or
+ * earlier when the next event would exceed 'MQTT_PUB_BATCH_MAX_BYTES'.
+ * Batching changes the payload seen by subscribers from one event object,
+ * e.g. {"PRESENCE": " IN", "Seq":7}, to an array of them in event order,
+ * e.g. [{"PRESENCE": " IN", "Seq":7},{"PRESENCE": "OUT", "Seq":8}], so it is
+ * off by default.
+ */
+#define MQTT_PUB_BATCH_ENABLE             ( 0 )
+#define MQTT_PUB_BATCH_WINDOW_MS          ( 500 )
+#define MQTT_PUB_BATCH_MAX_BYTES          ( 512 )
+
+/* Number of radar event payloads published concurrently. Each one waits for
+ * its own PUBACK in a worker task (publish_pool.c), so the event throughput
+ * is no longer limited to one payload per broker round trip. Set it to 1 to
+ * publish one payload at a time. At most 'MQTT_STATE_ARRAY_MAX_COUNT' - 2 and
+ * 'CY_MQTT_MAX_OUTGOING_PUBLISHES' - 1, which is set in the Makefile.
+ */
+#define MQTT_PUB_INFLIGHT_WINDOW          ( 4 )
+
+/* Payload encoding of radar events. 'MQTT_PUB_PAYLOAD_JSON' publishes JSON
+ * objects on 'MQTT_PUB_TOPIC'. 'MQTT_PUB_PAYLOAD_BINARY' publishes the
+ * versioned binary records described in radar_event_codec.h on the sibling
+ * topic 'MQTT_PUB_BIN_TOPIC' and skips all JSON formatting.
+ */
+#define MQTT_PUB_PAYLOAD_JSON             ( 0 )
+#define MQTT_PUB_PAYLOAD_BINARY           ( 1 )
+#define MQTT_PUB_PAYLOAD_FORMAT           ( MQTT_PUB_PAYLOAD_JSON )
+#define MQTT_PUB_BIN_TOPIC                MQTT_PUB_TOPIC "/bin"
+
+/* Topic on which diagnostics, such as the radar event latency report, are
+ * published on request.
+ */
+#define MQTT_DIAG_TOPIC                   MQTT_PUB_TOPIC "/diag"
+
+/* Topic on which the occupancy summaries (IN/OUT rates, peak occupancy and
+ * dwell times over the last minute, 15 minutes and hour) are published.
+ */
+#define MQTT_STATS_TOPIC                  MQTT_PUB_TOPIC "/stats"
+
 /* Configuration for the 'Last Will and Testament (LWT)'. It is an MQTT message
  * that will be published by the MQTT broker if the MQTT connection is
  * unexpectedly closed. This configuration is sent to the MQTT broker during
@@ -83,11 +124,25 @@
 /* The keep-alive interval in seconds used for MQTT ping request. */
 #define MQTT_KEEP_ALIVE_SECONDS           ( 60 )
 
+/* Set this macro to 1 to connect with a persistent session (clean session
+ * flag cleared). The broker then keeps the subscriptions and the QoS 1/2
+ * messages for this client across reconnections. The topics are subscribed
+ * again after every reconnection all the same, in case the broker expired or
+ * lost the session. The client identifier stays the same for the lifetime of
+ * the device.
+ */
+#define MQTT_PERSISTENT_SESSION           ( 0 )
+
 /* Every active MQTT connection must have a unique client identifier. If you
  * are using the above 'MQTT_CLIENT_IDENTIFIER' as client ID for multiple MQTT
  * connections simultaneously, set this macro to 1. The device will then
  * generate a unique client identifier by appending a timestamp to the
  * 'MQTT_CLIENT_IDENTIFIER' string. Example: 'psoc6-mqtt-client5927'
+ * With 'MQTT_PERSISTENT_SESSION', a hash of the silicon unique ID is
+ * appended instead, so that the broker finds the session again after a
+ * reboot. It takes the characters left by 'MQTT_CLIENT_IDENTIFIER' within
+ * 'MQTT_CLIENT_IDENTIFIER_MAX_LEN', up to 13; the more there are, the less
+ * likely two devices of a fleet share an ID. Example: 'radar-mqtt-clientw3mhv6'
  */
 #define GENERATE_UNIQUE_CLIENT_ID         ( 1 )
 
@@ -133,11 +188,26 @@
  */
 #define MQTT_NETWORK_BUFFER_SIZE          ( 2 * CY_MQTT_MIN_NETWORK_BUFFER_SIZE )
 
-/* Maximum MQTT connection re-connection limit. */
-#define MAX_MQTT_CONN_RETRIES            (150u)
+/* Maximum MQTT connection re-connection limit. With the backoff below a
+ * device gives up after 143 to 286 seconds of delays, within the 300 seconds
+ * of the former fixed 2 second interval and 150 retries.
+ */
+#define MAX_MQTT_CONN_RETRIES            (12u)
 
-/* MQTT re-connection time interval in milliseconds. */
+/* MQTT re-connection delay in milliseconds after the first failed attempt.
+ * The delay doubles with every further failure up to
+ * 'MQTT_CONN_RETRY_MAX_INTERVAL_MS' and is randomized per device within the
+ * upper half of that range.
+ */
 #define MQTT_CONN_RETRY_INTERVAL_MS      (2000)
+#define MQTT_CONN_RETRY_MAX_INTERVAL_MS  (32000)
+
+/* Largest random delay in milliseconds before the first MQTT connection
+ * attempt after a Wi-Fi reconnection, so that all sensors of a site do not
+ * hit the broker at once when their access point comes back. The MQTT
+ * connection is re-established without delay if Wi-Fi never dropped.
+ */
+#define MQTT_RECONNECT_JITTER_MS         (5000)
 
 
 /**************** MQTT CLIENT CERTIFICATE CONFIGURATION MACROS ****************/
@@ -161,11 +231,55 @@
 "........base64 data........\n" \
 "-----END CERTIFICATE-----"
 
+/* Set this macro to 1 to use the DER-encoded credentials below instead of the
+ * PEM strings above. DER skips the base64 decoding and PEM scanning that is
+ * otherwise repeated on every TLS handshake, and takes about a quarter less
+ * flash. Convert the PEM files with, for example:
+ *   openssl x509 -in client.cert.pem -outform der | xxd -i
+ *   openssl rsa -in client.private.key -outform der | xxd -i
+ */
+#define MQTT_CREDENTIALS_DER              ( 0 )
+
+/* DER-encoded credentials used when 'MQTT_CREDENTIALS_DER' is 1, defined like
+ * the PEM strings above, e.g.
+ *   #define CLIENT_CERTIFICATE_DER      { 0x30, 0x82, 0x03, 0x5a, ... }
+ *   #define CLIENT_PRIVATE_KEY_DER      { 0x30, 0x82, 0x04, 0xa4, ... }
+ *   #define ROOT_CA_CERTIFICATE_DER     { 0x30, 0x82, 0x03, 0x41, ... }
+ * A credential that is not defined is not used.
+ */
+
+/* Set this macro to 1 to parse the Root CA certificate once into the global
+ * trust store of the secure sockets library after the MQTT library is
+ * initialized. Every reconnection then reuses the parsed certificate instead
+ * of parsing it again for each new TLS context. The certificate then also
+ * verifies any other TLS connection of the application that brings no Root CA
+ * of its own.
+ */
+#define MQTT_ROOT_CA_LOAD_ONCE            ( 0 )
+
+/* Set this macro to 1 to offer the TLS session of the last connection on a
+ * reconnection (see tls_cache.c). A broker that still knows the session
+ * resumes it with an abbreviated handshake, without certificate exchange or
+ * key agreement; otherwise a full handshake is done. Session ID resumption
+ * works with the default mbedtls configuration, brokers that only resume
+ * with session tickets also need 'MBEDTLS_SSL_SESSION_TICKETS' in
+ * configs/mbedtls_user_config.h. Requires the GCC_ARM or ARM toolchain.
+ */
+#define MQTT_TLS_SESSION_RESUME           ( 0 )
+
+/* Set this macro to 1 to parse the client certificate and private key once
+ * and keep them across reconnections (see tls_cache.c), instead of parsing
+ * them for every connection. Requires the GCC_ARM or ARM toolchain.
+ */
+#define MQTT_TLS_IDENTITY_REUSE           ( 0 )
+
 /******************************************************************************
 * Global Variables
 *******************************************************************************/
 extern cy_mqtt_broker_info_t broker_info;
 extern cy_awsport_ssl_credentials_t  *security_info;
+extern const char *root_ca_certificate;
+extern const uint32_t root_ca_certificate_size;
 extern cy_mqtt_connect_info_t connection_info;
 
 
@@ -44,10 +44,18 @@
  */
 #define WIFI_SECURITY                     CY_WCM_SECURITY_WPA2_AES_PSK
 
-/* Maximum Wi-Fi re-connection limit. */
-#define MAX_WIFI_CONN_RETRIES             (120u)
+/* Maximum Wi-Fi re-connection limit. With the backoff below a device gives
+ * up after 277 to 555 seconds of delays, within the 600 seconds of the
+ * former fixed 5 second interval and 120 retries.
+ */
+#define MAX_WIFI_CONN_RETRIES             (12u)
 
-/* Wi-Fi re-connection time interval in milliseconds. */
+/* Wi-Fi re-connection delay in milliseconds after the first failed attempt.
+ * The delay doubles with every further failure up to
+ * 'WIFI_CONN_RETRY_MAX_INTERVAL_MS' and is randomized per device within the
+ * upper half of that range.
+ */
 #define WIFI_CONN_RETRY_INTERVAL_MS       (5000)
+#define WIFI_CONN_RETRY_MAX_INTERVAL_MS   (60000)
 
 #endif /* WIFI_CONFIG_H_ */
@@ -0,0 +1,198 @@
+/******************************************************************************
+ * File Name:   app_boot.c
+ *
+ * Description: This file implements the boot phases. The radar, publisher,
+ *   MQTT client and subscriber tasks start concurrently; each one signals the
+ *   phases it completes in an event group, and a task that depends on another
+ *   phase waits for its bit instead of a fixed delay. The time of every phase
+ *   is recorded and printed once the first radar event has been published.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+
+#include "cyhal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_boot.h"
+#include "app_memory.h"
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+#define APP_BOOT_PHASE_NAME(phase, name) name,
+static const char *const phase_names[APP_BOOT_PHASE_COUNT] =
+{
+    APP_BOOT_PHASE_LIST(APP_BOOT_PHASE_NAME)
+};
+#undef APP_BOOT_PHASE_NAME
+
+static EventGroupHandle_t boot_events;
+#if STATIC_ALLOCATION_ENABLE
+static StaticEventGroup_t boot_events_buffer;
+#endif
+
+/* Written once per phase in a critical section */
+static app_boot_timeline_t boot_timeline;
+
+/*******************************************************************************
+ * Function Name: print_timeline
+ *******************************************************************************
+ * Summary:
+ *   Prints the time of every boot phase on the debug UART.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_timeline(void)
+{
+    app_boot_timeline_t copy;
+
+    app_boot_get_timeline(&copy);
+
+    printf("Boot timeline (ms after the scheduler start):\n");
+    for (uint32_t i = 0; i < APP_BOOT_PHASE_COUNT; i++)
+    {
+        if ((copy.reached & APP_BOOT_BIT(i)) != 0)
+        {
+            printf("  %-16s %6lu\n", phase_names[i], (unsigned long)copy.ms[i]);
+        }
+        else
+        {
+            printf("  %-16s %6s\n", phase_names[i], "-");
+        }
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+ * Function Name: app_boot_init
+ *******************************************************************************
+ * Summary:
+ *   Creates the event group of the boot phases. Called from main() before
+ *   any task is created.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void app_boot_init(void)
+{
+#if STATIC_ALLOCATION_ENABLE
+    boot_events = xEventGroupCreateStatic(&boot_events_buffer);
+#else
+    boot_events = xEventGroupCreate();
+#endif
+    if (boot_events == NULL)
+    {
+        printf("Boot: event group creation failed\n");
+        CY_ASSERT(0);
+    }
+    app_memory_add("Boot", "Phase events", sizeof(StaticEventGroup_t), STATIC_ALLOCATION_ENABLE);
+}
+
+/*******************************************************************************
+ * Function Name: app_boot_signal
+ *******************************************************************************
+ * Summary:
+ *   Marks a boot phase as reached and wakes the tasks waiting for it. Only
+ *   the first call per phase records its time, later calls, for example after
+ *   a reconnection, return right away. Reaching APP_BOOT_FIRST_PUBLISH prints
+ *   the timeline. Must not be called from an interrupt.
+ *
+ * Parameters:
+ *   phase: reached boot phase
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void app_boot_signal(app_boot_phase_t phase)
+{
+    EventBits_t bit = APP_BOOT_BIT(phase);
+    bool first = false;
+
+    taskENTER_CRITICAL();
+    if ((boot_timeline.reached & bit) == 0)
+    {
+        boot_timeline.ms[phase] = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+        boot_timeline.reached |= bit;
+        first = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (first)
+    {
+        xEventGroupSetBits(boot_events, bit);
+
+        if (phase == APP_BOOT_FIRST_PUBLISH)
+        {
+            print_timeline();
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: app_boot_wait
+ *******************************************************************************
+ * Summary:
+ *   Blocks until all given boot phases are reached. Phases stay reached, so
+ *   the call returns at once if they already are.
+ *
+ * Parameters:
+ *   bits: APP_BOOT_BIT() of the phases to wait for
+ *   timeout: longest wait in ticks, portMAX_DELAY to wait forever
+ *
+ * Return:
+ *   true if all phases are reached, false on timeout
+ ******************************************************************************/
+bool app_boot_wait(EventBits_t bits, TickType_t timeout)
+{
+    return ((xEventGroupWaitBits(boot_events, bits, pdFALSE, pdTRUE, timeout) & bits) == bits);
+}
+
+/*******************************************************************************
+ * Function Name: app_boot_get_timeline
+ *******************************************************************************
+ * Summary:
+ *   Copies the time of the boot phases reached so far.
+ *
+ * Parameters:
+ *   timeline: receives the phases
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void app_boot_get_timeline(app_boot_timeline_t *timeline)
+{
+    taskENTER_CRITICAL();
+    *timeline = boot_timeline;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
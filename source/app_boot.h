@@ -0,0 +1,71 @@
+/******************************************************************************
+ * File Name:   app_boot.h
+ *
+ * Description: This file contains the boot phases shared by the tasks and the
+ *   functions to signal and wait for them.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "event_groups.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Boot phases in their usual order, with the name printed in the timeline */
+#define APP_BOOT_PHASE_LIST(X)                              X(APP_BOOT_PUBLISHER_READY, "publisher ready")          X(APP_BOOT_RADAR_READY, "radar ready")                  X(APP_BOOT_WIFI_CONNECTED, "Wi-Fi connected")           X(APP_BOOT_MQTT_CONNECTED, "MQTT connected")            X(APP_BOOT_SUBSCRIBED, "subscribed")                    X(APP_BOOT_FIRST_DETECTION, "first detection")          X(APP_BOOT_FIRST_PUBLISH, "first publish")
+
+/* Event group bit of a phase */
+#define APP_BOOT_BIT(phase) ((EventBits_t)1u << (phase))
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+#define APP_BOOT_PHASE_ENUM(phase, name) phase,
+typedef enum
+{
+    APP_BOOT_PHASE_LIST(APP_BOOT_PHASE_ENUM)
+    APP_BOOT_PHASE_COUNT
+} app_boot_phase_t;
+#undef APP_BOOT_PHASE_ENUM
+
+/* Time of every phase reached so far */
+typedef struct
+{
+    EventBits_t reached;                        /* APP_BOOT_BIT() of the reached phases */
+    uint32_t ms[APP_BOOT_PHASE_COUNT];          /* Milliseconds since the scheduler start */
+} app_boot_timeline_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void app_boot_init(void);
+void app_boot_signal(app_boot_phase_t phase);
+bool app_boot_wait(EventBits_t bits, TickType_t timeout);
+void app_boot_get_timeline(app_boot_timeline_t *timeline);
+
+/* [] END OF FILE */
@@ -0,0 +1,295 @@
+/******************************************************************************
+ * File Name:   app_memory.c
+ *
+ * Description: This file creates the tasks, queues and mutexes of the
+ *   application from static buffers or from the heap, depending on
+ *   STATIC_ALLOCATION_ENABLE, and keeps a list of them for the RAM report
+ *   printed at start-up.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "app_memory.h"
+#include "mem_pool.h"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* One entry of the RAM report */
+typedef struct
+{
+    const char *subsystem;
+    const char *name;
+    uint32_t bytes;
+    bool is_static;
+} app_memory_object_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static app_memory_object_t objects[APP_MEMORY_MAX_OBJECTS];
+static uint32_t object_count = 0;
+/* Objects not listed since the list was full */
+static uint32_t objects_dropped = 0;
+
+/*******************************************************************************
+ * Function Name: app_memory_add
+ *******************************************************************************
+ * Summary:
+ *   Adds an object to the RAM report. The strings must stay valid.
+ *
+ * Parameters:
+ *   subsystem: group of the object in the report
+ *   name: object name
+ *   bytes: RAM used by the object, including its control block
+ *   is_static: true if the object uses static buffers, false if heap
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void app_memory_add(const char *subsystem, const char *name, size_t bytes, bool is_static)
+{
+    taskENTER_CRITICAL();
+    if (object_count < APP_MEMORY_MAX_OBJECTS)
+    {
+        objects[object_count].subsystem = subsystem;
+        objects[object_count].name = name;
+        objects[object_count].bytes = (uint32_t)bytes;
+        objects[object_count].is_static = is_static;
+        object_count++;
+    }
+    else
+    {
+        objects_dropped++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: app_task_create
+ *******************************************************************************
+ * Summary:
+ *   Creates a task like xTaskCreate() and adds it to the RAM report. The task
+ *   uses the given stack and control block if both are set, else the heap.
+ *
+ * Parameters:
+ *   subsystem: group of the task in the report
+ *   code, name, stack_depth, parameters, priority, handle: see xTaskCreate()
+ *   stack: stack of stack_depth words, APP_TASK_STACK()
+ *   tcb: task control block, APP_TASK_TCB()
+ *
+ * Return:
+ *   pdPASS if the task was created, else an error code
+ ******************************************************************************/
+BaseType_t app_task_create(const char *subsystem, TaskFunction_t code, const char *name,
+                           uint32_t stack_depth, void *parameters, UBaseType_t priority,
+                           TaskHandle_t *handle, StackType_t *stack, StaticTask_t *tcb)
+{
+    BaseType_t result = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+    TaskHandle_t task;
+
+    if ((stack != NULL) && (tcb != NULL))
+    {
+        task = xTaskCreateStatic(code, name, stack_depth, parameters, priority, stack, tcb);
+        if (task != NULL)
+        {
+            if (handle != NULL)
+            {
+                *handle = task;
+            }
+            result = pdPASS;
+        }
+    }
+    else
+    {
+        result = xTaskCreate(code, name, (configSTACK_DEPTH_TYPE)stack_depth, parameters, priority, handle);
+    }
+
+    if (result == pdPASS)
+    {
+        app_memory_add(subsystem, name, (stack_depth * sizeof(StackType_t)) + sizeof(StaticTask_t), stack != NULL);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: app_queue_create
+ *******************************************************************************
+ * Summary:
+ *   Creates a queue like xQueueCreate() and adds it to the RAM report. The
+ *   queue uses the given storage and control block if both are set, else the
+ *   heap.
+ *
+ * Parameters:
+ *   subsystem: group of the queue in the report
+ *   name: queue name in the report
+ *   length, item_size: see xQueueCreate()
+ *   storage: item storage of length * item_size bytes, APP_QUEUE_STORAGE()
+ *   queue: queue control block, APP_QUEUE_QCB()
+ *
+ * Return:
+ *   queue handle, NULL on failure
+ ******************************************************************************/
+QueueHandle_t app_queue_create(const char *subsystem, const char *name,
+                               UBaseType_t length, UBaseType_t item_size,
+                               uint8_t *storage, StaticQueue_t *queue)
+{
+    QueueHandle_t handle;
+
+    if ((storage != NULL) && (queue != NULL))
+    {
+        handle = xQueueCreateStatic(length, item_size, storage, queue);
+    }
+    else
+    {
+        handle = xQueueCreate(length, item_size);
+    }
+
+    if (handle != NULL)
+    {
+        app_memory_add(subsystem, name, (length * item_size) + sizeof(StaticQueue_t), storage != NULL);
+    }
+
+    return handle;
+}
+
+/*******************************************************************************
+ * Function Name: app_mutex_create
+ *******************************************************************************
+ * Summary:
+ *   Creates a mutex like xSemaphoreCreateMutex() and adds it to the RAM
+ *   report. The mutex uses the given control block if set, else the heap.
+ *
+ * Parameters:
+ *   subsystem: group of the mutex in the report
+ *   name: mutex name in the report
+ *   mutex: control block, APP_MUTEX_QCB()
+ *
+ * Return:
+ *   mutex handle, NULL on failure
+ ******************************************************************************/
+SemaphoreHandle_t app_mutex_create(const char *subsystem, const char *name, StaticSemaphore_t *mutex)
+{
+    SemaphoreHandle_t handle;
+
+    if (mutex != NULL)
+    {
+        handle = xSemaphoreCreateMutexStatic(mutex);
+    }
+    else
+    {
+        handle = xSemaphoreCreateMutex();
+    }
+
+    if (handle != NULL)
+    {
+        app_memory_add(subsystem, name, sizeof(StaticSemaphore_t), mutex != NULL);
+    }
+
+    return handle;
+}
+
+/*******************************************************************************
+ * Function Name: app_memory_report
+ *******************************************************************************
+ * Summary:
+ *   Prints the RAM used by the objects created so far, grouped by subsystem,
+ *   and the heap currently in use. Objects from the heap are marked with '*'.
+ *   The heap figure includes the allocations of the libraries (Wi-Fi, lwIP,
+ *   MQTT, TLS).
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void app_memory_report(void)
+{
+    static app_memory_object_t snapshot[APP_MEMORY_MAX_OBJECTS];
+    uint32_t count;
+    uint32_t total_static = 0;
+    uint32_t total_heap = 0;
+
+    taskENTER_CRITICAL();
+    count = object_count;
+    memcpy(snapshot, objects, count * sizeof(app_memory_object_t));
+    taskEXIT_CRITICAL();
+
+    printf("\nRAM report (%s allocation):\n", STATIC_ALLOCATION_ENABLE ? "static" : "heap");
+
+    /* Print each subsystem once, at the position of its first object */
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t subtotal = 0;
+        bool listed = false;
+
+        for (uint32_t j = 0; (j < i) && !listed; j++)
+        {
+            listed = (strcmp(snapshot[j].subsystem, snapshot[i].subsystem) == 0);
+        }
+        if (listed)
+        {
+            continue;
+        }
+
+        for (uint32_t j = i; j < count; j++)
+        {
+            if (strcmp(snapshot[j].subsystem, snapshot[i].subsystem) == 0)
+            {
+                printf("  %-12s %-24s %6lu%s\n", (j == i) ? snapshot[i].subsystem : "",
+                       snapshot[j].name, (unsigned long)snapshot[j].bytes, snapshot[j].is_static ? "" : " *");
+                subtotal += snapshot[j].bytes;
+                if (snapshot[j].is_static)
+                {
+                    total_static += snapshot[j].bytes;
+                }
+                else
+                {
+                    total_heap += snapshot[j].bytes;
+                }
+            }
+        }
+        printf("  %-12s %-24s %6lu\n", "", "total", (unsigned long)subtotal);
+    }
+
+    printf("  Static: %lu bytes, application objects on the heap: %lu bytes\n",
+           (unsigned long)total_static, (unsigned long)total_heap);
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    printf("  Heap in use: %lu bytes\n", (unsigned long)mallinfo().uordblks);
+#endif
+    if (objects_dropped > 0)
+    {
+        printf("  %lu objects not listed, increase APP_MEMORY_MAX_OBJECTS\n", (unsigned long)objects_dropped);
+    }
+#if MEM_POOL_ENABLE
+    mem_pool_report();
+#endif
+    printf("\n");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+ * File Name:   app_memory.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in app_memory.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#if STATIC_ALLOCATION_ENABLE && !configSUPPORT_STATIC_ALLOCATION
+#error "STATIC_ALLOCATION_ENABLE needs configSUPPORT_STATIC_ALLOCATION"
+#endif
+
+/* Most objects listed in the RAM report */
+#define APP_MEMORY_MAX_OBJECTS (32u)
+
+/* Declare the buffers of a task, queue or mutex at file scope and pass them to
+ * app_task_create(), app_queue_create() or app_mutex_create(). Without
+ * STATIC_ALLOCATION_ENABLE no buffers are reserved, the declarations expand
+ * to nothing and the objects come from the heap. The macros supply their own
+ * semicolons, call sites have none. */
+#if STATIC_ALLOCATION_ENABLE
+#define APP_TASK_MEMORY(name, stack_depth) \
+    static StackType_t name##_stack[(stack_depth)]; \
+    static StaticTask_t name##_tcb;
+#define APP_TASK_STACK(name) (name##_stack)
+#define APP_TASK_TCB(name)   (&name##_tcb)
+
+#define APP_QUEUE_MEMORY(name, length, item_size) \
+    static uint8_t name##_storage[(length) * (item_size)]; \
+    static StaticQueue_t name##_queue;
+#define APP_QUEUE_STORAGE(name) (name##_storage)
+#define APP_QUEUE_QCB(name)     (&name##_queue)
+
+#define APP_MUTEX_MEMORY(name) static StaticSemaphore_t name##_mutex;
+#define APP_MUTEX_QCB(name)    (&name##_mutex)
+#else
+#define APP_TASK_MEMORY(name, stack_depth)
+#define APP_TASK_STACK(name) (NULL)
+#define APP_TASK_TCB(name)   (NULL)
+
+#define APP_QUEUE_MEMORY(name, length, item_size)
+#define APP_QUEUE_STORAGE(name) (NULL)
+#define APP_QUEUE_QCB(name)     (NULL)
+
+#define APP_MUTEX_MEMORY(name)
+#define APP_MUTEX_QCB(name)    (NULL)
+#endif
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+BaseType_t app_task_create(const char *subsystem, TaskFunction_t code, const char *name,
+                           uint32_t stack_depth, void *parameters, UBaseType_t priority,
+                           TaskHandle_t *handle, StackType_t *stack, StaticTask_t *tcb);
+QueueHandle_t app_queue_create(const char *subsystem, const char *name,
+                               UBaseType_t length, UBaseType_t item_size,
+                               uint8_t *storage, StaticQueue_t *queue);
+SemaphoreHandle_t app_mutex_create(const char *subsystem, const char *name, StaticSemaphore_t *mutex);
+
+void app_memory_add(const char *subsystem, const char *name, size_t bytes, bool is_static);
+void app_memory_report(void);
+
+/* [] END OF FILE */
@@ -0,0 +1,224 @@
+/******************************************************************************
+ * File Name:   low_power.c
+ *
+ * Description: This file implements the tickless idle of the low power mode.
+ *   The idle task enters CPU Sleep or System Deep Sleep until the next task
+ *   timeout or an interrupt through vApplicationSleep() of the RTOS
+ *   abstraction library, and the time spent asleep is counted so that builds
+ *   can be compared.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+
+#include "cyhal.h"
+#include "cybsp.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "cyabs_freertos_helpers.h"
+#include "low_power.h"
+#include "radar_task.h"
+
+#if LOW_POWER_ENABLE && !RADAR_IRQ_ACQUISITION_ENABLE
+#error "LOW_POWER_ENABLE needs RADAR_IRQ_ACQUISITION_ENABLE, a polling radar task keeps the CPU awake"
+#endif
+
+/* In Deep Sleep the SDIO bus is stopped, only the host wake interrupt of the
+ * Wi-Fi chip tells about incoming MQTT traffic */
+#if LOW_POWER_ENABLE && defined(CY_WIFI_HOST_WAKE_SW_FORCE) && (CY_WIFI_HOST_WAKE_SW_FORCE == 0)
+#error "LOW_POWER_ENABLE needs the Wi-Fi host wake interrupt, remove CY_WIFI_HOST_WAKE_SW_FORCE=0 from the Makefile"
+#endif
+
+/* vApplicationSleep() of the RTOS abstraction library chooses between CPU
+ * Sleep and Deep Sleep with the Power settings of the device configurator */
+#if LOW_POWER_ENABLE && \
+    (!defined(CY_CFG_PWR_SYS_IDLE_MODE) || (CY_CFG_PWR_SYS_IDLE_MODE != CY_CFG_PWR_MODE_DEEPSLEEP))
+#warning "LOW_POWER_ENABLE: System Idle Power Mode is not System Deep Sleep, the idle task only enters CPU Sleep"
+#endif
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+#if LOW_POWER_ENABLE
+/* Wake-up timer, runs from the low frequency clock in Deep Sleep */
+static cyhal_lptimer_t wakeup_timer;
+static bool wakeup_timer_ready = false;
+
+/* Reports the power mode the CPU woke up from */
+static bool low_power_transition(cyhal_syspm_callback_state_t state, cyhal_syspm_callback_mode_t mode,
+                                 void *callback_arg);
+static cyhal_syspm_callback_data_t transition_callback =
+{
+    .callback = low_power_transition,
+    .states = (cyhal_syspm_callback_state_t)(CYHAL_SYSPM_CB_CPU_SLEEP | CYHAL_SYSPM_CB_CPU_DEEPSLEEP),
+    .ignore_modes = (cyhal_syspm_callback_mode_t)(CYHAL_SYSPM_CHECK_READY | CYHAL_SYSPM_CHECK_FAIL |
+                                                  CYHAL_SYSPM_BEFORE_TRANSITION),
+    .args = NULL,
+    .next = NULL
+};
+
+/* Power mode of the last idle period, set by low_power_transition() */
+static volatile cyhal_syspm_callback_state_t slept_state;
+static volatile bool slept;
+#endif
+
+/* Updated by the idle task with interrupts disabled */
+static low_power_stats_t low_power_stats;
+
+/*******************************************************************************
+ * Function Name: low_power_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the wake-up timer of the tickless idle and hands it to the
+ *   RTOS abstraction library. Must be called before the scheduler is started.
+ *   Without the timer the idle task does not sleep.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void low_power_init(void)
+{
+#if LOW_POWER_ENABLE
+    if (cyhal_lptimer_init(&wakeup_timer) == CY_RSLT_SUCCESS)
+    {
+        wakeup_timer_ready = true;
+        cyabs_rtos_set_lptimer(&wakeup_timer);
+        cyhal_syspm_register_callback(&transition_callback);
+        printf("Low power mode: tickless idle, Deep Sleep from %u ms idle time\n",
+               (unsigned int)CY_CFG_PWR_DEEPSLEEP_LATENCY);
+    }
+    else
+    {
+        printf("Low power mode: wake-up timer unavailable, sleep disabled\n");
+    }
+#endif
+}
+
+#if LOW_POWER_ENABLE
+/*******************************************************************************
+ * Function Name: low_power_transition
+ *******************************************************************************
+ * Summary:
+ *   System power management callback, called after the CPU woke up from CPU
+ *   Sleep or Deep Sleep.
+ *
+ * Parameters:
+ *   state: power mode left
+ *   mode: always CYHAL_SYSPM_AFTER_TRANSITION
+ *   callback_arg: unused
+ *
+ * Return:
+ *   true
+ ******************************************************************************/
+static bool low_power_transition(cyhal_syspm_callback_state_t state, cyhal_syspm_callback_mode_t mode,
+                                 void *callback_arg)
+{
+    (void)mode;
+    (void)callback_arg;
+
+    slept_state = state;
+    slept = true;
+    return true;
+}
+#endif
+
+/*******************************************************************************
+ * Function Name: low_power_sleep
+ *******************************************************************************
+ * Summary:
+ *   Called by the idle task through portSUPPRESS_TICKS_AND_SLEEP() once no task
+ *   is ready for at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks. Sleeps
+ *   with vApplicationSleep() of the RTOS abstraction library, which enters
+ *   Deep Sleep for idle periods longer than the Deep Sleep latency of the
+ *   device configurator and CPU Sleep otherwise, and advances the tick count.
+ *   The ticks it stepped are counted as time asleep.
+ *
+ * Parameters:
+ *   expected_idle_ticks: ticks until the next task timeout
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void low_power_sleep(TickType_t expected_idle_ticks)
+{
+#if LOW_POWER_ENABLE
+    TickType_t start;
+    uint32_t slept_ms;
+
+    if (!wakeup_timer_ready)
+    {
+        return;
+    }
+
+    /* The scheduler is suspended, only vTaskStepTick() moves the tick count */
+    slept = false;
+    start = xTaskGetTickCount();
+    vApplicationSleep(expected_idle_ticks);
+    slept_ms = (uint32_t)(((uint64_t)(xTaskGetTickCount() - start) * 1000u) / configTICK_RATE_HZ);
+
+    if (!slept)
+    {
+        low_power_stats.aborted++;
+        return;
+    }
+
+    low_power_stats.asleep_ms += slept_ms;
+    if (slept_state == CYHAL_SYSPM_CB_CPU_DEEPSLEEP)
+    {
+        low_power_stats.deepsleeps++;
+        low_power_stats.deepsleep_ms += slept_ms;
+    }
+    else
+    {
+        low_power_stats.sleeps++;
+    }
+#else
+    (void)expected_idle_ticks;
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: low_power_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the sleep counters. The awake time is the uptime minus
+ *   asleep_ms.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void low_power_get_stats(low_power_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = low_power_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * File Name:   low_power.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in low_power.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the idle task, all zero unless LOW_POWER_ENABLE is set */
+typedef struct
+{
+    uint32_t sleeps;            /* Idle periods spent in CPU Sleep */
+    uint32_t deepsleeps;        /* Idle periods spent in System Deep Sleep */
+    uint32_t aborted;           /* Idle periods ended before sleeping, e.g. by a task becoming ready */
+    uint64_t asleep_ms;         /* Time spent in CPU Sleep or Deep Sleep */
+    uint64_t deepsleep_ms;      /* Part of asleep_ms spent in Deep Sleep */
+} low_power_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void low_power_init(void);
+void low_power_sleep(TickType_t expected_idle_ticks);
+void low_power_get_stats(low_power_stats_t *stats);
+
+/* [] END OF FILE */
@@ -26,12 +26,20 @@
 
 /* Header file includes */
 #include "FreeRTOS.h"
+#include "app_boot.h"
+#include "app_memory.h"
 #include "cy_retarget_io.h"
 #include "cybsp.h"
 #include "cyhal.h"
+#include "low_power.h"
+#include "mem_pool.h"
 #include "mqtt_task.h"
 #include "task.h"
 
+#if MEM_POOL_ENABLE
+#include "mbedtls/platform.h"
+#endif
+
 /*******************************************************************************
 * Macros
 *******************************************************************************/
@@ -53,12 +61,15 @@ static void isr_timer(void *callback_arg, cyhal_timer_event_t event);
 volatile int uxTopUsedPriority;
 /* Timer object used for blinking the LED */
 cyhal_timer_t led_blink_timer;
+/* Buffers of the MQTT client task */
+APP_TASK_MEMORY(mqtt_client_task, MQTT_CLIENT_TASK_STACK_SIZE)
 /******************************************************************************
  * Function Name: main
  ******************************************************************************
  * Summary:
  *  System entrance point. This function initializes retarget IO, sets up
- *  the MQTT client task, and then starts the RTOS scheduler.
+ *  the boot phases and the MQTT client task, and then starts the RTOS
+ *  scheduler.
  *
  * Parameters:
  *  void
@@ -102,9 +113,21 @@ int main(void)
     printf("CE229889 - AnyCloud Example: MQTT Client with xensiv sensors: BGT60TRxx\n");
     printf("=====================================================================\n\n");
 
+#if MEM_POOL_ENABLE
+    /* Keep the TLS buffers in the fixed-block pools across reconnections */
+    mbedtls_platform_set_calloc_free(mem_pool_calloc, mem_pool_free);
+#endif
+
+    /* Prepare the tickless idle, no-op unless LOW_POWER_ENABLE is set */
+    low_power_init();
+
+    /* Phases the tasks signal to each other while they start concurrently */
+    app_boot_init();
+
     /* Create the MQTT Client task. */
-    xTaskCreate(mqtt_client_task, "MQTT Client task", MQTT_CLIENT_TASK_STACK_SIZE,
-                NULL, MQTT_CLIENT_TASK_PRIORITY, NULL);
+    app_task_create("MQTT", mqtt_client_task, "MQTT Client task", MQTT_CLIENT_TASK_STACK_SIZE,
+                    NULL, MQTT_CLIENT_TASK_PRIORITY, NULL,
+                    APP_TASK_STACK(mqtt_client_task), APP_TASK_TCB(mqtt_client_task));
 
     /* Start the FreeRTOS scheduler. */
     vTaskStartScheduler();
@@ -0,0 +1,376 @@
+/******************************************************************************
+ * File Name:   mem_pool.c
+ *
+ * Description: This file implements a fixed-block allocator with size classes.
+ *   With MEM_POOL_ENABLE it replaces heap_3 as pvPortMalloc()/vPortFree() and
+ *   serves the allocations of mbedTLS, so the buffers freed and allocated again
+ *   on every reconnection always return to the same blocks and cannot fragment
+ *   the heap. A request is served by the smallest class with a free block;
+ *   requests larger than every block go to the C library heap.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mem_pool.h"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* One size class. Free blocks are chained through their first word, blocks
+ * never used so far are taken from 'unused' on. */
+typedef struct
+{
+    uint32_t block_size;
+    uint32_t block_count;
+    uint8_t *blocks;
+    uint32_t *requested;        /* Requested size of every allocated block */
+    void *free_list;
+    uint32_t unused;
+} mem_pool_class_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Block storage and requested sizes of every class, 8-byte aligned */
+#define MEM_POOL_STORAGE(size, count) \
+    static uint64_t mem_pool_blocks_##size[((size) * (count)) / sizeof(uint64_t)]; \
+    static uint32_t mem_pool_requested_##size[(count)];
+MEM_POOL_CLASS_LIST(MEM_POOL_STORAGE)
+
+#define MEM_POOL_CLASS(size, count) \
+    { (size), (count), (uint8_t *)mem_pool_blocks_##size, mem_pool_requested_##size, NULL, 0 },
+static mem_pool_class_t pool_classes[MEM_POOL_CLASS_COUNT] =
+{
+    MEM_POOL_CLASS_LIST(MEM_POOL_CLASS)
+};
+
+static mem_pool_stats_t pool_stats;
+
+/*******************************************************************************
+ * Function Name: class_of_block
+ *******************************************************************************
+ * Summary:
+ *   Returns the index of the class a block belongs to.
+ *
+ * Parameters:
+ *   block: pointer returned by mem_pool_alloc()
+ *
+ * Return:
+ *   class index, MEM_POOL_CLASS_COUNT if the block is from the C library heap
+ ******************************************************************************/
+static uint32_t class_of_block(const uint8_t *block)
+{
+    for (uint32_t i = 0; i < MEM_POOL_CLASS_COUNT; i++)
+    {
+        const mem_pool_class_t *pool = &pool_classes[i];
+
+        if ((block >= pool->blocks) && (block < &pool->blocks[pool->block_size * pool->block_count]))
+        {
+            return i;
+        }
+    }
+
+    return MEM_POOL_CLASS_COUNT;
+}
+
+/*******************************************************************************
+ * Function Name: mem_pool_alloc
+ *******************************************************************************
+ * Summary:
+ *   Allocates a block of at least 'size' bytes, 8-byte aligned.
+ *
+ * Parameters:
+ *   size: requested size in bytes
+ *
+ * Return:
+ *   block, NULL if no memory is left
+ ******************************************************************************/
+void *mem_pool_alloc(size_t size)
+{
+    uint8_t *block = NULL;
+    bool best_fit = true;
+
+    if (size == 0)
+    {
+        return NULL;
+    }
+
+    vTaskSuspendAll();
+    for (uint32_t i = 0; (i < MEM_POOL_CLASS_COUNT) && (block == NULL); i++)
+    {
+        mem_pool_class_t *pool = &pool_classes[i];
+        mem_pool_class_stats_t *class_stats = &pool_stats.classes[i];
+        uint32_t index;
+
+        if (pool->block_size < size)
+        {
+            continue;
+        }
+
+        if (pool->free_list != NULL)
+        {
+            block = pool->free_list;
+            pool->free_list = *(void **)block;
+        }
+        else if (pool->unused < pool->block_count)
+        {
+            block = &pool->blocks[pool->block_size * pool->unused];
+            pool->unused++;
+        }
+        else
+        {
+            if (best_fit)
+            {
+                class_stats->spills++;
+                best_fit = false;
+            }
+            continue;
+        }
+
+        index = (uint32_t)(block - pool->blocks) / pool->block_size;
+        pool->requested[index] = (uint32_t)size;
+
+        class_stats->allocations++;
+        if (++class_stats->in_use > class_stats->high_water)
+        {
+            class_stats->high_water = class_stats->in_use;
+        }
+        pool_stats.requested_in_use += (uint32_t)size;
+        pool_stats.bytes_in_use += pool->block_size;
+        if (pool_stats.bytes_in_use > pool_stats.bytes_peak)
+        {
+            pool_stats.bytes_peak = pool_stats.bytes_in_use;
+        }
+    }
+
+    /* Like heap_3, the C library heap is only called with the scheduler
+     * suspended, so it does not rely on the __malloc_lock() and
+     * __malloc_unlock() hooks of newlib */
+    if (block == NULL)
+    {
+        block = malloc(size);
+        if (block != NULL)
+        {
+            pool_stats.fallbacks++;
+        }
+        else
+        {
+            pool_stats.failures++;
+        }
+    }
+    (void)xTaskResumeAll();
+
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: mem_pool_calloc
+ *******************************************************************************
+ * Summary:
+ *   Allocates a zeroed array, see calloc(). Used by mbedTLS.
+ *
+ * Parameters:
+ *   count: number of elements
+ *   size: size of one element
+ *
+ * Return:
+ *   block, NULL if no memory is left or the size overflows
+ ******************************************************************************/
+void *mem_pool_calloc(size_t count, size_t size)
+{
+    void *block;
+
+    if ((size != 0) && (count > (SIZE_MAX / size)))
+    {
+        return NULL;
+    }
+
+    block = mem_pool_alloc(count * size);
+    if (block != NULL)
+    {
+        memset(block, 0, count * size);
+    }
+
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: mem_pool_free
+ *******************************************************************************
+ * Summary:
+ *   Returns a block to its class, or to the C library heap it came from.
+ *
+ * Parameters:
+ *   block: pointer returned by mem_pool_alloc() or mem_pool_calloc(), or NULL
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void mem_pool_free(void *block)
+{
+    uint32_t i;
+
+    if (block == NULL)
+    {
+        return;
+    }
+
+    i = class_of_block(block);
+
+    vTaskSuspendAll();
+    if (i == MEM_POOL_CLASS_COUNT)
+    {
+        free(block);
+    }
+    else
+    {
+        mem_pool_class_t *pool = &pool_classes[i];
+        uint32_t index = (uint32_t)((uint8_t *)block - pool->blocks) / pool->block_size;
+
+        pool_stats.requested_in_use -= pool->requested[index];
+        pool_stats.bytes_in_use -= pool->block_size;
+        pool_stats.classes[i].in_use--;
+
+        *(void **)block = pool->free_list;
+        pool->free_list = block;
+    }
+    (void)xTaskResumeAll();
+}
+
+#if MEM_POOL_ENABLE
+/*******************************************************************************
+ * Function Name: pvPortMalloc
+ *******************************************************************************
+ * Summary:
+ *   FreeRTOS heap allocation, replaces heap_3 while MEM_POOL_ENABLE is set.
+ *
+ * Parameters:
+ *   xWantedSize: requested size in bytes
+ *
+ * Return:
+ *   block, NULL if no memory is left
+ ******************************************************************************/
+void *pvPortMalloc(size_t xWantedSize)
+{
+    void *block = mem_pool_alloc(xWantedSize);
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+    if (block == NULL)
+    {
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif
+
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: vPortFree
+ *******************************************************************************
+ * Summary:
+ *   FreeRTOS heap release, replaces heap_3 while MEM_POOL_ENABLE is set.
+ *
+ * Parameters:
+ *   pv: block returned by pvPortMalloc(), or NULL
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void vPortFree(void *pv)
+{
+    mem_pool_free(pv);
+}
+#endif /* MEM_POOL_ENABLE */
+
+/*******************************************************************************
+ * Function Name: mem_pool_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the allocator counters.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void mem_pool_get_stats(mem_pool_stats_t *stats)
+{
+    vTaskSuspendAll();
+    *stats = pool_stats;
+    (void)xTaskResumeAll();
+
+    for (uint32_t i = 0; i < MEM_POOL_CLASS_COUNT; i++)
+    {
+        stats->classes[i].block_size = pool_classes[i].block_size;
+        stats->classes[i].block_count = pool_classes[i].block_count;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: mem_pool_report
+ *******************************************************************************
+ * Summary:
+ *   Prints the use of every size class and the internal fragmentation, i.e.
+ *   the share of the allocated block bytes not requested by the callers.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void mem_pool_report(void)
+{
+    mem_pool_stats_t stats;
+    uint32_t waste_permille = 0;
+
+    mem_pool_get_stats(&stats);
+    if (stats.bytes_in_use > 0)
+    {
+        waste_permille = (uint32_t)(((uint64_t)(stats.bytes_in_use - stats.requested_in_use) * 1000u) /
+                                    stats.bytes_in_use);
+    }
+
+    printf("Memory pool: %lu bytes in use (peak %lu), %lu.%lu%% unused inside blocks, %lu heap fallbacks, %lu failures\n",
+           (unsigned long)stats.bytes_in_use, (unsigned long)stats.bytes_peak,
+           (unsigned long)(waste_permille / 10u), (unsigned long)(waste_permille % 10u),
+           (unsigned long)stats.fallbacks, (unsigned long)stats.failures);
+    for (uint32_t i = 0; i < MEM_POOL_CLASS_COUNT; i++)
+    {
+        const mem_pool_class_stats_t *class_stats = &stats.classes[i];
+
+        printf("  %5lu bytes: %2lu of %2lu in use, high water %2lu, %lu allocations, %lu spills\n",
+               (unsigned long)class_stats->block_size, (unsigned long)class_stats->in_use,
+               (unsigned long)class_stats->block_count, (unsigned long)class_stats->high_water,
+               (unsigned long)class_stats->allocations, (unsigned long)class_stats->spills);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * File Name:   mem_pool.h
+ *
+ * Description: This file contains the size classes, function prototypes and
+ *   types used in mem_pool.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Size classes as X(block size in bytes, number of blocks). Block sizes must be
+ * multiples of 8 and ascending. The largest class holds the 16 KB record
+ * buffers of mbedTLS, two per TLS connection, plus one spare for the overlap of
+ * an old and a new connection. */
+#define MEM_POOL_CLASS_LIST(X) \
+    X(32,    96) \
+    X(64,    64) \
+    X(128,   48) \
+    X(256,   32) \
+    X(512,   16) \
+    X(1024,  12) \
+    X(2048,   6) \
+    X(4096,   4) \
+    X(17408,  3)
+
+#define MEM_POOL_COUNT_CLASS(size, count) + 1
+#define MEM_POOL_CLASS_COUNT (0 MEM_POOL_CLASS_LIST(MEM_POOL_COUNT_CLASS))
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of one size class */
+typedef struct
+{
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t in_use;            /* Blocks currently allocated */
+    uint32_t high_water;        /* Most blocks allocated at the same time */
+    uint32_t allocations;       /* Blocks handed out so far */
+    uint32_t spills;            /* Requests served by a larger class as this one was full */
+} mem_pool_class_stats_t;
+
+/* Counters of the whole allocator */
+typedef struct
+{
+    mem_pool_class_stats_t classes[MEM_POOL_CLASS_COUNT];
+    uint32_t bytes_in_use;      /* Block bytes currently allocated */
+    uint32_t bytes_peak;        /* Most block bytes allocated at the same time */
+    uint32_t requested_in_use;  /* Bytes requested by the callers of the allocated blocks */
+    uint32_t fallbacks;         /* Requests served by the C library heap, no block fitted */
+    uint32_t failures;          /* Requests that could not be served at all */
+} mem_pool_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void *mem_pool_alloc(size_t size);
+void *mem_pool_calloc(size_t count, size_t size);
+void mem_pool_free(void *block);
+
+void mem_pool_get_stats(mem_pool_stats_t *stats);
+void mem_pool_report(void);
+
+/* [] END OF FILE */
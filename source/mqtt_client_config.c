@@ -41,31 +41,71 @@ cy_mqtt_broker_info_t broker_info =
 };
 
 #if (MQTT_SECURE_CONNECTION)
+#if MQTT_CREDENTIALS_DER
+/* DER-encoded credentials. Unlike PEM strings, their size must not include a
+ * terminating null character.
+ */
+#ifdef CLIENT_CERTIFICATE_DER
+static const uint8_t client_certificate_der[] = CLIENT_CERTIFICATE_DER;
+#define CLIENT_CERTIFICATE_DATA         ((const char *)client_certificate_der)
+#define CLIENT_CERTIFICATE_SIZE         sizeof(client_certificate_der)
+#endif
+#ifdef CLIENT_PRIVATE_KEY_DER
+static const uint8_t client_private_key_der[] = CLIENT_PRIVATE_KEY_DER;
+#define CLIENT_PRIVATE_KEY_DATA         ((const char *)client_private_key_der)
+#define CLIENT_PRIVATE_KEY_SIZE         sizeof(client_private_key_der)
+#endif
+#ifdef ROOT_CA_CERTIFICATE_DER
+static const uint8_t root_ca_certificate_der[] = ROOT_CA_CERTIFICATE_DER;
+#define ROOT_CA_CERTIFICATE_DATA        ((const char *)root_ca_certificate_der)
+#define ROOT_CA_CERTIFICATE_SIZE        sizeof(root_ca_certificate_der)
+#endif
+#else
+/* PEM-encoded credentials. Their size includes the terminating null
+ * character, as required by the PEM parser.
+ */
+#ifdef CLIENT_CERTIFICATE
+#define CLIENT_CERTIFICATE_DATA         ((const char *)CLIENT_CERTIFICATE)
+#define CLIENT_CERTIFICATE_SIZE         sizeof(CLIENT_CERTIFICATE)
+#endif
+#ifdef CLIENT_PRIVATE_KEY
+#define CLIENT_PRIVATE_KEY_DATA         ((const char *)CLIENT_PRIVATE_KEY)
+#define CLIENT_PRIVATE_KEY_SIZE         sizeof(CLIENT_PRIVATE_KEY)
+#endif
+#ifdef ROOT_CA_CERTIFICATE
+#define ROOT_CA_CERTIFICATE_DATA        ((const char *)ROOT_CA_CERTIFICATE)
+#define ROOT_CA_CERTIFICATE_SIZE        sizeof(ROOT_CA_CERTIFICATE)
+#endif
+#endif /* MQTT_CREDENTIALS_DER */
+
 /* MQTT client credentials to be used in case of a secure connection. */
 static cy_awsport_ssl_credentials_t credentials =
 {
     /* Configure the client certificate. */
-#ifdef CLIENT_CERTIFICATE
-    .client_cert = (const char *)CLIENT_CERTIFICATE,
-    .client_cert_size = sizeof(CLIENT_CERTIFICATE),
+#ifdef CLIENT_CERTIFICATE_DATA
+    .client_cert = CLIENT_CERTIFICATE_DATA,
+    .client_cert_size = CLIENT_CERTIFICATE_SIZE,
 #else
     .client_cert = NULL,
     .client_cert_size = 0,
 #endif
 
     /* Configure the client private key. */
-#ifdef CLIENT_PRIVATE_KEY
-    .private_key = (const char *)CLIENT_PRIVATE_KEY,
-    .private_key_size = sizeof(CLIENT_PRIVATE_KEY),
+#ifdef CLIENT_PRIVATE_KEY_DATA
+    .private_key = CLIENT_PRIVATE_KEY_DATA,
+    .private_key_size = CLIENT_PRIVATE_KEY_SIZE,
 #else
     .private_key = NULL,
     .private_key_size = 0,
 #endif
 
-    /* Configure the Root CA certificate of the MQTT Broker/Server. */
-#ifdef ROOT_CA_CERTIFICATE
-    .root_ca = (const char *)ROOT_CA_CERTIFICATE,
-    .root_ca_size = sizeof(ROOT_CA_CERTIFICATE),
+    /* Configure the Root CA certificate of the MQTT Broker/Server. When it is
+     * loaded once into the global trust store, it is left out here, so that
+     * the TLS context of a connection does not parse it again.
+     */
+#if defined(ROOT_CA_CERTIFICATE_DATA) && !MQTT_ROOT_CA_LOAD_ONCE
+    .root_ca = ROOT_CA_CERTIFICATE_DATA,
+    .root_ca_size = ROOT_CA_CERTIFICATE_SIZE,
 #else
     .root_ca = NULL,
     .root_ca_size = 0,
@@ -98,9 +138,21 @@ static cy_awsport_ssl_credentials_t credentials =
 /* Pointer to the security details of the MQTT connection. */
 cy_awsport_ssl_credentials_t *security_info = &credentials;
 
+/* Root CA certificate to be loaded once into the global trust store. */
+#if defined(ROOT_CA_CERTIFICATE_DATA) && MQTT_ROOT_CA_LOAD_ONCE
+const char *root_ca_certificate = ROOT_CA_CERTIFICATE_DATA;
+const uint32_t root_ca_certificate_size = ROOT_CA_CERTIFICATE_SIZE;
+#else
+const char *root_ca_certificate = NULL;
+const uint32_t root_ca_certificate_size = 0;
+#endif
+
 #else
 /* Pointer to the security details of the MQTT connection. */
 cy_awsport_ssl_credentials_t *security_info = NULL;
+
+const char *root_ca_certificate = NULL;
+const uint32_t root_ca_certificate_size = 0;
 #endif /* #if (MQTT_SECURE_CONNECTION) */
 
 #if ENABLE_LWT_MESSAGE
@@ -128,7 +180,11 @@ cy_mqtt_connect_info_t connection_info =
     .username_len = 0,
     .password = NULL,
     .password_len = 0,
+#if MQTT_PERSISTENT_SESSION
+    .clean_session = false,
+#else
     .clean_session = true,
+#endif
     .keep_alive_sec = MQTT_KEEP_ALIVE_SECONDS,
 #if ENABLE_LWT_MESSAGE
     .will_info = &will_msg_info
@@ -36,9 +36,14 @@
 #include "task.h"
 
 /* Task header files */
+#include "app_boot.h"
+#include "app_memory.h"
+#include "mem_pool.h"
 #include "mqtt_task.h"
+#include "publish_pool.h"
 #include "publisher_task.h"
 #include "radar_task.h"
+#include "reconnect_backoff.h"
 #include "subscriber_task.h"
 
 /* Configuration file for Wi-Fi and MQTT client */
@@ -51,8 +56,12 @@
 #include "cy_lwip.h"
 
 #include "cy_mqtt_api.h"
+#include "cy_tls.h"
 #include "clock.h"
 
+/* Standard C header files */
+#include <malloc.h>
+
 /* LwIP header files */
 #include "lwip/netif.h"
 
@@ -64,8 +73,10 @@
  */
 #define MQTT_TASK_QUEUE_LENGTH           (3u)
 
-/* Time in milliseconds to wait before creating the publisher task. */
-#define TASK_CREATION_DELAY_MS           (2000u)
+/* Time in milliseconds to wait for the radar task after the MQTT connection
+ * before printing the RAM report.
+ */
+#define RADAR_READY_TIMEOUT_MS           (5000u)
 
 /* Flag Masks for tracking which cleanup functions must be called. */
 #define WCM_INITIALIZED                  (1lu << 0)
@@ -75,6 +86,7 @@
 #define MQTT_INSTANCE_CREATED            (1lu << 4)
 #define MQTT_CONNECTION_SUCCESS          (1lu << 5)
 #define MQTT_MSG_RECEIVED                (1lu << 6)
+#define ROOT_CA_LOADED                   (1lu << 7)
 
 /* Macro to check if the result of an operation was successful and set the
  * corresponding bit in the status_flag based on 'init_mask' parameter. When
@@ -115,6 +127,23 @@ uint32_t status_flag;
  */
 uint8_t *mqtt_network_buffer = NULL;
 
+#if STATIC_ALLOCATION_ENABLE
+static uint8_t mqtt_network_buffer_storage[MQTT_NETWORK_BUFFER_SIZE];
+#endif
+
+/* Buffers of the queue and of the tasks created by the MQTT client task. */
+APP_QUEUE_MEMORY(mqtt_task_q, MQTT_TASK_QUEUE_LENGTH, sizeof(mqtt_task_cmd_t))
+APP_TASK_MEMORY(subscriber_task, SUBSCRIBER_TASK_STACK_SIZE)
+APP_TASK_MEMORY(publisher_task, PUBLISHER_TASK_STACK_SIZE)
+APP_TASK_MEMORY(radar_task, RADAR_TASK_STACK_SIZE)
+
+/* Reconnection delays and connection attempt metrics of both links. */
+static reconnect_backoff_t wifi_backoff;
+static reconnect_backoff_t mqtt_backoff;
+
+/* Duration and heap cost of the MQTT connection setup. */
+static mqtt_handshake_stats_t handshake_stats;
+
 /******************************************************************************
 * Function Prototypes
 *******************************************************************************/
@@ -123,6 +152,10 @@ static cy_rslt_t mqtt_init(void);
 static cy_rslt_t mqtt_connect(void);
 void mqtt_event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, void *user_data);
 static void cleanup(void);
+static void backoff_init(void);
+static void spread_mqtt_reconnect(void);
+static void print_connection_stats(const char *link, const reconnect_backoff_t *backoff);
+static void record_handshake(uint32_t start_ms);
 
 #if GENERATE_UNIQUE_CLIENT_ID
 static cy_rslt_t mqtt_get_unique_client_identifier(char *mqtt_client_identifier);
@@ -133,7 +166,8 @@ static cy_rslt_t mqtt_get_unique_client_identifier(char *mqtt_client_identifier)
  ******************************************************************************
  * Summary:
  *  Task for handling initialization & connection of Wi-Fi and the MQTT client.
- *  The task also creates and manages the subscriber and publisher tasks upon
+ *  The task first creates the publisher and radar tasks, so the sensor starts
+ *  while the network comes up, and creates the subscriber task upon
  *  successful MQTT connection. The task also handles the WiFi and MQTT
  *  connections by initiating reconnection on the event of disconnections.
  *
@@ -160,7 +194,30 @@ void mqtt_client_task(void *pvParameters)
     (void) pvParameters;
 
     /* Create a message queue to communicate with other tasks and callbacks. */
-    mqtt_task_q = xQueueCreate(MQTT_TASK_QUEUE_LENGTH, sizeof(mqtt_task_cmd_t));
+    mqtt_task_q = app_queue_create("MQTT", "MQTT task queue", MQTT_TASK_QUEUE_LENGTH, sizeof(mqtt_task_cmd_t),
+                                   APP_QUEUE_STORAGE(mqtt_task_q), APP_QUEUE_QCB(mqtt_task_q));
+
+    /* Create the publisher task and cleanup if the operation fails. It keeps
+     * radar events in the outbox until the MQTT connection is up.
+     */
+    if (pdPASS != app_task_create("Publisher", publisher_task, "Publisher task", PUBLISHER_TASK_STACK_SIZE,
+                                  NULL, PUBLISHER_TASK_PRIORITY, &publisher_task_handle,
+                                  APP_TASK_STACK(publisher_task), APP_TASK_TCB(publisher_task)))
+    {
+        printf("Failed to create Publisher task!\n");
+        goto exit_cleanup;
+    }
+
+    /* Initializes context object of Radar Sensing library, sets default */
+    /* parameters values for sensor and continuously acquire data from sensor. */
+    /* The sensor is brought up while the Wi-Fi and MQTT connections are made. */
+    if (pdPASS != app_task_create("Radar", radar_task, RADAR_TASK_NAME, RADAR_TASK_STACK_SIZE,
+                                  NULL, RADAR_TASK_PRIORITY, &radar_task_handle,
+                                  APP_TASK_STACK(radar_task), APP_TASK_TCB(radar_task)))
+    {
+        printf("Failed to create '%s' task!\n", RADAR_TASK_NAME);
+        goto exit_cleanup;
+    }
 
     /* Initialize the Wi-Fi Connection Manager and jump to the cleanup block
      * upon failure.
@@ -177,11 +234,24 @@ void mqtt_client_task(void *pvParameters)
     status_flag |= WCM_INITIALIZED;
     printf("\nWi-Fi Connection Manager initialized.\n");
 
+    /* Seed the reconnection delays differently on every device. */
+    backoff_init();
+
     /* Initiate connection to the Wi-Fi AP and cleanup if the operation fails. */
     if (CY_RSLT_SUCCESS != wifi_connect())
     {
         goto exit_cleanup;
     }
+    app_boot_signal(APP_BOOT_WIFI_CONNECTED);
+
+    /* Register the topic filters and create the receive queues before the
+     * connection, the broker may deliver messages of a persistent session
+     * right away.
+     */
+    if (!subscriber_init())
+    {
+        goto exit_cleanup;
+    }
 
     /* Set-up the MQTT client and connect to the MQTT broker. Jump to the
      * cleanup block if any of the operations fail.
@@ -190,34 +260,29 @@ void mqtt_client_task(void *pvParameters)
     {
         goto exit_cleanup;
     }
+    app_boot_signal(APP_BOOT_MQTT_CONNECTED);
 
     /* Create the subscriber task and cleanup if the operation fails. */
-    if (pdPASS != xTaskCreate(subscriber_task, "Subscriber task", SUBSCRIBER_TASK_STACK_SIZE,
-                              NULL, SUBSCRIBER_TASK_PRIORITY, &subscriber_task_handle))
+    if (pdPASS != app_task_create("Subscriber", subscriber_task, "Subscriber task", SUBSCRIBER_TASK_STACK_SIZE,
+                                  NULL, SUBSCRIBER_TASK_PRIORITY, &subscriber_task_handle,
+                                  APP_TASK_STACK(subscriber_task), APP_TASK_TCB(subscriber_task)))
     {
         printf("Failed to create the Subscriber task!\n");
         goto exit_cleanup;
     }
 
-    /* Wait for the subscribe operation to complete. */
-    vTaskDelay(pdMS_TO_TICKS(TASK_CREATION_DELAY_MS));
-
-    /* Create the publisher task and cleanup if the operation fails. */
-    if (pdPASS != xTaskCreate(publisher_task, "Publisher task", PUBLISHER_TASK_STACK_SIZE,
-                              NULL, PUBLISHER_TASK_PRIORITY, &publisher_task_handle))
-    {
-        printf("Failed to create Publisher task!\n");
-        goto exit_cleanup;
-    }
+    /* Start publishing, the outbox holds the events detected so far. The
+     * subscription is made concurrently by the subscriber task.
+     */
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_PUBLISHER_READY), portMAX_DELAY);
+    publisher_q_data.cmd = PUBLISHER_INIT;
+    xQueueSend(publisher_task_q, &publisher_q_data, portMAX_DELAY);
 
-    /* Initializes context object of Radar Sensing library, sets default */
-    /* parameters values for sensor and continuously acquire data from sensor. */
-    if (pdPASS != xTaskCreate(radar_task, RADAR_TASK_NAME, RADAR_TASK_STACK_SIZE,
-                              NULL, RADAR_TASK_PRIORITY, &radar_task_handle))
-    {
-        printf("Failed to create '%s' task!\n", RADAR_TASK_NAME);
-        goto exit_cleanup;
-    }
+    /* Print the RAM use once the radar task has created its tasks as well.
+     * Without a radar wing board it never does, report after a timeout.
+     */
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_RADAR_READY), pdMS_TO_TICKS(RADAR_READY_TIMEOUT_MS));
+    app_memory_report();
 
     while (true)
     {
@@ -259,7 +324,9 @@ void mqtt_client_task(void *pvParameters)
                     cy_mqtt_disconnect(mqtt_connection);
 
                     /* Check if Wi-Fi connection is active. If not, update the
-                     * status flag and initiate Wi-Fi reconnection.
+                     * status flag and initiate Wi-Fi reconnection. Otherwise
+                     * only the broker connection was lost, and MQTT is
+                     * reconnected right away.
                      */
                     if (cy_wcm_is_connected_to_ap() == 0)
                     {
@@ -269,6 +336,7 @@ void mqtt_client_task(void *pvParameters)
                         {
                             goto exit_cleanup;
                         }
+                        spread_mqtt_reconnect();
                     }
 
                     printf("Initiating MQTT Reconnection...\n");
@@ -277,7 +345,10 @@ void mqtt_client_task(void *pvParameters)
                         goto exit_cleanup;
                     }
 
-                    /* Initiate MQTT subscribe post the reconnection. */
+                    /* Initiate MQTT subscribe post the reconnection. Even
+                     * with a persistent session, as the broker may have
+                     * expired or lost it; subscribing again is harmless.
+                     */
                     subscriber_q_data.cmd = SUBSCRIBE_TO_TOPIC;
                     xQueueSend(subscriber_task_q, &subscriber_q_data, portMAX_DELAY);
 
@@ -306,6 +377,9 @@ void mqtt_client_task(void *pvParameters)
     {
         vTaskDelete(publisher_task_handle);
     }
+    /* Workers may still wait for a PUBACK, join them before the MQTT handle
+     * is deleted. */
+    publish_pool_stop();
     if (radar_task_handle != NULL)
     {
         radar_task_cleanup();
@@ -322,8 +396,8 @@ void mqtt_client_task(void *pvParameters)
  * Summary:
  *  Function that initiates connection to the Wi-Fi Access Point using the
  *  specified SSID and PASSWORD. The connection is retried a maximum of
- *  'MAX_WIFI_CONN_RETRIES' times with interval of 'WIFI_CONN_RETRY_INTERVAL_MS'
- *  milliseconds.
+ *  'MAX_WIFI_CONN_RETRIES' times with a randomized, exponentially growing
+ *  interval starting at 'WIFI_CONN_RETRY_INTERVAL_MS' milliseconds.
  *
  * Parameters:
  *  void
@@ -353,11 +427,16 @@ static cy_rslt_t wifi_connect(void)
         /* Connect to the Wi-Fi AP. */
         for (uint32_t retry_count = 0; retry_count < MAX_WIFI_CONN_RETRIES; retry_count++)
         {
+            uint32_t delay_ms;
+
+            reconnect_backoff_attempt(&wifi_backoff);
             result = cy_wcm_connect_ap(&connect_param, &ip_address);
 
             if (result == CY_RSLT_SUCCESS)
             {
                 printf("\nSuccessfully connected to Wi-Fi network '%s'.\n", connect_param.ap_credentials.SSID);
+                reconnect_backoff_success(&wifi_backoff);
+                print_connection_stats("Wi-Fi", &wifi_backoff);
 
                 /* Set the appropriate bit in the status_flag to denote
                  * successful Wi-Fi connection, print the assigned IP address.
@@ -374,14 +453,14 @@ static cy_rslt_t wifi_connect(void)
                 return result;
             }
 
-            printf("Connection to Wi-Fi network failed with error code 0x%0X. Retrying in %d ms. Retries left: %d\n",
-                (int)result, WIFI_CONN_RETRY_INTERVAL_MS, (int)(MAX_WIFI_CONN_RETRIES - retry_count - 1));
-            vTaskDelay(pdMS_TO_TICKS(WIFI_CONN_RETRY_INTERVAL_MS));
+            delay_ms = reconnect_backoff_failure(&wifi_backoff);
+            printf("Connection to Wi-Fi network failed with error code 0x%0X. Retrying in %lu ms. Retries left: %d\n",
+                (int)result, (unsigned long)delay_ms, (int)(MAX_WIFI_CONN_RETRIES - retry_count - 1));
+            vTaskDelay(pdMS_TO_TICKS(delay_ms));
         }
 
         printf("\nExceeded maximum Wi-Fi connection attempts!\n");
-        printf("Wi-Fi connection failed after retrying for %d mins\n\n",
-            (int)(WIFI_CONN_RETRY_INTERVAL_MS * MAX_WIFI_CONN_RETRIES) / 60000u);
+        print_connection_stats("Wi-Fi", &wifi_backoff);
     }
     return result;
 }
@@ -411,13 +490,25 @@ static cy_rslt_t mqtt_init(void)
     result = cy_mqtt_init();
     CHECK_RESULT(result, LIBS_INITIALIZED, "MQTT library initialization failed!\n\n");
 
+    /* Parse the Root CA certificate once, instead of on every TLS handshake. */
+    if (root_ca_certificate != NULL)
+    {
+        result = cy_tls_load_global_root_ca_certificates(root_ca_certificate, root_ca_certificate_size);
+        CHECK_RESULT(result, ROOT_CA_LOADED, "Loading the Root CA certificate failed!\n\n");
+    }
+
     /* Allocate buffer for MQTT send and receive operations. */
+#if STATIC_ALLOCATION_ENABLE
+    mqtt_network_buffer = mqtt_network_buffer_storage;
+#else
     mqtt_network_buffer = (uint8_t *) pvPortMalloc(sizeof(uint8_t) * MQTT_NETWORK_BUFFER_SIZE);
+#endif
     if(mqtt_network_buffer == NULL)
     {
         result = ~CY_RSLT_SUCCESS;
     }
     CHECK_RESULT(result, BUFFER_INITIALIZED, "Network Buffer allocation failed!\n\n");
+    app_memory_add("MQTT", "Network buffer", MQTT_NETWORK_BUFFER_SIZE, STATIC_ALLOCATION_ENABLE);
 
     /* Create the MQTT client instance. */
     result = cy_mqtt_create(mqtt_network_buffer, MQTT_NETWORK_BUFFER_SIZE,
@@ -435,8 +526,8 @@ static cy_rslt_t mqtt_init(void)
  ******************************************************************************
  * Summary:
  *  Function that initiates MQTT connect operation. The connection is retried
- *  a maximum of 'MAX_MQTT_CONN_RETRIES' times with interval of
- *  'MQTT_CONN_RETRY_INTERVAL_MS' milliseconds.
+ *  a maximum of 'MAX_MQTT_CONN_RETRIES' times with a randomized, exponentially
+ *  growing interval starting at 'MQTT_CONN_RETRY_INTERVAL_MS' milliseconds.
  *
  * Parameters:
  *  void
@@ -451,8 +542,10 @@ static cy_rslt_t mqtt_connect(void)
     /* Variable to indicate status of various operations. */
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
-    /* MQTT client identifier string. */
-    char mqtt_client_identifier[(MQTT_CLIENT_IDENTIFIER_MAX_LEN + 1)] = MQTT_CLIENT_IDENTIFIER;
+    /* MQTT client identifier string. It must outlive the connection, since a
+     * persistent session is bound to it.
+     */
+    static char mqtt_client_identifier[(MQTT_CLIENT_IDENTIFIER_MAX_LEN + 1)] = MQTT_CLIENT_IDENTIFIER;
 
     /* Configure the user credentials as a part of MQTT Connect packet */
     if (strlen(MQTT_USERNAME) > 0)
@@ -483,6 +576,9 @@ static cy_rslt_t mqtt_connect(void)
 
     for (uint32_t retry_count = 0; retry_count < MAX_MQTT_CONN_RETRIES; retry_count++)
     {
+        uint32_t delay_ms;
+        uint32_t start_ms;
+
         if (cy_wcm_is_connected_to_ap() == 0)
         {
             printf("Unexpectedly disconnected from Wi-Fi network! Initiating Wi-Fi reconnection...\n");
@@ -494,14 +590,20 @@ static cy_rslt_t mqtt_connect(void)
             {
                 return result;
             }
+            spread_mqtt_reconnect();
         }
 
         /* Establish the MQTT connection. */
+        reconnect_backoff_attempt(&mqtt_backoff);
+        start_ms = (uint32_t)Clock_GetTimeMs();
         result = cy_mqtt_connect(mqtt_connection, &connection_info);
 
         if (result == CY_RSLT_SUCCESS)
         {
             printf("\nMQTT connection successful.\n\n");
+            record_handshake(start_ms);
+            reconnect_backoff_success(&mqtt_backoff);
+            print_connection_stats("MQTT", &mqtt_backoff);
 
             /* Set the appropriate bit in the status_flag to denote successful
              * MQTT connection, and return the result to the calling function.
@@ -510,14 +612,14 @@ static cy_rslt_t mqtt_connect(void)
             return result;
         }
 
-        printf("MQTT connection failed with error code 0x%0X. Retrying in %d ms. Retries left: %d\n",
-               (int)result, MQTT_CONN_RETRY_INTERVAL_MS, (int)(MAX_MQTT_CONN_RETRIES - retry_count - 1));
-        vTaskDelay(pdMS_TO_TICKS(MQTT_CONN_RETRY_INTERVAL_MS));
+        delay_ms = reconnect_backoff_failure(&mqtt_backoff);
+        printf("MQTT connection failed with error code 0x%0X. Retrying in %lu ms. Retries left: %d\n",
+               (int)result, (unsigned long)delay_ms, (int)(MAX_MQTT_CONN_RETRIES - retry_count - 1));
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
 
     printf("\nExceeded maximum MQTT connection attempts\n");
-    printf("MQTT connection failed after retrying for %d mins\n\n",
-           (int)(MQTT_CONN_RETRY_INTERVAL_MS * MAX_MQTT_CONN_RETRIES) / 60000u);
+    print_connection_stats("MQTT", &mqtt_backoff);
     return result;
 }
 
@@ -597,7 +699,12 @@ void mqtt_event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, void *use
  ******************************************************************************
  * Summary:
  *  Function that generates unique client identifier for the MQTT client by
- *  appending a timestamp to a common prefix 'MQTT_CLIENT_IDENTIFIER'.
+ *  appending a timestamp to a common prefix 'MQTT_CLIENT_IDENTIFIER'. With
+ *  'MQTT_PERSISTENT_SESSION', a hash of the whole 64-bit silicon unique ID is
+ *  appended instead, which stays the same across reconnections and reboots.
+ *  The low bytes of the ID are the lot number shared by all dies of a lot,
+ *  the wafer and die position bits make it unique, so all bits are mixed into
+ *  the base 36 digits that fit within 'MQTT_CLIENT_IDENTIFIER_MAX_LEN'.
  *
  * Parameters:
  *  char *mqtt_client_identifier : Pointer to the string that stores the
@@ -612,6 +719,44 @@ static cy_rslt_t mqtt_get_unique_client_identifier(char *mqtt_client_identifier)
 {
     cy_rslt_t status = CY_RSLT_SUCCESS;
 
+#if MQTT_PERSISTENT_SESSION
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    size_t prefix_len = strlen(MQTT_CLIENT_IDENTIFIER);
+    /* 13 base 36 digits hold 64 bits */
+    size_t digit_count = (prefix_len < MQTT_CLIENT_IDENTIFIER_MAX_LEN) ?
+                         (MQTT_CLIENT_IDENTIFIER_MAX_LEN - prefix_len) : 0u;
+    uint64_t hash = Cy_SysLib_GetUniqueId();
+
+    /* splitmix64 finalizer: a bijection in which every bit of the ID affects
+     * every digit taken from the result.
+     */
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+
+    if (digit_count > 13u)
+    {
+        digit_count = 13u;
+    }
+
+    /* A prefix leaving no room for the hash would collide across devices. */
+    if (digit_count == 0u)
+    {
+        status = ~CY_RSLT_SUCCESS;
+    }
+    else
+    {
+        memcpy(mqtt_client_identifier, MQTT_CLIENT_IDENTIFIER, prefix_len);
+        for (size_t i = 0; i < digit_count; i++)
+        {
+            mqtt_client_identifier[prefix_len + i] = digits[hash % 36u];
+            hash /= 36u;
+        }
+        mqtt_client_identifier[prefix_len + digit_count] = '\0';
+    }
+#else
     /* Check for errors from snprintf. */
     if (0 > snprintf(mqtt_client_identifier,
                      (MQTT_CLIENT_IDENTIFIER_MAX_LEN + 1),
@@ -620,6 +765,7 @@ static cy_rslt_t mqtt_get_unique_client_identifier(char *mqtt_client_identifier)
     {
         status = ~CY_RSLT_SUCCESS;
     }
+#endif
 
     return status;
 }
@@ -647,15 +793,26 @@ static void cleanup(void)
         printf("Disconnecting from the MQTT Broker...\n");
         cy_mqtt_disconnect(mqtt_connection);
     }
-    /* Delete the MQTT instance if it was created. */
+    /* Delete the MQTT instance if it was created, then the TLS session and
+     * client identity it kept across reconnections.
+     */
     if (status_flag & MQTT_INSTANCE_CREATED)
     {
         cy_mqtt_delete(mqtt_connection);
     }
+    tls_cache_release();
     /* Deallocate the network buffer. */
     if (status_flag & BUFFER_INITIALIZED)
     {
+#if !STATIC_ALLOCATION_ENABLE
         vPortFree((void *) mqtt_network_buffer);
+#endif
+        mqtt_network_buffer = NULL;
+    }
+    /* Release the Root CA certificate from the global trust store. */
+    if (status_flag & ROOT_CA_LOADED)
+    {
+        cy_tls_release_global_root_ca_certificates();
     }
     /* Deinit the MQTT library. */
     if (status_flag & LIBS_INITIALIZED)
@@ -677,4 +834,204 @@ static void cleanup(void)
     }
 }
 
+/******************************************************************************
+ * Function Name: backoff_init
+ ******************************************************************************
+ * Summary:
+ *  Function that initializes the Wi-Fi and MQTT reconnection delays. The
+ *  random generators are seeded from the TRNG so that devices which lose the
+ *  same access point spread out their reconnection attempts. If the TRNG is
+ *  not available, the uptime is used as seed instead.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void backoff_init(void)
+{
+    cyhal_trng_t trng_obj;
+    uint32_t seed = (uint32_t)Clock_GetTimeMs();
+
+    if (cyhal_trng_init(&trng_obj) == CY_RSLT_SUCCESS)
+    {
+        seed = cyhal_trng_generate(&trng_obj);
+        cyhal_trng_free(&trng_obj);
+    }
+
+    reconnect_backoff_init(&wifi_backoff, WIFI_CONN_RETRY_INTERVAL_MS, WIFI_CONN_RETRY_MAX_INTERVAL_MS, seed);
+    reconnect_backoff_init(&mqtt_backoff, MQTT_CONN_RETRY_INTERVAL_MS, MQTT_CONN_RETRY_MAX_INTERVAL_MS, ~seed);
+}
+
+/******************************************************************************
+ * Function Name: spread_mqtt_reconnect
+ ******************************************************************************
+ * Summary:
+ *  Function that waits for a random time of up to 'MQTT_RECONNECT_JITTER_MS'
+ *  milliseconds after a Wi-Fi reconnection, before the MQTT connection is
+ *  attempted.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void spread_mqtt_reconnect(void)
+{
+    uint32_t delay_ms = reconnect_backoff_jitter(&mqtt_backoff, MQTT_RECONNECT_JITTER_MS);
+
+    printf("Connecting to the MQTT broker in %lu ms...\n", (unsigned long)delay_ms);
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+}
+
+/******************************************************************************
+ * Function Name: print_connection_stats
+ ******************************************************************************
+ * Summary:
+ *  Function that prints the connection attempt metrics of a link.
+ *
+ * Parameters:
+ *  link    : Name of the link
+ *  backoff : Reconnection state of the link
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void print_connection_stats(const char *link, const reconnect_backoff_t *backoff)
+{
+    printf("%s connection attempts: %lu, successes: %lu, failures: %lu, longest failure run: %lu, total wait: %lu ms\n",
+           link,
+           (unsigned long)backoff->stats.attempts,
+           (unsigned long)backoff->stats.successes,
+           (unsigned long)backoff->stats.failures,
+           (unsigned long)backoff->stats.max_failure_run,
+           (unsigned long)backoff->stats.total_delay_ms);
+}
+
+/******************************************************************************
+ * Function Name: mqtt_task_get_connection_stats
+ ******************************************************************************
+ * Summary:
+ *  Function that returns the Wi-Fi and MQTT connection attempt metrics.
+ *
+ * Parameters:
+ *  wifi_stats : Wi-Fi connection metrics, can be NULL
+ *  mqtt_stats : MQTT connection metrics, can be NULL
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void mqtt_task_get_connection_stats(reconnect_backoff_stats_t *wifi_stats, reconnect_backoff_stats_t *mqtt_stats)
+{
+    taskENTER_CRITICAL();
+    if (wifi_stats != NULL)
+    {
+        *wifi_stats = wifi_backoff.stats;
+    }
+    if (mqtt_stats != NULL)
+    {
+        *mqtt_stats = mqtt_backoff.stats;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/******************************************************************************
+ * Function Name: record_handshake
+ ******************************************************************************
+ * Summary:
+ *  Function that records the duration and heap cost of a successful MQTT
+ *  connection setup. With heap_3, every allocation of the TLS stack goes
+ *  through the C library heap. Its statistics give the bytes in use and the
+ *  size of the heap obtained from the system, which bounds but is not the
+ *  peak usage. With MEM_POOL_ENABLE, the TLS stack allocates from the memory
+ *  pools, whose in-use bytes are added and whose high-water mark is recorded.
+ *
+ * Parameters:
+ *  start_ms : Time at which cy_mqtt_connect() was called
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void record_handshake(uint32_t start_ms)
+{
+    uint32_t elapsed_ms = (uint32_t)Clock_GetTimeMs() - start_ms;
+    struct mallinfo heap = mallinfo();
+    uint32_t pool_peak = 0;
+    tls_cache_stats_t tls;
+#if MEM_POOL_ENABLE
+    mem_pool_stats_t pool;
+
+    mem_pool_get_stats(&pool);
+    heap.uordblks += pool.bytes_in_use;
+    pool_peak = pool.bytes_peak;
+#endif
+    tls_cache_get_stats(&tls);
+
+    taskENTER_CRITICAL();
+    handshake_stats.connects++;
+    handshake_stats.last_ms = elapsed_ms;
+    if ((handshake_stats.connects == 1) || (elapsed_ms < handshake_stats.min_ms))
+    {
+        handshake_stats.min_ms = elapsed_ms;
+    }
+    if (elapsed_ms > handshake_stats.max_ms)
+    {
+        handshake_stats.max_ms = elapsed_ms;
+    }
+    handshake_stats.total_ms += elapsed_ms;
+    handshake_stats.heap_in_use = (uint32_t)heap.uordblks;
+    handshake_stats.heap_size = (uint32_t)heap.arena;
+    handshake_stats.pool_peak = pool_peak;
+    handshake_stats.tls = tls;
+    taskEXIT_CRITICAL();
+
+    printf("MQTT connection setup took %lu ms (min %lu, max %lu, avg %lu over %lu connects), heap in use %lu of %lu bytes\n",
+           (unsigned long)elapsed_ms,
+           (unsigned long)handshake_stats.min_ms,
+           (unsigned long)handshake_stats.max_ms,
+           (unsigned long)(handshake_stats.total_ms / handshake_stats.connects),
+           (unsigned long)handshake_stats.connects,
+           (unsigned long)handshake_stats.heap_in_use,
+           (unsigned long)handshake_stats.heap_size);
+    printf("TLS: %lu handshakes, %lu resumed of %lu offered sessions, client identity parsed %lu times, reused %lu times\n",
+           (unsigned long)tls.handshakes,
+           (unsigned long)tls.resumed,
+           (unsigned long)tls.offered,
+           (unsigned long)tls.identity_parses,
+           (unsigned long)tls.identity_reuses);
+#if MEM_POOL_ENABLE
+    printf("Memory pools: %lu bytes in use, peak %lu bytes\n",
+           (unsigned long)pool.bytes_in_use, (unsigned long)pool_peak);
+    mem_pool_report();
+#endif
+}
+
+/******************************************************************************
+ * Function Name: mqtt_task_get_handshake_stats
+ ******************************************************************************
+ * Summary:
+ *  Function that returns the duration and heap cost of the MQTT connection
+ *  setups so far.
+ *
+ * Parameters:
+ *  stats : Filled with the connection setup metrics
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void mqtt_task_get_handshake_stats(mqtt_handshake_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = handshake_stats;
+    taskEXIT_CRITICAL();
+}
+
 /* [] END OF FILE */
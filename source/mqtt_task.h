@@ -29,6 +29,8 @@
 #include "FreeRTOS.h"
 #include "queue.h"
 #include "cy_mqtt_api.h"
+#include "reconnect_backoff.h"
+#include "tls_cache.h"
 
 
 /*******************************************************************************
@@ -49,6 +51,22 @@ typedef enum
     HANDLE_DISCONNECTION
 } mqtt_task_cmd_t;
 
+/* Cost of the MQTT connection setup, including the TCP connect, the TLS
+ * handshake and the CONNECT/CONNACK exchange.
+ */
+typedef struct
+{
+    uint32_t connects;          /* Successful connections */
+    uint32_t last_ms;
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint32_t total_ms;
+    uint32_t heap_in_use;       /* Heap allocated after the last connection, in bytes */
+    uint32_t heap_size;         /* Heap obtained from the system after the last connection, in bytes */
+    uint32_t pool_peak;         /* High-water mark of the memory pools, in bytes, MEM_POOL_ENABLE only */
+    tls_cache_stats_t tls;      /* Reuse of the TLS session and client identity */
+} mqtt_handshake_stats_t;
+
 /*******************************************************************************
  * Extern variables
  ******************************************************************************/
@@ -59,5 +77,7 @@ extern QueueHandle_t mqtt_task_q;
 * Function Prototypes
 *******************************************************************************/
 void mqtt_client_task(void *pvParameters);
+void mqtt_task_get_connection_stats(reconnect_backoff_stats_t *wifi_stats, reconnect_backoff_stats_t *mqtt_stats);
+void mqtt_task_get_handshake_stats(mqtt_handshake_stats_t *stats);
 
 /* [] END OF FILE */
@@ -0,0 +1,384 @@
+/******************************************************************************
+ * File Name:   publish_pool.c
+ *
+ * Description: This file implements a pool of publish workers that keeps up
+ *              to 'MQTT_PUB_INFLIGHT_WINDOW' QoS 1 publishes in flight.
+ *              cy_mqtt_publish() blocks until the PUBACK, so every worker
+ *              task waits for one acknowledgment while the owner task goes
+ *              on encoding the next payloads. Finished jobs are handed back
+ *              to the owner in completion order.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+#include "app_memory.h"
+#include "core_mqtt_config.h"
+#include "mqtt_task.h"
+#include "publish_pool.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The subscription and the synchronous diagnostics publishes need their own
+ * entries in the state array of the MQTT library. */
+#if ((MQTT_PUB_INFLIGHT_WINDOW < 1) || (MQTT_PUB_INFLIGHT_WINDOW > (MQTT_STATE_ARRAY_MAX_COUNT - 2)))
+#error "MQTT_PUB_INFLIGHT_WINDOW must be between 1 and MQTT_STATE_ARRAY_MAX_COUNT - 2."
+#endif
+
+/* cy_mqtt_publish() fails a QoS 1 publish once 'CY_MQTT_MAX_OUTGOING_PUBLISHES'
+ * are waiting for their PUBACK: one per worker plus the status publishes of
+ * the publisher task. */
+#if ((MQTT_PUB_INFLIGHT_WINDOW + 1) > CY_MQTT_MAX_OUTGOING_PUBLISHES)
+#error "MQTT_PUB_INFLIGHT_WINDOW must not exceed CY_MQTT_MAX_OUTGOING_PUBLISHES - 1, see the Makefile."
+#endif
+
+/* Current tick time in ms */
+#define PUBLISH_POOL_NOW_MS() ((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS))
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static publish_job_t pool_jobs[MQTT_PUB_INFLIGHT_WINDOW];
+
+/* Queues of job pointers: free slots, jobs waiting for a worker, and finished
+ * jobs waiting for the owner. Each can hold every job, sends never block. */
+static QueueHandle_t free_q;
+static QueueHandle_t job_q;
+static QueueHandle_t done_q;
+
+static publish_pool_done_cb_t done_callback;
+
+/* Set by publish_pool_stop(): queued jobs are failed without publishing and
+ * every worker acknowledges its NULL job to the stopping task. */
+static volatile bool pool_stopping;
+static TaskHandle_t stopping_task;
+
+/* Buffers of the queues and of the worker tasks */
+APP_QUEUE_MEMORY(free_q, MQTT_PUB_INFLIGHT_WINDOW, sizeof(publish_job_t *))
+APP_QUEUE_MEMORY(job_q, MQTT_PUB_INFLIGHT_WINDOW, sizeof(publish_job_t *))
+APP_QUEUE_MEMORY(done_q, MQTT_PUB_INFLIGHT_WINDOW, sizeof(publish_job_t *))
+#if STATIC_ALLOCATION_ENABLE
+static StackType_t worker_stacks[MQTT_PUB_INFLIGHT_WINDOW][PUBLISH_POOL_TASK_STACK_SIZE];
+static StaticTask_t worker_tcbs[MQTT_PUB_INFLIGHT_WINDOW];
+#define WORKER_STACK(i) (worker_stacks[(i)])
+#define WORKER_TCB(i)   (&worker_tcbs[(i)])
+#else
+#define WORKER_STACK(i) (NULL)
+#define WORKER_TCB(i)   (NULL)
+#endif
+
+static publish_pool_stats_t pool_stats;
+
+/*******************************************************************************
+ * Function Name: publish_pool_task
+ *******************************************************************************
+ * Summary:
+ *   Worker that publishes one job at a time and retries it until it is
+ *   acknowledged, the retry limit is reached or the job timed out. A NULL job
+ *   makes the worker exit.
+ *
+ * Parameters:
+ *   pvParameters: unused
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void publish_pool_task(void *pvParameters)
+{
+    publish_job_t *job;
+    cy_mqtt_publish_info_t info;
+
+    (void)pvParameters;
+
+    for (;;)
+    {
+        xQueueReceive(job_q, &job, portMAX_DELAY);
+        if (job == NULL)
+        {
+            xTaskNotifyGive(stopping_task);
+            vTaskDelete(NULL);
+        }
+
+        info.qos = (cy_mqtt_qos_t)MQTT_MESSAGES_QOS;
+        info.topic = job->topic;
+        info.topic_len = strlen(job->topic);
+        info.payload = (const char *)job->payload;
+        info.payload_len = job->payload_len;
+        info.retain = false;
+        info.dup = false;
+
+        job->attempts = 0;
+        job->start_ms = PUBLISH_POOL_NOW_MS();
+
+        while (!pool_stopping)
+        {
+            job->attempts++;
+            job->result = cy_mqtt_publish(mqtt_connection, &info);
+            if ((job->result == CY_RSLT_SUCCESS) || (job->attempts > PUBLISH_POOL_RETRY_LIMIT))
+            {
+                break;
+            }
+            if ((PUBLISH_POOL_NOW_MS() - job->start_ms) >= PUBLISH_POOL_TIMEOUT_MS)
+            {
+                taskENTER_CRITICAL();
+                pool_stats.timeouts++;
+                taskEXIT_CRITICAL();
+                break;
+            }
+
+            taskENTER_CRITICAL();
+            pool_stats.retries++;
+            taskEXIT_CRITICAL();
+
+            /* The library gives every attempt a new packet identifier, so it
+             * is a new PUBLISH and not a redelivery: the DUP flag stays clear. */
+            vTaskDelay(pdMS_TO_TICKS(PUBLISH_POOL_RETRY_MS));
+        }
+
+        if (job->attempts == 0)
+        {
+            job->result = CY_RSLT_MODULE_MQTT_NOT_CONNECTED;
+        }
+        job->end_ms = PUBLISH_POOL_NOW_MS();
+
+        taskENTER_CRITICAL();
+        pool_stats.inflight--;
+        if (job->result == CY_RSLT_SUCCESS)
+        {
+            pool_stats.acknowledged++;
+        }
+        else
+        {
+            pool_stats.failed++;
+        }
+        taskEXIT_CRITICAL();
+
+        xQueueSend(done_q, &job, portMAX_DELAY);
+        done_callback();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_init
+ *******************************************************************************
+ * Summary:
+ *   Creates the queues and one worker task per message in flight.
+ *
+ * Parameters:
+ *   done: called by a worker whenever a job finished, must not block
+ *
+ * Return:
+ *   true on success
+ ******************************************************************************/
+bool publish_pool_init(publish_pool_done_cb_t done)
+{
+    publish_job_t *job;
+
+    done_callback = done;
+    pool_stopping = false;
+
+    free_q = app_queue_create("Publisher", "Publish free queue", MQTT_PUB_INFLIGHT_WINDOW, sizeof(publish_job_t *),
+                              APP_QUEUE_STORAGE(free_q), APP_QUEUE_QCB(free_q));
+    job_q = app_queue_create("Publisher", "Publish job queue", MQTT_PUB_INFLIGHT_WINDOW, sizeof(publish_job_t *),
+                             APP_QUEUE_STORAGE(job_q), APP_QUEUE_QCB(job_q));
+    done_q = app_queue_create("Publisher", "Publish done queue", MQTT_PUB_INFLIGHT_WINDOW, sizeof(publish_job_t *),
+                              APP_QUEUE_STORAGE(done_q), APP_QUEUE_QCB(done_q));
+    if ((free_q == NULL) || (job_q == NULL) || (done_q == NULL))
+    {
+        return false;
+    }
+    app_memory_add("Publisher", "Publish jobs", sizeof(pool_jobs), true);
+
+    for (uint32_t i = 0; i < MQTT_PUB_INFLIGHT_WINDOW; i++)
+    {
+        job = &pool_jobs[i];
+        job->index = i;
+        xQueueSend(free_q, &job, 0);
+
+        if (pdPASS != app_task_create("Publisher", publish_pool_task, PUBLISH_POOL_TASK_NAME,
+                                      PUBLISH_POOL_TASK_STACK_SIZE, NULL, PUBLISH_POOL_TASK_PRIORITY, NULL,
+                                      WORKER_STACK(i), WORKER_TCB(i)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_acquire
+ *******************************************************************************
+ * Summary:
+ *   Takes a free job slot without blocking.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   job to fill and submit, NULL if 'MQTT_PUB_INFLIGHT_WINDOW' jobs are in
+ *   flight or not yet collected
+ ******************************************************************************/
+publish_job_t *publish_pool_acquire(void)
+{
+    publish_job_t *job = NULL;
+
+    if (pdTRUE != xQueueReceive(free_q, &job, 0))
+    {
+        return NULL;
+    }
+
+    return job;
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_submit
+ *******************************************************************************
+ * Summary:
+ *   Hands a filled job to the workers.
+ *
+ * Parameters:
+ *   job: job returned by publish_pool_acquire()
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void publish_pool_submit(publish_job_t *job)
+{
+    taskENTER_CRITICAL();
+    pool_stats.submitted++;
+    pool_stats.inflight++;
+    if (pool_stats.inflight > pool_stats.inflight_high_water)
+    {
+        pool_stats.inflight_high_water = pool_stats.inflight;
+    }
+    taskEXIT_CRITICAL();
+
+    xQueueSend(job_q, &job, portMAX_DELAY);
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_collect
+ *******************************************************************************
+ * Summary:
+ *   Returns the next finished job. The owner evaluates the result and then
+ *   gives the slot back with publish_pool_release().
+ *
+ * Parameters:
+ *   wait: ticks to wait for a job to finish
+ *
+ * Return:
+ *   finished job, NULL if none finished in time
+ ******************************************************************************/
+publish_job_t *publish_pool_collect(TickType_t wait)
+{
+    publish_job_t *job = NULL;
+
+    if (pdTRUE != xQueueReceive(done_q, &job, wait))
+    {
+        return NULL;
+    }
+
+    return job;
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_release
+ *******************************************************************************
+ * Summary:
+ *   Gives a job slot back, either after it was collected or if it was
+ *   acquired but not submitted.
+ *
+ * Parameters:
+ *   job: job to free
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void publish_pool_release(publish_job_t *job)
+{
+    xQueueSend(free_q, &job, 0);
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_stop
+ *******************************************************************************
+ * Summary:
+ *   Stops the workers and waits until all of them exited, so that none is
+ *   still inside cy_mqtt_publish() when the MQTT handle is deleted. Jobs not
+ *   yet started are failed without publishing, a publish in progress ends
+ *   within the acknowledgment timeout of the MQTT library. Must be called
+ *   after the owner task was deleted; the queues are kept.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void publish_pool_stop(void)
+{
+    publish_job_t *job = NULL;
+
+    if (job_q == NULL)
+    {
+        return;
+    }
+
+    stopping_task = xTaskGetCurrentTaskHandle();
+    pool_stopping = true;
+
+    for (uint32_t i = 0; i < MQTT_PUB_INFLIGHT_WINDOW; i++)
+    {
+        xQueueSend(job_q, &job, portMAX_DELAY);
+    }
+    for (uint32_t i = 0; i < MQTT_PUB_INFLIGHT_WINDOW; i++)
+    {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: publish_pool_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the pool counters. Can be called from any task.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void publish_pool_get_stats(publish_pool_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = pool_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
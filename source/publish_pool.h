@@ -0,0 +1,114 @@
+/******************************************************************************
+ * File Name:   publish_pool.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in publish_pool.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "cy_mqtt_api.h"
+#include "mqtt_client_config.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Task parameters of the publish workers, one per message in flight */
+#define PUBLISH_POOL_TASK_NAME       "Publish worker"
+#define PUBLISH_POOL_TASK_PRIORITY   (2)
+/* The TLS handshake runs in the MQTT task and the PUBACKs are read by the
+ * MQTT library thread: the deepest path of a worker is the record encryption
+ * of mbedtls_ssl_write() below cy_mqtt_publish(), and it never calls printf.
+ * The stack high-water mark of every worker is published on
+ * 'MQTT_DIAG_TOPIC'; configCHECK_FOR_STACK_OVERFLOW catches an overflow. */
+#define PUBLISH_POOL_TASK_STACK_SIZE (1024)
+
+/* Largest payload of a job */
+#define PUBLISH_POOL_PAYLOAD_SIZE    (MQTT_PUB_BATCH_MAX_BYTES)
+
+/* A failed publish is retried as a new PUBLISH up to
+ * 'PUBLISH_POOL_RETRY_LIMIT' times, 'PUBLISH_POOL_RETRY_MS' apart. No retry
+ * is started once the job is older than 'PUBLISH_POOL_TIMEOUT_MS'. Every
+ * attempt itself is bounded by the acknowledgment timeout of the MQTT library.
+ */
+#define PUBLISH_POOL_RETRY_LIMIT     (2u)
+#define PUBLISH_POOL_RETRY_MS        (500u)
+#define PUBLISH_POOL_TIMEOUT_MS      (10000u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Publish handed to a worker */
+typedef struct
+{
+    uint32_t index;             /* Slot of the job, 0 to MQTT_PUB_INFLIGHT_WINDOW - 1 */
+    const char *topic;
+    uint8_t payload[PUBLISH_POOL_PAYLOAD_SIZE];
+    size_t payload_len;
+
+    /* Filled in by the worker */
+    cy_rslt_t result;
+    uint32_t attempts;
+    uint32_t start_ms;          /* Tick time in ms of the first attempt */
+    uint32_t end_ms;            /* Tick time in ms of the PUBACK or of giving up */
+} publish_job_t;
+
+/* Called by a worker after it queued a finished job */
+typedef void (*publish_pool_done_cb_t)(void);
+
+/* Counters of the pool */
+typedef struct
+{
+    uint32_t submitted;
+    uint32_t acknowledged;
+    uint32_t failed;
+    uint32_t retries;
+    uint32_t timeouts;          /* Jobs given up because they exceeded PUBLISH_POOL_TIMEOUT_MS */
+    uint32_t inflight;
+    uint32_t inflight_high_water;
+} publish_pool_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+bool publish_pool_init(publish_pool_done_cb_t done);
+
+/* Called from the owner task only */
+publish_job_t *publish_pool_acquire(void);
+void publish_pool_submit(publish_job_t *job);
+publish_job_t *publish_pool_collect(TickType_t wait);
+void publish_pool_release(publish_job_t *job);
+
+/* Called from the MQTT task on exit, before cy_mqtt_delete() */
+void publish_pool_stop(void);
+
+void publish_pool_get_stats(publish_pool_stats_t *stats);
+
+/* [] END OF FILE */
@@ -31,8 +31,19 @@
 #include "FreeRTOS.h"
 
 /* Task header files */
+#include "app_boot.h"
+#include "app_memory.h"
 #include "publisher_task.h"
 #include "mqtt_task.h"
+#include "publish_pool.h"
+#include "radar_debounce.h"
+#include "radar_diag.h"
+#include "radar_event_codec.h"
+#include "radar_event_ring.h"
+#include "radar_latency.h"
+#include "radar_occupancy.h"
+#include "radar_outbox.h"
+#include "radar_task.h"
 #include "subscriber_task.h"
 
 /* Configuration file for MQTT client */
@@ -58,6 +69,49 @@
  */
 #define PUBLISHER_TASK_QUEUE_LENGTH     (3u)
 
+/* Number of published batches between two batch size histogram reports on
+ * the debug UART.
+ */
+#define PUBLISHER_BATCH_REPORT_INTERVAL (32u)
+
+/* Longest JSON rendering of one radar event */
+#define PUBLISHER_EVENT_JSON_MAX_SIZE   (96u)
+
+#if (MQTT_PUB_BATCH_MAX_BYTES < (PUBLISHER_EVENT_JSON_MAX_SIZE + 2))
+#error "MQTT_PUB_BATCH_MAX_BYTES must hold at least one event payload."
+#endif
+
+/* Size of the latency report and of the status record published on
+ * 'MQTT_DIAG_TOPIC' */
+#define PUBLISHER_DIAG_MAX_BYTES        (768u)
+
+/* Most events in one batch. The records of the pending batch are kept until
+ * it is published, so that they can go to the outbox if publishing fails.
+ */
+#define PUBLISHER_BATCH_MAX_EVENTS      (32u)
+
+/* Current tick time in ms, the time base of all latency stamps */
+#define PUBLISHER_NOW_MS()              ((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS))
+
+/* Topic on which radar events are published */
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_BINARY)
+#define PUBLISHER_EVENT_TOPIC           MQTT_PUB_BIN_TOPIC
+#else
+#define PUBLISHER_EVENT_TOPIC           MQTT_PUB_TOPIC
+#endif
+
+/* Outbox records replayed per payload. Without batching, subscribers expect
+ * one event per message, so the outbox is replayed like live events, one
+ * record per step at a shorter interval to keep the replay rate.
+ */
+#if MQTT_PUB_BATCH_ENABLE
+#define PUBLISHER_REPLAY_RECORDS        PUBLISHER_REPLAY_BATCH_SIZE
+#else
+#define PUBLISHER_REPLAY_RECORDS        (1u)
+#endif
+#define PUBLISHER_REPLAY_STEP_MS        ((PUBLISHER_REPLAY_INTERVAL_MS * PUBLISHER_REPLAY_RECORDS) / \
+                                         PUBLISHER_REPLAY_BATCH_SIZE)
+
 /******************************************************************************
 * Global Variables
 *******************************************************************************/
@@ -66,6 +120,7 @@ TaskHandle_t publisher_task_handle;
 
 /* Handle of the queue holding the commands for the publisher task */
 QueueHandle_t publisher_task_q;
+APP_QUEUE_MEMORY(publisher_task_q, PUBLISHER_TASK_QUEUE_LENGTH, sizeof(publisher_data_t))
 
 /* Structure to store publish message information. */
 cy_mqtt_publish_info_t publish_info =
@@ -77,6 +132,120 @@ cy_mqtt_publish_info_t publish_info =
     .dup = false
 };
 
+/******************************************************************************
+* Typedefines
+*******************************************************************************/
+/* Stamps of an event that is waiting to be published */
+typedef struct
+{
+    uint32_t event_ms;          /* Library timestamp of the event */
+    uint32_t dequeue_ms;        /* Tick time when the publisher popped the event */
+} latency_sample_t;
+
+/* Event of the pending batch */
+typedef struct
+{
+    radar_event_record_t record;
+    latency_sample_t sample;
+} pending_event_t;
+
+/* Events carried by a publish job, needed once the job finished */
+typedef struct
+{
+    bool replay;                /* Outbox replay, the records are still in the outbox */
+    uint32_t count;             /* Events in the payload */
+    uint32_t outbox_dropped;    /* Outbox drop counter when a replay was peeked */
+    pending_event_t events[PUBLISHER_BATCH_MAX_EVENTS]; /* Live events only */
+} job_context_t;
+
+/* Whether events can be published or have to go to the outbox */
+typedef enum
+{
+    PUBLISHER_BOOTING,          /* Before the first PUBLISHER_INIT */
+    PUBLISHER_CONNECTED,        /* Publish live events, replay the outbox paced */
+    PUBLISHER_DISCONNECTED,     /* Between PUBLISHER_DEINIT and PUBLISHER_INIT */
+    PUBLISHER_PUBLISH_FAILED    /* A publish failed, retry from the outbox */
+} publisher_link_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static bool publish_message(const char *topic, const void *payload, size_t payload_len);
+static void handle_publish_failure(cy_rslt_t result);
+static void notify_publish_complete(void);
+static publish_job_t *acquire_job(void);
+static void complete_publish(publish_job_t *job);
+static void complete_replay(const publish_job_t *job, const job_context_t *context);
+static void publish_radar_events(void);
+static void log_radar_event(const radar_event_record_t *record);
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_JSON)
+static void format_radar_event(const radar_event_record_t *record, char *buffer, size_t buffer_size);
+#endif
+static TickType_t batch_wait_time(void);
+static void record_batch(uint32_t count);
+static void report_throughput(void);
+static void record_dequeue_latency(const radar_event_record_t *record, latency_sample_t *sample);
+static void record_publish_latency(const latency_sample_t *sample, uint32_t start_ms, uint32_t end_ms);
+static void publish_latency_report(void);
+static void publish_diag_status(void);
+static void notify_diag_due(void);
+static void publish_occupancy_stats(void);
+static void notify_occupancy_due(void);
+static void store_radar_event(const radar_event_record_t *record, bool sent);
+static void record_first_publish(void);
+static TickType_t outbox_wait_time(void);
+static void replay_outbox(void);
+static size_t encode_radar_events(const radar_event_record_t *records, uint32_t count,
+                                  uint8_t *buffer, size_t buffer_size, uint32_t *encoded);
+#if MQTT_PUB_BATCH_ENABLE
+static void batch_append(const radar_event_record_t *record, const latency_sample_t *sample);
+static void batch_flush(void);
+#endif
+
+/******************************************************************************
+* Local Variables
+*******************************************************************************/
+/* Number of dropped ring records already reported on the debug UART */
+static uint32_t reported_event_drops = 0;
+
+/* Batch size histogram */
+static publisher_batch_stats_t batch_stats;
+
+/* Latency report published on request */
+static char diag_payload[PUBLISHER_DIAG_MAX_BYTES];
+
+/* State of the link to the broker as seen by the publisher */
+static publisher_link_t publisher_link = PUBLISHER_BOOTING;
+/* Tick count of the last outbox replay attempt */
+static TickType_t replay_tick = 0;
+/* A replay is in flight, its records must not be replayed again */
+static bool replay_in_flight = false;
+/* Jobs submitted to the publish pool and not yet completed */
+static uint32_t jobs_in_flight = 0;
+
+/* Events of every publish job, indexed like the jobs */
+static job_context_t job_contexts[MQTT_PUB_INFLIGHT_WINDOW];
+/* Tick time and acknowledged count at the last throughput report */
+static uint32_t throughput_ms = 0;
+static uint32_t throughput_acknowledged = 0;
+
+/* Time from a reconnection to the first acknowledged publish */
+static publisher_reconnect_stats_t reconnect_stats;
+/* Tick time of the last reconnection, valid until the first publish */
+static uint32_t reconnect_ms = 0;
+static bool awaiting_first_publish = false;
+
+#if MQTT_PUB_BATCH_ENABLE
+/* Payload of the batch being collected, a JSON array or a binary payload */
+static uint8_t batch_payload[MQTT_PUB_BATCH_MAX_BYTES];
+static size_t batch_len = 0;
+static uint32_t batch_count = 0;
+/* Tick count at which the first event entered the pending batch */
+static TickType_t batch_start = 0;
+/* Events of the pending batch */
+static pending_event_t batch_events[PUBLISHER_BATCH_MAX_EVENTS];
+#endif
+
 /******************************************************************************
  * Function Name: publisher_task
  ******************************************************************************
@@ -95,65 +264,1260 @@ cy_mqtt_publish_info_t publish_info =
  ******************************************************************************/
 void publisher_task(void *pvParameters)
 {
-    /* Status variable */
-    cy_rslt_t result;
-
     publisher_data_t publisher_q_data;
 
-    /* Command to the MQTT client task */
-    mqtt_task_cmd_t mqtt_task_cmd;
-
     /* To avoid compiler warnings */
     (void) pvParameters;
 
     /* Create a message queue to communicate with other tasks and callbacks. */
-    publisher_task_q = xQueueCreate(PUBLISHER_TASK_QUEUE_LENGTH, sizeof(publisher_data_t));
+    publisher_task_q = app_queue_create("Publisher", "Publisher queue", PUBLISHER_TASK_QUEUE_LENGTH,
+                                        sizeof(publisher_data_t), APP_QUEUE_STORAGE(publisher_task_q),
+                                        APP_QUEUE_QCB(publisher_task_q));
+#if MQTT_PUB_BATCH_ENABLE
+    app_memory_add("Publisher", "Batch and status payloads", sizeof(batch_payload) + sizeof(diag_payload), true);
+#else
+    app_memory_add("Publisher", "Status payloads", sizeof(diag_payload), true);
+#endif
+
+    /* Radar events are published by the workers of the publish pool. */
+    if (!publish_pool_init(notify_publish_complete))
+    {
+        printf("  Publisher: publish pool initialization failed!\n\n");
+        CY_ASSERT(0);
+    }
+
+    /* Periodic CPU load, stack and heap record on 'MQTT_DIAG_TOPIC'. */
+    radar_diag_start(notify_diag_due);
+
+    /* Periodic occupancy summary on 'MQTT_STATS_TOPIC'. */
+    radar_occupancy_start(notify_occupancy_due);
+
+    /* Radar events can be queued from now on, even before the connection. */
+    app_boot_signal(APP_BOOT_PUBLISHER_READY);
 
     while (true)
     {
-        /* Wait for commands from other tasks and callbacks. */
-        if (pdTRUE == xQueueReceive(publisher_task_q, &publisher_q_data, portMAX_DELAY))
+        TickType_t wait_time = batch_wait_time();
+
+        if (outbox_wait_time() < wait_time)
+        {
+            wait_time = outbox_wait_time();
+        }
+
+        /* Wait for commands from other tasks and callbacks, or until the
+         * window of a pending batch elapses or the outbox is due.
+         */
+        if (pdTRUE == xQueueReceive(publisher_task_q, &publisher_q_data, wait_time))
         {
             switch(publisher_q_data.cmd)
             {
                 case PUBLISHER_INIT:
                 {
-                    /* Reserved for customer extension. */
+                    /* Connection is up, start replaying the outbox now. */
+                    if ((publisher_link != PUBLISHER_CONNECTED) && (publisher_link != PUBLISHER_BOOTING))
+                    {
+                        reconnect_ms = PUBLISHER_NOW_MS();
+                        awaiting_first_publish = true;
+                    }
+                    publisher_link = PUBLISHER_CONNECTED;
+                    replay_tick = xTaskGetTickCount() - pdMS_TO_TICKS(PUBLISHER_REPLAY_STEP_MS);
                     break;
                 }
 
                 case PUBLISHER_DEINIT:
                 {
-                    /* Reserved for customer extension. */
+                    /* Keep events in the outbox until the reconnection. */
+                    publisher_link = PUBLISHER_DISCONNECTED;
                     break;
                 }
 
                 case PUBLISH_MQTT_MSG:
                 {
                     /* Publish the data received over the message queue. */
-                    publish_info.payload = publisher_q_data.data;
-                    publish_info.payload_len = strlen(publish_info.payload);
+                    publish_message(MQTT_PUB_TOPIC, publisher_q_data.data, strlen(publisher_q_data.data));
+                    break;
+                }
 
-                    printf("  Publisher: Publishing '%s' on the topic '%s'\n\n",
-                           (char *) publish_info.payload, publish_info.topic);
+                case PUBLISH_RADAR_EVENTS:
+                {
+                    /* Records are drained below, after every command. */
+                    break;
+                }
 
-                    result = cy_mqtt_publish(mqtt_connection, &publish_info);
+                case PUBLISH_DIAG_LATENCY:
+                {
+                    publish_latency_report();
+                    break;
+                }
 
-                    if (result != CY_RSLT_SUCCESS)
-                    {
-                        printf("  Publisher: MQTT Publish failed with error 0x%0X.\n\n", (int)result);
+                case PUBLISH_DIAG_STATUS:
+                {
+                    /* Waiting radar events go first. */
+                    publish_radar_events();
+                    publish_diag_status();
+                    break;
+                }
 
-                        /* Communicate the publish failure with the the MQTT
-                         * client task.
-                         */
-                        mqtt_task_cmd = HANDLE_MQTT_PUBLISH_FAILURE;
-                        xQueueSend(mqtt_task_q, &mqtt_task_cmd, portMAX_DELAY);
-                    }
+                case PUBLISH_OCCUPANCY_STATS:
+                {
+                    /* Waiting radar events go first. */
+                    publish_radar_events();
+                    publish_occupancy_stats();
+                    break;
+                }
+
+                case PUBLISH_COMPLETE:
+                {
+                    /* Finished jobs are collected below. */
                     break;
                 }
             }
+
+            /* The radar task only signals an empty-to-non-empty transition of
+             * the event ring, and that signal can be lost on a full queue.
+             * Draining after every command guarantees no record is stranded.
+             */
+            publish_radar_events();
+        }
+
+        /* Evaluate the publishes that finished meanwhile. */
+        for (publish_job_t *job = publish_pool_collect(0); job != NULL; job = publish_pool_collect(0))
+        {
+            complete_publish(job);
+        }
+
+#if MQTT_PUB_BATCH_ENABLE
+        /* Publish the pending batch once its window has elapsed. */
+        if ((batch_count > 0) && (batch_wait_time() == 0))
+        {
+            batch_flush();
+        }
+#endif
+
+        /* Live events first, then at most one paced replay step. */
+        replay_outbox();
+    }
+}
+
+/******************************************************************************
+ * Function Name: publish_message
+ ******************************************************************************
+ * Summary:
+ *  Publishes a payload on the given topic and informs the MQTT client task on
+ *  failure.
+ *
+ * Parameters:
+ *  const char *topic : NUL-terminated topic name
+ *  const void *payload : payload, a string for every topic except
+ *                        'MQTT_PUB_BIN_TOPIC'
+ *  size_t payload_len : length of the payload
+ *
+ * Return:
+ *  bool : true if the payload was published
+ *
+ ******************************************************************************/
+static bool publish_message(const char *topic, const void *payload, size_t payload_len)
+{
+    /* Status variable */
+    cy_rslt_t result;
+
+    publish_info.topic = topic;
+    publish_info.topic_len = strlen(topic);
+    publish_info.payload = payload;
+    publish_info.payload_len = payload_len;
+
+    if (strcmp(topic, MQTT_PUB_BIN_TOPIC) == 0)
+    {
+        printf("  Publisher: Publishing %u bytes on the topic '%s'\n\n",
+               (unsigned int)payload_len, publish_info.topic);
+    }
+    else
+    {
+        printf("  Publisher: Publishing '%.*s' on the topic '%s'\n\n",
+               (int)payload_len, (const char *) publish_info.payload, publish_info.topic);
+    }
+
+    result = cy_mqtt_publish(mqtt_connection, &publish_info);
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        handle_publish_failure(result);
+    }
+    else if (awaiting_first_publish)
+    {
+        record_first_publish();
+    }
+
+    return (result == CY_RSLT_SUCCESS);
+}
+
+/******************************************************************************
+ * Function Name: handle_publish_failure
+ ******************************************************************************
+ * Summary:
+ *  Parks further events in the outbox until the link is up again and informs
+ *  the MQTT client task, at most once until a publish succeeds again.
+ *
+ * Parameters:
+ *  cy_rslt_t result : error returned by 'cy_mqtt_publish'
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void handle_publish_failure(cy_rslt_t result)
+{
+    /* Command to the MQTT client task */
+    mqtt_task_cmd_t mqtt_task_cmd;
+
+    printf("  Publisher: MQTT Publish failed with error 0x%0X.\n\n", (int)result);
+
+    /* Park events in the outbox and probe the link from there. */
+    if (publisher_link == PUBLISHER_CONNECTED)
+    {
+        publisher_link = PUBLISHER_PUBLISH_FAILED;
+        replay_tick = xTaskGetTickCount();
+
+        /* Communicate the publish failure with the the MQTT client task, once
+         * per failed link: the outbox probes and the failed jobs that follow
+         * are not reported again. Never wait here, a full queue must not
+         * stall the publisher.
+         */
+        mqtt_task_cmd = HANDLE_MQTT_PUBLISH_FAILURE;
+        if (pdTRUE != xQueueSend(mqtt_task_q, &mqtt_task_cmd, 0))
+        {
+            printf("  Publisher: MQTT task queue full, publish failure not reported.\n\n");
+        }
+    }
+}
+
+/******************************************************************************
+ * Function Name: publish_radar_events
+ ******************************************************************************
+ * Summary:
+ *  Drains the radar event ring in batches of 'PUBLISHER_EVENT_BATCH_SIZE'
+ *  records and publishes every record. Reports records the ring had to drop
+ *  since the last call.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publish_radar_events(void)
+{
+    radar_event_record_t records[PUBLISHER_EVENT_BATCH_SIZE];
+    radar_event_ring_stats_t ring_stats;
+    uint32_t count;
+#if !MQTT_PUB_BATCH_ENABLE
+    publish_job_t *job;
+    job_context_t *context;
+#endif
+    latency_sample_t sample;
+
+    while ((count = radar_event_ring_pop(records, PUBLISHER_EVENT_BATCH_SIZE)) > 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            record_dequeue_latency(&records[i], &sample);
+            log_radar_event(&records[i]);
+            if (publisher_link != PUBLISHER_CONNECTED)
+            {
+                store_radar_event(&records[i], false);
+                continue;
+            }
+#if MQTT_PUB_BATCH_ENABLE
+            batch_append(&records[i], &sample);
+#else
+            job = acquire_job();
+            if (publisher_link != PUBLISHER_CONNECTED)
+            {
+                /* A publish that completed meanwhile failed */
+                publish_pool_release(job);
+                store_radar_event(&records[i], false);
+                continue;
+            }
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_BINARY)
+            job->payload_len = radar_event_codec_encode(&records[i], 1, job->payload, sizeof(job->payload));
+#else
+            format_radar_event(&records[i], (char *)job->payload, sizeof(job->payload));
+            job->payload_len = strlen((const char *)job->payload);
+#endif
+            job->topic = PUBLISHER_EVENT_TOPIC;
+
+            context = &job_contexts[job->index];
+            context->replay = false;
+            context->count = 1;
+            context->events[0].record = records[i];
+            context->events[0].sample = sample;
+
+            jobs_in_flight++;
+            publish_pool_submit(job);
+#endif
         }
     }
+
+    radar_event_ring_get_stats(&ring_stats);
+    if (ring_stats.dropped != reported_event_drops)
+    {
+        printf("  Publisher: %lu radar events dropped, event ring full (high water %lu/%u).\n\n",
+               (unsigned long)(ring_stats.dropped - reported_event_drops),
+               (unsigned long)ring_stats.high_water, RADAR_EVENT_RING_LENGTH);
+        reported_event_drops = ring_stats.dropped;
+    }
+}
+
+/******************************************************************************
+ * Function Name: log_radar_event
+ ******************************************************************************
+ * Summary:
+ *  Logs a radar event record on the debug UART.
+ *
+ * Parameters:
+ *  const radar_event_record_t *record : event record
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void log_radar_event(const radar_event_record_t *record)
+{
+#ifdef RADAR_ENTRANCE_COUNTER_MODE
+    printf("%lu.%03lu: Counter event detected, IN: %ld, OUT: %ld, occupy_status: %d\n",
+           (unsigned long)(record->timestamp / 1000), (unsigned long)(record->timestamp % 1000),
+           (long)record->count_in,
+           (long)record->count_out,
+           record->occupy_status);
+#else
+    if (record->occupy_status)
+    {
+        printf("%lu.%03lu: Presence IN %d-%d mm\n",
+               (unsigned long)(record->timestamp / 1000), (unsigned long)(record->timestamp % 1000),
+               record->distance_mm - record->accuracy_mm,
+               record->distance_mm + record->accuracy_mm);
+    }
+    else
+    {
+        printf("%lu.%03lu: Presence OUT\n",
+               (unsigned long)(record->timestamp / 1000), (unsigned long)(record->timestamp % 1000));
+    }
+#endif
+}
+
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_JSON)
+/******************************************************************************
+ * Function Name: format_radar_event
+ ******************************************************************************
+ * Summary:
+ *  Renders a radar event record as the JSON payload published on
+ *  'MQTT_PUB_TOPIC'.
+ *
+ * Parameters:
+ *  const radar_event_record_t *record : event record
+ *  char *buffer : destination of the JSON string
+ *  size_t buffer_size : size of 'buffer'
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void format_radar_event(const radar_event_record_t *record, char *buffer, size_t buffer_size)
+{
+#ifdef RADAR_ENTRANCE_COUNTER_MODE
+    snprintf(buffer,
+             buffer_size,
+             "{\"IN_Count\":%ld, \"OUT_Count\":%ld, \"Status\":%d, \"Seq\":%lu}",
+             (long)record->count_in,
+             (long)record->count_out,
+             record->occupy_status,
+             (unsigned long)record->seq);
+#else
+    if (record->occupy_status)
+    {
+        snprintf(buffer, buffer_size, "{\"PRESENCE\": \" IN\", \"Seq\":%lu}", (unsigned long)record->seq);
+    }
+    else
+    {
+        snprintf(buffer, buffer_size, "{\"PRESENCE\": \"OUT\", \"Seq\":%lu}", (unsigned long)record->seq);
+    }
+#endif
+}
+#endif /* MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_JSON */
+
+/******************************************************************************
+ * Function Name: batch_wait_time
+ ******************************************************************************
+ * Summary:
+ *  Returns how long the publisher task may block waiting for commands before
+ *  the pending batch has to be published.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  TickType_t : ticks until the batch window elapses, 'portMAX_DELAY' if no
+ *               batch is pending
+ *
+ ******************************************************************************/
+static TickType_t batch_wait_time(void)
+{
+#if MQTT_PUB_BATCH_ENABLE
+    if (batch_count > 0)
+    {
+        TickType_t elapsed = xTaskGetTickCount() - batch_start;
+        TickType_t window = pdMS_TO_TICKS(MQTT_PUB_BATCH_WINDOW_MS);
+
+        return (elapsed >= window) ? 0 : (window - elapsed);
+    }
+#endif
+    return portMAX_DELAY;
+}
+
+#if MQTT_PUB_BATCH_ENABLE
+/******************************************************************************
+ * Function Name: batch_append
+ ******************************************************************************
+ * Summary:
+ *  Adds one event to the pending batch, as JSON array element or binary
+ *  record depending on 'MQTT_PUB_PAYLOAD_FORMAT'. The pending batch is
+ *  published first if the event would exceed 'MQTT_PUB_BATCH_MAX_BYTES'.
+ *
+ * Parameters:
+ *  const radar_event_record_t *record : event record
+ *  const latency_sample_t *sample : latency stamps of the event
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void batch_append(const radar_event_record_t *record, const latency_sample_t *sample)
+{
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_BINARY)
+    if ((batch_count > 0) &&
+        ((batch_count == PUBLISHER_BATCH_MAX_EVENTS) ||
+         ((batch_len + RADAR_EVENT_CODEC_RECORD_SIZE) > sizeof(batch_payload))))
+    {
+        batch_flush();
+    }
+
+    if (batch_count == 0)
+    {
+        /* The header is written on flush, once the record count is known */
+        batch_len = RADAR_EVENT_CODEC_HEADER_SIZE;
+        batch_start = xTaskGetTickCount();
+    }
+
+    radar_event_codec_put_record(&batch_payload[batch_len], record);
+    batch_len += RADAR_EVENT_CODEC_RECORD_SIZE;
+#else
+    char event_json[PUBLISHER_EVENT_JSON_MAX_SIZE];
+    size_t event_len;
+
+    format_radar_event(record, event_json, sizeof(event_json));
+    event_len = strlen(event_json);
+
+    /* Room for the separator, the event and the closing bracket */
+    if ((batch_count > 0) &&
+        ((batch_count == PUBLISHER_BATCH_MAX_EVENTS) || ((batch_len + 1 + event_len + 1) > sizeof(batch_payload))))
+    {
+        batch_flush();
+    }
+
+    if (batch_count == 0)
+    {
+        batch_payload[0] = '[';
+        batch_len = 1;
+        batch_start = xTaskGetTickCount();
+    }
+    else
+    {
+        batch_payload[batch_len++] = ',';
+    }
+
+    memcpy(&batch_payload[batch_len], event_json, event_len);
+    batch_len += event_len;
+#endif
+    batch_events[batch_count].record = *record;
+    batch_events[batch_count].sample = *sample;
+    batch_count++;
+}
+
+/******************************************************************************
+ * Function Name: batch_flush
+ ******************************************************************************
+ * Summary:
+ *  Completes the pending batch, publishes it and updates the batch size
+ *  histogram.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void batch_flush(void)
+{
+    publish_job_t *job;
+    job_context_t *context;
+    bool submitted = false;
+
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_BINARY)
+    radar_event_codec_put_header(batch_payload, batch_count);
+#else
+    batch_payload[batch_len++] = ']';
+#endif
+
+    /* The link may have gone down while the batch was collected, or while
+     * waiting for a free job.
+     */
+    if (publisher_link == PUBLISHER_CONNECTED)
+    {
+        job = acquire_job();
+        if (publisher_link == PUBLISHER_CONNECTED)
+        {
+            memcpy(job->payload, batch_payload, batch_len);
+            job->payload_len = batch_len;
+            job->topic = PUBLISHER_EVENT_TOPIC;
+
+            context = &job_contexts[job->index];
+            context->replay = false;
+            context->count = batch_count;
+            memcpy(context->events, batch_events, batch_count * sizeof(pending_event_t));
+
+            jobs_in_flight++;
+            publish_pool_submit(job);
+            submitted = true;
+        }
+        else
+        {
+            publish_pool_release(job);
+        }
+    }
+
+    if (!submitted)
+    {
+        for (uint32_t i = 0; i < batch_count; i++)
+        {
+            store_radar_event(&batch_events[i].record, false);
+        }
+    }
+
+    batch_count = 0;
+    batch_len = 0;
+}
+#endif /* MQTT_PUB_BATCH_ENABLE */
+
+/******************************************************************************
+ * Function Name: record_batch
+ ******************************************************************************
+ * Summary:
+ *  Adds a published batch to the batch size histogram and periodically
+ *  reports the histogram on the debug UART.
+ *
+ * Parameters:
+ *  uint32_t count : number of events in the batch
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void record_batch(uint32_t count)
+{
+    uint32_t bucket = (count < PUBLISHER_BATCH_HISTOGRAM_BUCKETS) ? count : PUBLISHER_BATCH_HISTOGRAM_BUCKETS;
+
+    taskENTER_CRITICAL();
+    batch_stats.batches++;
+    batch_stats.events += count;
+    batch_stats.buckets[bucket - 1]++;
+    taskEXIT_CRITICAL();
+
+    if ((batch_stats.batches % PUBLISHER_BATCH_REPORT_INTERVAL) == 0)
+    {
+        printf("  Publisher: %lu events in %lu batches, batch sizes:",
+               (unsigned long)batch_stats.events, (unsigned long)batch_stats.batches);
+        for (uint32_t i = 0; i < PUBLISHER_BATCH_HISTOGRAM_BUCKETS; i++)
+        {
+            printf(" %lu%s:%lu", (unsigned long)(i + 1),
+                   (i == (PUBLISHER_BATCH_HISTOGRAM_BUCKETS - 1)) ? "+" : "",
+                   (unsigned long)batch_stats.buckets[i]);
+        }
+        printf("\n\n");
+
+        report_throughput();
+        radar_latency_dump();
+    }
+}
+
+/******************************************************************************
+ * Function Name: report_throughput
+ ******************************************************************************
+ * Summary:
+ *  Reports the acknowledged publishes per second since the last report and
+ *  the counters of the publish pool on the debug UART.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void report_throughput(void)
+{
+    publish_pool_stats_t pool_stats;
+    uint32_t now_ms = PUBLISHER_NOW_MS();
+    uint32_t elapsed_ms = now_ms - throughput_ms;
+    uint32_t acknowledged;
+
+    publish_pool_get_stats(&pool_stats);
+    acknowledged = pool_stats.acknowledged - throughput_acknowledged;
+
+    printf("  Publisher: %lu.%02lu publishes/s, window %u, in flight high water %lu, %lu retries, %lu timeouts, %lu failed.\n\n",
+           (unsigned long)((elapsed_ms > 0) ? ((acknowledged * 1000u) / elapsed_ms) : 0),
+           (unsigned long)((elapsed_ms > 0) ? (((acknowledged * 100000u) / elapsed_ms) % 100u) : 0),
+           MQTT_PUB_INFLIGHT_WINDOW,
+           (unsigned long)pool_stats.inflight_high_water, (unsigned long)pool_stats.retries,
+           (unsigned long)pool_stats.timeouts, (unsigned long)pool_stats.failed);
+
+    throughput_ms = now_ms;
+    throughput_acknowledged = pool_stats.acknowledged;
+}
+
+/******************************************************************************
+ * Function Name: record_dequeue_latency
+ ******************************************************************************
+ * Summary:
+ *  Records the latency of the stages an event passed before the publisher
+ *  popped it from the event ring, and keeps the stamps needed once it is
+ *  published.
+ *
+ * Parameters:
+ *  const radar_event_record_t *record : event record just popped
+ *  latency_sample_t *sample : stamps of the event, filled here
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void record_dequeue_latency(const radar_event_record_t *record, latency_sample_t *sample)
+{
+    sample->event_ms = record->timestamp;
+    sample->dequeue_ms = PUBLISHER_NOW_MS();
+
+    radar_latency_record(RADAR_LATENCY_CALLBACK, record->callback_ms - record->timestamp);
+    radar_latency_record(RADAR_LATENCY_ENQUEUE, record->enqueue_ms - record->callback_ms);
+    radar_latency_record(RADAR_LATENCY_DEQUEUE, sample->dequeue_ms - record->enqueue_ms);
+}
+
+/******************************************************************************
+ * Function Name: record_publish_latency
+ ******************************************************************************
+ * Summary:
+ *  Records the latency of the publish stages of an event. 'cy_mqtt_publish'
+ *  returns once the broker acknowledged the publish for QoS 1 and 2, so
+ *  'end_ms' is the PUBACK time. Replayed events are not sampled.
+ *
+ * Parameters:
+ *  const latency_sample_t *sample : stamps of the published event
+ *  uint32_t start_ms : tick time in ms before 'cy_mqtt_publish' was called
+ *  uint32_t end_ms : tick time in ms after 'cy_mqtt_publish' returned
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void record_publish_latency(const latency_sample_t *sample, uint32_t start_ms, uint32_t end_ms)
+{
+    radar_latency_record(RADAR_LATENCY_PUBLISH_START, start_ms - sample->dequeue_ms);
+    radar_latency_record(RADAR_LATENCY_PUBLISH, end_ms - start_ms);
+    radar_latency_record(RADAR_LATENCY_END_TO_END, end_ms - sample->event_ms);
+}
+
+/******************************************************************************
+ * Function Name: publish_latency_report
+ ******************************************************************************
+ * Summary:
+ *  Dumps the latency histograms and the occupancy debounce counters on the
+ *  debug UART and publishes the latency summary on 'MQTT_DIAG_TOPIC'.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publish_latency_report(void)
+{
+    radar_debounce_stats_t debounce_stats;
+    size_t len;
+
+    radar_latency_dump();
+
+    radar_debounce_get_stats(&debounce_stats);
+    printf("  Debounce: %lu occupancy updates, %lu published, %lu repeats and %lu flaps suppressed.\n\n",
+           (unsigned long)debounce_stats.offered, (unsigned long)debounce_stats.published,
+           (unsigned long)debounce_stats.repeats, (unsigned long)debounce_stats.flaps);
+
+    len = radar_latency_format(diag_payload, sizeof(diag_payload));
+    if (len > 0)
+    {
+        publish_message(MQTT_DIAG_TOPIC, diag_payload, len);
+    }
+}
+
+/******************************************************************************
+ * Function Name: publish_diag_status
+ ******************************************************************************
+ * Summary:
+ *  Publishes the periodic status record on 'MQTT_DIAG_TOPIC'. The record is
+ *  skipped while radar events are in flight, batched or in the outbox, so it
+ *  never delays them. The next record then covers the longer interval.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publish_diag_status(void)
+{
+    size_t len;
+
+    if ((publisher_link != PUBLISHER_CONNECTED) || (jobs_in_flight > 0) ||
+#if MQTT_PUB_BATCH_ENABLE
+        (batch_count > 0) ||
+#endif
+        (radar_outbox_count() > 0))
+    {
+        radar_diag_skip();
+        return;
+    }
+
+    len = radar_diag_format(diag_payload, sizeof(diag_payload));
+    if (len > 0)
+    {
+        publish_message(MQTT_DIAG_TOPIC, diag_payload, len);
+    }
+}
+
+/******************************************************************************
+ * Function Name: notify_diag_due
+ ******************************************************************************
+ * Summary:
+ *  Called from the timer service task when a status record is due. Does not
+ *  block; if the queue is full, this record is left out.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void notify_diag_due(void)
+{
+    publisher_data_t publisher_q_data;
+
+    publisher_q_data.cmd = PUBLISH_DIAG_STATUS;
+    if (pdTRUE != xQueueSend(publisher_task_q, &publisher_q_data, 0))
+    {
+        radar_diag_skip();
+    }
+}
+
+/******************************************************************************
+ * Function Name: publish_occupancy_stats
+ ******************************************************************************
+ * Summary:
+ *  Publishes the occupancy summary on 'MQTT_STATS_TOPIC'. Like the status
+ *  record, it is skipped while radar events are in flight, batched or in the
+ *  outbox. The windows are kept, so the next summary still covers them.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void publish_occupancy_stats(void)
+{
+    size_t len;
+
+    if ((publisher_link != PUBLISHER_CONNECTED) || (jobs_in_flight > 0) ||
+#if MQTT_PUB_BATCH_ENABLE
+        (batch_count > 0) ||
+#endif
+        (radar_outbox_count() > 0))
+    {
+        radar_occupancy_skip();
+        return;
+    }
+
+    len = radar_occupancy_format(diag_payload, sizeof(diag_payload), PUBLISHER_NOW_MS());
+    if (len > 0)
+    {
+        publish_message(MQTT_STATS_TOPIC, diag_payload, len);
+    }
+}
+
+/******************************************************************************
+ * Function Name: notify_occupancy_due
+ ******************************************************************************
+ * Summary:
+ *  Called from the timer service task when an occupancy summary is due. Does
+ *  not block; if the queue is full, this summary is left out.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void notify_occupancy_due(void)
+{
+    publisher_data_t publisher_q_data;
+
+    publisher_q_data.cmd = PUBLISH_OCCUPANCY_STATS;
+    if (pdTRUE != xQueueSend(publisher_task_q, &publisher_q_data, 0))
+    {
+        radar_occupancy_skip();
+    }
+}
+
+/******************************************************************************
+ * Function Name: publisher_get_batch_stats
+ ******************************************************************************
+ * Summary:
+ *  Returns a copy of the batch size histogram.
+ *
+ * Parameters:
+ *  publisher_batch_stats_t *stats : destination of the histogram
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void publisher_get_batch_stats(publisher_batch_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = batch_stats;
+    taskEXIT_CRITICAL();
+}
+
+/******************************************************************************
+ * Function Name: store_radar_event
+ ******************************************************************************
+ * Summary:
+ *  Keeps an event that could not be published in the outbox.
+ *
+ * Parameters:
+ *  const radar_event_record_t *record : event record
+ *  bool sent : true if the publish of the event failed without an
+ *              acknowledgment, so the broker may have received it
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void store_radar_event(const radar_event_record_t *record, bool sent)
+{
+    radar_outbox_put(record, sent);
+}
+
+/******************************************************************************
+ * Function Name: outbox_wait_time
+ ******************************************************************************
+ * Summary:
+ *  Returns how long the publisher task may block before the next outbox
+ *  replay step is due. Replays are paced by 'PUBLISHER_REPLAY_STEP_MS' so
+ *  that live events keep their latency, a failed link is probed every
+ *  'PUBLISHER_RETRY_INTERVAL_MS'.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  TickType_t : ticks until the next replay step, 'portMAX_DELAY' if none is
+ *               pending
+ *
+ ******************************************************************************/
+static TickType_t outbox_wait_time(void)
+{
+    TickType_t interval;
+    TickType_t elapsed;
+
+    /* A finished replay or a free job wakes the task with PUBLISH_COMPLETE */
+    if ((radar_outbox_count() == 0) || (publisher_link == PUBLISHER_DISCONNECTED) ||
+        (publisher_link == PUBLISHER_BOOTING) ||
+        replay_in_flight || (jobs_in_flight == MQTT_PUB_INFLIGHT_WINDOW))
+    {
+        return portMAX_DELAY;
+    }
+
+    interval = (publisher_link == PUBLISHER_CONNECTED) ? pdMS_TO_TICKS(PUBLISHER_REPLAY_STEP_MS) :
+                                                         pdMS_TO_TICKS(PUBLISHER_RETRY_INTERVAL_MS);
+    elapsed = xTaskGetTickCount() - replay_tick;
+
+    return (elapsed >= interval) ? 0 : (interval - elapsed);
+}
+
+/******************************************************************************
+ * Function Name: replay_outbox
+ ******************************************************************************
+ * Summary:
+ *  Publishes the oldest outbox records once the replay step is due and a
+ *  job is free: up to 'PUBLISHER_REPLAY_BATCH_SIZE' records as one payload
+ *  with 'MQTT_PUB_BATCH_ENABLE', else the oldest record as one event.
+ *  Records leave the outbox only after a successful publish, see
+ *  complete_replay(). A payload
+ *  holding records that may have reached the broker before is counted as a
+ *  resend, but not flagged DUP: it is a new PUBLISH with a new packet ID.
+ *  Consumers restore the order and drop duplicates with the sequence number
+ *  of every event.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void replay_outbox(void)
+{
+    radar_event_record_t records[PUBLISHER_REPLAY_RECORDS];
+    radar_outbox_stats_t outbox_stats;
+    publish_job_t *job;
+    job_context_t *context;
+    uint32_t count;
+    uint32_t encoded;
+    bool sent;
+
+    if (outbox_wait_time() != 0)
+    {
+        return;
+    }
+
+    /* Live events have the first claim on the publish window. */
+    job = publish_pool_acquire();
+    if (job == NULL)
+    {
+        return;
+    }
+    replay_tick = xTaskGetTickCount();
+
+    count = radar_outbox_peek(records, PUBLISHER_REPLAY_RECORDS, &sent);
+    job->payload_len = encode_radar_events(records, count, job->payload, sizeof(job->payload), &encoded);
+    if (job->payload_len == 0)
+    {
+        publish_pool_release(job);
+        return;
+    }
+    job->topic = PUBLISHER_EVENT_TOPIC;
+    if (sent)
+    {
+        taskENTER_CRITICAL();
+        reconnect_stats.dup_publishes++;
+        taskEXIT_CRITICAL();
+    }
+
+    radar_outbox_get_stats(&outbox_stats);
+    context = &job_contexts[job->index];
+    context->replay = true;
+    context->count = encoded;
+    context->outbox_dropped = outbox_stats.dropped;
+
+    replay_in_flight = true;
+    jobs_in_flight++;
+    publish_pool_submit(job);
+}
+
+/******************************************************************************
+ * Function Name: complete_replay
+ ******************************************************************************
+ * Summary:
+ *  Removes the records of a successful replay from the outbox. Records the
+ *  outbox dropped while the replay was in flight are not removed twice.
+ *
+ * Parameters:
+ *  const publish_job_t *job : finished replay job
+ *  const job_context_t *context : records carried by the job
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void complete_replay(const publish_job_t *job, const job_context_t *context)
+{
+    radar_outbox_stats_t outbox_stats;
+    uint32_t lost;
+
+    replay_in_flight = false;
+    if (job->result != CY_RSLT_SUCCESS)
+    {
+        return;
+    }
+
+    radar_outbox_get_stats(&outbox_stats);
+    lost = outbox_stats.dropped - context->outbox_dropped;
+    if (lost < context->count)
+    {
+        radar_outbox_consume(context->count - lost);
+    }
+
+    /* The link is back unless the MQTT client task meanwhile reported a
+     * disconnection.
+     */
+    if (publisher_link == PUBLISHER_PUBLISH_FAILED)
+    {
+        publisher_link = PUBLISHER_CONNECTED;
+    }
+
+    if (radar_outbox_count() == 0)
+    {
+        radar_outbox_get_stats(&outbox_stats);
+        printf("  Publisher: outbox replayed, %lu events stored, %lu replayed (%lu resent), %lu dropped (high water %lu/%u).\n\n",
+               (unsigned long)outbox_stats.stored, (unsigned long)outbox_stats.replayed,
+               (unsigned long)outbox_stats.resent,
+               (unsigned long)outbox_stats.dropped, (unsigned long)outbox_stats.high_water,
+               RADAR_OUTBOX_LENGTH);
+    }
+}
+
+/******************************************************************************
+ * Function Name: acquire_job
+ ******************************************************************************
+ * Summary:
+ *  Returns a free publish job. If 'MQTT_PUB_INFLIGHT_WINDOW' publishes are in
+ *  flight, waits for the next one to finish and evaluates it first.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  publish_job_t * : job to fill and submit
+ *
+ ******************************************************************************/
+static publish_job_t *acquire_job(void)
+{
+    publish_job_t *job;
+
+    while ((job = publish_pool_acquire()) == NULL)
+    {
+        complete_publish(publish_pool_collect(portMAX_DELAY));
+    }
+
+    return job;
+}
+
+/******************************************************************************
+ * Function Name: complete_publish
+ ******************************************************************************
+ * Summary:
+ *  Evaluates a finished publish job. Events of an acknowledged payload are
+ *  sampled for latency, events of a failed payload go to the outbox, marked
+ *  as possibly received by the broker.
+ *
+ * Parameters:
+ *  publish_job_t *job : finished job, freed here
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void complete_publish(publish_job_t *job)
+{
+    job_context_t *context = &job_contexts[job->index];
+
+    jobs_in_flight--;
+
+    if (context->replay)
+    {
+        complete_replay(job, context);
+    }
+    else if (job->result == CY_RSLT_SUCCESS)
+    {
+        for (uint32_t i = 0; i < context->count; i++)
+        {
+            record_publish_latency(&context->events[i].sample, job->start_ms, job->end_ms);
+        }
+        record_batch(context->count);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < context->count; i++)
+        {
+            store_radar_event(&context->events[i].record, true);
+        }
+    }
+
+    if (job->result != CY_RSLT_SUCCESS)
+    {
+        handle_publish_failure(job->result);
+    }
+    else
+    {
+        app_boot_signal(APP_BOOT_FIRST_PUBLISH);
+        if (awaiting_first_publish)
+        {
+            record_first_publish();
+        }
+    }
+
+    publish_pool_release(job);
+}
+
+/******************************************************************************
+ * Function Name: notify_publish_complete
+ ******************************************************************************
+ * Summary:
+ *  Called by a publish worker after a job finished. Wakes the publisher task
+ *  without blocking. If its queue is full, the task is awake anyway and
+ *  collects the job after the pending commands.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void notify_publish_complete(void)
+{
+    publisher_data_t publisher_q_data;
+
+    publisher_q_data.cmd = PUBLISH_COMPLETE;
+    xQueueSend(publisher_task_q, &publisher_q_data, 0);
+}
+
+/******************************************************************************
+ * Function Name: encode_radar_events
+ ******************************************************************************
+ * Summary:
+ *  Encodes as many of the given records as fit into one payload, as JSON
+ *  array or binary payload depending on 'MQTT_PUB_PAYLOAD_FORMAT'. Without
+ *  'MQTT_PUB_BATCH_ENABLE', only the first record is encoded, in the same
+ *  form as a live event.
+ *
+ * Parameters:
+ *  const radar_event_record_t *records : event records
+ *  uint32_t count : number of records
+ *  uint8_t *buffer : destination of the payload
+ *  size_t buffer_size : size of 'buffer'
+ *  uint32_t *encoded : number of records in the payload
+ *
+ * Return:
+ *  size_t : payload length, 0 if no record fits
+ *
+ ******************************************************************************/
+static size_t encode_radar_events(const radar_event_record_t *records, uint32_t count,
+                                  uint8_t *buffer, size_t buffer_size, uint32_t *encoded)
+{
+#if (MQTT_PUB_PAYLOAD_FORMAT == MQTT_PUB_PAYLOAD_BINARY)
+    uint32_t fit = (uint32_t)((buffer_size - RADAR_EVENT_CODEC_HEADER_SIZE) / RADAR_EVENT_CODEC_RECORD_SIZE);
+
+    *encoded = (count < fit) ? count : fit;
+    return (*encoded > 0) ? radar_event_codec_encode(records, *encoded, buffer, buffer_size) : 0;
+#elif !MQTT_PUB_BATCH_ENABLE
+    if (count == 0)
+    {
+        *encoded = 0;
+        return 0;
+    }
+    format_radar_event(&records[0], (char *)buffer, buffer_size);
+    *encoded = 1;
+    return strlen((const char *)buffer);
+#else
+    char event_json[PUBLISHER_EVENT_JSON_MAX_SIZE];
+    size_t len = 1;
+    uint32_t i;
+
+    buffer[0] = '[';
+    for (i = 0; i < count; i++)
+    {
+        size_t event_len;
+
+        format_radar_event(&records[i], event_json, sizeof(event_json));
+        event_len = strlen(event_json);
+
+        /* Room for the separator, the event and the closing bracket */
+        if ((len + 1 + event_len + 1) > buffer_size)
+        {
+            break;
+        }
+        if (i > 0)
+        {
+            buffer[len++] = ',';
+        }
+        memcpy(&buffer[len], event_json, event_len);
+        len += event_len;
+    }
+    buffer[len++] = ']';
+
+    *encoded = i;
+    return (i > 0) ? len : 0;
+#endif
+}
+
+/******************************************************************************
+ * Function Name: record_first_publish
+ ******************************************************************************
+ * Summary:
+ *  Records the time from the last reconnection to the first acknowledged
+ *  publish after it.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void record_first_publish(void)
+{
+    uint32_t elapsed_ms = PUBLISHER_NOW_MS() - reconnect_ms;
+
+    awaiting_first_publish = false;
+
+    taskENTER_CRITICAL();
+    reconnect_stats.reconnects++;
+    reconnect_stats.last_ms = elapsed_ms;
+    if (elapsed_ms > reconnect_stats.max_ms)
+    {
+        reconnect_stats.max_ms = elapsed_ms;
+    }
+    taskEXIT_CRITICAL();
+
+    printf("  Publisher: first publish %lu ms after the reconnection (max %lu ms over %lu reconnections).\n\n",
+           (unsigned long)elapsed_ms, (unsigned long)reconnect_stats.max_ms,
+           (unsigned long)reconnect_stats.reconnects);
+}
+
+/******************************************************************************
+ * Function Name: publisher_get_reconnect_stats
+ ******************************************************************************
+ * Summary:
+ *  Returns a copy of the reconnection recovery counters. Can be called from
+ *  any task.
+ *
+ * Parameters:
+ *  publisher_reconnect_stats_t *stats : destination of the counters
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void publisher_get_reconnect_stats(publisher_reconnect_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = reconnect_stats;
+    taskEXIT_CRITICAL();
 }
 
 /* [] END OF FILE */
@@ -39,6 +39,25 @@
 
 #define MQTT_PUB_QUEUE_LENGTH (10u)
 #define MQTT_PUB_MSG_MAX_SIZE (64u)
+
+/* Maximum number of radar event records drained from the event ring at once */
+#define PUBLISHER_EVENT_BATCH_SIZE (8u)
+
+/* Events that could not be published are kept in the outbox (radar_outbox.c)
+ * and replayed after the reconnection, 'PUBLISHER_REPLAY_BATCH_SIZE' events
+ * every 'PUBLISHER_REPLAY_INTERVAL_MS' milliseconds, so that live events are
+ * not held back. With 'MQTT_PUB_BATCH_ENABLE' they form one payload, else
+ * each event is published on its own. After a failed publish the link is probed every
+ * 'PUBLISHER_RETRY_INTERVAL_MS' milliseconds.
+ */
+#define PUBLISHER_REPLAY_BATCH_SIZE  (8u)
+#define PUBLISHER_REPLAY_INTERVAL_MS (250u)
+#define PUBLISHER_RETRY_INTERVAL_MS  (5000u)
+
+/* Number of buckets of the batch size histogram. Bucket 'n' counts batches of
+ * n + 1 events, the last bucket also counts all larger batches.
+ */
+#define PUBLISHER_BATCH_HISTOGRAM_BUCKETS (8u)
 /*******************************************************************************
  * Typedefines
  ******************************************************************************/
@@ -47,7 +66,12 @@ typedef enum
 {
     PUBLISHER_INIT,
     PUBLISHER_DEINIT,
-    PUBLISH_MQTT_MSG
+    PUBLISH_MQTT_MSG,
+    PUBLISH_RADAR_EVENTS,
+    PUBLISH_DIAG_LATENCY,
+    PUBLISH_DIAG_STATUS,
+    PUBLISH_OCCUPANCY_STATS,
+    PUBLISH_COMPLETE
 } publisher_cmd_t;
 
 /* Struct to be passed via the publisher task queue */
@@ -56,6 +80,23 @@ typedef struct{
     char data[MQTT_PUB_MSG_MAX_SIZE];
 } publisher_data_t;
 
+/* Batch size histogram of the batched publishing mode */
+typedef struct
+{
+    uint32_t batches;
+    uint32_t events;
+    uint32_t buckets[PUBLISHER_BATCH_HISTOGRAM_BUCKETS];
+} publisher_batch_stats_t;
+
+/* Recovery of the publisher after a reconnection */
+typedef struct
+{
+    uint32_t reconnects;        /* Reconnections after a link loss */
+    uint32_t last_ms;           /* Reconnection to the first acknowledged publish */
+    uint32_t max_ms;
+    uint32_t dup_publishes;     /* Outbox replays holding events that may have reached the broker */
+} publisher_reconnect_stats_t;
+
 /*******************************************************************************
  * Extern Variables
  ******************************************************************************/
@@ -66,5 +107,7 @@ extern QueueHandle_t publisher_task_q;
  * Function Prototypes
  ******************************************************************************/
 void publisher_task(void *pvParameters);
+void publisher_get_batch_stats(publisher_batch_stats_t *stats);
+void publisher_get_reconnect_stats(publisher_reconnect_stats_t *stats);
 
 /* [] END OF FILE */
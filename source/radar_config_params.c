@@ -0,0 +1,782 @@
+/******************************************************************************
+ * File Name:   radar_config_params.c
+ *
+ * Description: This file implements the key registry of the radar
+ *              configuration JSON objects. Every supported key of both
+ *              application modes is listed once in a table sorted by name,
+ *              together with its validator and setter, and is looked up with
+ *              an exact-match binary search.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file from system */
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cy_utils.h"
+
+/* Header file for local tasks */
+#include "publisher_task.h"
+#include "radar_config_params.h"
+#include "radar_counter.h"
+#include "radar_debounce.h"
+#include "radar_latency.h"
+#include "radar_sim.h"
+#include "radar_store.h"
+#include "radar_task.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PARAM_NAME(name) (name), (uint8_t)(sizeof(name) - 1u)
+
+#define PARAM_FLOAT(name, modes, min, max) \
+    { PARAM_NAME(name), (modes), RADAR_CONFIG_TYPE_FLOAT, (min), (max), NULL, set_library_parameter, true }
+
+#define PARAM_CHOICE(name, modes, choices) \
+    { PARAM_NAME(name), (modes), RADAR_CONFIG_TYPE_CHOICE, 0.0f, 0.0f, (choices), set_library_parameter, true }
+
+#define PARAM_COUNT(name, modes, setter, persistent) \
+    { PARAM_NAME(name), (modes), RADAR_CONFIG_TYPE_COUNT, 0.0f, 0.0f, NULL, (setter), (persistent) }
+
+/* Application setting with its own setter, kept like the library parameters */
+#define PARAM_OPTION(name, modes, choices, setter) \
+    { PARAM_NAME(name), (modes), RADAR_CONFIG_TYPE_CHOICE, 0.0f, 0.0f, (choices), (setter), true }
+
+#define PARAM_COMMAND(name, modes, choices, setter) \
+    { PARAM_NAME(name), (modes), RADAR_CONFIG_TYPE_CHOICE, 0.0f, 0.0f, (choices), (setter), false }
+
+#define RADAR_CONFIG_MODE_ALL (RADAR_CONFIG_MODE_PRESENCE | RADAR_CONFIG_MODE_COUNTER)
+
+/* Parameters owned by the library go to its simulated stand-in if enabled */
+#if RADAR_SIMULATION_ENABLE
+#define RADAR_SENSING_SET_PARAMETER radar_sim_set_parameter
+#else
+#define RADAR_SENSING_SET_PARAMETER mtb_radar_sensing_set_parameter
+#endif
+
+#ifdef RADAR_ENTRANCE_COUNTER_MODE
+#define RADAR_CONFIG_ACTIVE_MODE RADAR_CONFIG_MODE_COUNTER
+#else
+#define RADAR_CONFIG_ACTIVE_MODE RADAR_CONFIG_MODE_PRESENCE
+#endif
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static bool set_library_parameter(const radar_config_param_t *param,
+                                  mtb_radar_sensing_context_t *context,
+                                  const char *value);
+static bool set_count_in(const radar_config_param_t *param,
+                         mtb_radar_sensing_context_t *context,
+                         const char *value);
+static bool set_count_out(const radar_config_param_t *param,
+                          mtb_radar_sensing_context_t *context,
+                          const char *value);
+static bool set_debounce_dwell(const radar_config_param_t *param,
+                               mtb_radar_sensing_context_t *context,
+                               const char *value);
+static bool set_debounce_holdoff(const radar_config_param_t *param,
+                                 mtb_radar_sensing_context_t *context,
+                                 const char *value);
+static bool set_debounce_suppress(const radar_config_param_t *param,
+                                  mtb_radar_sensing_context_t *context,
+                                  const char *value);
+static bool set_diag_latency(const radar_config_param_t *param,
+                             mtb_radar_sensing_context_t *context,
+                             const char *value);
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static const char *const sensitivity_choices[] = { "low", "medium", "high", NULL };
+static const char *const installation_choices[] = { "ceiling", "side", NULL };
+static const char *const orientation_choices[] = { "portrait", "landscape", NULL };
+static const char *const bool_choices[] = { "true", "false", NULL };
+static const char *const diag_choices[] = { "report", "reset", NULL };
+
+/* Supported keys, valid values as documented in README.md. The table must stay
+ * sorted by name, radar_config_params_init() checks this at start-up. The
+ * entrance counters are kept by radar_store.c itself, commands are not kept. */
+static const radar_config_param_t radar_config_params[] =
+{
+    PARAM_FLOAT("radar_counter_ceiling_height", RADAR_CONFIG_MODE_COUNTER, 0.0f, 3.0f),
+    PARAM_FLOAT("radar_counter_entrance_width", RADAR_CONFIG_MODE_COUNTER, 0.0f, 3.0f),
+    PARAM_COUNT("radar_counter_in_number", RADAR_CONFIG_MODE_COUNTER, set_count_in, false),
+    PARAM_CHOICE("radar_counter_installation", RADAR_CONFIG_MODE_COUNTER, installation_choices),
+    PARAM_FLOAT("radar_counter_min_person_height", RADAR_CONFIG_MODE_COUNTER, 0.0f, 2.0f),
+    PARAM_CHOICE("radar_counter_orientation", RADAR_CONFIG_MODE_COUNTER, orientation_choices),
+    PARAM_COUNT("radar_counter_out_number", RADAR_CONFIG_MODE_COUNTER, set_count_out, false),
+    PARAM_CHOICE("radar_counter_reverse", RADAR_CONFIG_MODE_COUNTER, bool_choices),
+    PARAM_FLOAT("radar_counter_sensitivity", RADAR_CONFIG_MODE_COUNTER, 0.0f, 1.0f),
+    PARAM_FLOAT("radar_counter_traffic_light_zone", RADAR_CONFIG_MODE_COUNTER, 0.0f, 1.0f),
+    PARAM_COUNT("radar_debounce_dwell_ms", RADAR_CONFIG_MODE_ALL, set_debounce_dwell, true),
+    PARAM_COUNT("radar_debounce_holdoff_ms", RADAR_CONFIG_MODE_ALL, set_debounce_holdoff, true),
+    PARAM_OPTION("radar_debounce_suppress", RADAR_CONFIG_MODE_ALL, bool_choices, set_debounce_suppress),
+    PARAM_COMMAND("radar_diag_latency", RADAR_CONFIG_MODE_ALL, diag_choices, set_diag_latency),
+    PARAM_FLOAT("radar_presence_range_max", RADAR_CONFIG_MODE_PRESENCE, 0.66f, 10.2f),
+    PARAM_CHOICE("radar_presence_sensitivity", RADAR_CONFIG_MODE_PRESENCE, sensitivity_choices),
+};
+
+#define RADAR_CONFIG_PARAM_COUNT (sizeof(radar_config_params) / sizeof(radar_config_params[0]))
+
+/*******************************************************************************
+ * Function Name: compare_name
+ *******************************************************************************
+ * Summary:
+ *   Orders a length-delimited key against a table entry the same way strcmp()
+ *   would order two null terminated strings.
+ *
+ * Parameters:
+ *   name: key, not null terminated
+ *   name_length: length of the key
+ *   param: table entry
+ *
+ * Return:
+ *   <0, 0 or >0 if the key sorts before, equal to or after the entry
+ ******************************************************************************/
+static int compare_name(const char *name, size_t name_length, const radar_config_param_t *param)
+{
+    size_t common = (name_length < param->name_length) ? name_length : param->name_length;
+    int result = memcmp(name, param->name, common);
+
+    if (result == 0)
+    {
+        /* Equal up to the shorter one, a prefix sorts first */
+        result = (name_length > param->name_length) - (name_length < param->name_length);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: parse_count
+ *******************************************************************************
+ * Summary:
+ *   Parses a non-negative 32-bit decimal integer.
+ *
+ * Parameters:
+ *   value: null terminated string
+ *   count: parsed value, valid if true is returned
+ *
+ * Return:
+ *   true if the whole string is a valid count
+ ******************************************************************************/
+static bool parse_count(const char *value, int32_t *count)
+{
+    char *end;
+    long parsed;
+
+    errno = 0;
+    parsed = strtol(value, &end, 10);
+    if ((end == value) || (*end != '\0') || (errno != 0) || (parsed < 0) || (parsed > INT32_MAX))
+    {
+        return false;
+    }
+
+    *count = (int32_t)parsed;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: set_library_parameter
+ *******************************************************************************
+ * Summary:
+ *   Setter of the parameters owned by the xensiv-radar-sensing library.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true if the library accepted the value
+ ******************************************************************************/
+static bool set_library_parameter(const radar_config_param_t *param,
+                                  mtb_radar_sensing_context_t *context,
+                                  const char *value)
+{
+    return RADAR_SENSING_SET_PARAMETER(context, param->name, value) == MTB_RADAR_SENSING_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: set_count_in
+ *******************************************************************************
+ * Summary:
+ *   Setter of the entrance counter IN value.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true if the value is a valid count
+ ******************************************************************************/
+static bool set_count_in(const radar_config_param_t *param,
+                         mtb_radar_sensing_context_t *context,
+                         const char *value)
+{
+    int32_t count;
+
+    (void)param;
+    (void)context;
+
+    if (!parse_count(value, &count))
+    {
+        return false;
+    }
+
+    radar_counter_set_in((uint64_t)count);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: set_count_out
+ *******************************************************************************
+ * Summary:
+ *   Setter of the entrance counter OUT value.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true if the value is a valid count
+ ******************************************************************************/
+static bool set_count_out(const radar_config_param_t *param,
+                          mtb_radar_sensing_context_t *context,
+                          const char *value)
+{
+    int32_t count;
+
+    (void)param;
+    (void)context;
+
+    if (!parse_count(value, &count))
+    {
+        return false;
+    }
+
+    radar_counter_set_out((uint64_t)count);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: set_debounce_dwell
+ *******************************************************************************
+ * Summary:
+ *   Setter of the minimum dwell time of a new occupancy state.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true if the value is a valid count
+ ******************************************************************************/
+static bool set_debounce_dwell(const radar_config_param_t *param,
+                               mtb_radar_sensing_context_t *context,
+                               const char *value)
+{
+    int32_t dwell_ms;
+
+    (void)param;
+    (void)context;
+
+    if (!parse_count(value, &dwell_ms))
+    {
+        return false;
+    }
+
+    radar_debounce_set_dwell((uint32_t)dwell_ms);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: set_debounce_holdoff
+ *******************************************************************************
+ * Summary:
+ *   Setter of the hold-off time between two published occupancy states.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true if the value is a valid count
+ ******************************************************************************/
+static bool set_debounce_holdoff(const radar_config_param_t *param,
+                                 mtb_radar_sensing_context_t *context,
+                                 const char *value)
+{
+    int32_t holdoff_ms;
+
+    (void)param;
+    (void)context;
+
+    if (!parse_count(value, &holdoff_ms))
+    {
+        return false;
+    }
+
+    radar_debounce_set_holdoff((uint32_t)holdoff_ms);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: set_debounce_suppress
+ *******************************************************************************
+ * Summary:
+ *   Setter of the last-value suppression of occupancy updates.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true
+ ******************************************************************************/
+static bool set_debounce_suppress(const radar_config_param_t *param,
+                                  mtb_radar_sensing_context_t *context,
+                                  const char *value)
+{
+    (void)param;
+    (void)context;
+
+    radar_debounce_set_suppress(strcmp(value, "true") == 0);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: set_diag_latency
+ *******************************************************************************
+ * Summary:
+ *   Setter of the latency diagnostics command. "report" asks the publisher
+ *   task to dump the latency histograms and publish them on MQTT_DIAG_TOPIC,
+ *   "reset" clears them.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: validated value
+ *
+ * Return:
+ *   true if the command was carried out or queued
+ ******************************************************************************/
+static bool set_diag_latency(const radar_config_param_t *param,
+                             mtb_radar_sensing_context_t *context,
+                             const char *value)
+{
+    publisher_data_t publisher_q_data;
+
+    (void)param;
+    (void)context;
+
+    if (strcmp(value, "reset") == 0)
+    {
+        radar_latency_reset();
+        return true;
+    }
+
+    publisher_q_data.cmd = PUBLISH_DIAG_LATENCY;
+    return xQueueSendToBack(publisher_task_q, &publisher_q_data, 0) == pdTRUE;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_params_init
+ *******************************************************************************
+ * Summary:
+ *   Checks that the key table is strictly sorted, which the binary search in
+ *   radar_config_param_find() relies on, and that a staged set can hold every
+ *   key at once.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_config_params_init(void)
+{
+    CY_ASSERT(RADAR_CONFIG_PARAM_COUNT <= RADAR_CONFIG_STAGE_SIZE);
+
+    for (size_t i = 0; i < RADAR_CONFIG_PARAM_COUNT; i++)
+    {
+        const radar_config_param_t *param = &radar_config_params[i];
+
+        CY_ASSERT(strlen(param->name) == param->name_length);
+        if (i > 0)
+        {
+            CY_ASSERT(compare_name(param->name, param->name_length, &radar_config_params[i - 1]) > 0);
+        }
+        (void)param;
+    }
+}
+
+#if RADAR_STORE_ENABLE
+/*******************************************************************************
+ * Function Name: store_keys_are_unique
+ *******************************************************************************
+ * Summary:
+ *   Checks once that the store keys derived from the names are unique. The
+ *   keys are 15-bit CRCs, a new key name may collide with an existing one;
+ *   the values would then overwrite each other in the store, so no value is
+ *   kept or restored. Called by the radar task at boot and by the radar
+ *   config task afterwards, never at the same time.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if every persistent value can be stored
+ ******************************************************************************/
+static bool store_keys_are_unique(void)
+{
+    static bool checked = false;
+    static bool unique = true;
+
+    if (checked)
+    {
+        return unique;
+    }
+
+    for (size_t i = 0; i < RADAR_CONFIG_PARAM_COUNT; i++)
+    {
+        uint16_t key = radar_store_key(radar_config_params[i].name, radar_config_params[i].name_length);
+
+        for (size_t j = 0; j < i; j++)
+        {
+            if (key == radar_store_key(radar_config_params[j].name, radar_config_params[j].name_length))
+            {
+                printf("Store: keys '%s' and '%s' have the same store key 0x%04x, settings are not kept\n",
+                       radar_config_params[j].name, radar_config_params[i].name, (unsigned)key);
+                unique = false;
+            }
+        }
+    }
+    checked = true;
+
+    return unique;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_params_restore
+ *******************************************************************************
+ * Summary:
+ *   Applies the values of the persistent keys kept by radar_store.c. Stored
+ *   values are validated again, so a value that became invalid with a new
+ *   firmware keeps the default.
+ *
+ * Parameters:
+ *   context: radar sensing context, not yet enabled
+ *
+ * Return:
+ *   number of values applied
+ ******************************************************************************/
+uint32_t radar_config_params_restore(mtb_radar_sensing_context_t *context)
+{
+    char value[RADAR_CONFIG_VALUE_LENGTH];
+    uint32_t restored = 0;
+
+    if (!store_keys_are_unique())
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < RADAR_CONFIG_PARAM_COUNT; i++)
+    {
+        const radar_config_param_t *param = &radar_config_params[i];
+        uint16_t key = radar_store_key(param->name, param->name_length);
+
+        if (!param->persistent || !radar_config_param_is_active(param) ||
+            !radar_store_get(key, value, sizeof(value)))
+        {
+            continue;
+        }
+
+        if (radar_config_param_validate(param, value) && radar_config_param_apply(param, context, value))
+        {
+            restored++;
+        }
+        else
+        {
+            printf("Store: stored value '%s' of '%s' rejected\n", value, param->name);
+        }
+    }
+
+    return restored;
+}
+#endif
+
+/*******************************************************************************
+ * Function Name: radar_config_param_find
+ *******************************************************************************
+ * Summary:
+ *   Looks up a JSON key in the registry. Only an exact match of the whole key
+ *   is returned, prefixes or keys with trailing characters are not.
+ *
+ * Parameters:
+ *   name: key, not null terminated
+ *   name_length: length of the key
+ *
+ * Return:
+ *   table entry, or NULL if the key is unknown
+ ******************************************************************************/
+const radar_config_param_t *radar_config_param_find(const char *name, size_t name_length)
+{
+    size_t low = 0;
+    size_t high = RADAR_CONFIG_PARAM_COUNT;
+
+    while (low < high)
+    {
+        size_t mid = low + ((high - low) / 2u);
+        int result = compare_name(name, name_length, &radar_config_params[mid]);
+
+        if (result == 0)
+        {
+            return &radar_config_params[mid];
+        }
+        else if (result < 0)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1u;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_param_is_active
+ *******************************************************************************
+ * Summary:
+ *   Tells if a parameter belongs to the application mode selected at compile
+ *   time (RADAR_ENTRANCE_COUNTER_MODE).
+ *
+ * Parameters:
+ *   param: table entry
+ *
+ * Return:
+ *   true if the parameter can be set in the current mode
+ ******************************************************************************/
+bool radar_config_param_is_active(const radar_config_param_t *param)
+{
+    return (param->modes & RADAR_CONFIG_ACTIVE_MODE) != 0u;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_param_validate
+ *******************************************************************************
+ * Summary:
+ *   Checks a value against the type and valid range of a parameter. Does not
+ *   touch the radar sensing context, so no lock is required.
+ *
+ * Parameters:
+ *   param: table entry
+ *   value: null terminated value string
+ *
+ * Return:
+ *   true if the value is valid for the parameter
+ ******************************************************************************/
+bool radar_config_param_validate(const radar_config_param_t *param, const char *value)
+{
+    bool valid = false;
+
+    switch (param->type)
+    {
+        case RADAR_CONFIG_TYPE_FLOAT:
+        {
+            char *end;
+            float parsed = strtof(value, &end);
+
+            valid = (end != value) && (*end == '\0') && (parsed >= param->min) && (parsed <= param->max);
+            break;
+        }
+
+        case RADAR_CONFIG_TYPE_CHOICE:
+            for (const char *const *choice = param->choices; *choice != NULL; choice++)
+            {
+                if (strcmp(value, *choice) == 0)
+                {
+                    valid = true;
+                    break;
+                }
+            }
+            break;
+
+        case RADAR_CONFIG_TYPE_COUNT:
+        {
+            int32_t count;
+
+            valid = parse_count(value, &count);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return valid;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_param_apply
+ *******************************************************************************
+ * Summary:
+ *   Sets a validated value. The caller must hold sem_radar_sensing_context.
+ *
+ * Parameters:
+ *   param: table entry
+ *   context: radar sensing context
+ *   value: null terminated value string
+ *
+ * Return:
+ *   true if the value was applied
+ ******************************************************************************/
+bool radar_config_param_apply(const radar_config_param_t *param,
+                              mtb_radar_sensing_context_t *context,
+                              const char *value)
+{
+    return param->set(param, context, value);
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_stage_reset
+ *******************************************************************************
+ * Summary:
+ *   Empties a staged parameter set.
+ *
+ * Parameters:
+ *   stage: staged parameter set
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_config_stage_reset(radar_config_stage_t *stage)
+{
+    stage->count = 0;
+    stage->rejected = false;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_stage_add
+ *******************************************************************************
+ * Summary:
+ *   Adds a validated value to a staged parameter set. A key given more than
+ *   once keeps its last value, as if the values had been applied in order.
+ *
+ * Parameters:
+ *   stage: staged parameter set
+ *   param: table entry
+ *   value: null terminated value string, already validated
+ *
+ * Return:
+ *   true if the value was staged
+ ******************************************************************************/
+bool radar_config_stage_add(radar_config_stage_t *stage,
+                            const radar_config_param_t *param,
+                            const char *value)
+{
+    radar_config_staged_t *entry = NULL;
+
+    for (uint32_t i = 0; i < stage->count; i++)
+    {
+        if (stage->entries[i].param == param)
+        {
+            entry = &stage->entries[i];
+            break;
+        }
+    }
+
+    if (entry == NULL)
+    {
+        if (stage->count >= RADAR_CONFIG_STAGE_SIZE)
+        {
+            return false;
+        }
+        entry = &stage->entries[stage->count++];
+        entry->param = param;
+    }
+
+    strncpy(entry->value, value, sizeof(entry->value) - 1u);
+    entry->value[sizeof(entry->value) - 1u] = '\0';
+    entry->applied = false;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_config_stage_commit
+ *******************************************************************************
+ * Summary:
+ *   Applies every staged value. The caller must hold sem_radar_sensing_context
+ *   so that the radar task never processes a partially applied set. Nothing is
+ *   parsed or validated here, to keep the lock hold time short.
+ *
+ * Parameters:
+ *   stage: staged parameter set, 'applied' is updated per entry
+ *   context: radar sensing context
+ *
+ * Return:
+ *   number of values that could not be applied
+ ******************************************************************************/
+uint32_t radar_config_stage_commit(radar_config_stage_t *stage, mtb_radar_sensing_context_t *context)
+{
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < stage->count; i++)
+    {
+        radar_config_staged_t *entry = &stage->entries[i];
+
+        entry->applied = radar_config_param_apply(entry->param, context, entry->value);
+        if (!entry->applied)
+        {
+            failed++;
+        }
+#if RADAR_STORE_ENABLE
+        else if (entry->param->persistent && store_keys_are_unique())
+        {
+            radar_store_put(radar_store_key(entry->param->name, entry->param->name_length), entry->value);
+        }
+#endif
+    }
+
+#if RADAR_STORE_ENABLE
+    /* Also picks up entrance counters set by this message */
+    radar_store_notify();
+#endif
+
+    return failed;
+}
+
+/* [] END OF FILE */
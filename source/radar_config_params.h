@@ -0,0 +1,117 @@
+/******************************************************************************
+ * File Name:   radar_config_params.h
+ *
+ * Description: This file contains the key registry of the radar configuration
+ *   JSON objects used by radar_config_task.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mtb_radar_sensing.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Application modes a parameter applies to */
+#define RADAR_CONFIG_MODE_PRESENCE (1u << 0)
+#define RADAR_CONFIG_MODE_COUNTER  (1u << 1)
+
+/* Longest accepted value string, including the terminating null */
+#define RADAR_CONFIG_VALUE_LENGTH (32u)
+
+/* Number of distinct parameters a staged set can hold, one per registry key */
+#define RADAR_CONFIG_STAGE_SIZE (16u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Value type of a parameter, selects the validator */
+typedef enum
+{
+    RADAR_CONFIG_TYPE_FLOAT,    /* Decimal number within [min, max] */
+    RADAR_CONFIG_TYPE_CHOICE,   /* One of a null terminated list of strings, also used for commands */
+    RADAR_CONFIG_TYPE_COUNT     /* Non-negative 32-bit integer */
+} radar_config_type_t;
+
+typedef struct radar_config_param radar_config_param_t;
+
+/* Applies an already validated value */
+typedef bool (*radar_config_setter_t)(const radar_config_param_t *param,
+                                      mtb_radar_sensing_context_t *context,
+                                      const char *value);
+
+/* One entry of the key registry */
+struct radar_config_param
+{
+    const char *name;                   /* JSON key */
+    uint8_t name_length;                /* strlen(name) */
+    uint8_t modes;                      /* RADAR_CONFIG_MODE_* mask */
+    radar_config_type_t type;
+    float min;                          /* RADAR_CONFIG_TYPE_FLOAT only */
+    float max;                          /* RADAR_CONFIG_TYPE_FLOAT only */
+    const char *const *choices;         /* RADAR_CONFIG_TYPE_CHOICE only */
+    radar_config_setter_t set;
+    bool persistent;                    /* Kept in flash and restored at boot */
+};
+
+/* Validated value waiting to be committed */
+typedef struct
+{
+    const radar_config_param_t *param;
+    char value[RADAR_CONFIG_VALUE_LENGTH];
+    bool applied;                       /* Result of the last commit */
+} radar_config_staged_t;
+
+/* Parameter set collected from one configuration message. It is filled
+ * without holding sem_radar_sensing_context and committed in one go. */
+typedef struct
+{
+    uint32_t count;
+    bool rejected;                      /* An entry failed lookup or validation */
+    radar_config_staged_t entries[RADAR_CONFIG_STAGE_SIZE];
+} radar_config_stage_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void radar_config_params_init(void);
+uint32_t radar_config_params_restore(mtb_radar_sensing_context_t *context);
+
+const radar_config_param_t *radar_config_param_find(const char *name, size_t name_length);
+bool radar_config_param_is_active(const radar_config_param_t *param);
+bool radar_config_param_validate(const radar_config_param_t *param, const char *value);
+bool radar_config_param_apply(const radar_config_param_t *param,
+                              mtb_radar_sensing_context_t *context,
+                              const char *value);
+
+void radar_config_stage_reset(radar_config_stage_t *stage);
+bool radar_config_stage_add(radar_config_stage_t *stage,
+                            const radar_config_param_t *param,
+                            const char *value);
+uint32_t radar_config_stage_commit(radar_config_stage_t *stage, mtb_radar_sensing_context_t *context);
+
+/* [] END OF FILE */
@@ -35,7 +35,9 @@
 #include "cy_json_parser.h"
 
 /* Header file for local tasks */
+#include "app_boot.h"
 #include "publisher_task.h"
+#include "radar_config_params.h"
 #include "radar_config_task.h"
 #include "radar_task.h"
 #include "subscriber_task.h"
@@ -45,31 +47,40 @@
  ******************************************************************************/
 TaskHandle_t radar_config_task_handle = NULL;
 
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Parameters of the configuration message being received */
+static radar_config_stage_t config_stage;
+
 /*******************************************************************************
  * Function Name: json_parser_cb
  *******************************************************************************
  * Summary:
- *   Callback function that parses incoming json string.
+ *   Callback function that parses incoming json string. Values are only
+ *   validated and staged here, they are applied once the whole message has
+ *   been parsed.
  *
  * Parameters:
  *      json_object: incoming json object
- *      arg: callback data. Here it should be the context of
- *           mtb_radar_sensing_context_t.
+ *      arg: callback data. Here it should be the staged parameter set of
+ *           radar_config_stage_t.
  *
  * Return:
  *   none
  ******************************************************************************/
 static cy_rslt_t json_parser_cb(cy_JSON_object_t *json_object, void *arg)
 {
-    #define JSON_VALUE_LENGTH 32
-    mtb_radar_sensing_context_t *context = (mtb_radar_sensing_context_t *)arg;
+    radar_config_stage_t *stage = (radar_config_stage_t *)arg;
+    const radar_config_param_t *param;
 
     bool bad_entry = false;
     bool not_success = false;
-    char json_value[JSON_VALUE_LENGTH];
+    char json_value[RADAR_CONFIG_VALUE_LENGTH];
 
-    if (json_object->value_length >= JSON_VALUE_LENGTH)
+    if (json_object->value_length >= RADAR_CONFIG_VALUE_LENGTH)
     {
+        stage->rejected = true;
         return CY_RSLT_JSON_GENERIC_ERROR;
     }
     memcpy(json_value, json_object->value, json_object->value_length);
@@ -78,106 +89,18 @@ static cy_rslt_t json_parser_cb(cy_JSON_object_t *json_object, void *arg)
     publisher_data_t publisher_q_data;
     publisher_q_data.cmd = PUBLISH_MQTT_MSG;
 
-#ifdef RADAR_ENTRANCE_COUNTER_MODE
-    /* Supported keys and values for entrance counter */
-    if (memcmp(json_object->object_string, "radar_counter_installation", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_installation", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_orientation", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_orientation", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_ceiling_height", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_ceiling_height", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_entrance_width", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_entrance_width", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_sensitivity", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_sensitivity", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string,
-                    "radar_counter_traffic_light_zone",
-                    json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_traffic_light_zone", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_reverse", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_reverse", json_value) != MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_min_person_height", json_object->object_string_length) ==
-             0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_counter_min_person_height", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_in_number", json_object->object_string_length) == 0)
-    {
-        entrance_count_in = atoi(json_value);
-    }
-    else if (memcmp(json_object->object_string, "radar_counter_out_number", json_object->object_string_length) == 0)
-    {
-        entrance_count_out = atoi(json_value);
-    }
-#else
-    /* Supported keys and values for presence detection */
-    if (memcmp(json_object->object_string, "radar_presence_range_max", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_presence_range_max", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-    else if (memcmp(json_object->object_string, "radar_presence_sensitivity", json_object->object_string_length) == 0)
-    {
-        if (mtb_radar_sensing_set_parameter(context, "radar_presence_sensitivity", json_value) !=
-            MTB_RADAR_SENSING_SUCCESS)
-        {
-            not_success = true;
-        }
-    }
-#endif
-    else
+    /* Keys of the other application mode are not supported either */
+    param = radar_config_param_find(json_object->object_string, json_object->object_string_length);
+    if ((param == NULL) || !radar_config_param_is_active(param))
     {
         /* Invalid input json key */
         bad_entry = true;
     }
+    else if (!radar_config_param_validate(param, json_value) ||
+             !radar_config_stage_add(stage, param, json_value))
+    {
+        not_success = true;
+    }
 
     if (bad_entry)
     {
@@ -197,27 +120,87 @@ static cy_rslt_t json_parser_cb(cy_JSON_object_t *json_object, void *arg)
     }
     else
     {
-        snprintf(publisher_q_data.data,
-                 sizeof(publisher_q_data.data),
-                 "Config => %.*s: %.*s",
-                 json_object->object_string_length,
-                 json_object->object_string,
-                 json_object->value_length,
-                 json_object->value);
+        /* Result is reported after the commit */
+        return CY_RSLT_SUCCESS;
     }
 
+    /* Nothing of this message is applied if one entry is wrong */
+    stage->rejected = true;
+
     /* Send message back to publish queue. */
     xQueueSendToBack(publisher_task_q, &publisher_q_data, 0);
 
     return bad_entry ? CY_RSLT_JSON_GENERIC_ERROR : CY_RSLT_SUCCESS;
 }
 
+/*******************************************************************************
+ * Function Name: commit_stage
+ *******************************************************************************
+ * Summary:
+ *   Applies a complete staged parameter set while holding the radar sensing
+ *   context once, then reports the result of every entry.
+ *
+ * Parameters:
+ *   stage: staged parameter set
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void commit_stage(radar_config_stage_t *stage)
+{
+    publisher_data_t publisher_q_data;
+    radar_lock_stats_t lock_stats;
+    uint32_t failed;
+
+    /* Only the prepared values are applied under the lock */
+    if (!radar_sensing_context_lock())
+    {
+        return;
+    }
+    failed = radar_config_stage_commit(stage, &radar_sensing_context);
+    radar_sensing_context_unlock();
+
+    radar_task_get_lock_stats(&lock_stats);
+    printf("radar_config_task: %lu value(s) committed, %lu failed, max lock hold %lu ms, missed deadlines %lu\n",
+           (unsigned long)stage->count,
+           (unsigned long)failed,
+           (unsigned long)lock_stats.max_hold_ms,
+           (unsigned long)lock_stats.missed_deadlines);
+
+    publisher_q_data.cmd = PUBLISH_MQTT_MSG;
+    for (uint32_t i = 0; i < stage->count; i++)
+    {
+        const radar_config_staged_t *entry = &stage->entries[i];
+
+        if (entry->applied)
+        {
+            snprintf(publisher_q_data.data,
+                     sizeof(publisher_q_data.data),
+                     "Config => %s: %s",
+                     entry->param->name,
+                     entry->value);
+        }
+        else
+        {
+            snprintf(publisher_q_data.data,
+                     sizeof(publisher_q_data.data),
+                     "%s: configuration failed.",
+                     entry->param->name);
+        }
+
+        /* Send message back to publish queue. */
+        xQueueSendToBack(publisher_task_q, &publisher_q_data, 0);
+    }
+}
+
 /*******************************************************************************
  * Function Name: radar_config_task
  *******************************************************************************
  * Summary:
  *      Parse incoming json string, and set new configuration to
- *      xensiv-radar-sensing library.
+ *      xensiv-radar-sensing library. A message is parsed and validated
+ *      without holding the radar sensing context, and applied in one step
+ *      after its last fragment.
  *
  * Parameters:
  *   pvParameters: thread
@@ -228,32 +211,64 @@ static cy_rslt_t json_parser_cb(cy_JSON_object_t *json_object, void *arg)
 void radar_config_task(void *pvParameters)
 {
     cy_rslt_t result;
+    sub_payload_slot_t *slot;
+    uint8_t next_fragment = 0;
 
     /* To avoid compiler warnings */
     (void)pvParameters;
 
+    radar_config_params_init();
+    radar_config_stage_reset(&config_stage);
+
     /* Register JSON parser to parse input configuration JSON string */
-    cy_JSON_parser_register_callback(json_parser_cb, (void *)&radar_sensing_context);
+    cy_JSON_parser_register_callback(json_parser_cb, (void *)&config_stage);
+
+    /* The payload queue exists once the subscriber task subscribed, and
+     * replies go to the publisher queue.
+     */
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_SUBSCRIBED) | APP_BOOT_BIT(APP_BOOT_PUBLISHER_READY), portMAX_DELAY);
 
     while (true)
     {
-        /* Block till a notification is received from the subscriber task. */
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-
-        /* Get mutex to block any other json parse jobs */
-        if (xSemaphoreTake(sem_sub_payload, portMAX_DELAY) == pdTRUE)
+        /* Block till a payload is handed over by the subscription callback. */
+        if (xQueueReceive(sub_payload_q, &slot, portMAX_DELAY) == pdTRUE)
         {
-            /* Get mutex to block mtb_radar_sensing_process in radar task */
-            if (xSemaphoreTake(sem_radar_sensing_context, portMAX_DELAY) == pdTRUE)
+            /* A new message starts with fragment 0 */
+            if (slot->fragment == 0)
+            {
+                radar_config_stage_reset(&config_stage);
+                next_fragment = 0;
+            }
+            if (slot->fragment != next_fragment)
+            {
+                /* A fragment was dropped, the message is incomplete */
+                config_stage.rejected = true;
+            }
+            next_fragment = slot->fragment + 1u;
+
+            /* The slot holds the only copy of the payload, exactly 'length'
+             * bytes; it is parsed there and released afterwards */
+            result = cy_JSON_parser(slot->data, slot->length);
+            if (result != CY_RSLT_SUCCESS)
             {
-                result = cy_JSON_parser(sub_msg_payload, strlen(sub_msg_payload));
-                if (result != CY_RSLT_SUCCESS)
+                printf("radar_config_task: json parser error!\n");
+                config_stage.rejected = true;
+            }
+
+            if (slot->last_fragment)
+            {
+                if (config_stage.rejected)
+                {
+                    printf("radar_config_task: configuration rejected, nothing applied\n");
+                }
+                else if (config_stage.count > 0)
                 {
-                    printf("radar_config_task: json parser error!\n");
+                    commit_stage(&config_stage);
                 }
-                xSemaphoreGive(sem_radar_sensing_context);
+                radar_config_stage_reset(&config_stage);
+                next_fragment = 0;
             }
-            xSemaphoreGive(sem_sub_payload);
+            subscriber_payload_release(slot);
         }
     }
 }
@@ -0,0 +1,252 @@
+/******************************************************************************
+ * File Name:   radar_counter.c
+ *
+ * Description: This file implements the entrance counters. The radar task
+ *   increments them and the radar configuration task overwrites them; the
+ *   publisher and the diagnostics read them. The 64-bit totals are written
+ *   and read in short critical sections, so a reader always sees both totals
+ *   of a single update.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_counter.h"
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Written and read in critical sections only: 64-bit accesses are not atomic
+ * on the Cortex-M4 */
+static uint32_t counter_seq = 0;
+static uint64_t counter_in = 0;
+static uint64_t counter_out = 0;
+
+/*******************************************************************************
+ * Function Name: write_begin
+ *******************************************************************************
+ * Summary:
+ *   Starts an update. Readers wait in their critical section until it is
+ *   complete.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void write_begin(void)
+{
+    taskENTER_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: write_end
+ *******************************************************************************
+ * Summary:
+ *   Completes an update started with write_begin().
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void write_end(void)
+{
+    counter_seq++;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_add_in
+ *******************************************************************************
+ * Summary:
+ *   Counts a person walking in.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_counter_add_in(void)
+{
+    write_begin();
+    counter_in++;
+    write_end();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_add_out
+ *******************************************************************************
+ * Summary:
+ *   Counts a person walking out.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_counter_add_out(void)
+{
+    write_begin();
+    counter_out++;
+    write_end();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_set_in
+ *******************************************************************************
+ * Summary:
+ *   Overwrites the IN total, e.g. from the radar_counter_in_number key.
+ *
+ * Parameters:
+ *   value: new total
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_counter_set_in(uint64_t value)
+{
+    write_begin();
+    counter_in = value;
+    write_end();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_set_out
+ *******************************************************************************
+ * Summary:
+ *   Overwrites the OUT total, e.g. from the radar_counter_out_number key.
+ *
+ * Parameters:
+ *   value: new total
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_counter_set_out(uint64_t value)
+{
+    write_begin();
+    counter_out = value;
+    write_end();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_reset
+ *******************************************************************************
+ * Summary:
+ *   Clears both totals in one update, so no reader sees only one of them
+ *   cleared.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_counter_reset(void)
+{
+    write_begin();
+    counter_in = 0;
+    counter_out = 0;
+    write_end();
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_get_snapshot
+ *******************************************************************************
+ * Summary:
+ *   Copies the totals of one update in a critical section. Can be called from
+ *   a task or from an interrupt at or below
+ *   configMAX_SYSCALL_INTERRUPT_PRIORITY; a higher priority interrupt is not
+ *   masked by the writers and could read a torn total.
+ *
+ * Parameters:
+ *   snapshot: destination of the totals
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_counter_get_snapshot(radar_counter_snapshot_t *snapshot)
+{
+    UBaseType_t state;
+    uint64_t in;
+    uint64_t out;
+    uint32_t seq;
+
+    state = taskENTER_CRITICAL_FROM_ISR();
+    in = counter_in;
+    out = counter_out;
+    seq = counter_seq;
+    taskEXIT_CRITICAL_FROM_ISR(state);
+
+    snapshot->in = in;
+    snapshot->out = out;
+    snapshot->occupancy = (in > out) ? (in - out) : 0u;
+    snapshot->seq = seq;
+}
+
+/*******************************************************************************
+ * Function Name: radar_counter_format_u64
+ *******************************************************************************
+ * Summary:
+ *   Formats a 64-bit total in decimal. The newlib-nano printf() family does
+ *   not support %llu.
+ *
+ * Parameters:
+ *   value: number to format
+ *   buffer: destination of the NUL-terminated string
+ *   buffer_size: size of the buffer, RADAR_COUNTER_U64_LENGTH fits any value
+ *
+ * Return:
+ *   length of the string, 0 if the buffer is too small
+ ******************************************************************************/
+size_t radar_counter_format_u64(uint64_t value, char *buffer, size_t buffer_size)
+{
+    char digits[RADAR_COUNTER_U64_LENGTH];
+    size_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10u));
+        value /= 10u;
+    } while (value != 0u);
+
+    if (count >= buffer_size)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        buffer[i] = digits[count - 1u - i];
+    }
+    buffer[count] = '\0';
+
+    return count;
+}
+
+/* [] END OF FILE */
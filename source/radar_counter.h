@@ -0,0 +1,67 @@
+/******************************************************************************
+ * File Name:   radar_counter.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_counter.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Buffer size for radar_counter_format_u64(), 20 digits and the NUL */
+#define RADAR_COUNTER_U64_LENGTH (21u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Consistent copy of the entrance counters */
+typedef struct
+{
+    uint64_t in;                /* People that walked in */
+    uint64_t out;               /* People that walked out */
+    uint64_t occupancy;         /* in - out, 0 if more walked out than in */
+    uint32_t seq;               /* Number of updates so far, changes with every update */
+} radar_counter_snapshot_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Writers, from any task */
+void radar_counter_add_in(void);
+void radar_counter_add_out(void);
+void radar_counter_set_in(uint64_t value);
+void radar_counter_set_out(uint64_t value);
+void radar_counter_reset(void);
+
+/* Reader, from any task or from an interrupt at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY */
+void radar_counter_get_snapshot(radar_counter_snapshot_t *snapshot);
+
+size_t radar_counter_format_u64(uint64_t value, char *buffer, size_t buffer_size);
+
+/* [] END OF FILE */
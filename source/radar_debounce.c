@@ -0,0 +1,272 @@
+/******************************************************************************
+ * File Name:   radar_debounce.c
+ *
+ * Description: This file implements the debounce stage of the occupancy
+ *   updates (presence IN/OUT, counter OCCUPIED/FREE) between the radar sensing
+ *   callback and the publisher. A new state is published once it lasted the
+ *   minimum dwell time and the hold-off since the last published state
+ *   expired. Changes that revert earlier and repeats of the published state
+ *   are suppressed and counted. Entrance counter IN/OUT events pass through.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mtb_radar_sensing.h"
+#include "radar_debounce.h"
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static uint32_t dwell_ms = RADAR_DEBOUNCE_DWELL_MS;
+static uint32_t holdoff_ms = RADAR_DEBOUNCE_HOLDOFF_MS;
+static bool suppress_repeats = RADAR_DEBOUNCE_SUPPRESS;
+
+/* Last published occupancy state */
+static bool published = false;
+static uint8_t published_state;
+static uint32_t published_ms;
+
+/* Latest update of a state change waiting for its dwell time or hold-off */
+static bool pending = false;
+static radar_event_record_t pending_record;
+static uint32_t pending_since_ms;
+
+static radar_debounce_stats_t debounce_stats;
+
+/*******************************************************************************
+ * Function Name: is_occupancy_event
+ *******************************************************************************
+ * Summary:
+ *   Tells whether an event reports the occupancy state.
+ *
+ * Parameters:
+ *   event: mtb_radar_sensing_event_t of the record
+ *
+ * Return:
+ *   true for presence IN/OUT and counter OCCUPIED/FREE
+ ******************************************************************************/
+static bool is_occupancy_event(uint8_t event)
+{
+    return (event == MTB_RADAR_SENSING_EVENT_PRESENCE_IN) ||
+           (event == MTB_RADAR_SENSING_EVENT_PRESENCE_OUT) ||
+           (event == MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED) ||
+           (event == MTB_RADAR_SENSING_EVENT_COUNTER_FREE);
+}
+
+/*******************************************************************************
+ * Function Name: release_pending
+ *******************************************************************************
+ * Summary:
+ *   Publishes the pending state if its dwell time and the hold-off are over.
+ *
+ * Parameters:
+ *   now_ms: current tick time in ms
+ *   out: receives the record to publish
+ *
+ * Return:
+ *   true if 'out' is to be published
+ ******************************************************************************/
+static bool release_pending(uint32_t now_ms, radar_event_record_t *out)
+{
+    if (!pending || ((now_ms - pending_since_ms) < dwell_ms) ||
+        (published && ((now_ms - published_ms) < holdoff_ms)))
+    {
+        return false;
+    }
+
+    *out = pending_record;
+    pending = false;
+    published = true;
+    published_state = out->occupy_status;
+    published_ms = now_ms;
+
+    taskENTER_CRITICAL();
+    debounce_stats.published++;
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_debounce_offer
+ *******************************************************************************
+ * Summary:
+ *   Passes an event through the debounce stage.
+ *
+ * Parameters:
+ *   record: event from the radar sensing callback
+ *   now_ms: current tick time in ms
+ *   out: receives the record to publish, may be an earlier update
+ *
+ * Return:
+ *   true if 'out' is to be published now
+ ******************************************************************************/
+bool radar_debounce_offer(const radar_event_record_t *record, uint32_t now_ms, radar_event_record_t *out)
+{
+    if (!is_occupancy_event(record->event))
+    {
+        *out = *record;
+        return true;
+    }
+
+    taskENTER_CRITICAL();
+    debounce_stats.offered++;
+    taskEXIT_CRITICAL();
+
+    if (pending && (record->occupy_status == pending_record.occupy_status))
+    {
+        /* Same change again, keep its start time and the latest data */
+        pending_record = *record;
+        taskENTER_CRITICAL();
+        debounce_stats.repeats++;
+        taskEXIT_CRITICAL();
+    }
+    else if (published && (record->occupy_status == published_state))
+    {
+        if (pending)
+        {
+            /* The change reverted before it was published */
+            pending = false;
+            taskENTER_CRITICAL();
+            debounce_stats.flaps++;
+            taskEXIT_CRITICAL();
+        }
+
+        if (suppress_repeats)
+        {
+            taskENTER_CRITICAL();
+            debounce_stats.repeats++;
+            taskEXIT_CRITICAL();
+            return false;
+        }
+
+        /* Repeats are wanted, they do not change the published state */
+        *out = *record;
+        taskENTER_CRITICAL();
+        debounce_stats.published++;
+        taskEXIT_CRITICAL();
+        return true;
+    }
+    else
+    {
+        pending = true;
+        pending_record = *record;
+        pending_since_ms = now_ms;
+    }
+
+    return release_pending(now_ms, out);
+}
+
+/*******************************************************************************
+ * Function Name: radar_debounce_poll
+ *******************************************************************************
+ * Summary:
+ *   Publishes a pending state change once it is due. Called on every wake-up
+ *   of the radar task, so the delay is at most RADAR_IRQ_IDLE_TIMEOUT_MS
+ *   beyond the dwell time or hold-off.
+ *
+ * Parameters:
+ *   now_ms: current tick time in ms
+ *   out: receives the record to publish
+ *
+ * Return:
+ *   true if 'out' is to be published
+ ******************************************************************************/
+bool radar_debounce_poll(uint32_t now_ms, radar_event_record_t *out)
+{
+    return release_pending(now_ms, out);
+}
+
+/*******************************************************************************
+ * Function Name: radar_debounce_set_dwell
+ *******************************************************************************
+ * Summary:
+ *   Sets the minimum dwell time of a new occupancy state.
+ *
+ * Parameters:
+ *   dwell: time in ms, 0 publishes changes without delay
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_debounce_set_dwell(uint32_t dwell)
+{
+    dwell_ms = dwell;
+}
+
+/*******************************************************************************
+ * Function Name: radar_debounce_set_holdoff
+ *******************************************************************************
+ * Summary:
+ *   Sets the hold-off time between two published occupancy states.
+ *
+ * Parameters:
+ *   holdoff: time in ms, 0 disables the hold-off
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_debounce_set_holdoff(uint32_t holdoff)
+{
+    holdoff_ms = holdoff;
+}
+
+/*******************************************************************************
+ * Function Name: radar_debounce_set_suppress
+ *******************************************************************************
+ * Summary:
+ *   Enables or disables the last-value suppression.
+ *
+ * Parameters:
+ *   suppress: true to drop updates repeating the published state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_debounce_set_suppress(bool suppress)
+{
+    suppress_repeats = suppress;
+}
+
+/*******************************************************************************
+ * Function Name: radar_debounce_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the debounce counters. The suppressed updates are
+ *   'offered' minus 'published'.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_debounce_get_stats(radar_debounce_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = debounce_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * File Name:   radar_debounce.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_debounce.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_event_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The defaults publish every occupancy update as it arrives, like before the
+ * debounce stage existed; the radar_debounce_* configuration keys turn it on.
+ */
+
+/* Default time in milliseconds a new occupancy state must last before it is
+ * published. A state that reverts earlier is never published. */
+#define RADAR_DEBOUNCE_DWELL_MS    (0u)
+
+/* Default shortest time in milliseconds between two published occupancy
+ * states. A change within the hold-off is published when it expires, if it
+ * still differs from the last published state. */
+#define RADAR_DEBOUNCE_HOLDOFF_MS  (0u)
+
+/* Default of the last-value suppression: an update repeating the published
+ * occupancy state is not published. */
+#define RADAR_DEBOUNCE_SUPPRESS    (false)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the debounce stage */
+typedef struct
+{
+    uint32_t offered;           /* Occupancy updates received from the library */
+    uint32_t published;         /* Occupancy updates passed to the publisher */
+    uint32_t repeats;           /* Updates equal to the published or pending state */
+    uint32_t flaps;             /* Pending changes that reverted within dwell or hold-off */
+} radar_debounce_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Called from the radar task only, with sem_radar_sensing_context held */
+bool radar_debounce_offer(const radar_event_record_t *record, uint32_t now_ms, radar_event_record_t *out);
+bool radar_debounce_poll(uint32_t now_ms, radar_event_record_t *out);
+
+/* Called from the radar config task with sem_radar_sensing_context held */
+void radar_debounce_set_dwell(uint32_t dwell);
+void radar_debounce_set_holdoff(uint32_t holdoff);
+void radar_debounce_set_suppress(bool suppress);
+
+void radar_debounce_get_stats(radar_debounce_stats_t *stats);
+
+/* [] END OF FILE */
@@ -0,0 +1,443 @@
+/******************************************************************************
+ * File Name:   radar_diag.c
+ *
+ * Description: This file implements the status record published periodically
+ *              on the diagnostics topic: per task CPU load and stack high
+ *              water mark, the smallest heap headroom seen so far and, with
+ *              MEM_POOL_ENABLE, the high water marks of the memory pools.
+ *              The FreeRTOS run time counter is driven by a free running
+ *              hardware timer started here.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+
+#include "cyhal.h"
+#include "cybsp.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "app_memory.h"
+#include "low_power.h"
+#include "mem_pool.h"
+#include "radar_diag.h"
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Free running counter of the run time statistics */
+static cyhal_timer_t diag_timer;
+/* Set if the hardware timer is running, the tick count is used otherwise */
+static bool diag_timer_running = false;
+
+/* Periodic trigger of the status record */
+static TimerHandle_t diag_period_timer;
+#if STATIC_ALLOCATION_ENABLE
+static StaticTimer_t diag_period_timer_buffer;
+#endif
+static void (*diag_due)(void);
+
+/* Task states of the last record, the run time is compared by task number */
+static TaskStatus_t task_status[RADAR_DIAG_MAX_TASKS];
+static UBaseType_t last_task_numbers[RADAR_DIAG_MAX_TASKS];
+static uint32_t last_task_run_time[RADAR_DIAG_MAX_TASKS];
+static UBaseType_t last_task_count = 0;
+static uint32_t last_total_run_time = 0;
+
+static radar_diag_stats_t diag_stats;
+
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+/* Heap region of the GCC linker script, used by malloc() and heap_3 */
+extern uint8_t __HeapBase;
+extern uint8_t __HeapLimit;
+#endif
+
+/*******************************************************************************
+ * Function Name: radar_diag_timer_init
+ *******************************************************************************
+ * Summary:
+ *   Starts the free running timer of the run time statistics. Called by the
+ *   scheduler through portCONFIGURE_TIMER_FOR_RUN_TIME_STATS(). If no 32-bit
+ *   timer is available, the run time counter falls back to the tick count.
+ *   The TCPWM is clocked by the peripheral clock, which stops in Deep Sleep:
+ *   the counter and thus the CPU loads only cover the time the CPU is awake
+ *   or in CPU Sleep. The Deep Sleep time is reported separately as "deep_s".
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_diag_timer_init(void)
+{
+    const cyhal_timer_cfg_t diag_timer_cfg =
+    {
+        .compare_value = 0,                 /* Timer compare value, not used */
+        .period = UINT32_MAX,               /* Wrap at the full 32-bit range */
+        .direction = CYHAL_TIMER_DIR_UP,    /* Timer counts up */
+        .is_compare = false,                /* Don't use compare mode */
+        .is_continuous = true,              /* Run timer indefinitely */
+        .value = 0                          /* Initial value of counter */
+    };
+
+    if ((cyhal_timer_init(&diag_timer, NC, NULL) == CY_RSLT_SUCCESS) &&
+        (cyhal_timer_configure(&diag_timer, &diag_timer_cfg) == CY_RSLT_SUCCESS) &&
+        (cyhal_timer_set_frequency(&diag_timer, RADAR_DIAG_TIMER_HZ) == CY_RSLT_SUCCESS) &&
+        (cyhal_timer_start(&diag_timer) == CY_RSLT_SUCCESS))
+    {
+        diag_timer_running = true;
+    }
+    else
+    {
+        printf("Diagnostics: run time timer unavailable, using the tick count\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_diag_timer_read
+ *******************************************************************************
+ * Summary:
+ *   Returns the run time counter. Called by the scheduler on every context
+ *   switch through portGET_RUN_TIME_COUNTER_VALUE().
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   counter value in units of 1 / RADAR_DIAG_TIMER_HZ seconds
+ ******************************************************************************/
+uint32_t radar_diag_timer_read(void)
+{
+    if (diag_timer_running)
+    {
+        return cyhal_timer_read(&diag_timer);
+    }
+
+    return (uint32_t)xTaskGetTickCount() * (RADAR_DIAG_TIMER_HZ / configTICK_RATE_HZ);
+}
+
+/*******************************************************************************
+ * Function Name: diag_period_callback
+ *******************************************************************************
+ * Summary:
+ *   Timer service callback, signals that a status record is due.
+ *
+ * Parameters:
+ *   timer: period timer
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void diag_period_callback(TimerHandle_t timer)
+{
+    (void)timer;
+
+    diag_due();
+}
+
+/*******************************************************************************
+ * Function Name: radar_diag_start
+ *******************************************************************************
+ * Summary:
+ *   Starts the periodic status records. The first record covers the time
+ *   since boot.
+ *
+ * Parameters:
+ *   due: called from the timer service task every RADAR_DIAG_PERIOD_MS, must
+ *        not block
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_diag_start(void (*due)(void))
+{
+    diag_due = due;
+
+#if STATIC_ALLOCATION_ENABLE
+    diag_period_timer = xTimerCreateStatic("Diag timer", pdMS_TO_TICKS(RADAR_DIAG_PERIOD_MS),
+                                           pdTRUE, NULL, diag_period_callback, &diag_period_timer_buffer);
+#else
+    diag_period_timer = xTimerCreate("Diag timer", pdMS_TO_TICKS(RADAR_DIAG_PERIOD_MS),
+                                     pdTRUE, NULL, diag_period_callback);
+#endif
+    app_memory_add("Diag", "Period timer", sizeof(StaticTimer_t), STATIC_ALLOCATION_ENABLE);
+    if ((diag_period_timer == NULL) || (xTimerStart(diag_period_timer, 0) != pdPASS))
+    {
+        printf("Diagnostics: period timer start failed\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: heap_headroom
+ *******************************************************************************
+ * Summary:
+ *   Returns the smallest free heap seen so far. malloc() never returns memory
+ *   to the heap region, so the region not yet claimed is the minimum ever
+ *   free size, not counting free blocks inside the claimed part.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   minimum ever free heap in bytes, 0 if the heap region is unknown
+ ******************************************************************************/
+static uint32_t heap_headroom(void)
+{
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    struct mallinfo heap = mallinfo();
+    uint32_t region = (uint32_t)(&__HeapLimit - &__HeapBase);
+
+    return (region > (uint32_t)heap.arena) ? (region - (uint32_t)heap.arena) : 0;
+#else
+    return 0;
+#endif
+}
+
+#if MEM_POOL_ENABLE
+/*******************************************************************************
+ * Function Name: format_pools
+ *******************************************************************************
+ * Summary:
+ *   Appends the memory pool member of the status record. The TLS stack and the
+ *   FreeRTOS objects allocate from the pools, so heap_min alone only covers
+ *   the requests the pools passed on to malloc(). Every row holds the block
+ *   size, the number of blocks and the most blocks allocated at the same time.
+ *
+ * Parameters:
+ *   buffer: destination, the member is written at 'len'
+ *   buffer_size: size of the buffer
+ *   len: length of the record so far
+ *
+ * Return:
+ *   new length of the record, 0 if the buffer is too small
+ ******************************************************************************/
+static size_t format_pools(char *buffer, size_t buffer_size, size_t len)
+{
+    /* Too large for the stack of the publisher task */
+    static mem_pool_stats_t pool_stats;
+    int written;
+
+    mem_pool_get_stats(&pool_stats);
+
+    written = snprintf(&buffer[len], buffer_size - len, "\"pool_fallbacks\":%lu,\"pools\":[",
+                       (unsigned long)pool_stats.fallbacks);
+    if ((written <= 0) || ((size_t)written >= (buffer_size - len)))
+    {
+        return 0;
+    }
+    len += (size_t)written;
+
+    for (uint32_t i = 0; i < MEM_POOL_CLASS_COUNT; i++)
+    {
+        written = snprintf(&buffer[len], buffer_size - len, "%s[%lu,%lu,%lu]", (i == 0) ? "" : ",",
+                           (unsigned long)pool_stats.classes[i].block_size,
+                           (unsigned long)pool_stats.classes[i].block_count,
+                           (unsigned long)pool_stats.classes[i].high_water);
+        if ((written <= 0) || ((size_t)written >= (buffer_size - len)))
+        {
+            return 0;
+        }
+        len += (size_t)written;
+    }
+
+    written = snprintf(&buffer[len], buffer_size - len, "],");
+    if ((written <= 0) || ((size_t)written >= (buffer_size - len)))
+    {
+        return 0;
+    }
+
+    return len + (size_t)written;
+}
+#endif /* MEM_POOL_ENABLE */
+
+/*******************************************************************************
+ * Function Name: task_cpu_permille
+ *******************************************************************************
+ * Summary:
+ *   Returns the CPU load of a task since the last record, in per mille of the
+ *   elapsed run time.
+ *
+ * Parameters:
+ *   status: current state of the task
+ *   elapsed: run time counter difference since the last record
+ *
+ * Return:
+ *   CPU load in per mille
+ ******************************************************************************/
+static uint32_t task_cpu_permille(const TaskStatus_t *status, uint32_t elapsed)
+{
+    uint32_t run_time = status->ulRunTimeCounter;
+
+    for (UBaseType_t i = 0; i < last_task_count; i++)
+    {
+        if (last_task_numbers[i] == status->xTaskNumber)
+        {
+            run_time -= last_task_run_time[i];
+            break;
+        }
+    }
+
+    return (elapsed > 0) ? (uint32_t)(((uint64_t)run_time * 1000u) / elapsed) : 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_diag_format
+ *******************************************************************************
+ * Summary:
+ *   Samples all tasks and formats the status record as a compact JSON object,
+ *   e.g. {"up_s":600,"asleep_s":0,"deep_s":0,"heap_min":41232,"tasks":[...]}
+ *   With MEM_POOL_ENABLE, the pool members of format_pools() precede the
+ *   task rows. Every task row holds the name, the CPU load in per mille since the last
+ *   record and the stack high water mark in words. Rows that do not fit are
+ *   left out.
+ *
+ * Parameters:
+ *   buffer: destination of the NUL-terminated JSON string
+ *   buffer_size: size of the buffer
+ *
+ * Return:
+ *   length of the JSON string, 0 if the buffer is too small
+ ******************************************************************************/
+size_t radar_diag_format(char *buffer, size_t buffer_size)
+{
+    uint32_t start = radar_diag_timer_read();
+    uint32_t total_run_time;
+    uint32_t elapsed;
+    uint32_t format_us;
+    low_power_stats_t sleep_stats;
+    UBaseType_t count;
+    size_t len;
+    int written;
+
+    count = uxTaskGetSystemState(task_status, RADAR_DIAG_MAX_TASKS, &total_run_time);
+    elapsed = total_run_time - last_total_run_time;
+    low_power_get_stats(&sleep_stats);
+
+    written = snprintf(buffer, buffer_size,
+                       "{\"up_s\":%lu,\"asleep_s\":%lu,\"deep_s\":%lu,\"heap_min\":%lu,",
+                       (unsigned long)(xTaskGetTickCount() / configTICK_RATE_HZ),
+                       (unsigned long)(sleep_stats.asleep_ms / 1000u),
+                       (unsigned long)(sleep_stats.deepsleep_ms / 1000u),
+                       (unsigned long)heap_headroom());
+    if ((written <= 0) || ((size_t)written >= buffer_size))
+    {
+        return 0;
+    }
+    len = (size_t)written;
+
+#if MEM_POOL_ENABLE
+    len = format_pools(buffer, buffer_size, len);
+    if (len == 0)
+    {
+        return 0;
+    }
+#endif
+
+    written = snprintf(&buffer[len], buffer_size - len, "\"tasks\":[");
+    if ((written <= 0) || ((len + (size_t)written + 2) >= buffer_size))
+    {
+        return 0;
+    }
+    len += (size_t)written;
+
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        /* Keep room for the closing brackets */
+        written = snprintf(&buffer[len], buffer_size - len - 2, "%s[\"%s\",%lu,%u]",
+                           (i == 0) ? "" : ",",
+                           task_status[i].pcTaskName,
+                           (unsigned long)task_cpu_permille(&task_status[i], elapsed),
+                           (unsigned int)task_status[i].usStackHighWaterMark);
+        if ((written <= 0) || ((size_t)written >= (buffer_size - len - 2)))
+        {
+            break;
+        }
+        len += (size_t)written;
+    }
+    buffer[len++] = ']';
+    buffer[len++] = '}';
+    buffer[len] = '\0';
+
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        last_task_numbers[i] = task_status[i].xTaskNumber;
+        last_task_run_time[i] = task_status[i].ulRunTimeCounter;
+    }
+    last_task_count = count;
+    last_total_run_time = total_run_time;
+
+    format_us = (radar_diag_timer_read() - start) * (1000000u / RADAR_DIAG_TIMER_HZ);
+
+    taskENTER_CRITICAL();
+    diag_stats.published++;
+    if (format_us > diag_stats.max_format_us)
+    {
+        diag_stats.max_format_us = format_us;
+    }
+    taskEXIT_CRITICAL();
+
+    return len;
+}
+
+/*******************************************************************************
+ * Function Name: radar_diag_skip
+ *******************************************************************************
+ * Summary:
+ *   Counts a status record that was skipped to not delay radar events.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_diag_skip(void)
+{
+    taskENTER_CRITICAL();
+    diag_stats.skipped++;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_diag_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the status record counters. Can be called from any task.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_diag_get_stats(radar_diag_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = diag_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
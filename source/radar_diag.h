@@ -0,0 +1,73 @@
+/******************************************************************************
+ * File Name:   radar_diag.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_diag.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Resolution of the FreeRTOS run time counter. The counter wraps after about
+ * 11 hours, CPU loads are computed from differences and are not affected.
+ * The counter stands still in Deep Sleep, see radar_diag_timer_init(). */
+#define RADAR_DIAG_TIMER_HZ    (100000u)
+
+/* Interval in milliseconds between two status records on 'MQTT_DIAG_TOPIC'.
+ * A record is skipped while radar events are waiting to be published, the
+ * next one then covers the longer interval. */
+#define RADAR_DIAG_PERIOD_MS   (60000u)
+
+/* Most tasks sampled at once. If more tasks exist, the record holds no task
+ * rows. */
+#define RADAR_DIAG_MAX_TASKS   (24u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the status records */
+typedef struct
+{
+    uint32_t published;         /* Records handed to the publisher */
+    uint32_t skipped;           /* Records skipped to not delay radar events */
+    uint32_t max_format_us;     /* Longest sampling and formatting time */
+} radar_diag_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Run time counter hooks, see FreeRTOSConfig.h */
+void radar_diag_timer_init(void);
+uint32_t radar_diag_timer_read(void);
+
+void radar_diag_start(void (*due)(void));
+size_t radar_diag_format(char *buffer, size_t buffer_size);
+void radar_diag_skip(void);
+void radar_diag_get_stats(radar_diag_stats_t *stats);
+
+/* [] END OF FILE */
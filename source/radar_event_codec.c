@@ -0,0 +1,203 @@
+/******************************************************************************
+ * File Name:   radar_event_codec.c
+ *
+ * Description: This file implements the versioned binary encoding of radar
+ *              event records published as an alternative to JSON. The file
+ *              only depends on the C standard library, so that it can be
+ *              compiled into host side tools to decode the payloads.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "radar_event_codec.h"
+
+/*******************************************************************************
+ * Function Name: put_u16 / put_u32 / get_u16 / get_u32
+ *******************************************************************************
+ * Summary:
+ *   Little endian field accessors, independent of the host byte order and
+ *   alignment.
+ ******************************************************************************/
+static void put_u16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint16_t get_u16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | ((uint16_t)buffer[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+           ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_codec_put_header
+ *******************************************************************************
+ * Summary:
+ *   Writes the payload header for 'count' records.
+ *
+ * Parameters:
+ *   buffer: destination, at least RADAR_EVENT_CODEC_HEADER_SIZE bytes
+ *   count: number of records following the header
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_event_codec_put_header(uint8_t *buffer, uint32_t count)
+{
+    buffer[0] = RADAR_EVENT_CODEC_SCHEMA_ID;
+    buffer[1] = RADAR_EVENT_CODEC_VERSION;
+    buffer[2] = (uint8_t)count;
+    buffer[3] = RADAR_EVENT_CODEC_RECORD_SIZE;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_codec_put_record
+ *******************************************************************************
+ * Summary:
+ *   Writes one record in wire format.
+ *
+ * Parameters:
+ *   buffer: destination, at least RADAR_EVENT_CODEC_RECORD_SIZE bytes
+ *   record: record to encode
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_event_codec_put_record(uint8_t *buffer, const radar_event_record_t *record)
+{
+    put_u32(&buffer[0], record->timestamp);
+    put_u32(&buffer[4], (uint32_t)record->count_in);
+    put_u32(&buffer[8], (uint32_t)record->count_out);
+    put_u16(&buffer[12], record->distance_mm);
+    put_u16(&buffer[14], record->accuracy_mm);
+    buffer[16] = record->event;
+    buffer[17] = record->occupy_status;
+    put_u16(&buffer[18], 0);
+    put_u32(&buffer[20], record->seq);
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_codec_encode
+ *******************************************************************************
+ * Summary:
+ *   Encodes an array of records into one payload.
+ *
+ * Parameters:
+ *   records: records to encode
+ *   count: number of records
+ *   buffer: destination
+ *   buffer_size: size of 'buffer'
+ *
+ * Return:
+ *   number of bytes written, 0 if the records do not fit
+ ******************************************************************************/
+size_t radar_event_codec_encode(const radar_event_record_t *records, uint32_t count,
+                                uint8_t *buffer, size_t buffer_size)
+{
+    size_t length = RADAR_EVENT_CODEC_PAYLOAD_SIZE(count);
+
+    if ((count > RADAR_EVENT_CODEC_MAX_RECORDS) || (length > buffer_size))
+    {
+        return 0;
+    }
+
+    radar_event_codec_put_header(buffer, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        radar_event_codec_put_record(&buffer[RADAR_EVENT_CODEC_PAYLOAD_SIZE(i)], &records[i]);
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_codec_decode
+ *******************************************************************************
+ * Summary:
+ *   Decodes a payload into records. Fields appended by later versions of the
+ *   format are skipped.
+ *
+ * Parameters:
+ *   buffer: payload
+ *   length: payload length
+ *   records: destination array
+ *   max_count: capacity of 'records'
+ *
+ * Return:
+ *   number of records decoded, -1 if the payload is malformed or 'records'
+ *   is too small
+ ******************************************************************************/
+int32_t radar_event_codec_decode(const uint8_t *buffer, size_t length,
+                                 radar_event_record_t *records, uint32_t max_count)
+{
+    uint32_t count;
+    uint32_t record_size;
+
+    if ((length < RADAR_EVENT_CODEC_HEADER_SIZE) || (buffer[0] != RADAR_EVENT_CODEC_SCHEMA_ID) ||
+        (buffer[1] == 0))
+    {
+        return -1;
+    }
+
+    count = buffer[2];
+    record_size = buffer[3];
+
+    if ((record_size < RADAR_EVENT_CODEC_RECORD_SIZE_V1) || (count > max_count) ||
+        (length < (RADAR_EVENT_CODEC_HEADER_SIZE + (count * record_size))))
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *field = &buffer[RADAR_EVENT_CODEC_HEADER_SIZE + (i * record_size)];
+
+        records[i].timestamp = get_u32(&field[0]);
+        records[i].count_in = (int32_t)get_u32(&field[4]);
+        records[i].count_out = (int32_t)get_u32(&field[8]);
+        records[i].distance_mm = get_u16(&field[12]);
+        records[i].accuracy_mm = get_u16(&field[14]);
+        records[i].event = field[16];
+        records[i].occupy_status = field[17];
+        records[i].seq = (record_size >= RADAR_EVENT_CODEC_RECORD_SIZE) ? get_u32(&field[20]) : 0;
+        /* Latency stamps are local to the device and not transmitted */
+        records[i].callback_ms = 0;
+        records[i].enqueue_ms = 0;
+    }
+
+    return (int32_t)count;
+}
+
+/* [] END OF FILE */
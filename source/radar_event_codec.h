@@ -0,0 +1,70 @@
+/******************************************************************************
+ * File Name:   radar_event_codec.h
+ *
+ * Description: This file is the public interface of radar_event_codec.c
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "radar_event_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Binary payload layout, all fields little endian:
+ *
+ *   header:  schema id (1) | version (1) | record count (1) | record size (1)
+ *   record:  timestamp (4) | count in (4) | count out (4) |
+ *            distance mm (2) | accuracy mm (2) | event (1) |
+ *            occupy status (1) | reserved (2) | sequence (4)
+ *
+ * Decoders must use the record size from the header to step through the
+ * records, so that later versions can append fields. Version 1 records end
+ * before the sequence number.
+ */
+#define RADAR_EVENT_CODEC_SCHEMA_ID   (0x52u)
+#define RADAR_EVENT_CODEC_VERSION     (2u)
+#define RADAR_EVENT_CODEC_HEADER_SIZE (4u)
+#define RADAR_EVENT_CODEC_RECORD_SIZE (24u)
+#define RADAR_EVENT_CODEC_RECORD_SIZE_V1 (20u)
+#define RADAR_EVENT_CODEC_MAX_RECORDS (255u)
+
+/* Size of a payload holding 'count' records */
+#define RADAR_EVENT_CODEC_PAYLOAD_SIZE(count) \
+    (RADAR_EVENT_CODEC_HEADER_SIZE + ((count) * RADAR_EVENT_CODEC_RECORD_SIZE))
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void radar_event_codec_put_header(uint8_t *buffer, uint32_t count);
+void radar_event_codec_put_record(uint8_t *buffer, const radar_event_record_t *record);
+
+size_t radar_event_codec_encode(const radar_event_record_t *records, uint32_t count,
+                                uint8_t *buffer, size_t buffer_size);
+int32_t radar_event_codec_decode(const uint8_t *buffer, size_t length,
+                                 radar_event_record_t *records, uint32_t max_count);
+
+/* [] END OF FILE */
@@ -0,0 +1,173 @@
+/******************************************************************************
+ * File Name:   radar_event_ring.c
+ *
+ * Description: This file implements a lock-free single-producer/single-consumer
+ *              ring of radar event records. The radar task produces records
+ *              from the sensing callback and the publisher task drains them in
+ *              batches, so that no queue operation happens on the radar path.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "cyhal.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_event_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_EVENT_RING_MASK (RADAR_EVENT_RING_LENGTH - 1u)
+
+#if ((RADAR_EVENT_RING_LENGTH & RADAR_EVENT_RING_MASK) != 0)
+#error "RADAR_EVENT_RING_LENGTH must be a power of two."
+#endif
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static radar_event_record_t ring_records[RADAR_EVENT_RING_LENGTH];
+
+/* Free running indexes. 'head' is written by the producer only and 'tail' by
+ * the consumer only.
+ */
+static volatile uint32_t ring_head = 0;
+static volatile uint32_t ring_tail = 0;
+
+/* Producer side counters */
+static volatile uint32_t ring_pushed = 0;
+static volatile uint32_t ring_dropped = 0;
+static volatile uint32_t ring_high_water = 0;
+
+/*******************************************************************************
+ * Function Name: radar_event_ring_push
+ *******************************************************************************
+ * Summary:
+ *   Appends a record to the ring. Must only be called from a single producer.
+ *
+ * Parameters:
+ *   record: event record to append
+ *
+ * Return:
+ *   true if the record was stored, false if the ring was full
+ ******************************************************************************/
+bool radar_event_ring_push(const radar_event_record_t *record)
+{
+    uint32_t head = ring_head;
+    uint32_t used = head - ring_tail;
+
+    if (used >= RADAR_EVENT_RING_LENGTH)
+    {
+        ring_dropped++;
+        return false;
+    }
+
+    ring_records[head & RADAR_EVENT_RING_MASK] = *record;
+
+    /* Make the record visible before publishing the new head */
+    __DMB();
+    ring_head = head + 1u;
+
+    ring_pushed++;
+    if ((used + 1u) > ring_high_water)
+    {
+        ring_high_water = used + 1u;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_ring_pop
+ *******************************************************************************
+ * Summary:
+ *   Removes up to 'max_count' records from the ring. Must only be called from
+ *   a single consumer.
+ *
+ * Parameters:
+ *   records: destination array
+ *   max_count: capacity of 'records'
+ *
+ * Return:
+ *   number of records copied
+ ******************************************************************************/
+uint32_t radar_event_ring_pop(radar_event_record_t *records, uint32_t max_count)
+{
+    uint32_t tail = ring_tail;
+    uint32_t available = ring_head - tail;
+    uint32_t count = (available < max_count) ? available : max_count;
+
+    /* Read the records only after the head has been observed */
+    __DMB();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        records[i] = ring_records[(tail + i) & RADAR_EVENT_RING_MASK];
+    }
+
+    /* Finish reading before handing the slots back to the producer */
+    __DMB();
+    ring_tail = tail + count;
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_ring_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of records currently held in the ring.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   number of records
+ ******************************************************************************/
+uint32_t radar_event_ring_count(void)
+{
+    return ring_head - ring_tail;
+}
+
+/*******************************************************************************
+ * Function Name: radar_event_ring_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the ring counters.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   void
+ ******************************************************************************/
+void radar_event_ring_get_stats(radar_event_ring_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    stats->pushed = ring_pushed;
+    stats->dropped = ring_dropped;
+    stats->high_water = ring_high_water;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * File Name:   radar_event_ring.h
+ *
+ * Description: This file is the public interface of radar_event_ring.c
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Number of event records the ring can hold. Must be a power of two. */
+#define RADAR_EVENT_RING_LENGTH (32u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Compact binary record of one radar sensing event */
+typedef struct
+{
+    uint32_t timestamp;     /* Library timestamp in ms */
+    int32_t count_in;       /* Entrance counter IN value after the event */
+    int32_t count_out;      /* Entrance counter OUT value after the event */
+    uint16_t distance_mm;   /* Presence distance, 0 if not applicable */
+    uint16_t accuracy_mm;   /* Presence distance accuracy, 0 if not applicable */
+    uint8_t event;          /* mtb_radar_sensing_event_t */
+    uint8_t occupy_status;  /* 1 if occupied/present, else 0 */
+    uint32_t seq;           /* Sequence number, consecutive unless events were dropped */
+    uint32_t callback_ms;   /* Tick time in ms when the callback was entered */
+    uint32_t enqueue_ms;    /* Tick time in ms when the record was pushed */
+} radar_event_record_t;
+
+/* Counters of the event ring */
+typedef struct
+{
+    uint32_t pushed;        /* Records accepted by the ring */
+    uint32_t dropped;       /* Records rejected because the ring was full */
+    uint32_t high_water;    /* Maximum number of records held at once */
+} radar_event_ring_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Producer side, called from the radar task only */
+bool radar_event_ring_push(const radar_event_record_t *record);
+
+/* Consumer side, called from the publisher task only */
+uint32_t radar_event_ring_pop(radar_event_record_t *records, uint32_t max_count);
+
+uint32_t radar_event_ring_count(void);
+void radar_event_ring_get_stats(radar_event_ring_stats_t *stats);
+
+/* [] END OF FILE */
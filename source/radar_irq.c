@@ -0,0 +1,219 @@
+/******************************************************************************
+ * File Name:   radar_irq.c
+ *
+ * Description: FIFO-ready interrupt of the radar sensor. The HAL keeps one
+ *   callback per pin and the RadarSensing library registers its own on the IRQ
+ *   pin, so the registration is wrapped at link time: the library's callback
+ *   is remembered and called first by the handler of this file, which then
+ *   wakes the radar task.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file includes */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header file */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/* Header file for local task */
+#include "radar_irq.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Name of the wrapper of a HAL function and of the wrapped function: GNU ld
+ * with --wrap (see LDFLAGS in the Makefile), armlink with $Sub$$/$Super$$.
+ * The IAR linker has no equivalent, IRQ acquisition is disabled there (see
+ * radar_task.h). */
+#if defined(__ARMCC_VERSION)
+#define RADAR_IRQ_WRAP(function) $Sub$$##function
+#define RADAR_IRQ_REAL(function) $Super$$##function
+#else
+#define RADAR_IRQ_WRAP(function) __wrap_##function
+#define RADAR_IRQ_REAL(function) __real_##function
+#endif
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void RADAR_IRQ_WRAP(cyhal_gpio_register_callback)(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+void RADAR_IRQ_REAL(cyhal_gpio_register_callback)(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Callback data of the radar FIFO-ready interrupt */
+static cyhal_gpio_callback_data_t radar_irq_cb_data;
+/* Callback the RadarSensing library registered on the IRQ pin */
+static cyhal_gpio_callback_data_t *volatile library_cb_data = NULL;
+/* Task woken by the interrupt, NULL until radar_irq_start() */
+static TaskHandle_t radar_irq_task = NULL;
+/* Tick count at which the last FIFO-ready interrupt was raised */
+static volatile TickType_t radar_irq_tick = 0;
+/* FIFO-ready interrupts received */
+static volatile uint32_t radar_irq_counter = 0;
+
+/*******************************************************************************
+ * Function Name: radar_irq_handler
+ *******************************************************************************
+ * Summary:
+ *   Interrupt handler of the radar FIFO-ready IRQ. Runs the handler of the
+ *   RadarSensing library, then wakes the radar task through a direct-to-task
+ *   notification, so that data is processed only when a frame is available.
+ *
+ * Parameters:
+ *   callback_arg: unused
+ *   event: GPIO event that triggered the interrupt
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void radar_irq_handler(void *callback_arg, cyhal_gpio_event_t event)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    cyhal_gpio_callback_data_t *library = library_cb_data;
+
+    (void)callback_arg;
+
+    if ((library != NULL) && (library->callback != NULL))
+    {
+        library->callback(library->callback_arg, event);
+    }
+
+    radar_irq_counter++;
+    radar_irq_tick = xTaskGetTickCountFromISR();
+
+    vTaskNotifyGiveFromISR(radar_irq_task, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+#if !defined(__ICCARM__)
+/*******************************************************************************
+ * Function Name: cyhal_gpio_register_callback wrapper
+ *******************************************************************************
+ * Summary:
+ *   Link-time wrapper of cyhal_gpio_register_callback(). A registration on the
+ *   radar IRQ pin by anyone but this file is remembered for the chained call;
+ *   once the radar task is woken by the interrupt, the handler of this file
+ *   stays installed. Other pins are passed through.
+ *
+ * Parameters:
+ *   pin: GPIO pin
+ *   callback_data: callback to register, NULL to unregister
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void RADAR_IRQ_WRAP(cyhal_gpio_register_callback)(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data)
+{
+    if ((pin == RADAR_IRQ_PIN) && (callback_data != &radar_irq_cb_data))
+    {
+        library_cb_data = callback_data;
+        if (radar_irq_task != NULL)
+        {
+            return;
+        }
+    }
+
+    RADAR_IRQ_REAL(cyhal_gpio_register_callback)(pin, callback_data);
+}
+#endif
+
+/*******************************************************************************
+ * Function Name: radar_irq_start
+ *******************************************************************************
+ * Summary:
+ *   Installs the interrupt handler on the radar IRQ pin, chained to the
+ *   callback the RadarSensing library registered, and enables the rising
+ *   edge interrupt.
+ *
+ * Parameters:
+ *   task: task to wake on every interrupt
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_irq_start(TaskHandle_t task)
+{
+    radar_irq_task = task;
+
+    radar_irq_cb_data.callback = radar_irq_handler;
+    radar_irq_cb_data.callback_arg = NULL;
+    cyhal_gpio_register_callback(RADAR_IRQ_PIN, &radar_irq_cb_data);
+    cyhal_gpio_enable_event(RADAR_IRQ_PIN, CYHAL_GPIO_IRQ_RISE, RADAR_IRQ_PRIORITY, true);
+}
+
+/*******************************************************************************
+ * Function Name: radar_irq_pending
+ *******************************************************************************
+ * Summary:
+ *   Tells if the IRQ line is still asserted, meaning another frame is waiting
+ *   and no new edge will come.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if the sensor still signals a filled FIFO
+ ******************************************************************************/
+bool radar_irq_pending(void)
+{
+    return cyhal_gpio_read(RADAR_IRQ_PIN);
+}
+
+/*******************************************************************************
+ * Function Name: radar_irq_last_tick
+ *******************************************************************************
+ * Summary:
+ *   Returns the tick count at which the last interrupt was raised.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   tick count
+ ******************************************************************************/
+TickType_t radar_irq_last_tick(void)
+{
+    return radar_irq_tick;
+}
+
+/*******************************************************************************
+ * Function Name: radar_irq_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of interrupts received.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   interrupt count
+ ******************************************************************************/
+uint32_t radar_irq_count(void)
+{
+    return radar_irq_counter;
+}
+
+/* [] END OF FILE */
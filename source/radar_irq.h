@@ -0,0 +1,55 @@
+/******************************************************************************
+ * File Name:   radar_irq.h
+ *
+ * Description: This file is the public interface of radar_irq.c: the FIFO-
+ *   ready interrupt of the radar sensor, shared with the RadarSensing library.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+/* Header file includes */
+#include "cyhal.h"
+#include "cybsp.h"
+
+/* FreeRTOS header file */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Pin of the radar FIFO-ready IRQ */
+#define RADAR_IRQ_PIN (CYBSP_GPIO10)
+
+/* Interrupt priority of the radar FIFO-ready IRQ */
+#define RADAR_IRQ_PRIORITY (CYHAL_ISR_PRIORITY_DEFAULT)
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void radar_irq_start(TaskHandle_t task);
+bool radar_irq_pending(void);
+TickType_t radar_irq_last_tick(void);
+uint32_t radar_irq_count(void);
+
+/* [] END OF FILE */
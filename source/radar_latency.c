@@ -0,0 +1,278 @@
+/******************************************************************************
+ * File Name:   radar_latency.c
+ *
+ * Description: This file implements fixed-bucket latency histograms of the
+ *              stages a radar event passes from the sensing library to the
+ *              MQTT broker. Only counters are updated per sample, percentiles
+ *              are derived from the buckets when a summary is requested.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_latency.h"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t count;
+    uint32_t max;
+    uint32_t buckets[RADAR_LATENCY_BUCKETS];
+} radar_latency_histogram_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Inclusive upper bound in ms of every bucket, the last one is open ended */
+static const uint32_t bucket_limits[RADAR_LATENCY_BUCKETS] =
+{
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, UINT32_MAX
+};
+
+static const char *const stage_names[RADAR_LATENCY_STAGE_COUNT] =
+{
+    "callback", "enqueue", "dequeue", "publish_start", "publish", "end_to_end"
+};
+
+static radar_latency_histogram_t histograms[RADAR_LATENCY_STAGE_COUNT];
+
+/*******************************************************************************
+ * Function Name: percentile
+ *******************************************************************************
+ * Summary:
+ *   Upper bound of the bucket in which the given percentile falls, capped by
+ *   the exact maximum.
+ *
+ * Parameters:
+ *   histogram: histogram copy
+ *   percent: percentile, 1 to 100
+ *
+ * Return:
+ *   latency in ms
+ ******************************************************************************/
+static uint32_t percentile(const radar_latency_histogram_t *histogram, uint32_t percent)
+{
+    /* Rank of the sample, rounded up */
+    uint32_t rank = (uint32_t)((((uint64_t)histogram->count * percent) + 99u) / 100u);
+    uint32_t seen = 0;
+
+    for (uint32_t i = 0; i < RADAR_LATENCY_BUCKETS; i++)
+    {
+        seen += histogram->buckets[i];
+        if ((seen >= rank) && (seen > 0))
+        {
+            return (bucket_limits[i] < histogram->max) ? bucket_limits[i] : histogram->max;
+        }
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+ * Function Name: radar_latency_record
+ *******************************************************************************
+ * Summary:
+ *   Adds one sample to the histogram of a stage. Can be called from any task.
+ *
+ * Parameters:
+ *   stage: measured stage
+ *   latency_ms: measured latency in ms
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_latency_record(radar_latency_stage_t stage, uint32_t latency_ms)
+{
+    radar_latency_histogram_t *histogram = &histograms[stage];
+    uint32_t bucket = 0;
+
+    while (latency_ms > bucket_limits[bucket])
+    {
+        bucket++;
+    }
+
+    taskENTER_CRITICAL();
+    histogram->count++;
+    histogram->buckets[bucket]++;
+    if (latency_ms > histogram->max)
+    {
+        histogram->max = latency_ms;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_latency_get_summary
+ *******************************************************************************
+ * Summary:
+ *   Returns sample count, p50, p99 and maximum of a stage.
+ *
+ * Parameters:
+ *   stage: measured stage
+ *   summary: destination of the summary
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_latency_get_summary(radar_latency_stage_t stage, radar_latency_summary_t *summary)
+{
+    radar_latency_histogram_t histogram;
+
+    taskENTER_CRITICAL();
+    histogram = histograms[stage];
+    taskEXIT_CRITICAL();
+
+    summary->count = histogram.count;
+    summary->p50 = percentile(&histogram, 50u);
+    summary->p99 = percentile(&histogram, 99u);
+    summary->max = histogram.max;
+}
+
+/*******************************************************************************
+ * Function Name: radar_latency_reset
+ *******************************************************************************
+ * Summary:
+ *   Clears all histograms.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_latency_reset(void)
+{
+    taskENTER_CRITICAL();
+    memset(histograms, 0, sizeof(histograms));
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_latency_dump
+ *******************************************************************************
+ * Summary:
+ *   Prints the summary and the buckets of every stage on the debug UART.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_latency_dump(void)
+{
+    printf("Radar event latency (ms):\n");
+    for (uint32_t stage = 0; stage < RADAR_LATENCY_STAGE_COUNT; stage++)
+    {
+        radar_latency_histogram_t histogram;
+        radar_latency_summary_t summary;
+
+        taskENTER_CRITICAL();
+        histogram = histograms[stage];
+        taskEXIT_CRITICAL();
+
+        radar_latency_get_summary((radar_latency_stage_t)stage, &summary);
+        printf("  %-13s n=%lu p50=%lu p99=%lu max=%lu |",
+               stage_names[stage],
+               (unsigned long)summary.count,
+               (unsigned long)summary.p50,
+               (unsigned long)summary.p99,
+               (unsigned long)summary.max);
+        for (uint32_t i = 0; i < RADAR_LATENCY_BUCKETS; i++)
+        {
+            if (i < (RADAR_LATENCY_BUCKETS - 1u))
+            {
+                printf(" <=%lu:%lu", (unsigned long)bucket_limits[i], (unsigned long)histogram.buckets[i]);
+            }
+            else
+            {
+                printf(" >%lu:%lu", (unsigned long)bucket_limits[i - 1u], (unsigned long)histogram.buckets[i]);
+            }
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+ * Function Name: radar_latency_format
+ *******************************************************************************
+ * Summary:
+ *   Formats the summaries of all stages as a JSON object for the diagnostics
+ *   topic, e.g. {"latency_ms":{"callback":{"n":3,"p50":1,"p99":1,"max":1},...}}
+ *
+ * Parameters:
+ *   buffer: destination of the NUL-terminated JSON string
+ *   buffer_size: size of the buffer
+ *
+ * Return:
+ *   length of the JSON string, 0 if the buffer is too small
+ ******************************************************************************/
+size_t radar_latency_format(char *buffer, size_t buffer_size)
+{
+    size_t len = 0;
+    int written;
+
+    written = snprintf(buffer, buffer_size, "{\"latency_ms\":{");
+    for (uint32_t stage = 0; (stage < RADAR_LATENCY_STAGE_COUNT) && (written > 0); stage++)
+    {
+        radar_latency_summary_t summary;
+
+        len += (size_t)written;
+        if (len >= buffer_size)
+        {
+            return 0;
+        }
+
+        radar_latency_get_summary((radar_latency_stage_t)stage, &summary);
+        written = snprintf(&buffer[len], buffer_size - len,
+                           "%s\"%s\":{\"n\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu}",
+                           (stage == 0) ? "" : ",",
+                           stage_names[stage],
+                           (unsigned long)summary.count,
+                           (unsigned long)summary.p50,
+                           (unsigned long)summary.p99,
+                           (unsigned long)summary.max);
+    }
+    if (written <= 0)
+    {
+        return 0;
+    }
+    len += (size_t)written;
+    if (len >= buffer_size)
+    {
+        return 0;
+    }
+
+    written = snprintf(&buffer[len], buffer_size - len, "}}");
+    len += (size_t)written;
+
+    return (len < buffer_size) ? len : 0;
+}
+
+/* [] END OF FILE */
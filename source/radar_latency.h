@@ -0,0 +1,72 @@
+/******************************************************************************
+ * File Name:   radar_latency.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_latency.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Number of buckets of every latency histogram, see radar_latency.c */
+#define RADAR_LATENCY_BUCKETS (13u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Measured stages of a radar event on its way to the broker */
+typedef enum
+{
+    RADAR_LATENCY_CALLBACK,         /* Library timestamp to sensing callback */
+    RADAR_LATENCY_ENQUEUE,          /* Sensing callback to event ring push */
+    RADAR_LATENCY_DEQUEUE,          /* Event ring push to publisher pop */
+    RADAR_LATENCY_PUBLISH_START,    /* Publisher pop to cy_mqtt_publish() call, includes batching */
+    RADAR_LATENCY_PUBLISH,          /* cy_mqtt_publish() call to return, i.e. PUBACK for QoS 1 and 2 */
+    RADAR_LATENCY_END_TO_END,       /* Library timestamp to cy_mqtt_publish() return */
+    RADAR_LATENCY_STAGE_COUNT
+} radar_latency_stage_t;
+
+/* Summary of one stage, all times in ms */
+typedef struct
+{
+    uint32_t count;
+    uint32_t p50;                   /* Upper bound of the bucket holding the median */
+    uint32_t p99;                   /* Upper bound of the bucket holding the 99th percentile */
+    uint32_t max;                   /* Exact maximum */
+} radar_latency_summary_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void radar_latency_record(radar_latency_stage_t stage, uint32_t latency_ms);
+void radar_latency_get_summary(radar_latency_stage_t stage, radar_latency_summary_t *summary);
+void radar_latency_reset(void);
+void radar_latency_dump(void);
+size_t radar_latency_format(char *buffer, size_t buffer_size);
+
+/* [] END OF FILE */
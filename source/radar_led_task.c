@@ -1,8 +1,9 @@
 /*****************************************************************************
  * File name: radar_led_task.c
  *
- * Description: This file implements a LED blinking pattern for entrance
- * counter events.
+ * Description: This file implements the LED patterns of the radar events.
+ * Blink sequences are declared as tables of timed steps. The task sleeps until
+ * the next step or the next event and only writes the pins that change.
  *
  * ===========================================================================
  * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
@@ -29,6 +30,7 @@
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "app_memory.h"
 #include "radar_led_task.h"
 #include "radar_task.h"
 
@@ -44,29 +46,16 @@
 /*******************************************************************************
  * Constants
  ******************************************************************************/
-/* LED blink timing */
-#define COUNTER_IN_LED_ON_TIME     (3U)
-#define COUNTER_IN_LED_OFF_TIME    (20U)
-#define COUNTER_OUT_LED_ON_TIME    (3U)
-#define COUNTER_OUT_LED_OFF_TIME   (50U)
-#define COUNTER_IN_LED_BLINK_TIME  (5U)
-#define COUNTER_OUT_LED_BLINK_TIME (2U)
-/* Delay time after each call to radar_led_task  */
-#define RADAR_LED_TASK_DELAY (2)
-
-
-/* List of LED status */
-typedef enum
-{
-    LED_PRESENCE,
-    LED_ABSENCE,
-    LED_COUNTER_IN,
-    LED_COUNTER_OUT,
-    LED_COUNTER_OCCUPIED,
-    LED_COUNTER_FREE,
-    LED_ERROR,
-    LED_OFF
-} led_condition_t;
+/* LED blink timing in ms, and number of blinks of a counter event */
+#define COUNTER_IN_LED_ON_TIME_MS   (4U)
+#define COUNTER_IN_LED_OFF_TIME_MS  (36U)
+#define COUNTER_IN_LED_BLINKS       (7U)
+#define COUNTER_OUT_LED_ON_TIME_MS  (4U)
+#define COUNTER_OUT_LED_OFF_TIME_MS (96U)
+#define COUNTER_OUT_LED_BLINKS      (4U)
+
+/* Commands that can wait for the LED task */
+#define RADAR_LED_QUEUE_LENGTH (4U)
 
 /* List of LED colors */
 typedef enum
@@ -74,20 +63,65 @@ typedef enum
     LED_NULL = 0x00,
     LED_RED = 0x01,
     LED_GREEN = 0x02,
-    LED_BLUE = 0x04
+    LED_BLUE = 0x04,
+    LED_KEEP = 0xFF     /* Command leaves the base color unchanged */
 } LED_COLOR;
 
+/* One step of a blink sequence, the LED shows the base color or is off */
+typedef struct
+{
+    bool on;
+    uint16_t duration_ms;
+} led_step_t;
+
+/* Blink sequence, its steps are played 'repeat' times. Afterwards the LED
+ * shows the base color. */
+typedef struct
+{
+    const led_step_t *steps;
+    uint8_t step_count;
+    uint8_t repeat;
+} led_pattern_t;
+
+/* Request passed from radar_led_set_pattern() to the LED task */
+typedef struct
+{
+    uint8_t color;                  /* New base color or LED_KEEP */
+    const led_pattern_t *pattern;   /* Blink sequence to start, NULL for none */
+} led_command_t;
+
+/* Blink sequences of the entrance counter events */
+static const led_step_t counter_in_steps[] =
+{
+    { true, COUNTER_IN_LED_ON_TIME_MS },
+    { false, COUNTER_IN_LED_OFF_TIME_MS }
+};
+static const led_pattern_t counter_in_pattern =
+{
+    counter_in_steps, sizeof(counter_in_steps) / sizeof(counter_in_steps[0]), COUNTER_IN_LED_BLINKS
+};
+
+static const led_step_t counter_out_steps[] =
+{
+    { true, COUNTER_OUT_LED_ON_TIME_MS },
+    { false, COUNTER_OUT_LED_OFF_TIME_MS }
+};
+static const led_pattern_t counter_out_pattern =
+{
+    counter_out_steps, sizeof(counter_out_steps) / sizeof(counter_out_steps[0]), COUNTER_OUT_LED_BLINKS
+};
+
 /*******************************************************************************
  * Global Variables
  ******************************************************************************/
-static led_condition_t led_state = LED_OFF; // LED status of different event
-static LED_COLOR led_color = LED_GREEN;     // current LED color
-static uint8_t led_counter_in_num = 0;      // current unprocessed counter IN event number
-static uint8_t led_counter_out_num = 0;     // current unprocessed counter OUT event number
-static uint8_t led_onoff_time_in = 0;       // LED/GPIO on off time counter for IN event
-static uint8_t led_onoff_time_out = 0;      // LED/GPIO on off time counter for OUT event
-static uint8_t led_blink_count_in = 0;      // LED blink counter for IN event
-static uint8_t led_blink_count_out = 0;     // LED blink counter for OUT event
+static QueueHandle_t led_q = NULL;
+APP_QUEUE_MEMORY(led_q, RADAR_LED_QUEUE_LENGTH, sizeof(led_command_t))
+
+static uint8_t led_color = LED_GREEN;       // base color, shown between blink sequences
+static bool led_color_shown = false;        // base color is shown once an event set or resumed it
+static uint8_t led_output = LED_NULL;       // colors currently driven on the GPIOs
+
+static radar_led_stats_t led_stats;
 
 TaskHandle_t radar_led_task_handle = NULL;
 
@@ -95,7 +129,8 @@ TaskHandle_t radar_led_task_handle = NULL;
  * Function Name: gpio_led_set
  *******************************************************************************
  * Summary:
- *   This function sets GPIOs to activate LED set by the user.
+ *   This function sets GPIOs to activate LED set by the user. Only the GPIOs
+ *   whose state changes are written.
  *
  * Parameters:
  *   led_set: LED color
@@ -105,23 +140,56 @@ TaskHandle_t radar_led_task_handle = NULL;
  ******************************************************************************/
 static void gpio_led_set(uint32_t led_set)
 {
+    uint32_t changed = (led_set ^ led_output) & (LED_RED | LED_GREEN | LED_BLUE);
+
     /* Set red LED */
-    uint8_t red_led_state = led_set & LED_RED ? LED_STATE_ON : LED_STATE_OFF;
-    cyhal_gpio_write(LED_RGB_RED, red_led_state);
+    if (changed & LED_RED)
+    {
+        cyhal_gpio_write(LED_RGB_RED, led_set & LED_RED ? LED_STATE_ON : LED_STATE_OFF);
+        led_stats.pin_writes++;
+    }
     /* Set green LED */
-    uint8_t green_led_state = led_set & LED_GREEN ? LED_STATE_ON : LED_STATE_OFF;
-    cyhal_gpio_write(LED_RGB_GREEN, green_led_state);
+    if (changed & LED_GREEN)
+    {
+        cyhal_gpio_write(LED_RGB_GREEN, led_set & LED_GREEN ? LED_STATE_ON : LED_STATE_OFF);
+        led_stats.pin_writes++;
+    }
     /* Set blue LED */
-    uint8_t blue_led_state = led_set & LED_BLUE ? LED_STATE_ON : LED_STATE_OFF;
-    cyhal_gpio_write(LED_RGB_BLUE, blue_led_state);
+    if (changed & LED_BLUE)
+    {
+        cyhal_gpio_write(LED_RGB_BLUE, led_set & LED_BLUE ? LED_STATE_ON : LED_STATE_OFF);
+        led_stats.pin_writes++;
+    }
+
+    led_output = (uint8_t)led_set;
+}
+
+/*******************************************************************************
+ * Function Name: radar_led_init
+ *******************************************************************************
+ * Summary:
+ *   This function creates the command queue of the LED task. It must be called
+ *   before the first radar event can occur.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return
+ *   none
+ ******************************************************************************/
+void radar_led_init(void)
+{
+    led_q = app_queue_create("Radar", "LED queue", RADAR_LED_QUEUE_LENGTH, sizeof(led_command_t),
+                             APP_QUEUE_STORAGE(led_q), APP_QUEUE_QCB(led_q));
 }
 
 /*******************************************************************************
  * Function Name: radar_led_set_pattern
  *******************************************************************************
  * Summary:
- *   This function sets LED blinking pattern for presence or entrance counter
- *   events.
+ *   This function queues the LED pattern of presence or entrance counter
+ *   events for the LED task. It does not block, a command that does not fit
+ *   into the queue is dropped.
  *
  * Parameters:
  *   event: radar sensing event, check reference from 'xensiv-radar-sensing' lib.
@@ -131,41 +199,36 @@ static void gpio_led_set(uint32_t led_set)
  ******************************************************************************/
 void radar_led_set_pattern(mtb_radar_sensing_event_t event)
 {
+    led_command_t command = { LED_KEEP, NULL };
+
     if (event == MTB_RADAR_SENSING_EVENT_COUNTER_IN)
     {
         /* Override LED pattern for LED drive mode */
-        led_counter_in_num = 1;
-        led_counter_out_num = 0;
-        led_onoff_time_out = 0;
-        led_blink_count_out = 0;
+        command.pattern = &counter_in_pattern;
     }
     else if (event == MTB_RADAR_SENSING_EVENT_COUNTER_OUT)
     {
         /* Override LED pattern for LED drive mode */
-        led_counter_out_num = 1;
-        led_counter_in_num = 0;
-        led_onoff_time_in = 0;
-        led_blink_count_in = 0;
+        command.pattern = &counter_out_pattern;
     }
-    else if (event == MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED)
+    else if ((event == MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED) || (event == MTB_RADAR_SENSING_EVENT_PRESENCE_IN))
     {
-        led_state = LED_COUNTER_OCCUPIED;
-        led_color = LED_RED;
+        command.color = LED_RED;
     }
-    else if (event == MTB_RADAR_SENSING_EVENT_COUNTER_FREE)
+    else if ((event == MTB_RADAR_SENSING_EVENT_COUNTER_FREE) || (event == MTB_RADAR_SENSING_EVENT_PRESENCE_OUT))
     {
-        led_state = LED_COUNTER_FREE;
-        led_color = LED_GREEN;
+        command.color = LED_GREEN;
     }
-    else if (event == MTB_RADAR_SENSING_EVENT_PRESENCE_IN)
+    else
     {
-        led_state = LED_PRESENCE;
-        led_color = LED_RED;
+        return;
     }
-    else if (event == MTB_RADAR_SENSING_EVENT_PRESENCE_OUT)
+
+    if ((led_q == NULL) || (pdTRUE != xQueueSend(led_q, &command, 0)))
     {
-        led_state = LED_ABSENCE;
-        led_color = LED_GREEN;
+        taskENTER_CRITICAL();
+        led_stats.dropped++;
+        taskEXIT_CRITICAL();
     }
 }
 
@@ -173,7 +236,9 @@ void radar_led_set_pattern(mtb_radar_sensing_event_t event)
  * Function Name: radar_led_task
  *******************************************************************************
  * Summary:
- *   This function initializes parameters for LED blinking pattern.
+ *   This function initializes the LED GPIOs and plays the LED patterns. The
+ *   task blocks until the next command or, while a blink sequence runs, until
+ *   the end of the current step.
  *
  * Parameters:
  *   arg: thread
@@ -183,6 +248,13 @@ void radar_led_set_pattern(mtb_radar_sensing_event_t event)
  ******************************************************************************/
 void radar_led_task(void *pvParameters)
 {
+    const led_pattern_t *pattern = NULL;    // running blink sequence
+    uint8_t step = 0;                       // current step of the sequence
+    uint8_t round = 0;                      // completed repetitions of the sequence
+    TickType_t step_start = 0;              // tick count at which the current step started
+    TickType_t wait = portMAX_DELAY;
+    led_command_t command;
+
     (void)pvParameters;
 
     /* Initialize the three LED ports and set the LEDs' initial state to off*/
@@ -206,77 +278,83 @@ void radar_led_task(void *pvParameters)
 
     for (;;)
     {
-        /* Process counter IN event */
-        if (led_counter_in_num > 0)
+        TickType_t now;
+
+        if (pdTRUE == xQueueReceive(led_q, &command, wait))
         {
-            /* Blink LED according to COUNTER_IN_ON_TIME */
-            led_onoff_time_in++;
-            if (led_onoff_time_in < COUNTER_IN_LED_ON_TIME)
+            /* Process event */
+            if (command.color != LED_KEEP)
             {
-                gpio_led_set(led_color);
+                led_color = command.color;
+                led_color_shown = true;
             }
-            else if (led_onoff_time_in < COUNTER_IN_LED_OFF_TIME)
+            if (command.pattern != NULL)
             {
-                gpio_led_set(LED_NULL);
+                /* A new counter event restarts the blinking */
+                pattern = command.pattern;
+                step = 0;
+                round = 0;
+                step_start = xTaskGetTickCount();
             }
-            else
+        }
+        else if (pattern != NULL)
+        {
+            /* Current step is over, go to the next one */
+            step_start += pdMS_TO_TICKS(pattern->steps[step].duration_ms);
+            if (++step == pattern->step_count)
             {
-                led_onoff_time_in = 0;
-                if (led_blink_count_in > COUNTER_IN_LED_BLINK_TIME)
+                step = 0;
+                if (++round == pattern->repeat)
                 {
-                    /* Deduct count after a LED blink generated */
-                    led_counter_in_num--;
-                    led_blink_count_in = 0;
                     /* Resume LED */
-                    gpio_led_set(led_color);
-                }
-                else
-                {
-                    /* Repeat blink */
-                    led_blink_count_in++;
+                    pattern = NULL;
+                    led_color_shown = true;
                 }
             }
         }
-        /* Process counter OUT event */
-        else if (led_counter_out_num > 0)
+
+        taskENTER_CRITICAL();
+        led_stats.wakeups++;
+        taskEXIT_CRITICAL();
+
+        if (pattern != NULL)
         {
-            /* Blink LED according to COUNTER_OUT_ON_TIME */
-            led_onoff_time_out++;
-            if (led_onoff_time_out < COUNTER_OUT_LED_ON_TIME)
+            gpio_led_set(pattern->steps[step].on ? led_color : LED_NULL);
+
+            /* Sleep until the end of the step */
+            now = xTaskGetTickCount();
+            wait = pdMS_TO_TICKS(pattern->steps[step].duration_ms);
+            wait = ((now - step_start) >= wait) ? 0 : (wait - (now - step_start));
+        }
+        else
+        {
+            /* Process traffic light event */
+            if (led_color_shown)
             {
                 gpio_led_set(led_color);
             }
-            else if (led_onoff_time_out < COUNTER_OUT_LED_OFF_TIME)
-            {
-                gpio_led_set(LED_NULL);
-            }
-            else
-            {
-                led_onoff_time_out = 0;
-                if (led_blink_count_out > COUNTER_OUT_LED_BLINK_TIME)
-                {
-                    /* Deduct count after a LED blink generated */
-                    led_counter_out_num--;
-                    led_blink_count_out = 0;
-                    /* Resume LED */
-                    gpio_led_set(led_color);
-                }
-                else
-                {
-                    /* Repeat blink */
-                    led_blink_count_out++;
-                }
-            }
+            wait = portMAX_DELAY;
         }
-        /* Process traffic light event */
-        else if ((led_state == LED_COUNTER_OCCUPIED) || (led_state == LED_COUNTER_FREE) || (led_state == LED_ABSENCE) ||
-                 (led_state == LED_PRESENCE))
-        {
-            gpio_led_set(led_color);
-        }
-        /* Include 2ms delay */
-        vTaskDelay(pdMS_TO_TICKS(RADAR_LED_TASK_DELAY));
     }
 }
 
+/*******************************************************************************
+ * Function Name: radar_led_get_stats
+ *******************************************************************************
+ * Summary:
+ *   This function returns a copy of the LED task counters.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return
+ *   none
+ ******************************************************************************/
+void radar_led_get_stats(radar_led_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = led_stats;
+    taskEXIT_CRITICAL();
+}
+
 /* [] END OF FILE */
@@ -42,11 +42,21 @@
 #define RADAR_LED_TASK_STACK_SIZE (512)
 #define RADAR_LED_TASK_PRIORITY   (2)
 
+/* Counters of the LED task */
+typedef struct
+{
+    uint32_t wakeups;           /* Times the task ran, for an event or a blink step */
+    uint32_t pin_writes;        /* GPIO writes, unchanged pins are not written */
+    uint32_t dropped;           /* Events lost because the command queue was full */
+} radar_led_stats_t;
+
 extern TaskHandle_t radar_led_task_handle;
 /*******************************************************************************
  * Functions
  ******************************************************************************/
+void radar_led_init(void);
 void radar_led_task(void *pvParameters);
 void radar_led_set_pattern(mtb_radar_sensing_event_t event);
+void radar_led_get_stats(radar_led_stats_t *stats);
 
 /* [] END OF FILE */
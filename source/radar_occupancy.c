@@ -0,0 +1,495 @@
+/******************************************************************************
+ * File Name:   radar_occupancy.c
+ *
+ * Description: This file implements the occupancy summaries published
+ *              periodically on the statistics topic. The radar events are
+ *              aggregated into a ring of one-minute buckets holding the
+ *              IN/OUT counts, the peak occupancy, the occupied time and a
+ *              dwell time histogram. A summary adds up the last complete
+ *              buckets of every window, so memory and work do not depend on
+ *              the event rate.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include "mtb_radar_sensing.h"
+#include "app_memory.h"
+#include "radar_counter.h"
+#include "radar_occupancy.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define WINDOW_ENTRY(name, buckets) { (name), (buckets) },
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Aggregates of one bucket */
+typedef struct
+{
+    uint16_t in;                /* Entrance counter IN or presence IN events */
+    uint16_t out;               /* Entrance counter OUT or presence OUT events */
+    uint16_t peak;              /* Highest occupancy level */
+    uint16_t dwell[RADAR_OCCUPANCY_DWELL_BINS]; /* Occupied periods ended in this bucket */
+    uint32_t occupied_ms;       /* Time the zone was occupied */
+} occupancy_bucket_t;
+
+/* Sums of the buckets of one window */
+typedef struct
+{
+    uint32_t span;              /* Complete buckets covered, less than the window after boot */
+    uint32_t in;
+    uint32_t out;
+    uint32_t peak;
+    uint32_t occupied_ms;
+    uint32_t dwell[RADAR_OCCUPANCY_DWELL_BINS];
+} occupancy_window_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t buckets;
+} occupancy_window_def_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static const occupancy_window_def_t windows[] =
+{
+    RADAR_OCCUPANCY_WINDOW_LIST(WINDOW_ENTRY)
+};
+
+#define OCCUPANCY_WINDOW_COUNT (sizeof(windows) / sizeof(windows[0]))
+
+static const uint32_t dwell_bounds_s[] = RADAR_OCCUPANCY_DWELL_BOUNDS_S;
+
+/* Ring of buckets, 'head' is the one being filled */
+static occupancy_bucket_t buckets[RADAR_OCCUPANCY_BUCKETS];
+static uint32_t head = 0;
+static uint32_t complete_buckets = 0;
+static uint32_t bucket_start_ms;
+static bool clock_started = false;
+
+/* Current occupancy */
+static uint32_t level = 0;
+static bool occupied = false;
+static uint32_t occupied_since_ms;
+/* Occupied time is added to the buckets up to this time */
+static uint32_t accounted_ms;
+
+/* Periodic trigger of the summary */
+static TimerHandle_t occupancy_period_timer;
+#if STATIC_ALLOCATION_ENABLE
+static StaticTimer_t occupancy_period_timer_buffer;
+#endif
+static void (*occupancy_due)(void);
+
+static radar_occupancy_stats_t occupancy_stats;
+
+/*******************************************************************************
+ * Function Name: advance
+ *******************************************************************************
+ * Summary:
+ *   Closes the buckets that ended before 'now_ms' and adds the occupied time
+ *   up to 'now_ms'. Called with the scheduler suspended.
+ *
+ * Parameters:
+ *   now_ms: current tick time in ms
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void advance(uint32_t now_ms)
+{
+    uint32_t elapsed;
+
+    if (!clock_started)
+    {
+        bucket_start_ms = now_ms;
+        accounted_ms = now_ms;
+        clock_started = true;
+    }
+
+    /* After a gap longer than the ring every bucket lies within the gap and
+     * only holds the state carried through it */
+    elapsed = (now_ms - bucket_start_ms) / RADAR_OCCUPANCY_BUCKET_MS;
+    if (elapsed > RADAR_OCCUPANCY_BUCKETS)
+    {
+        for (uint32_t i = 0; i < RADAR_OCCUPANCY_BUCKETS; i++)
+        {
+            memset(&buckets[i], 0, sizeof(buckets[i]));
+            buckets[i].peak = (level > UINT16_MAX) ? UINT16_MAX : (uint16_t)level;
+            buckets[i].occupied_ms = occupied ? RADAR_OCCUPANCY_BUCKET_MS : 0u;
+        }
+        buckets[head].occupied_ms = 0;
+        bucket_start_ms += elapsed * RADAR_OCCUPANCY_BUCKET_MS;
+        accounted_ms = bucket_start_ms;
+        complete_buckets = RADAR_OCCUPANCY_BUCKETS - 1u;
+    }
+
+    while ((now_ms - bucket_start_ms) >= RADAR_OCCUPANCY_BUCKET_MS)
+    {
+        uint32_t bucket_end_ms = bucket_start_ms + RADAR_OCCUPANCY_BUCKET_MS;
+
+        if (occupied)
+        {
+            buckets[head].occupied_ms += bucket_end_ms - accounted_ms;
+            accounted_ms = bucket_end_ms;
+        }
+
+        head = (head + 1u) % RADAR_OCCUPANCY_BUCKETS;
+        memset(&buckets[head], 0, sizeof(buckets[head]));
+        /* The level carried into a bucket counts for its peak */
+        buckets[head].peak = (level > UINT16_MAX) ? UINT16_MAX : (uint16_t)level;
+        bucket_start_ms = bucket_end_ms;
+        if (complete_buckets < (RADAR_OCCUPANCY_BUCKETS - 1u))
+        {
+            complete_buckets++;
+        }
+    }
+
+    if (occupied)
+    {
+        buckets[head].occupied_ms += now_ms - accounted_ms;
+        accounted_ms = now_ms;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: dwell_bin
+ *******************************************************************************
+ * Summary:
+ *   Returns the histogram bin of an occupied period.
+ *
+ * Parameters:
+ *   dwell_ms: length of the period in ms
+ *
+ * Return:
+ *   bin index
+ ******************************************************************************/
+static uint32_t dwell_bin(uint32_t dwell_ms)
+{
+    uint32_t bin = 0;
+
+    while ((bin < (RADAR_OCCUPANCY_DWELL_BINS - 1u)) && ((dwell_ms / 1000u) >= dwell_bounds_s[bin]))
+    {
+        bin++;
+    }
+
+    return bin;
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_record
+ *******************************************************************************
+ * Summary:
+ *   Adds a radar event to the current bucket. The occupancy level is the
+ *   number of people inside in entrance counter mode and 0/1 in presence
+ *   mode. An occupied period runs from PRESENCE_IN or COUNTER_OCCUPIED to
+ *   PRESENCE_OUT or COUNTER_FREE.
+ *
+ * Parameters:
+ *   event: mtb_radar_sensing_event_t
+ *   inside: people inside after the event, from the entrance counters
+ *   now_ms: tick time of the event in ms
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_occupancy_record(uint8_t event, uint64_t inside, uint32_t now_ms)
+{
+    occupancy_bucket_t *bucket;
+    bool starts = false;
+    bool ends = false;
+
+    vTaskSuspendAll();
+
+    advance(now_ms);
+    bucket = &buckets[head];
+
+    switch (event)
+    {
+        case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+            bucket->in++;
+            level = (inside > UINT32_MAX) ? UINT32_MAX : (uint32_t)inside;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+            bucket->out++;
+            level = (inside > UINT32_MAX) ? UINT32_MAX : (uint32_t)inside;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
+            starts = true;
+            break;
+        case MTB_RADAR_SENSING_EVENT_COUNTER_FREE:
+            ends = true;
+            break;
+        case MTB_RADAR_SENSING_EVENT_PRESENCE_IN:
+            bucket->in++;
+            starts = true;
+            level = 1u;
+            break;
+        case MTB_RADAR_SENSING_EVENT_PRESENCE_OUT:
+            bucket->out++;
+            ends = true;
+            level = 0u;
+            break;
+        default:
+            break;
+    }
+
+    if (starts && !occupied)
+    {
+        occupied = true;
+        occupied_since_ms = now_ms;
+        accounted_ms = now_ms;
+    }
+    else if (ends && occupied)
+    {
+        occupied = false;
+        bucket->dwell[dwell_bin(now_ms - occupied_since_ms)]++;
+    }
+
+    if (level > bucket->peak)
+    {
+        bucket->peak = (level > UINT16_MAX) ? UINT16_MAX : (uint16_t)level;
+    }
+
+    (void)xTaskResumeAll();
+}
+
+/*******************************************************************************
+ * Function Name: occupancy_period_callback
+ *******************************************************************************
+ * Summary:
+ *   Timer service callback, signals that a summary is due.
+ *
+ * Parameters:
+ *   timer: period timer
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void occupancy_period_callback(TimerHandle_t timer)
+{
+    (void)timer;
+
+    occupancy_due();
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_start
+ *******************************************************************************
+ * Summary:
+ *   Starts the periodic occupancy summaries.
+ *
+ * Parameters:
+ *   due: called from the timer service task every RADAR_OCCUPANCY_PERIOD_MS,
+ *        must not block
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_occupancy_start(void (*due)(void))
+{
+    occupancy_due = due;
+
+#if STATIC_ALLOCATION_ENABLE
+    occupancy_period_timer = xTimerCreateStatic("Stats timer", pdMS_TO_TICKS(RADAR_OCCUPANCY_PERIOD_MS),
+                                                pdTRUE, NULL, occupancy_period_callback,
+                                                &occupancy_period_timer_buffer);
+#else
+    occupancy_period_timer = xTimerCreate("Stats timer", pdMS_TO_TICKS(RADAR_OCCUPANCY_PERIOD_MS),
+                                          pdTRUE, NULL, occupancy_period_callback);
+#endif
+    app_memory_add("Diag", "Stats timer", sizeof(StaticTimer_t), STATIC_ALLOCATION_ENABLE);
+    app_memory_add("Diag", "Occupancy buckets", sizeof(buckets), true);
+    if ((occupancy_period_timer == NULL) || (xTimerStart(occupancy_period_timer, 0) != pdPASS))
+    {
+        printf("Occupancy: period timer start failed\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_format
+ *******************************************************************************
+ * Summary:
+ *   Adds up the complete buckets of every window and formats the summary as a
+ *   compact JSON object, e.g.
+ *   {"up_s":900,"in_total":12,"out_total":9,"1m":{"span":1,"in":3,"out":2,
+ *   "in_ph":180,"out_ph":120,"peak":4,"occ_s":35,"dwell":[1,0,2,0,0,0,0]},
+ *   "15m":{...},"1h":{...}}
+ *   'span' is the number of minutes covered, 'in_ph'/'out_ph' the rates per
+ *   hour over the span, 'occ_s' the occupied seconds and 'dwell' the occupied
+ *   periods per RADAR_OCCUPANCY_DWELL_BOUNDS_S bin. 'in_total'/'out_total'
+ *   are the 64-bit entrance counter totals.
+ *
+ * Parameters:
+ *   buffer: destination of the NUL-terminated JSON string
+ *   buffer_size: size of the buffer
+ *   now_ms: current tick time in ms
+ *
+ * Return:
+ *   length of the JSON string, 0 if the buffer is too small
+ ******************************************************************************/
+size_t radar_occupancy_format(char *buffer, size_t buffer_size, uint32_t now_ms)
+{
+    occupancy_window_t sums[OCCUPANCY_WINDOW_COUNT];
+    radar_counter_snapshot_t counts;
+    char total_in[RADAR_COUNTER_U64_LENGTH];
+    char total_out[RADAR_COUNTER_U64_LENGTH];
+    size_t len;
+    int written;
+
+    memset(sums, 0, sizeof(sums));
+
+    vTaskSuspendAll();
+    advance(now_ms);
+    for (uint32_t w = 0; w < OCCUPANCY_WINDOW_COUNT; w++)
+    {
+        occupancy_window_t *sum = &sums[w];
+
+        sum->span = (windows[w].buckets < complete_buckets) ? windows[w].buckets : complete_buckets;
+        for (uint32_t i = 1; i <= sum->span; i++)
+        {
+            const occupancy_bucket_t *bucket =
+                &buckets[(head + RADAR_OCCUPANCY_BUCKETS - i) % RADAR_OCCUPANCY_BUCKETS];
+
+            sum->in += bucket->in;
+            sum->out += bucket->out;
+            sum->occupied_ms += bucket->occupied_ms;
+            if (bucket->peak > sum->peak)
+            {
+                sum->peak = bucket->peak;
+            }
+            for (uint32_t bin = 0; bin < RADAR_OCCUPANCY_DWELL_BINS; bin++)
+            {
+                sum->dwell[bin] += bucket->dwell[bin];
+            }
+        }
+    }
+    (void)xTaskResumeAll();
+
+    radar_counter_get_snapshot(&counts);
+    (void)radar_counter_format_u64(counts.in, total_in, sizeof(total_in));
+    (void)radar_counter_format_u64(counts.out, total_out, sizeof(total_out));
+
+    written = snprintf(buffer, buffer_size, "{\"up_s\":%lu,\"in_total\":%s,\"out_total\":%s",
+                       (unsigned long)(xTaskGetTickCount() / configTICK_RATE_HZ), total_in, total_out);
+    if ((written <= 0) || ((size_t)written >= buffer_size))
+    {
+        return 0;
+    }
+    len = (size_t)written;
+
+    for (uint32_t w = 0; w < OCCUPANCY_WINDOW_COUNT; w++)
+    {
+        const occupancy_window_t *sum = &sums[w];
+        uint32_t span_min = sum->span * (RADAR_OCCUPANCY_BUCKET_MS / 1000u) / 60u;
+
+        written = snprintf(&buffer[len], buffer_size - len,
+                           ",\"%s\":{\"span\":%lu,\"in\":%lu,\"out\":%lu,\"in_ph\":%lu,\"out_ph\":%lu,"
+                           "\"peak\":%lu,\"occ_s\":%lu,\"dwell\":[",
+                           windows[w].name, (unsigned long)span_min,
+                           (unsigned long)sum->in, (unsigned long)sum->out,
+                           (unsigned long)((span_min > 0) ? ((sum->in * 60u) / span_min) : 0u),
+                           (unsigned long)((span_min > 0) ? ((sum->out * 60u) / span_min) : 0u),
+                           (unsigned long)sum->peak, (unsigned long)(sum->occupied_ms / 1000u));
+        if ((written <= 0) || ((size_t)written >= (buffer_size - len)))
+        {
+            return 0;
+        }
+        len += (size_t)written;
+
+        for (uint32_t bin = 0; bin < RADAR_OCCUPANCY_DWELL_BINS; bin++)
+        {
+            written = snprintf(&buffer[len], buffer_size - len, "%s%lu%s",
+                               (bin == 0) ? "" : ",", (unsigned long)sum->dwell[bin],
+                               (bin == (RADAR_OCCUPANCY_DWELL_BINS - 1u)) ? "]}" : "");
+            if ((written <= 0) || ((size_t)written >= (buffer_size - len)))
+            {
+                return 0;
+            }
+            len += (size_t)written;
+        }
+    }
+
+    if ((len + 2u) > buffer_size)
+    {
+        return 0;
+    }
+    buffer[len++] = '}';
+    buffer[len] = '\0';
+
+    taskENTER_CRITICAL();
+    occupancy_stats.published++;
+    taskEXIT_CRITICAL();
+
+    return len;
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_skip
+ *******************************************************************************
+ * Summary:
+ *   Counts a summary that was skipped to not delay radar events. The windows
+ *   are kept, the next summary covers them.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_occupancy_skip(void)
+{
+    taskENTER_CRITICAL();
+    occupancy_stats.skipped++;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_occupancy_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the summary counters. Can be called from any task.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_occupancy_get_stats(radar_occupancy_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = occupancy_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
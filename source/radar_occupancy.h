@@ -0,0 +1,79 @@
+/******************************************************************************
+ * File Name:   radar_occupancy.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_occupancy.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Length of one aggregation bucket in milliseconds. The windows are whole
+ * numbers of buckets. */
+#define RADAR_OCCUPANCY_BUCKET_MS      (60000u)
+
+/* Windows of a summary in buckets: tumbling 1 min, sliding 15 min and 1 h */
+#define RADAR_OCCUPANCY_WINDOW_LIST(X) \
+    X("1m", 1u)                         \
+    X("15m", 15u)                       \
+    X("1h", 60u)
+
+/* Buckets kept, the longest window plus the bucket being filled */
+#define RADAR_OCCUPANCY_BUCKETS        (60u + 1u)
+
+/* Upper bounds in seconds of the occupancy dwell time histogram bins, a last
+ * bin counts the longer stays */
+#define RADAR_OCCUPANCY_DWELL_BOUNDS_S { 10u, 30u, 60u, 300u, 900u, 3600u }
+#define RADAR_OCCUPANCY_DWELL_BINS     (7u)
+
+/* Interval in milliseconds between two summaries on 'MQTT_STATS_TOPIC' */
+#define RADAR_OCCUPANCY_PERIOD_MS      (RADAR_OCCUPANCY_BUCKET_MS)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the summaries */
+typedef struct
+{
+    uint32_t published;         /* Summaries handed to the publisher */
+    uint32_t skipped;           /* Summaries skipped to not delay radar events */
+} radar_occupancy_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Called from the radar task for every event of the library */
+void radar_occupancy_record(uint8_t event, uint64_t inside, uint32_t now_ms);
+
+void radar_occupancy_start(void (*due)(void));
+size_t radar_occupancy_format(char *buffer, size_t buffer_size, uint32_t now_ms);
+void radar_occupancy_skip(void);
+void radar_occupancy_get_stats(radar_occupancy_stats_t *stats);
+
+/* [] END OF FILE */
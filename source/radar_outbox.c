@@ -0,0 +1,218 @@
+/******************************************************************************
+ * File Name:   radar_outbox.c
+ *
+ * Description: This file implements the outbox of radar event records that
+ *              could not be published while the Wi-Fi or MQTT connection was
+ *              down. Records keep their order and sequence number and are
+ *              removed only after they were published, so that a failed
+ *              replay loses nothing. The outbox is owned by the publisher
+ *              task and needs no locking.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_outbox.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_OUTBOX_MASK (RADAR_OUTBOX_LENGTH - 1u)
+
+#if ((RADAR_OUTBOX_LENGTH & RADAR_OUTBOX_MASK) != 0u)
+#error "RADAR_OUTBOX_LENGTH must be a power of two."
+#endif
+
+/* Words of the bitmap of records that were sent before */
+#define RADAR_OUTBOX_SENT_WORDS ((RADAR_OUTBOX_LENGTH + 31u) / 32u)
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static radar_event_record_t outbox_records[RADAR_OUTBOX_LENGTH];
+
+/* Records whose publish failed without an acknowledgment, they may have
+ * reached the broker already */
+static uint32_t outbox_sent[RADAR_OUTBOX_SENT_WORDS];
+
+/* Free running indices, the difference is the number of records held */
+static uint32_t outbox_head = 0;
+static uint32_t outbox_tail = 0;
+
+static radar_outbox_stats_t outbox_stats;
+
+/*******************************************************************************
+ * Function Name: radar_outbox_put
+ *******************************************************************************
+ * Summary:
+ *   Appends a record. When the outbox is full the oldest record is dropped,
+ *   the newest state is worth more than the oldest after a long outage.
+ *
+ * Parameters:
+ *   record: record to keep
+ *   sent: true if the record was published without an acknowledgment
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_outbox_put(const radar_event_record_t *record, bool sent)
+{
+    uint32_t count;
+    uint32_t index;
+
+    if ((outbox_head - outbox_tail) == RADAR_OUTBOX_LENGTH)
+    {
+        outbox_tail++;
+        outbox_stats.dropped++;
+    }
+
+    index = outbox_head & RADAR_OUTBOX_MASK;
+    outbox_records[index] = *record;
+    if (sent)
+    {
+        outbox_sent[index / 32u] |= (1uL << (index % 32u));
+    }
+    else
+    {
+        outbox_sent[index / 32u] &= ~(1uL << (index % 32u));
+    }
+    outbox_head++;
+    outbox_stats.stored++;
+
+    count = outbox_head - outbox_tail;
+    if (count > outbox_stats.high_water)
+    {
+        outbox_stats.high_water = count;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_outbox_peek
+ *******************************************************************************
+ * Summary:
+ *   Copies the oldest records without removing them.
+ *
+ * Parameters:
+ *   records: destination array
+ *   max_count: capacity of 'records'
+ *   sent: set to true if any copied record was sent before
+ *
+ * Return:
+ *   number of records copied
+ ******************************************************************************/
+uint32_t radar_outbox_peek(radar_event_record_t *records, uint32_t max_count, bool *sent)
+{
+    uint32_t count = outbox_head - outbox_tail;
+    uint32_t index;
+
+    if (count > max_count)
+    {
+        count = max_count;
+    }
+
+    *sent = false;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        index = (outbox_tail + i) & RADAR_OUTBOX_MASK;
+        records[i] = outbox_records[index];
+        if ((outbox_sent[index / 32u] & (1uL << (index % 32u))) != 0u)
+        {
+            *sent = true;
+        }
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_outbox_consume
+ *******************************************************************************
+ * Summary:
+ *   Removes the oldest records once they were published.
+ *
+ * Parameters:
+ *   count: number of records to remove, as returned by radar_outbox_peek()
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_outbox_consume(uint32_t count)
+{
+    uint32_t held = outbox_head - outbox_tail;
+
+    if (count > held)
+    {
+        count = held;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t index = (outbox_tail + i) & RADAR_OUTBOX_MASK;
+
+        if ((outbox_sent[index / 32u] & (1uL << (index % 32u))) != 0u)
+        {
+            outbox_stats.resent++;
+        }
+    }
+
+    outbox_tail += count;
+    outbox_stats.replayed += count;
+}
+
+/*******************************************************************************
+ * Function Name: radar_outbox_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of records waiting for replay.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of records held
+ ******************************************************************************/
+uint32_t radar_outbox_count(void)
+{
+    return outbox_head - outbox_tail;
+}
+
+/*******************************************************************************
+ * Function Name: radar_outbox_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the outbox counters. Can be called from any task.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_outbox_get_stats(radar_outbox_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = outbox_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * File Name:   radar_outbox.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_outbox.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "radar_event_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Number of event records kept while the broker is unreachable. Must be a
+ * power of two. When full, the oldest record is dropped. */
+#define RADAR_OUTBOX_LENGTH (64u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the outbox */
+typedef struct
+{
+    uint32_t stored;            /* Records put into the outbox */
+    uint32_t replayed;          /* Records removed after a successful publish */
+    uint32_t dropped;           /* Oldest records overwritten because the outbox was full */
+    uint32_t high_water;        /* Maximum number of records held at once */
+    uint32_t resent;            /* Records replayed that had been sent before */
+} radar_outbox_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Called from the publisher task only */
+void radar_outbox_put(const radar_event_record_t *record, bool sent);
+uint32_t radar_outbox_peek(radar_event_record_t *records, uint32_t max_count, bool *sent);
+void radar_outbox_consume(uint32_t count);
+uint32_t radar_outbox_count(void);
+
+void radar_outbox_get_stats(radar_outbox_stats_t *stats);
+
+/* [] END OF FILE */
@@ -0,0 +1,328 @@
+/******************************************************************************
+ * File Name:   radar_sim.c
+ *
+ * Description: This file implements a stand-in of the xensiv-radar-sensing
+ *              library used when RADAR_SIMULATION_ENABLE is set. It replays a
+ *              trace file of presence or entrance counter events through the
+ *              regular sensing callback, so that the rest of the application
+ *              runs unchanged without a radar wing board. The firmware
+ *              compiles the trace in, the host build can load another one.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_sim.h"
+#include "radar_task.h"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* One step of the replayed trace */
+typedef struct
+{
+    uint32_t delay_ms;                  /* Time since the previous step */
+    mtb_radar_sensing_event_t event;
+    uint16_t distance_mm;               /* Presence events only */
+} radar_sim_step_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Trace replayed unless another one is loaded, see radar_sim_*.trace */
+static const radar_sim_step_t radar_sim_default_trace[] =
+{
+#ifdef RADAR_ENTRANCE_COUNTER_MODE
+#include "radar_sim_counter.trace"
+#else
+#include "radar_sim_presence.trace"
+#endif
+};
+
+static const radar_sim_step_t *radar_sim_trace = radar_sim_default_trace;
+static uint32_t radar_sim_trace_length = sizeof(radar_sim_default_trace) / sizeof(radar_sim_default_trace[0]);
+
+#if RADAR_SIM_FILE_ENABLE
+/* Steps of the trace read by radar_sim_load() */
+static radar_sim_step_t radar_sim_loaded_trace[RADAR_SIM_MAX_STEPS];
+
+/* Names of the events in a trace file */
+static const struct
+{
+    const char *name;
+    mtb_radar_sensing_event_t event;
+} radar_sim_event_names[] =
+{
+    { "MTB_RADAR_SENSING_EVENT_COUNTER_IN", MTB_RADAR_SENSING_EVENT_COUNTER_IN },
+    { "MTB_RADAR_SENSING_EVENT_COUNTER_OUT", MTB_RADAR_SENSING_EVENT_COUNTER_OUT },
+    { "MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED", MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED },
+    { "MTB_RADAR_SENSING_EVENT_COUNTER_FREE", MTB_RADAR_SENSING_EVENT_COUNTER_FREE },
+    { "MTB_RADAR_SENSING_EVENT_PRESENCE_IN", MTB_RADAR_SENSING_EVENT_PRESENCE_IN },
+    { "MTB_RADAR_SENSING_EVENT_PRESENCE_OUT", MTB_RADAR_SENSING_EVENT_PRESENCE_OUT },
+};
+#endif
+
+static mtb_radar_sensing_callback_t radar_sim_callback = NULL;
+static void *radar_sim_callback_data = NULL;
+
+/* Next step to replay and the time it is due */
+static uint32_t radar_sim_step = 0;
+static uint64_t radar_sim_due_ms = 0;
+static bool radar_sim_started = false;
+
+static radar_sim_stats_t radar_sim_stats;
+
+/*******************************************************************************
+ * Function Name: step_delay
+ *******************************************************************************
+ * Summary:
+ *   Delay of a trace step, scaled by RADAR_SIM_SPEEDUP.
+ *
+ * Parameters:
+ *   step: index into the trace
+ *
+ * Return:
+ *   delay in ms
+ ******************************************************************************/
+static uint64_t step_delay(uint32_t step)
+{
+    return radar_sim_trace[step].delay_ms / RADAR_SIM_SPEEDUP;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sim_init
+ *******************************************************************************
+ * Summary:
+ *   Registers the sensing callback, the counterpart of
+ *   mtb_radar_sensing_register_callback(). The trace starts with the first
+ *   call of radar_sim_process().
+ *
+ * Parameters:
+ *   callback: sensing callback
+ *   data: user data passed to the callback
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_sim_init(mtb_radar_sensing_callback_t callback, void *data)
+{
+    radar_sim_callback = callback;
+    radar_sim_callback_data = data;
+    radar_sim_step = 0;
+    radar_sim_started = false;
+
+    printf("Radar simulation: replaying %u events, speed-up %u\n",
+           (unsigned int)radar_sim_trace_length,
+           (unsigned int)RADAR_SIM_SPEEDUP);
+}
+
+#if RADAR_SIM_FILE_ENABLE
+/*******************************************************************************
+ * Function Name: radar_sim_load
+ *******************************************************************************
+ * Summary:
+ *   Replaces the compiled-in trace with the steps of a trace file, in the
+ *   format of radar_sim_*.trace: one "{ delay_ms, event, distance_mm }," step
+ *   per line, and comment lines. Call it before radar_sim_init(). On an
+ *   error, the trace in use is kept.
+ *
+ * Parameters:
+ *   path: trace file
+ *
+ * Return:
+ *   true if the file held at least one step and no invalid line
+ ******************************************************************************/
+bool radar_sim_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[160];
+    uint32_t line_number = 0;
+    uint32_t length = 0;
+    bool result = true;
+
+    if (file == NULL)
+    {
+        printf("Radar simulation: cannot open '%s'\n", path);
+        return false;
+    }
+
+    while (result && (fgets(line, sizeof(line), file) != NULL))
+    {
+        const char *text = line;
+        unsigned int delay_ms;
+        unsigned int distance_mm;
+        char name[48];
+        uint32_t i;
+
+        line_number++;
+        while ((*text == ' ') || (*text == '\t'))
+        {
+            text++;
+        }
+        if ((*text == '\0') || (*text == '\n') || (*text == '\r') || (*text == '*') ||
+            (strncmp(text, "/*", 2) == 0) || (strncmp(text, "//", 2) == 0))
+        {
+            continue;
+        }
+
+        result = (sscanf(text, "{ %u , %47[A-Z_] , %u }", &delay_ms, name, &distance_mm) == 3) &&
+                 (length < RADAR_SIM_MAX_STEPS) && (distance_mm <= UINT16_MAX);
+        for (i = 0; result && (i < (sizeof(radar_sim_event_names) / sizeof(radar_sim_event_names[0]))); i++)
+        {
+            if (strcmp(name, radar_sim_event_names[i].name) == 0)
+            {
+                break;
+            }
+        }
+        if (!result || (i == (sizeof(radar_sim_event_names) / sizeof(radar_sim_event_names[0]))))
+        {
+            printf("Radar simulation: invalid step at %s:%u\n", path, (unsigned int)line_number);
+            result = false;
+            break;
+        }
+
+        radar_sim_loaded_trace[length].delay_ms = delay_ms;
+        radar_sim_loaded_trace[length].event = radar_sim_event_names[i].event;
+        radar_sim_loaded_trace[length].distance_mm = (uint16_t)distance_mm;
+        length++;
+    }
+    fclose(file);
+
+    if (result && (length == 0))
+    {
+        printf("Radar simulation: '%s' holds no step\n", path);
+        result = false;
+    }
+    if (result)
+    {
+        radar_sim_trace = radar_sim_loaded_trace;
+        radar_sim_trace_length = length;
+    }
+
+    return result;
+}
+#endif /* RADAR_SIM_FILE_ENABLE */
+
+/*******************************************************************************
+ * Function Name: radar_sim_process
+ *******************************************************************************
+ * Summary:
+ *   Counterpart of mtb_radar_sensing_process(). Emits every trace event that
+ *   is due at 'time_ms', up to RADAR_SIM_MAX_EVENTS_PER_PROCESS, and restarts
+ *   the trace at its end.
+ *
+ * Parameters:
+ *   context: radar sensing context, handed to the callback
+ *   time_ms: current time in ms
+ *
+ * Return:
+ *   MTB_RADAR_SENSING_SUCCESS
+ ******************************************************************************/
+mtb_radar_sensing_result_t radar_sim_process(mtb_radar_sensing_context_t *context, uint64_t time_ms)
+{
+    uint32_t emitted = 0;
+
+    if (!radar_sim_started)
+    {
+        radar_sim_due_ms = time_ms + step_delay(0);
+        radar_sim_started = true;
+    }
+
+    while ((time_ms >= radar_sim_due_ms) && (emitted < RADAR_SIM_MAX_EVENTS_PER_PROCESS))
+    {
+        const radar_sim_step_t *step = &radar_sim_trace[radar_sim_step];
+        mtb_radar_sensing_presence_event_info_t info = { 0 };
+
+        /* Every event info starts with the common part holding the timestamp */
+        ((mtb_radar_sensing_event_info_t *)&info)->timestamp = radar_sim_due_ms;
+        info.distance = (float)step->distance_mm / 1000.0f;
+        info.accuracy = 0.1f;
+
+        if (radar_sim_callback != NULL)
+        {
+            radar_sim_callback(context, step->event, (mtb_radar_sensing_event_info_t *)&info, radar_sim_callback_data);
+        }
+        radar_sim_stats.events++;
+        emitted++;
+
+        if (++radar_sim_step >= radar_sim_trace_length)
+        {
+            radar_sim_step = 0;
+            radar_sim_stats.loops++;
+        }
+        radar_sim_due_ms += step_delay(radar_sim_step);
+    }
+
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sim_set_parameter
+ *******************************************************************************
+ * Summary:
+ *   Counterpart of mtb_radar_sensing_set_parameter(). Values are already
+ *   validated by the parameter registry, they are only logged.
+ *
+ * Parameters:
+ *   context: radar sensing context, unused
+ *   key: parameter name
+ *   value: parameter value
+ *
+ * Return:
+ *   MTB_RADAR_SENSING_SUCCESS
+ ******************************************************************************/
+mtb_radar_sensing_result_t radar_sim_set_parameter(mtb_radar_sensing_context_t *context,
+                                                   const char *key,
+                                                   const char *value)
+{
+    (void)context;
+
+    printf("Radar simulation: %s = %s\n", key, value);
+    radar_sim_stats.parameters++;
+
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sim_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the simulation counters.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_sim_get_stats(radar_sim_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = radar_sim_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * File Name:   radar_sim.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_sim.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mtb_radar_sensing.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Factor by which the trace is replayed faster than recorded. Raise it to
+ * load test the publisher pipeline with a higher event rate. */
+#define RADAR_SIM_SPEEDUP (1u)
+
+/* Most events emitted by one radar_sim_process() call */
+#define RADAR_SIM_MAX_EVENTS_PER_PROCESS (8u)
+
+/* Set to 1 where a file system is available, e.g. in the host build, to load
+ * trace files with radar_sim_load() */
+#ifndef RADAR_SIM_FILE_ENABLE
+#define RADAR_SIM_FILE_ENABLE (0)
+#endif
+
+/* Most steps of a loaded trace */
+#define RADAR_SIM_MAX_STEPS (1024u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the simulated radar */
+typedef struct
+{
+    uint32_t events;            /* Events passed to the sensing callback */
+    uint32_t loops;             /* Complete replays of the trace */
+    uint32_t parameters;        /* Parameters accepted by radar_sim_set_parameter() */
+} radar_sim_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+#if RADAR_SIM_FILE_ENABLE
+bool radar_sim_load(const char *path);
+#endif
+void radar_sim_init(mtb_radar_sensing_callback_t callback, void *data);
+mtb_radar_sensing_result_t radar_sim_process(mtb_radar_sensing_context_t *context, uint64_t time_ms);
+mtb_radar_sensing_result_t radar_sim_set_parameter(mtb_radar_sensing_context_t *context,
+                                                   const char *key,
+                                                   const char *value);
+void radar_sim_get_stats(radar_sim_stats_t *stats);
+
+/* [] END OF FILE */
@@ -0,0 +1,820 @@
+/******************************************************************************
+ * File Name:   radar_store.c
+ *
+ * Description: This file implements the persistent store of the radar
+ *   configuration values and the entrance counters. The values are kept in a
+ *   RAM table and journaled to the emulated EEPROM flash region in slots
+ *   written round robin, so the wear is spread over all rows:
+ *   - An append slot holds the values changed since the last slot.
+ *   - A checkpoint slot holds all values and starts a new chain.
+ *   Every slot carries a sequence number and a CRC. At boot, the chain from
+ *   the newest valid checkpoint is replayed up to the first missing or
+ *   corrupted slot, so a write cut by a reset only loses its own changes. A
+ *   checkpoint is written before the chain could reach the slot holding its
+ *   start, so the slot being written is never part of the valid chain.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cyhal.h"
+#include "cy_utils.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_memory.h"
+#include "radar_config_params.h"
+#include "radar_counter.h"
+#include "radar_diag.h"
+#include "radar_store.h"
+#include "radar_task.h"
+
+#if RADAR_STORE_ENABLE
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define STORE_MAGIC              (0x52534A31u)  /* "RSJ1" */
+#define STORE_FLAG_CHECKPOINT    (0x0001u)
+
+#define STORE_HEADER_SIZE        (sizeof(store_header_t))
+/* Key, length and value bytes of one entry */
+#define STORE_ENTRY_SIZE(length) (3u + (length))
+#define STORE_SLOT_ROWS          (RADAR_STORE_SLOT_SIZE / CY_FLASH_SIZEOF_ROW)
+
+#if ((RADAR_STORE_SLOT_SIZE % CY_FLASH_SIZEOF_ROW) != 0)
+#error "RADAR_STORE_SLOT_SIZE must be a multiple of the flash row size."
+#endif
+
+#if ((16u + (RADAR_STORE_MAX_KEYS * (3u + RADAR_STORE_VALUE_LENGTH - 1u))) > RADAR_STORE_SLOT_SIZE)
+#error "A checkpoint of RADAR_STORE_MAX_KEYS values does not fit into a slot."
+#endif
+
+#if (RADAR_STORE_COMPACT_SLOTS >= (RADAR_STORE_SLOTS - 1u))
+#error "RADAR_STORE_COMPACT_SLOTS must leave a free slot for the checkpoint."
+#endif
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Start of every slot, followed by 'length' bytes of entries */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;               /* Consecutive over all slots, never 0 */
+    uint16_t length;
+    uint16_t flags;             /* STORE_FLAG_* */
+    uint32_t crc;               /* CRC-32 of seq, length, flags and the entries */
+} store_header_t;
+
+/* One value of the RAM table */
+typedef struct
+{
+    uint16_t key;               /* 0 if unused */
+    uint8_t length;
+    bool dirty;                 /* Changed since the last slot */
+    char value[RADAR_STORE_VALUE_LENGTH];
+} store_entry_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Journal in the emulated EEPROM region of the flash, erased by programming */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t store_flash[RADAR_STORE_SLOTS * RADAR_STORE_SLOT_SIZE] = { 0u };
+
+APP_TASK_MEMORY(radar_store_task, RADAR_STORE_TASK_STACK_SIZE)
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+static cyhal_flash_t flash_obj;
+static bool flash_ready = false;
+
+static TaskHandle_t radar_store_task_handle = NULL;
+
+static store_entry_t entries[RADAR_STORE_MAX_KEYS];
+
+/* Word aligned, cyhal_flash_write() programs whole rows from RAM */
+static uint32_t slot_buffer[RADAR_STORE_SLOT_SIZE / sizeof(uint32_t)];
+
+/* Newest valid slot and the checkpoint its chain starts with */
+static bool journal_empty = true;
+static uint32_t newest_slot = 0;
+static uint32_t newest_seq = 0;
+static uint32_t checkpoint_seq = 0;
+
+/* Counter update number of the last written counters */
+static uint32_t stored_counter_seq = 0;
+
+static radar_store_stats_t store_stats;
+
+/*******************************************************************************
+ * Function Name: crc32
+ *******************************************************************************
+ * Summary:
+ *   Continues a CRC-32 (IEEE 802.3) over a block of bytes.
+ *
+ * Parameters:
+ *   crc: result of the previous block, 0 for the first one
+ *   data: bytes to add
+ *   length: number of bytes
+ *
+ * Return:
+ *   CRC over all blocks so far
+ ******************************************************************************/
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t length)
+{
+    crc = ~crc;
+    while (length-- > 0u)
+    {
+        crc ^= *data++;
+        for (uint32_t bit = 0; bit < 8u; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+
+    return ~crc;
+}
+
+/*******************************************************************************
+ * Function Name: slot_crc
+ *******************************************************************************
+ * Summary:
+ *   Computes the CRC of the slot in slot_buffer, skipping the magic number
+ *   and the CRC field of the header.
+ *
+ * Parameters:
+ *   header: header of the slot in slot_buffer
+ *
+ * Return:
+ *   CRC of the slot
+ ******************************************************************************/
+static uint32_t slot_crc(const store_header_t *header)
+{
+    const uint8_t *bytes = (const uint8_t *)slot_buffer;
+    uint32_t crc;
+
+    crc = crc32(0u, &bytes[offsetof(store_header_t, seq)],
+                offsetof(store_header_t, crc) - offsetof(store_header_t, seq));
+    return crc32(crc, &bytes[STORE_HEADER_SIZE], header->length);
+}
+
+/*******************************************************************************
+ * Function Name: read_slot
+ *******************************************************************************
+ * Summary:
+ *   Reads a slot into slot_buffer and checks it.
+ *
+ * Parameters:
+ *   slot: slot index
+ *
+ * Return:
+ *   header of the slot, NULL if it holds no valid data
+ ******************************************************************************/
+static const store_header_t *read_slot(uint32_t slot)
+{
+    const store_header_t *header = (const store_header_t *)slot_buffer;
+    uint32_t address = (uint32_t)(uintptr_t)&store_flash[slot * RADAR_STORE_SLOT_SIZE];
+
+    if (cyhal_flash_read(&flash_obj, address, (uint8_t *)slot_buffer, RADAR_STORE_SLOT_SIZE) != CY_RSLT_SUCCESS)
+    {
+        return NULL;
+    }
+
+    if ((header->magic != STORE_MAGIC) || (header->seq == 0u) ||
+        (header->length > (RADAR_STORE_SLOT_SIZE - STORE_HEADER_SIZE)) ||
+        (header->crc != slot_crc(header)))
+    {
+        return NULL;
+    }
+
+    return header;
+}
+
+/*******************************************************************************
+ * Function Name: find_entry
+ *******************************************************************************
+ * Summary:
+ *   Looks up a key in the RAM table.
+ *
+ * Parameters:
+ *   key: key to look up
+ *   create: take a free entry if the key is not present
+ *
+ * Return:
+ *   entry, NULL if not present and 'create' is false or the table is full
+ ******************************************************************************/
+static store_entry_t *find_entry(uint16_t key, bool create)
+{
+    store_entry_t *free_entry = NULL;
+
+    for (uint32_t i = 0; i < RADAR_STORE_MAX_KEYS; i++)
+    {
+        if (entries[i].key == key)
+        {
+            return &entries[i];
+        }
+        if ((entries[i].key == 0u) && (free_entry == NULL))
+        {
+            free_entry = &entries[i];
+        }
+    }
+
+    if (create && (free_entry != NULL))
+    {
+        free_entry->key = key;
+        return free_entry;
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: set_entry
+ *******************************************************************************
+ * Summary:
+ *   Updates a value of the RAM table if it changed.
+ *
+ * Parameters:
+ *   key: key of the value
+ *   value: bytes of the value, not null terminated
+ *   length: number of bytes
+ *   dirty: mark the value for the next slot
+ *
+ * Return:
+ *   false if the table is full or the value too long
+ ******************************************************************************/
+static bool set_entry(uint16_t key, const char *value, size_t length, bool dirty)
+{
+    store_entry_t *entry = find_entry(key, true);
+
+    if ((entry == NULL) || (length >= RADAR_STORE_VALUE_LENGTH))
+    {
+        return false;
+    }
+
+    if ((entry->length != length) || (memcmp(entry->value, value, length) != 0))
+    {
+        memcpy(entry->value, value, length);
+        entry->value[length] = '\0';
+        entry->length = (uint8_t)length;
+        entry->dirty = dirty;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: replay_slot
+ *******************************************************************************
+ * Summary:
+ *   Copies the values of the slot in slot_buffer into the RAM table.
+ *
+ * Parameters:
+ *   header: header of the slot in slot_buffer
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void replay_slot(const store_header_t *header)
+{
+    const uint8_t *data = &((const uint8_t *)slot_buffer)[STORE_HEADER_SIZE];
+    uint32_t offset = 0;
+
+    while ((offset + STORE_ENTRY_SIZE(0u)) <= header->length)
+    {
+        uint16_t key = (uint16_t)(data[offset] | (data[offset + 1u] << 8));
+        uint8_t length = data[offset + 2u];
+
+        if ((offset + STORE_ENTRY_SIZE(length)) > header->length)
+        {
+            break;
+        }
+        (void)set_entry(key, (const char *)&data[offset + 3u], length, false);
+        offset += STORE_ENTRY_SIZE(length);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: load_journal
+ *******************************************************************************
+ * Summary:
+ *   Finds the newest valid checkpoint and replays its chain into the RAM
+ *   table.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void load_journal(void)
+{
+    uint32_t slot_seq[RADAR_STORE_SLOTS];
+    bool found = false;
+    uint32_t start_slot = 0;
+
+    for (uint32_t slot = 0; slot < RADAR_STORE_SLOTS; slot++)
+    {
+        const store_header_t *header = read_slot(slot);
+
+        slot_seq[slot] = (header != NULL) ? header->seq : 0u;
+        if ((header != NULL) && ((header->flags & STORE_FLAG_CHECKPOINT) != 0u) &&
+            (!found || (header->seq > checkpoint_seq)))
+        {
+            found = true;
+            checkpoint_seq = header->seq;
+            start_slot = slot;
+        }
+    }
+
+    if (!found)
+    {
+        return;
+    }
+
+    /* Slots are written round robin, the chain follows the checkpoint */
+    journal_empty = false;
+    newest_slot = start_slot;
+    newest_seq = checkpoint_seq;
+    for (uint32_t i = 0; i < RADAR_STORE_SLOTS; i++)
+    {
+        uint32_t slot = (start_slot + i) % RADAR_STORE_SLOTS;
+        const store_header_t *header;
+
+        if (slot_seq[slot] != (checkpoint_seq + i))
+        {
+            break;
+        }
+
+        /* Read again, the CRC is checked once more */
+        header = read_slot(slot);
+        if (header == NULL)
+        {
+            break;
+        }
+        replay_slot(header);
+        store_stats.replayed_slots++;
+        newest_slot = slot;
+        newest_seq = header->seq;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: serialize
+ *******************************************************************************
+ * Summary:
+ *   Copies the entries of a slot into slot_buffer. Called with the scheduler
+ *   suspended.
+ *
+ * Parameters:
+ *   checkpoint: all values instead of the changed ones
+ *
+ * Return:
+ *   number of entry bytes, 0 if they do not fit into a slot
+ ******************************************************************************/
+static uint32_t serialize(bool checkpoint)
+{
+    uint8_t *data = &((uint8_t *)slot_buffer)[STORE_HEADER_SIZE];
+    uint32_t length = 0;
+
+    for (uint32_t i = 0; i < RADAR_STORE_MAX_KEYS; i++)
+    {
+        const store_entry_t *entry = &entries[i];
+
+        if ((entry->key == 0u) || (!checkpoint && !entry->dirty))
+        {
+            continue;
+        }
+        if ((STORE_HEADER_SIZE + length + STORE_ENTRY_SIZE(entry->length)) > RADAR_STORE_SLOT_SIZE)
+        {
+            return 0;
+        }
+        data[length] = (uint8_t)(entry->key & 0xFFu);
+        data[length + 1u] = (uint8_t)(entry->key >> 8);
+        data[length + 2u] = entry->length;
+        memcpy(&data[length + 3u], entry->value, entry->length);
+        length += STORE_ENTRY_SIZE(entry->length);
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: write_slot
+ *******************************************************************************
+ * Summary:
+ *   Serializes the values into the next slot and programs its rows. Changes
+ *   that do not fit into an append slot are written as a checkpoint.
+ *
+ * Parameters:
+ *   checkpoint: write all values instead of the changed ones
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void write_slot(bool checkpoint)
+{
+    store_header_t *header = (store_header_t *)slot_buffer;
+    uint32_t slot = journal_empty ? 0u : ((newest_slot + 1u) % RADAR_STORE_SLOTS);
+    uint32_t seq = newest_seq + 1u;
+    uint32_t length;
+    uint32_t rows;
+    bool written = true;
+
+    /* The chain must not grow onto the slot holding its checkpoint */
+    if (journal_empty || ((seq - checkpoint_seq) >= (RADAR_STORE_SLOTS - 1u)))
+    {
+        checkpoint = true;
+    }
+
+    vTaskSuspendAll();
+    length = serialize(checkpoint);
+    if (!checkpoint && (length == 0u))
+    {
+        /* A checkpoint always fits, see the size check above */
+        checkpoint = true;
+        length = serialize(true);
+    }
+    for (uint32_t i = 0; i < RADAR_STORE_MAX_KEYS; i++)
+    {
+        entries[i].dirty = false;
+    }
+    (void)xTaskResumeAll();
+
+    header->magic = STORE_MAGIC;
+    header->seq = seq;
+    header->length = (uint16_t)length;
+    header->flags = checkpoint ? STORE_FLAG_CHECKPOINT : 0u;
+    header->crc = slot_crc(header);
+
+    rows = (STORE_HEADER_SIZE + length + CY_FLASH_SIZEOF_ROW - 1u) / CY_FLASH_SIZEOF_ROW;
+    for (uint32_t row = 0; row < rows; row++)
+    {
+        uint32_t address = (uint32_t)(uintptr_t)&store_flash[(slot * RADAR_STORE_SLOT_SIZE) + (row * CY_FLASH_SIZEOF_ROW)];
+
+        if (cyhal_flash_write(&flash_obj, address, &slot_buffer[(row * CY_FLASH_SIZEOF_ROW) / sizeof(uint32_t)]) !=
+            CY_RSLT_SUCCESS)
+        {
+            written = false;
+            break;
+        }
+        store_stats.rows_written++;
+    }
+
+    if (!written)
+    {
+        /* Write everything again with the next slot */
+        vTaskSuspendAll();
+        for (uint32_t i = 0; i < RADAR_STORE_MAX_KEYS; i++)
+        {
+            entries[i].dirty = (entries[i].key != 0u);
+        }
+        (void)xTaskResumeAll();
+        store_stats.write_errors++;
+        printf("Store: writing slot %lu failed\n", (unsigned long)slot);
+        return;
+    }
+
+    journal_empty = false;
+    newest_slot = slot;
+    newest_seq = seq;
+    if (checkpoint)
+    {
+        checkpoint_seq = seq;
+        store_stats.checkpoints++;
+    }
+    else
+    {
+        store_stats.appends++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: has_dirty_entries
+ *******************************************************************************
+ * Summary:
+ *   Tells whether a value changed since the last slot.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if a slot is to be written
+ ******************************************************************************/
+static bool has_dirty_entries(void)
+{
+    bool dirty = false;
+
+    vTaskSuspendAll();
+    for (uint32_t i = 0; (i < RADAR_STORE_MAX_KEYS) && !dirty; i++)
+    {
+        dirty = entries[i].dirty;
+    }
+    (void)xTaskResumeAll();
+
+    return dirty;
+}
+
+/*******************************************************************************
+ * Function Name: put_counters
+ *******************************************************************************
+ * Summary:
+ *   Copies the entrance counters into the RAM table if they changed since the
+ *   last time.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void put_counters(void)
+{
+    radar_counter_snapshot_t counts;
+    char value[RADAR_COUNTER_U64_LENGTH];
+
+    radar_counter_get_snapshot(&counts);
+    if (counts.seq == stored_counter_seq)
+    {
+        return;
+    }
+    stored_counter_seq = counts.seq;
+
+    (void)radar_counter_format_u64(counts.in, value, sizeof(value));
+    radar_store_put(RADAR_STORE_KEY_COUNT_IN, value);
+    (void)radar_counter_format_u64(counts.out, value, sizeof(value));
+    radar_store_put(RADAR_STORE_KEY_COUNT_OUT, value);
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_task
+ *******************************************************************************
+ * Summary:
+ *   Writes changed configuration values shortly after they were applied,
+ *   changed entrance counters every RADAR_STORE_COUNTER_PERIOD_MS, and a
+ *   checkpoint once the chain reaches RADAR_STORE_COMPACT_SLOTS slots.
+ *
+ * Parameters:
+ *   pvParameters: unused
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void radar_store_task(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;)
+    {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADAR_STORE_COUNTER_PERIOD_MS)) != 0u)
+        {
+            /* Collect the changes following this one into the same slot */
+            vTaskDelay(pdMS_TO_TICKS(RADAR_STORE_HOLDOFF_MS));
+        }
+
+        put_counters();
+        if (has_dirty_entries())
+        {
+            write_slot(false);
+        }
+
+        /* Compaction, keeps the boot replay short */
+        if (!journal_empty && ((newest_seq - checkpoint_seq + 1u) >= RADAR_STORE_COMPACT_SLOTS))
+        {
+            write_slot(true);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_restore
+ *******************************************************************************
+ * Summary:
+ *   Loads the journal and applies the stored entrance counters and
+ *   configuration values. Called by the radar task after the default
+ *   parameters are set and before the radar sensing context is enabled.
+ *
+ * Parameters:
+ *   context: radar sensing context
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_store_restore(mtb_radar_sensing_context_t *context)
+{
+    uint32_t start = radar_diag_timer_read();
+    char value[RADAR_STORE_VALUE_LENGTH];
+    radar_counter_snapshot_t counts;
+
+    if (cyhal_flash_init(&flash_obj) != CY_RSLT_SUCCESS)
+    {
+        printf("Store: flash initialization failed, settings are not kept\n");
+        return;
+    }
+    flash_ready = true;
+
+    load_journal();
+
+    if (radar_store_get(RADAR_STORE_KEY_COUNT_IN, value, sizeof(value)))
+    {
+        radar_counter_set_in(strtoull(value, NULL, 10));
+        store_stats.restored_keys++;
+    }
+    if (radar_store_get(RADAR_STORE_KEY_COUNT_OUT, value, sizeof(value)))
+    {
+        radar_counter_set_out(strtoull(value, NULL, 10));
+        store_stats.restored_keys++;
+    }
+    /* Restored counters are not written again */
+    radar_counter_get_snapshot(&counts);
+    stored_counter_seq = counts.seq;
+
+    store_stats.restored_keys += radar_config_params_restore(context);
+    store_stats.restore_us = (radar_diag_timer_read() - start) * (1000000u / RADAR_DIAG_TIMER_HZ);
+
+    printf("Store: %lu values restored from %lu slots in %lu us\n",
+           (unsigned long)store_stats.restored_keys, (unsigned long)store_stats.replayed_slots,
+           (unsigned long)store_stats.restore_us);
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_start
+ *******************************************************************************
+ * Summary:
+ *   Creates the store task.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_store_start(void)
+{
+    if (!flash_ready)
+    {
+        return;
+    }
+
+    if (pdPASS != app_task_create("Radar",
+                                  radar_store_task,
+                                  RADAR_STORE_TASK_NAME,
+                                  RADAR_STORE_TASK_STACK_SIZE,
+                                  NULL,
+                                  RADAR_STORE_TASK_PRIORITY,
+                                  &radar_store_task_handle,
+                                  APP_TASK_STACK(radar_store_task),
+                                  APP_TASK_TCB(radar_store_task)))
+    {
+        printf("Failed to create Radar store task!\n");
+        CY_ASSERT(0);
+    }
+    app_memory_add("Radar", "Store table and slot", sizeof(entries) + sizeof(slot_buffer), true);
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_key
+ *******************************************************************************
+ * Summary:
+ *   Derives the store key of a configuration key name. The names are not
+ *   stored, so that a checkpoint of all values fits into one slot.
+ *
+ * Parameters:
+ *   name: configuration key name
+ *   name_length: length of the name
+ *
+ * Return:
+ *   store key, always with the top bit set
+ ******************************************************************************/
+uint16_t radar_store_key(const char *name, size_t name_length)
+{
+    return (uint16_t)(0x8000u | (crc32(0u, (const uint8_t *)name, name_length) & 0x7FFFu));
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_get
+ *******************************************************************************
+ * Summary:
+ *   Returns a stored value.
+ *
+ * Parameters:
+ *   key: store key
+ *   value: destination of the null terminated value
+ *   value_size: size of 'value'
+ *
+ * Return:
+ *   true if the key is stored and the value fits
+ ******************************************************************************/
+bool radar_store_get(uint16_t key, char *value, size_t value_size)
+{
+    const store_entry_t *entry;
+    bool found = false;
+
+    vTaskSuspendAll();
+    entry = find_entry(key, false);
+    if ((entry != NULL) && (entry->length < value_size))
+    {
+        memcpy(value, entry->value, (size_t)entry->length + 1u);
+        found = true;
+    }
+    (void)xTaskResumeAll();
+
+    return found;
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_put
+ *******************************************************************************
+ * Summary:
+ *   Updates a value in the RAM table. It is written by the store task after
+ *   radar_store_notify() or with the next periodic counter write.
+ *
+ * Parameters:
+ *   key: store key
+ *   value: null terminated value
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_store_put(uint16_t key, const char *value)
+{
+    bool stored;
+
+    vTaskSuspendAll();
+    stored = set_entry(key, value, strlen(value), true);
+    (void)xTaskResumeAll();
+
+    if (!stored)
+    {
+        printf("Store: no room for key 0x%04x\n", key);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_notify
+ *******************************************************************************
+ * Summary:
+ *   Wakes the store task to write the changed values and counters, e.g.
+ *   after a configuration message was applied. Does not block.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_store_notify(void)
+{
+    if (radar_store_task_handle != NULL)
+    {
+        xTaskNotifyGive(radar_store_task_handle);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: radar_store_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the journal counters.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void radar_store_get_stats(radar_store_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = store_stats;
+    taskEXIT_CRITICAL();
+}
+
+#endif /* RADAR_STORE_ENABLE */
+
+/* [] END OF FILE */
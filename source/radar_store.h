@@ -0,0 +1,100 @@
+/******************************************************************************
+ * File Name:   radar_store.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in radar_store.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mtb_radar_sensing.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RADAR_STORE_TASK_NAME       "RADAR STORE TASK"
+#define RADAR_STORE_TASK_STACK_SIZE (1024)
+#define RADAR_STORE_TASK_PRIORITY   (1)
+
+/* Size of one journal slot in bytes, a multiple of the flash row size. Only
+ * the rows holding data are written. */
+#define RADAR_STORE_SLOT_SIZE       (1024u)
+
+/* Slots of the journal, written round robin */
+#define RADAR_STORE_SLOTS           (8u)
+
+/* A checkpoint of all values is written once this many slots must be
+ * replayed at boot, by the store task while it is otherwise idle */
+#define RADAR_STORE_COMPACT_SLOTS   (RADAR_STORE_SLOTS / 2u)
+
+/* Values kept, one per persistent configuration key plus the counters */
+#define RADAR_STORE_MAX_KEYS        (24u)
+
+/* Longest value, including the terminating null */
+#define RADAR_STORE_VALUE_LENGTH    (32u)
+
+/* Interval in milliseconds at which changed entrance counters are written */
+#define RADAR_STORE_COUNTER_PERIOD_MS (300000u)
+
+/* Time in milliseconds the store task waits after a configuration change
+ * for further changes, and so the shortest time between two writes */
+#define RADAR_STORE_HOLDOFF_MS      (1000u)
+
+/* Keys of the entrance counters, configuration keys have the top bit set */
+#define RADAR_STORE_KEY_COUNT_IN    (0x0001u)
+#define RADAR_STORE_KEY_COUNT_OUT   (0x0002u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters of the journal */
+typedef struct
+{
+    uint32_t appends;           /* Slots holding changed values */
+    uint32_t checkpoints;       /* Slots holding all values */
+    uint32_t write_errors;      /* Failed flash writes */
+    uint32_t rows_written;      /* Flash rows programmed */
+    uint32_t restored_keys;     /* Values restored at boot */
+    uint32_t replayed_slots;    /* Slots read at boot */
+    uint32_t restore_us;        /* Time taken by radar_store_restore() */
+} radar_store_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void radar_store_restore(mtb_radar_sensing_context_t *context);
+void radar_store_start(void);
+
+uint16_t radar_store_key(const char *name, size_t name_length);
+bool radar_store_get(uint16_t key, char *value, size_t value_size);
+/* Called from the radar config task with sem_radar_sensing_context held */
+void radar_store_put(uint16_t key, const char *value);
+void radar_store_notify(void);
+
+void radar_store_get_stats(radar_store_stats_t *stats);
+
+/* [] END OF FILE */
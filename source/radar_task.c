@@ -34,9 +34,18 @@
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "app_boot.h"
+#include "app_memory.h"
 #include "publisher_task.h"
 #include "radar_config_task.h"
+#include "radar_counter.h"
+#include "radar_debounce.h"
+#include "radar_event_ring.h"
+#include "radar_irq.h"
 #include "radar_led_task.h"
+#include "radar_occupancy.h"
+#include "radar_sim.h"
+#include "radar_store.h"
 #include "radar_task.h"
 
 /*******************************************************************************
@@ -58,6 +67,12 @@
 #else
 #define SPI_FREQUENCY (20000000UL)
 #endif
+/* Processing entry point, the library or its simulated stand-in */
+#if RADAR_SIMULATION_ENABLE
+#define RADAR_SENSING_PROCESS radar_sim_process
+#else
+#define RADAR_SENSING_PROCESS mtb_radar_sensing_process
+#endif
 
 /*******************************************************************************
  * Global Variables
@@ -69,15 +84,66 @@ SemaphoreHandle_t sem_radar_sensing_context = NULL;
 /* Radar sensing context */
 mtb_radar_sensing_context_t radar_sensing_context;
 
-/* Entrance counter In & Out number. Can be reset from remote server. */
-int32_t entrance_count_in = 0;
-int32_t entrance_count_out = 0;
+/* Buffers of the mutex and of the tasks created by the radar task */
+APP_MUTEX_MEMORY(sem_radar_sensing_context)
+APP_TASK_MEMORY(radar_config_task, RADAR_CONFIG_TASK_STACK_SIZE)
+APP_TASK_MEMORY(radar_led_task, RADAR_LED_TASK_STACK_SIZE)
 
 /*******************************************************************************
  * Local Variables
  ******************************************************************************/
 static int32_t occupy_status = 0;
 
+/* Sequence number of the next radar event record */
+static uint32_t event_seq = 0;
+
+/* Wake-up statistics of the radar task */
+static radar_acquisition_stats_t acquisition_stats;
+
+/* Usage statistics of sem_radar_sensing_context */
+static radar_lock_stats_t lock_stats;
+/* Tick count at which the current holder took sem_radar_sensing_context */
+static TickType_t lock_tick = 0;
+
+/*******************************************************************************
+ * Function Name: push_record
+ *******************************************************************************
+ * Summary:
+ *   Numbers an event record that passed the debounce stage, queues it on the
+ *   event ring and wakes the publisher task if it may be idle.
+ *
+ * Parameters:
+ *   record: record to publish
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void push_record(radar_event_record_t *record)
+{
+    bool ring_was_empty;
+
+    /* Numbered before the push, so that ring drops show up as gaps */
+    record->seq = event_seq++;
+    record->enqueue_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    ring_was_empty = (radar_event_ring_count() == 0);
+    if (!radar_event_ring_push(record))
+    {
+        /* Ring full, the drop is accounted in the ring statistics */
+        return;
+    }
+
+    /* Wake the publisher only when it may be idle. Otherwise it is already
+     * draining the ring and picks this record up in the same pass.
+     */
+    if (ring_was_empty)
+    {
+        publisher_data_t publisher_q_data;
+        publisher_q_data.cmd = PUBLISH_RADAR_EVENTS;
+        xQueueSendToBack(publisher_task_q, &publisher_q_data, 0);
+    }
+}
+
 /*******************************************************************************
  * Function Name: radar_sensing_callback
  *******************************************************************************
@@ -98,13 +164,17 @@ static void radar_sensing_callback(mtb_radar_sensing_context_t *context,
                                    mtb_radar_sensing_event_info_t *event_info,
                                    void *data)
 {
+    uint32_t callback_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+
     (void)context;
     (void)data;
 
+    app_boot_signal(APP_BOOT_FIRST_DETECTION);
     radar_led_set_pattern(event);
 
-    publisher_data_t publisher_q_data;
-    publisher_q_data.cmd = PUBLISH_MQTT_MSG;
+    radar_counter_snapshot_t counts;
+    radar_event_record_t record;
+    radar_event_record_t debounced;
 
     switch (event)
     {
@@ -112,11 +182,11 @@ static void radar_sensing_callback(mtb_radar_sensing_context_t *context,
         /* The following cases happen when radar working in EntranceCounter mode */
         // people walking in detected
         case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
-            ++entrance_count_in;
+            radar_counter_add_in();
             break;
         // people walking out detected
         case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
-            ++entrance_count_out;
+            radar_counter_add_out();
             break;
         // object detected in traffic zone, reminder for social distancing
         case MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED:
@@ -138,45 +208,42 @@ static void radar_sensing_callback(mtb_radar_sensing_context_t *context,
 #endif
         default:
             printf("Unknown event. Error!\n");
-            snprintf(publisher_q_data.data, sizeof(publisher_q_data.data), "{\"Radar Module\": \"Unknown event. Error!\"}");
             return;
     }
 
-#ifdef RADAR_ENTRANCE_COUNTER_MODE
-    printf("%.2f: Counter free detected, IN: %ld, OUT: %ld, occupy_status: %ld\r\n",
-           (float)event_info->timestamp / 1000,
-           entrance_count_in,
-           entrance_count_out,
-           occupy_status);
-
-    snprintf(publisher_q_data.data,
-             sizeof(publisher_q_data.data),
-             "{\"IN_Count\":%ld, \"OUT_Count\":%ld, \"Status\":%ld}",
-             entrance_count_in,
-             entrance_count_out,
-             occupy_status);
-#else
+    radar_counter_get_snapshot(&counts);
+
+    /* The summaries aggregate every event, before the debounce stage */
+    radar_occupancy_record((uint8_t)event, counts.occupancy, callback_ms);
+
+    /* Capture the event as a compact record, formatting is left to the publisher */
+    record.timestamp = (uint32_t)event_info->timestamp;
+    /* Low 32 bits of the totals, consumers use the differences */
+    record.count_in = (int32_t)(uint32_t)counts.in;
+    record.count_out = (int32_t)(uint32_t)counts.out;
+    record.distance_mm = 0;
+    record.accuracy_mm = 0;
+    record.event = (uint8_t)event;
+    record.occupy_status = (uint8_t)occupy_status;
+
+#ifndef RADAR_ENTRANCE_COUNTER_MODE
     if (occupy_status)
     {
-        printf("%.3f: Presence IN %.2f-%.2f\n",
-               (float)event_info->timestamp / 1000,
-               ((mtb_radar_sensing_presence_event_info_t *)event_info)->distance -
-                   ((mtb_radar_sensing_presence_event_info_t *)event_info)->accuracy,
-               ((mtb_radar_sensing_presence_event_info_t *)event_info)->distance +
-                   ((mtb_radar_sensing_presence_event_info_t *)event_info)->accuracy);
-
-        snprintf(publisher_q_data.data, sizeof(publisher_q_data.data), "{\"PRESENCE\": \" IN\"}");
-    }
-    else
-    {
-        printf("%.3f: Presence OUT\n", (float)event_info->timestamp / 1000);
+        mtb_radar_sensing_presence_event_info_t *presence_info =
+            (mtb_radar_sensing_presence_event_info_t *)event_info;
 
-        snprintf(publisher_q_data.data, sizeof(publisher_q_data.data), "{\"PRESENCE\": \"OUT\"}");
+        record.distance_mm = (uint16_t)(presence_info->distance * 1000.0f);
+        record.accuracy_mm = (uint16_t)(presence_info->accuracy * 1000.0f);
     }
 #endif
 
-    /* Send message back to publish queue. */
-    xQueueSendToBack(publisher_task_q, &publisher_q_data, 0);
+    record.callback_ms = callback_ms;
+
+    /* The LED follows every event, the broker only debounced occupancy */
+    if (radar_debounce_offer(&record, callback_ms, &debounced))
+    {
+        push_record(&debounced);
+    }
 }
 
 /*******************************************************************************
@@ -218,12 +285,20 @@ void radar_task(void *pvParameters)
 
     (void)pvParameters;
 
+#if RADAR_SIMULATION_ENABLE
+    /* No wing board, replay the event trace */
+    radar_sim_init(radar_sensing_callback, NULL);
+#if RADAR_STORE_ENABLE
+    /* Values applied before the last reset replace the defaults */
+    radar_store_restore(&radar_sensing_context);
+#endif
+#else
     cyhal_spi_t mSPI;
 
     mtb_radar_sensing_hw_cfg_t hw_cfg = {.spi_cs = CYBSP_SPI_CS,
                                          .reset = CYBSP_GPIO11,
                                          .ldo_en = CYBSP_GPIO5,
-                                         .irq = CYBSP_GPIO10,
+                                         .irq = RADAR_IRQ_PIN,
                                          .spi = &mSPI};
 
     /* Activate radar reset pin */
@@ -357,14 +432,21 @@ void radar_task(void *pvParameters)
     }
 #endif
 
+#if RADAR_STORE_ENABLE
+    /* Values applied before the last reset replace the defaults above */
+    radar_store_restore(&radar_sensing_context);
+#endif
+
     /* Enable context object */
     if (mtb_radar_sensing_enable(&radar_sensing_context) != MTB_RADAR_SENSING_SUCCESS)
     {
         CY_ASSERT(0);
     }
+#endif /* RADAR_SIMULATION_ENABLE */
 
     /* Initiate semaphore mutex to protect 'radar_sensing_context' */
-    sem_radar_sensing_context = xSemaphoreCreateMutex();
+    sem_radar_sensing_context = app_mutex_create("Radar", "Sensing context mutex",
+                                                 APP_MUTEX_QCB(sem_radar_sensing_context));
     if (sem_radar_sensing_context == NULL)
     {
         printf(" 'sem_radar_sensing_context' semaphore creation failed... Task suspend\n\n");
@@ -375,12 +457,15 @@ void radar_task(void *pvParameters)
      * Create task for radar configuration. Configuration parameters come from
      * Subscriber task. Subscribed topics are configured inside 'mqtt_client_config.c'.
      */
-    if (pdPASS != xTaskCreate(radar_config_task,
-                              RADAR_CONFIG_TASK_NAME,
-                              RADAR_CONFIG_TASK_STACK_SIZE,
-                              NULL,
-                              RADAR_CONFIG_TASK_PRIORITY,
-                              &radar_config_task_handle))
+    if (pdPASS != app_task_create("Radar",
+                                  radar_config_task,
+                                  RADAR_CONFIG_TASK_NAME,
+                                  RADAR_CONFIG_TASK_STACK_SIZE,
+                                  NULL,
+                                  RADAR_CONFIG_TASK_PRIORITY,
+                                  &radar_config_task_handle,
+                                  APP_TASK_STACK(radar_config_task),
+                                  APP_TASK_TCB(radar_config_task)))
     {
         printf("Failed to create Radar config task!\n");
         CY_ASSERT(0);
@@ -390,17 +475,26 @@ void radar_task(void *pvParameters)
      * Create task for led control. Based on different radar sensing event, led will display
      * in different mode. Refer to 'radar_led_task.c/.h' for more info.
      */
-    if (pdPASS != xTaskCreate(radar_led_task,
-                              RADAR_LED_TASK_NAME,
-                              RADAR_LED_TASK_STACK_SIZE,
-                              NULL,
-                              RADAR_LED_TASK_PRIORITY,
-                              &radar_led_task_handle))
+    radar_led_init();
+    if (pdPASS != app_task_create("Radar",
+                                  radar_led_task,
+                                  RADAR_LED_TASK_NAME,
+                                  RADAR_LED_TASK_STACK_SIZE,
+                                  NULL,
+                                  RADAR_LED_TASK_PRIORITY,
+                                  &radar_led_task_handle,
+                                  APP_TASK_STACK(radar_led_task),
+                                  APP_TASK_TCB(radar_led_task)))
     {
         printf("Failed to create Radar led task!\n");
         CY_ASSERT(0);
     }
 
+#if RADAR_STORE_ENABLE
+    /* Writes changed values and counters to flash in the background */
+    radar_store_start();
+#endif
+
     /* Stop LED blinking timer, turn on LED to indicate user that turn-on phase is over and entering ready state */
     result = cyhal_timer_stop(&led_blink_timer);
     if (result != CY_RSLT_SUCCESS)
@@ -409,19 +503,74 @@ void radar_task(void *pvParameters)
     }
     cyhal_gpio_write(CYBSP_USER_LED, false); /* USER_LED is active low */
 
+    /* Sensing runs, the MQTT client task prints the RAM report after this */
+    app_boot_signal(APP_BOOT_RADAR_READY);
+
+    /* Records are handed to the publisher queue from the first frame on */
+    app_boot_wait(APP_BOOT_BIT(APP_BOOT_PUBLISHER_READY), portMAX_DELAY);
+
+#if RADAR_IRQ_ACQUISITION_ENABLE
+    /* Wake the radar task from the FIFO-ready interrupt instead of polling */
+    radar_irq_start(xTaskGetCurrentTaskHandle());
+#endif
+
     for (;;)
     {
-        if (xSemaphoreTake(sem_radar_sensing_context, portMAX_DELAY) == pdTRUE)
+        TickType_t wake_tick;
+
+#if RADAR_IRQ_ACQUISITION_ENABLE
+        /* Sleep until the sensor signals a filled FIFO */
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADAR_IRQ_IDLE_TIMEOUT_MS)) == 0)
         {
-            /* Process data acquired from radar every 2ms */
-            if (mtb_radar_sensing_process(&radar_sensing_context, ifx_currenttime()) != MTB_RADAR_SENSING_SUCCESS)
+            acquisition_stats.idle_timeouts++;
+            wake_tick = xTaskGetTickCount();
+        }
+        else
+        {
+            wake_tick = radar_irq_last_tick();
+
+            uint32_t latency = (uint32_t)(xTaskGetTickCount() - wake_tick) * portTICK_PERIOD_MS;
+            if (latency > acquisition_stats.max_irq_latency)
+            {
+                acquisition_stats.max_irq_latency = latency;
+            }
+        }
+#else
+        wake_tick = xTaskGetTickCount();
+#endif
+        if (radar_sensing_context_lock())
+        {
+            /* A long wait for the context means the FIFO may have overflowed */
+            if ((xTaskGetTickCount() - wake_tick) > pdMS_TO_TICKS(RADAR_PROCESS_DEADLINE_MS))
+            {
+                lock_stats.missed_deadlines++;
+            }
+
+            /* Process data acquired from radar */
+            if (RADAR_SENSING_PROCESS(&radar_sensing_context, ifx_currenttime()) != MTB_RADAR_SENSING_SUCCESS)
             {
                 printf("ifx_radar_sensing_process error\n");
                 CY_ASSERT(0);
             }
-            xSemaphoreGive(sem_radar_sensing_context);
-            vTaskDelay(MTB_RADAR_SENSING_PROCESS_DELAY);
+            acquisition_stats.wakeup_count++;
+
+            /* Publish an occupancy change whose dwell time or hold-off ended */
+            radar_event_record_t debounced;
+            if (radar_debounce_poll((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS), &debounced))
+            {
+                push_record(&debounced);
+            }
+            radar_sensing_context_unlock();
         }
+#if RADAR_IRQ_ACQUISITION_ENABLE
+        /* IRQ line still asserted: another frame is waiting, no new edge will come */
+        if (radar_irq_pending())
+        {
+            xTaskNotifyGive(radar_task_handle);
+        }
+#else
+        vTaskDelay(MTB_RADAR_SENSING_PROCESS_DELAY);
+#endif
     }
 }
 
@@ -449,4 +598,95 @@ void radar_task_cleanup(void)
     }
 }
 
+/*******************************************************************************
+ * Function Name: radar_task_get_acquisition_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the radar task wake-up statistics.
+ *
+ * Parameters:
+ *   stats: destination of the statistics
+ *
+ * Return:
+ *   void
+ ******************************************************************************/
+void radar_task_get_acquisition_stats(radar_acquisition_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = acquisition_stats;
+    taskEXIT_CRITICAL();
+#if RADAR_IRQ_ACQUISITION_ENABLE
+    stats->irq_count = radar_irq_count();
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: radar_task_get_lock_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the radar sensing context mutex statistics.
+ *
+ * Parameters:
+ *   stats: destination of the statistics
+ *
+ * Return:
+ *   void
+ ******************************************************************************/
+void radar_task_get_lock_stats(radar_lock_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = lock_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: radar_sensing_context_lock
+ *******************************************************************************
+ * Summary:
+ *   Takes sem_radar_sensing_context and starts measuring the hold time. Every
+ *   user of 'radar_sensing_context' goes through this function.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   true if the mutex was taken
+ ******************************************************************************/
+bool radar_sensing_context_lock(void)
+{
+    if (xSemaphoreTake(sem_radar_sensing_context, portMAX_DELAY) != pdTRUE)
+    {
+        return false;
+    }
+
+    lock_tick = xTaskGetTickCount();
+    lock_stats.lock_count++;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: radar_sensing_context_unlock
+ *******************************************************************************
+ * Summary:
+ *   Records the hold time and gives sem_radar_sensing_context back.
+ *
+ * Parameters:
+ *   void
+ *
+ * Return:
+ *   void
+ ******************************************************************************/
+void radar_sensing_context_unlock(void)
+{
+    uint32_t hold_ms = (uint32_t)(xTaskGetTickCount() - lock_tick) * portTICK_PERIOD_MS;
+
+    if (hold_ms > lock_stats.max_hold_ms)
+    {
+        lock_stats.max_hold_ms = hold_ms;
+    }
+
+    xSemaphoreGive(sem_radar_sensing_context);
+}
+
 /* [] END OF FILE */
@@ -28,6 +28,8 @@
 #pragma once
 
 /* Header file includes */
+#include <stdbool.h>
+
 #include "FreeRTOS.h"
 #include "semphr.h"
 #include "task.h"
@@ -50,6 +52,71 @@
  */
 #undef RADAR_ENTRANCE_COUNTER_MODE
 
+/**
+ * Compile time switch to run without a radar wing board. Set to 1, the radar
+ * sensing library is not initialized and the event trace of
+ * radar_sim_*.trace is replayed instead (see radar_sim.c), so that the event
+ * and configuration pipeline can be load tested on the kit alone. The host
+ * tests set it on the compiler command line.
+ */
+#ifndef RADAR_SIMULATION_ENABLE
+#define RADAR_SIMULATION_ENABLE (0)
+#endif
+
+/**
+ * Compile time switch to keep the configuration values and the entrance
+ * counters in flash (see radar_store.c). Set to 1, they are restored at boot
+ * before the radar sensing context is enabled. Set to 0 (default), every
+ * reset reverts to the defaults set in radar_task(). It may also be set with
+ * DEFINES in the Makefile.
+ */
+#ifndef RADAR_STORE_ENABLE
+#define RADAR_STORE_ENABLE (0)
+#endif
+
+/**
+ * Compile time switch to select how radar data acquisition is triggered. Set
+ * to 1, the radar task sleeps until the sensor raises its FIFO-ready IRQ and
+ * only then processes a frame. Set to 0, the task polls the library every
+ * MTB_RADAR_SENSING_PROCESS_DELAY milliseconds.
+ */
+#if RADAR_SIMULATION_ENABLE || defined(__ICCARM__)
+/* There is no sensor IRQ when the radar is simulated. The IAR linker cannot
+ * wrap the IRQ pin registration of the library (see radar_irq.c). */
+#define RADAR_IRQ_ACQUISITION_ENABLE (0)
+#else
+#define RADAR_IRQ_ACQUISITION_ENABLE (1)
+#endif
+
+/* Longest time (in milliseconds) the radar task sleeps without an IRQ before
+ * processing anyway, so that time based events are still reported. */
+#define RADAR_IRQ_IDLE_TIMEOUT_MS (100)
+
+/* Longest time (in milliseconds) between the radar task being woken and
+ * holding the radar sensing context. Exceeding it risks a radar FIFO overflow
+ * and is counted as a missed processing deadline. */
+#define RADAR_PROCESS_DEADLINE_MS (10)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Counters describing how often the radar task woke up and why */
+typedef struct
+{
+    uint32_t irq_count;         /* FIFO-ready interrupts received */
+    uint32_t wakeup_count;      /* Calls to mtb_radar_sensing_process() */
+    uint32_t idle_timeouts;     /* Wake-ups caused by RADAR_IRQ_IDLE_TIMEOUT_MS */
+    uint32_t max_irq_latency;   /* Worst IRQ to processing latency in ms */
+} radar_acquisition_stats_t;
+
+/* Usage of the radar sensing context mutex */
+typedef struct
+{
+    uint32_t lock_count;        /* Times sem_radar_sensing_context was taken */
+    uint32_t max_hold_ms;       /* Longest time the mutex was held */
+    uint32_t missed_deadlines;  /* Processing started later than RADAR_PROCESS_DEADLINE_MS */
+} radar_lock_stats_t;
+
 /*******************************************************************************
  * Global Variables
  ******************************************************************************/
@@ -58,8 +125,6 @@ extern TaskHandle_t radar_task_handle;
 extern SemaphoreHandle_t sem_radar_sensing_context;
 extern mtb_radar_sensing_context_t radar_sensing_context;
 
-extern int32_t entrance_count_in;
-extern int32_t entrance_count_out;
 extern cyhal_timer_t led_blink_timer;
 
 /*******************************************************************************
@@ -67,5 +132,10 @@ extern cyhal_timer_t led_blink_timer;
  ******************************************************************************/
 void radar_task(void *pvParameters);
 void radar_task_cleanup(void);
+void radar_task_get_acquisition_stats(radar_acquisition_stats_t *stats);
+void radar_task_get_lock_stats(radar_lock_stats_t *stats);
+
+bool radar_sensing_context_lock(void);
+void radar_sensing_context_unlock(void);
 
 /* [] END OF FILE */
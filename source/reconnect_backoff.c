@@ -0,0 +1,184 @@
+/******************************************************************************
+ * File Name:   reconnect_backoff.c
+ *
+ * Description: This file implements the reconnection delays of the Wi-Fi and
+ *              MQTT connections: a capped exponential backoff with per-device
+ *              random jitter, so that a fleet of sensors losing the same
+ *              access point or broker does not reconnect in lockstep. The file
+ *              only depends on the C standard library.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "reconnect_backoff.h"
+
+/*******************************************************************************
+ * Function Name: next_random
+ *******************************************************************************
+ * Summary:
+ *   xorshift32 pseudo random generator. Quality is sufficient to spread
+ *   delays, the seed makes the sequence differ between devices.
+ *
+ * Parameters:
+ *   backoff: backoff state holding the generator state
+ *
+ * Return:
+ *   next pseudo random number
+ ******************************************************************************/
+static uint32_t next_random(reconnect_backoff_t *backoff)
+{
+    uint32_t x = backoff->random;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    backoff->random = x;
+
+    return x;
+}
+
+/*******************************************************************************
+ * Function Name: reconnect_backoff_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the backoff state of a link.
+ *
+ * Parameters:
+ *   backoff: backoff state
+ *   base_ms: delay cap after the first failure
+ *   max_ms: upper limit of the delay cap
+ *   seed: per-device random seed, e.g. from the TRNG
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void reconnect_backoff_init(reconnect_backoff_t *backoff, uint32_t base_ms, uint32_t max_ms, uint32_t seed)
+{
+    backoff->base_ms = base_ms;
+    backoff->max_ms = (max_ms > base_ms) ? max_ms : base_ms;
+    backoff->failure_run = 0;
+    /* xorshift must not start from 0 */
+    backoff->random = (seed != 0u) ? seed : 0x9E3779B9u;
+    backoff->stats = (reconnect_backoff_stats_t){ 0 };
+}
+
+/*******************************************************************************
+ * Function Name: reconnect_backoff_attempt
+ *******************************************************************************
+ * Summary:
+ *   Counts a connection attempt.
+ *
+ * Parameters:
+ *   backoff: backoff state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void reconnect_backoff_attempt(reconnect_backoff_t *backoff)
+{
+    backoff->stats.attempts++;
+}
+
+/*******************************************************************************
+ * Function Name: reconnect_backoff_success
+ *******************************************************************************
+ * Summary:
+ *   Records a successful attempt, the next failure starts from 'base_ms'
+ *   again.
+ *
+ * Parameters:
+ *   backoff: backoff state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void reconnect_backoff_success(reconnect_backoff_t *backoff)
+{
+    backoff->stats.successes++;
+    backoff->failure_run = 0;
+}
+
+/*******************************************************************************
+ * Function Name: reconnect_backoff_failure
+ *******************************************************************************
+ * Summary:
+ *   Records a failed attempt and returns the delay before the next one. The
+ *   cap doubles with every consecutive failure up to 'max_ms', the delay is
+ *   drawn uniformly from the upper half of the cap ("equal jitter"), so that
+ *   it never collapses to zero and still spreads devices apart.
+ *
+ * Parameters:
+ *   backoff: backoff state
+ *
+ * Return:
+ *   delay in ms before the next attempt
+ ******************************************************************************/
+uint32_t reconnect_backoff_failure(reconnect_backoff_t *backoff)
+{
+    uint32_t cap = backoff->base_ms;
+    uint32_t half;
+    uint32_t delay;
+
+    for (uint32_t i = 0; (i < backoff->failure_run) && (cap < backoff->max_ms); i++)
+    {
+        cap = (cap > (backoff->max_ms / 2u)) ? backoff->max_ms : (cap * 2u);
+    }
+
+    half = cap / 2u;
+    delay = half + (next_random(backoff) % (cap - half + 1u));
+
+    backoff->failure_run++;
+    backoff->stats.failures++;
+    if (backoff->failure_run > backoff->stats.max_failure_run)
+    {
+        backoff->stats.max_failure_run = backoff->failure_run;
+    }
+    backoff->stats.last_delay_ms = delay;
+    backoff->stats.total_delay_ms += delay;
+
+    return delay;
+}
+
+/*******************************************************************************
+ * Function Name: reconnect_backoff_jitter
+ *******************************************************************************
+ * Summary:
+ *   Returns a random delay within [0, range_ms], used to spread the first
+ *   attempt of devices that noticed the same outage at the same time.
+ *
+ * Parameters:
+ *   backoff: backoff state
+ *   range_ms: largest delay
+ *
+ * Return:
+ *   delay in ms
+ ******************************************************************************/
+uint32_t reconnect_backoff_jitter(reconnect_backoff_t *backoff, uint32_t range_ms)
+{
+    uint32_t delay = (range_ms > 0u) ? (next_random(backoff) % (range_ms + 1u)) : 0u;
+
+    backoff->stats.last_delay_ms = delay;
+    backoff->stats.total_delay_ms += delay;
+
+    return delay;
+}
+
+/* [] END OF FILE */
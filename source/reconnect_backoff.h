@@ -0,0 +1,64 @@
+/******************************************************************************
+ * File Name:   reconnect_backoff.h
+ *
+ * Description: This file is the public interface of reconnect_backoff.c
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Connection attempt metrics of one link */
+typedef struct
+{
+    uint32_t attempts;          /* Connection attempts */
+    uint32_t successes;         /* Attempts that connected */
+    uint32_t failures;          /* Attempts that failed */
+    uint32_t max_failure_run;   /* Longest run of consecutive failures */
+    uint32_t last_delay_ms;     /* Last delay handed out */
+    uint32_t total_delay_ms;    /* Sum of all delays handed out */
+} reconnect_backoff_stats_t;
+
+/* Backoff state of one link, e.g. Wi-Fi or MQTT */
+typedef struct
+{
+    uint32_t base_ms;           /* Delay cap after the first failure */
+    uint32_t max_ms;            /* Upper limit of the delay cap */
+    uint32_t failure_run;       /* Consecutive failures since the last success */
+    uint32_t random;            /* Pseudo random state, seeded per device */
+    reconnect_backoff_stats_t stats;
+} reconnect_backoff_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void reconnect_backoff_init(reconnect_backoff_t *backoff, uint32_t base_ms, uint32_t max_ms, uint32_t seed);
+void reconnect_backoff_attempt(reconnect_backoff_t *backoff);
+void reconnect_backoff_success(reconnect_backoff_t *backoff);
+uint32_t reconnect_backoff_failure(reconnect_backoff_t *backoff);
+uint32_t reconnect_backoff_jitter(reconnect_backoff_t *backoff, uint32_t range_ms);
+
+/* [] END OF FILE */
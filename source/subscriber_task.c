@@ -2,8 +2,9 @@
  * File Name:   subscriber_task.c
  *
  * Description: This file contains the task that subscribes to the topic
- *              'MQTT_SUB_TOPIC', and configure the sensor module based on the
- *              notifications received from the MQTT subscriber callback.
+ *              filters registered with the topic router in one SUBSCRIBE
+ *              packet, and the handler of the topic 'MQTT_SUB_TOPIC' that
+ *              passes the radar configuration to the radar config task.
  *
  * Related Document: See README.md
  *
@@ -29,12 +30,16 @@
 #include "FreeRTOS.h"
 #include "cybsp.h"
 #include "cyhal.h"
+#include "ctype.h"
 #include "string.h"
 
 /* Task header files */
+#include "app_boot.h"
+#include "app_memory.h"
 #include "mqtt_task.h"
 #include "radar_config_task.h"
 #include "subscriber_task.h"
+#include "topic_router.h"
 
 /* Configuration file for MQTT client */
 #include "mqtt_client_config.h"
@@ -52,9 +57,6 @@
 /* Time interval in milliseconds between MQTT subscribe retries. */
 #define MQTT_SUBSCRIBE_RETRY_INTERVAL_MS        (1000)
 
-/* The number of MQTT topics to be subscribed to. */
-#define SUBSCRIPTION_COUNT                      (1)
-
 
 /******************************************************************************
  * Global Variables
@@ -65,33 +67,90 @@ TaskHandle_t subscriber_task_handle;
 /* Handle of the queue holding the commands for the subscriber task */
 QueueHandle_t subscriber_task_q;
 
-/* Configure the subscription information structure. */
-cy_mqtt_subscribe_info_t subscribe_info =
-{
-    .qos = (cy_mqtt_qos_t) MQTT_MESSAGES_QOS,
-    .topic = MQTT_SUB_TOPIC,
-    .topic_len = (sizeof(MQTT_SUB_TOPIC) - 1)
-};
-
 /******************************************************************************
 * Function Prototypes
 *******************************************************************************/
 static void subscribe_to_topic(void);
 static void unsubscribe_from_topic(void);
+static void radar_config_message_handler(cy_mqtt_publish_info_t *received_msg_info, void *arg);
+static sub_payload_slot_t *payload_slot_acquire(void);
+static bool payload_slot_send(sub_payload_slot_t *slot);
+static bool stream_payload(const char *msg, uint32_t msg_len);
+
+/* Queue of received payload slots, consumed by the radar configuration task */
+QueueHandle_t sub_payload_q = NULL;
+
+/******************************************************************************
+* Local Variables
+*******************************************************************************/
+/* Pool of receive slots. A slot is free while it is not in use. */
+static sub_payload_slot_t sub_payload_slots[MQTT_SUB_SLOT_COUNT];
+
+/* Number of messages dropped because no receive slot was available */
+static uint32_t sub_payload_drops = 0;
+
+/* Buffers of the queues */
+APP_QUEUE_MEMORY(sub_payload_q, MQTT_SUB_SLOT_COUNT, sizeof(sub_payload_slot_t *))
+APP_QUEUE_MEMORY(subscriber_task_q, MQTT_SUB_QUEUE_LENGTH, sizeof(subscriber_data_t))
+
+/******************************************************************************
+ * Function Name: subscriber_init
+ ******************************************************************************
+ * Summary:
+ *  Creates the queues of the subscriber and registers the topic filter of the
+ *  radar configuration messages. Called by the MQTT client task before the
+ *  first connection: a persistent session may deliver messages as soon as the
+ *  broker accepted the connection, and the filters must be registered by the
+ *  time the subscriber task sends the first SUBSCRIBE.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool : true on success
+ *
+ ******************************************************************************/
+bool subscriber_init(void)
+{
+    /* Create the queue handing received payloads to the radar config task */
+    sub_payload_q = app_queue_create("Subscriber", "Payload queue", MQTT_SUB_SLOT_COUNT, sizeof(sub_payload_slot_t *),
+                                     APP_QUEUE_STORAGE(sub_payload_q), APP_QUEUE_QCB(sub_payload_q));
+    if (sub_payload_q == NULL)
+    {
+        printf(" 'sub_payload_q' queue creation failed!\n\n");
+        return false;
+    }
+    app_memory_add("Subscriber", "Payload slots", sizeof(sub_payload_slots), true);
+
+    /* Create a message queue to communicate with other tasks and callbacks.
+     * A disconnection may be handled while the first subscribe is running.
+     */
+    subscriber_task_q = app_queue_create("Subscriber", "Subscriber queue", MQTT_SUB_QUEUE_LENGTH, sizeof(subscriber_data_t),
+                                         APP_QUEUE_STORAGE(subscriber_task_q), APP_QUEUE_QCB(subscriber_task_q));
+    if (subscriber_task_q == NULL)
+    {
+        printf(" 'subscriber_task_q' queue creation failed!\n\n");
+        return false;
+    }
 
-/* Semaphore used to protect message payload */
-SemaphoreHandle_t sem_sub_payload = NULL;
-/* Subscribed message paylaod. Maximum with size of 512 byte. */
-char sub_msg_payload[512];
+    /* Radar configuration messages go to the radar config task. */
+    if (!topic_router_register(MQTT_SUB_TOPIC, (cy_mqtt_qos_t) MQTT_MESSAGES_QOS,
+                               radar_config_message_handler, NULL))
+    {
+        printf("Registering the topic '%s' failed!\n\n", MQTT_SUB_TOPIC);
+        return false;
+    }
+
+    return true;
+}
 
 /******************************************************************************
  * Function Name: subscriber_task
  ******************************************************************************
  * Summary:
- *  Task that sets up the user LED GPIO, subscribes to the specified MQTT topic,
- *  and controls the user LED based on the received commands over the message
- *  queue. The task can also unsubscribe from the topic based on the commands
- *  via the message queue.
+ *  Task that subscribes to the topic filters registered with the topic router
+ *  and subscribes or unsubscribes again based on the commands received over
+ *  the message queue. subscriber_init() must have been called.
  *
  * Parameters:
  *  void *pvParameters : Task parameter defined during task creation (unused)
@@ -107,20 +166,9 @@ void subscriber_task(void *pvParameters)
     /* To avoid compiler warnings */
     (void) pvParameters;
 
-    /* Initialize semaphore to protect payload */
-    sem_sub_payload = xSemaphoreCreateMutex();
-    if (sem_sub_payload == NULL)
-    {
-        printf(" 'sem_sub_payload' semaphore creation failed... Task suspend\n\n");
-        vTaskSuspend(NULL);
-    }
-
-    /* Subscribe to the specified MQTT topic. */
+    /* Subscribe to all registered topic filters. */
     subscribe_to_topic();
 
-    /* Create a message queue to communicate with other tasks and callbacks. */
-    subscriber_task_q = xQueueCreate(MQTT_SUB_QUEUE_LENGTH, sizeof(subscriber_data_t));
-
     while (true)
     {
         /* Wait for commands from other tasks and callbacks. */
@@ -148,9 +196,11 @@ void subscriber_task(void *pvParameters)
  * Function Name: subscribe_to_topic
  ******************************************************************************
  * Summary:
- *  Function that subscribes to the MQTT topic specified by the macro
- *  'MQTT_SUB_TOPIC'. This operation is retried a maximum of
- *  'MAX_SUBSCRIBE_RETRIES' times with interval of
+ *  Function that subscribes to all topic filters registered with the topic
+ *  router in a single SUBSCRIBE packet, on every connection: also with a
+ *  persistent session, as the broker may have lost or expired it. This
+ *  operation is retried a maximum
+ *  of 'MAX_SUBSCRIBE_RETRIES' times with interval of
  *  'MQTT_SUBSCRIBE_RETRY_INTERVAL_MS' milliseconds.
  *
  * Parameters:
@@ -168,14 +218,28 @@ static void subscribe_to_topic(void)
     /* Command to the MQTT client task */
     mqtt_task_cmd_t mqtt_task_cmd;
 
+    /* Registered topic filters */
+    cy_mqtt_subscribe_info_t *subscriptions;
+    uint32_t subscription_count = topic_router_get_subscriptions(&subscriptions);
+
+    if (subscription_count == 0)
+    {
+        return;
+    }
+
     /* Subscribe with the configured parameters. */
     for (uint32_t retry_count = 0; retry_count < MAX_SUBSCRIBE_RETRIES; retry_count++)
     {
-        result = cy_mqtt_subscribe(mqtt_connection, &subscribe_info, SUBSCRIPTION_COUNT);
+        result = cy_mqtt_subscribe(mqtt_connection, subscriptions, (uint8_t)subscription_count);
         if (result == CY_RSLT_SUCCESS)
         {
-            printf("MQTT client subscribed to the topic '%.*s' successfully.\n\n",
-                    subscribe_info.topic_len, subscribe_info.topic);
+            for (uint32_t i = 0; i < subscription_count; i++)
+            {
+                printf("MQTT client subscribed to the topic '%.*s' successfully.\n",
+                        subscriptions[i].topic_len, subscriptions[i].topic);
+            }
+            printf("\n");
+            app_boot_signal(APP_BOOT_SUBSCRIBED);
             break;
         }
 
@@ -198,9 +262,8 @@ static void subscribe_to_topic(void)
  ******************************************************************************
  * Summary:
  *  Callback to handle incoming MQTT messages. This callback prints the
- *  contents of the incoming message and informs the subscriber task, via a
- *  message queue, to turn on / turn off the device based on the received
- *  message.
+ *  contents of the incoming message and hands it to the handlers of all
+ *  matching topic filters.
  *
  * Parameters:
  *  cy_mqtt_publish_info_t *received_msg_info : Information structure of the
@@ -212,42 +275,324 @@ static void subscribe_to_topic(void)
  ******************************************************************************/
 void mqtt_subscription_callback(cy_mqtt_publish_info_t *received_msg_info)
 {
-    /* Received MQTT message */
-    const char *received_msg = received_msg_info->payload;
-    int received_msg_len = received_msg_info->payload_len;
-
     printf("  Subsciber: Incoming MQTT message received:\n"
            "    Publish topic name: %.*s\n"
            "    Publish QoS: %d\n"
            "    Publish payload: %.*s\n\n",
            received_msg_info->topic_len, received_msg_info->topic,
            (int) received_msg_info->qos,
-           received_msg_len, (const char *)received_msg);
+           (int) received_msg_info->payload_len, (const char *)received_msg_info->payload);
 
-    if (received_msg_len >= sizeof(sub_msg_payload))
+    if (topic_router_dispatch(received_msg_info) == 0)
     {
-        printf("Subscribed topic: '%.*s', received message too long. Buffer overflow.\n",
+        printf("No handler for the topic '%.*s', message dropped.\n",
                received_msg_info->topic_len, received_msg_info->topic);
-        return;
     }
+}
 
-    if (xSemaphoreTake(sem_sub_payload, portMAX_DELAY) == pdTRUE)
+/******************************************************************************
+ * Function Name: radar_config_message_handler
+ ******************************************************************************
+ * Summary:
+ *  Handler of the messages on 'MQTT_SUB_TOPIC'. It copies the message once
+ *  into a free receive slot and hands the slot to the radar configuration
+ *  task via a message queue. The handler never blocks: if no slot is free,
+ *  the message is dropped and counted. Messages larger than a slot are
+ *  streamed as several fragments.
+ *
+ * Parameters:
+ *  cy_mqtt_publish_info_t *received_msg_info : Information structure of the
+ *                                              received MQTT message
+ *  void *arg : unused
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+static void radar_config_message_handler(cy_mqtt_publish_info_t *received_msg_info, void *arg)
+{
+    /* Received MQTT message */
+    const char *received_msg = received_msg_info->payload;
+    uint32_t received_msg_len = received_msg_info->payload_len;
+    sub_payload_slot_t *slot;
+    bool handed_over;
+
+    (void) arg;
+
+    if (received_msg_len <= MQTT_SUB_MSG_MAX_SIZE)
     {
-        memset(sub_msg_payload, '\0', sizeof(sub_msg_payload));
-        memcpy(sub_msg_payload, received_msg, received_msg_len);
-        xSemaphoreGive(sem_sub_payload);
+        /* Common case: the whole message fits into one slot */
+        slot = payload_slot_acquire();
+        handed_over = false;
+        if (slot != NULL)
+        {
+            memcpy(slot->data, received_msg, received_msg_len);
+            slot->length = received_msg_len;
+            slot->fragment = 0;
+            slot->last_fragment = true;
+            handed_over = payload_slot_send(slot);
+        }
+    }
+    else
+    {
+        handed_over = stream_payload(received_msg, received_msg_len);
+    }
 
-        /* Notify the radar configuration task. */
-        xTaskNotifyGive(radar_config_task_handle);
+    if (!handed_over)
+    {
+        sub_payload_drops++;
+        printf("Subscribed topic: '%.*s', message dropped, no free receive slot or malformed payload (%lu dropped).\n",
+               received_msg_info->topic_len, received_msg_info->topic, (unsigned long)sub_payload_drops);
     }
 }
 
+/******************************************************************************
+ * Function Name: stream_payload
+ ******************************************************************************
+ * Summary:
+ *  Splits a flat JSON object that is larger than a receive slot at its
+ *  top-level members into as many slots as needed. Every fragment is a
+ *  complete JSON object, the last one is flagged. The message is handed over
+ *  as a whole or not at all: the fragments are only queued once the whole
+ *  message is split, and a malformed message or a lack of slots or queue
+ *  space discards all of them.
+ *
+ * Parameters:
+ *  const char *msg : received message
+ *  uint32_t msg_len : length of the received message
+ *
+ * Return:
+ *  bool : true if all fragments were handed over
+ *
+ ******************************************************************************/
+static bool stream_payload(const char *msg, uint32_t msg_len)
+{
+    sub_payload_slot_t *fragments[MQTT_SUB_SLOT_COUNT];
+    sub_payload_slot_t *slot = NULL;
+    uint32_t fragment_count = 0;
+    uint32_t pos = 0;
+    bool failed = false;
+
+    while ((pos < msg_len) && isspace((unsigned char)msg[pos]))
+    {
+        pos++;
+    }
+    if ((pos >= msg_len) || (msg[pos] != '{'))
+    {
+        return false;
+    }
+    pos++;
+
+    while (true)
+    {
+        uint32_t member_start;
+        uint32_t member_len;
+        uint32_t depth = 0;
+        bool in_string = false;
+
+        while ((pos < msg_len) && isspace((unsigned char)msg[pos]))
+        {
+            pos++;
+        }
+        if (pos >= msg_len)
+        {
+            failed = true;
+            break;
+        }
+        if (msg[pos] == '}')
+        {
+            break;
+        }
+
+        /* Find the end of the member: a top-level ',' or the closing '}' */
+        member_start = pos;
+        for (; pos < msg_len; pos++)
+        {
+            char c = msg[pos];
+
+            if (in_string)
+            {
+                if (c == '\\')
+                {
+                    pos++;
+                }
+                else if (c == '"')
+                {
+                    in_string = false;
+                }
+            }
+            else if (c == '"')
+            {
+                in_string = true;
+            }
+            else if ((c == '{') || (c == '['))
+            {
+                depth++;
+            }
+            else if ((c == '}') || (c == ']'))
+            {
+                if (depth == 0)
+                {
+                    break;
+                }
+                depth--;
+            }
+            else if ((c == ',') && (depth == 0))
+            {
+                break;
+            }
+        }
+
+        member_len = pos - member_start;
+        if ((pos >= msg_len) || ((member_len + 2) > MQTT_SUB_MSG_MAX_SIZE))
+        {
+            /* Unterminated message or a single member larger than a slot */
+            failed = true;
+            break;
+        }
+
+        /* Close the current fragment if the member does not fit anymore */
+        if ((slot != NULL) && ((slot->length + 1 + member_len + 1) > MQTT_SUB_MSG_MAX_SIZE))
+        {
+            slot->data[slot->length++] = '}';
+            slot = NULL;
+        }
+
+        if (slot == NULL)
+        {
+            slot = (fragment_count < MQTT_SUB_SLOT_COUNT) ? payload_slot_acquire() : NULL;
+            if (slot == NULL)
+            {
+                failed = true;
+                break;
+            }
+            slot->data[0] = '{';
+            slot->length = 1;
+            slot->fragment = (uint8_t)fragment_count;
+            slot->last_fragment = false;
+            fragments[fragment_count++] = slot;
+        }
+        else
+        {
+            slot->data[slot->length++] = ',';
+        }
+
+        memcpy(&slot->data[slot->length], &msg[member_start], member_len);
+        slot->length += member_len;
+
+        if (msg[pos] == '}')
+        {
+            /* Closing brace of the message, 'pos' is not advanced */
+            continue;
+        }
+        pos++;
+    }
+
+    /* Only the subscription callback queues payloads, so the free space
+     * checked here cannot shrink before the fragments are sent.
+     */
+    if (failed || (fragment_count == 0) || (sub_payload_q == NULL) ||
+        (uxQueueSpacesAvailable(sub_payload_q) < fragment_count))
+    {
+        for (uint32_t i = 0; i < fragment_count; i++)
+        {
+            subscriber_payload_release(fragments[i]);
+        }
+        return false;
+    }
+
+    slot->data[slot->length++] = '}';
+    slot->last_fragment = true;
+    for (uint32_t i = 0; i < fragment_count; i++)
+    {
+        (void)payload_slot_send(fragments[i]);
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: payload_slot_acquire
+ ******************************************************************************
+ * Summary:
+ *  Takes a free receive slot from the pool and marks it in use.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  sub_payload_slot_t * : free slot, NULL if all slots are in use
+ *
+ ******************************************************************************/
+static sub_payload_slot_t *payload_slot_acquire(void)
+{
+    sub_payload_slot_t *slot = NULL;
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < MQTT_SUB_SLOT_COUNT; i++)
+    {
+        if (!sub_payload_slots[i].in_use)
+        {
+            sub_payload_slots[i].in_use = true;
+            slot = &sub_payload_slots[i];
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return slot;
+}
+
+/******************************************************************************
+ * Function Name: payload_slot_send
+ ******************************************************************************
+ * Summary:
+ *  Hands a filled slot over to the radar configuration task without
+ *  blocking. The ownership of the slot moves to the receiver; on failure
+ *  the slot is released.
+ *
+ * Parameters:
+ *  sub_payload_slot_t *slot : filled slot
+ *
+ * Return:
+ *  bool : true if the slot was queued
+ *
+ ******************************************************************************/
+static bool payload_slot_send(sub_payload_slot_t *slot)
+{
+    if ((sub_payload_q == NULL) || (xQueueSendToBack(sub_payload_q, &slot, 0) != pdTRUE))
+    {
+        subscriber_payload_release(slot);
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * Function Name: subscriber_payload_release
+ ******************************************************************************
+ * Summary:
+ *  Returns a receive slot to the pool. Called by the owner of the slot once
+ *  it is done with the payload.
+ *
+ * Parameters:
+ *  sub_payload_slot_t *slot : slot in use
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void subscriber_payload_release(sub_payload_slot_t *slot)
+{
+    taskENTER_CRITICAL();
+    slot->in_use = false;
+    taskEXIT_CRITICAL();
+}
+
 /******************************************************************************
  * Function Name: unsubscribe_from_topic
  ******************************************************************************
  * Summary:
- *  Function that unsubscribes from the topic specified by the macro
- *  'MQTT_SUB_TOPIC'.
+ *  Function that unsubscribes from all registered topic filters.
  *
  * Parameters:
  *  void
@@ -258,9 +603,17 @@ void mqtt_subscription_callback(cy_mqtt_publish_info_t *received_msg_info)
  ******************************************************************************/
 static void unsubscribe_from_topic(void)
 {
-    cy_rslt_t result = cy_mqtt_unsubscribe(mqtt_connection,
-                                           (cy_mqtt_unsubscribe_info_t *) &subscribe_info,
-                                           SUBSCRIPTION_COUNT);
+    cy_mqtt_subscribe_info_t *subscriptions;
+    uint32_t subscription_count = topic_router_get_subscriptions(&subscriptions);
+    cy_rslt_t result;
+
+    if (subscription_count == 0)
+    {
+        return;
+    }
+
+    result = cy_mqtt_unsubscribe(mqtt_connection, (cy_mqtt_unsubscribe_info_t *) subscriptions,
+                                 (uint8_t)subscription_count);
 
     if (result != CY_RSLT_SUCCESS)
     {
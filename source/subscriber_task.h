@@ -42,6 +42,12 @@
 #define MQTT_SUB_QUEUE_LENGTH              (1u)
 #define MQTT_SUB_MSG_MAX_SIZE              (512u)
 
+/* Number of receive slots handed from the subscription callback to the
+ * radar configuration task. Payloads larger than 'MQTT_SUB_MSG_MAX_SIZE'
+ * are streamed as several fragments and need one slot per fragment.
+ */
+#define MQTT_SUB_SLOT_COUNT                (4u)
+
 /*******************************************************************************
 * Global Variables
 ********************************************************************************/
@@ -57,18 +63,35 @@ typedef struct{
     subscriber_cmd_t cmd;
 } subscriber_data_t;
 
+/* Receive slot holding one JSON object of a received message. The payload
+ * is copied once from the MQTT callback into the slot: cy_mqtt only keeps the
+ * received message valid during the callback, so the radar configuration
+ * task cannot parse it in place. A slot has one owner at a time, the
+ * callback until it is queued, then the radar configuration task. Messages
+ * larger than a slot are split at top-level members into several fragments,
+ * each a complete JSON object.
+ */
+typedef struct{
+    volatile bool in_use;   /* Taken from the pool, until released */
+    uint32_t length;
+    uint8_t fragment;       /* Index of the fragment within its message */
+    bool last_fragment;     /* No more fragments of this message follow */
+    char data[MQTT_SUB_MSG_MAX_SIZE];
+} sub_payload_slot_t;
+
 /*******************************************************************************
 * Extern Variables
 *******************************************************************************/
 extern TaskHandle_t subscriber_task_handle;
-extern SemaphoreHandle_t sem_sub_payload;
-extern char sub_msg_payload[512];
 extern QueueHandle_t subscriber_task_q;
+extern QueueHandle_t sub_payload_q;
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
+bool subscriber_init(void);
 void subscriber_task(void *pvParameters);
 void mqtt_subscription_callback(cy_mqtt_publish_info_t *received_msg_info);
+void subscriber_payload_release(sub_payload_slot_t *slot);
 
 /* [] END OF FILE */
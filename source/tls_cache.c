@@ -0,0 +1,316 @@
+/******************************************************************************
+ * File Name:   tls_cache.c
+ *
+ * Description: This file keeps the TLS state of the MQTT broker connection
+ *   across  *   reconnections: the session of the last handshake, offered
+ *   again for an  *   abbreviated handshake (MQTT_TLS_SESSION_RESUME), and the
+ *   parsed client  *   certificate and key (MQTT_TLS_IDENTITY_REUSE).
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+/* Header file includes */
+#include <stdbool.h>
+#include <string.h>
+
+#include "mbedtls/ssl.h"
+#include "cy_tls.h"
+
+/* Header file for local task */
+#include "mqtt_client_config.h"
+#include "tls_cache.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The MQTT library creates a new TLS context and identity for every
+ * connection and gives no access to them, so the library functions that set
+ * them up are wrapped: GNU ld with --wrap (see LDFLAGS in the Makefile),
+ * armlink with $Sub$$/$Super$$. The IAR linker has no equivalent, the cache
+ * is not used there. */
+#if defined(__ARMCC_VERSION)
+#define TLS_CACHE_WRAP(function) $Sub$$##function
+#define TLS_CACHE_REAL(function) $Super$$##function
+#else
+#define TLS_CACHE_WRAP(function) __wrap_##function
+#define TLS_CACHE_REAL(function) __real_##function
+#endif
+
+#if !defined(__ICCARM__)
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+int TLS_CACHE_WRAP(mbedtls_ssl_setup)(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf);
+int TLS_CACHE_REAL(mbedtls_ssl_setup)(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf);
+int TLS_CACHE_WRAP(mbedtls_ssl_handshake)(mbedtls_ssl_context *ssl);
+int TLS_CACHE_REAL(mbedtls_ssl_handshake)(mbedtls_ssl_context *ssl);
+cy_rslt_t TLS_CACHE_WRAP(cy_tls_create_identity)(const char *certificate_data, const uint32_t certificate_len,
+                                                 const char *private_key, uint32_t private_key_len,
+                                                 void **tls_identity);
+cy_rslt_t TLS_CACHE_REAL(cy_tls_create_identity)(const char *certificate_data, const uint32_t certificate_len,
+                                                 const char *private_key, uint32_t private_key_len,
+                                                 void **tls_identity);
+cy_rslt_t TLS_CACHE_WRAP(cy_tls_delete_identity)(void *tls_identity);
+cy_rslt_t TLS_CACHE_REAL(cy_tls_delete_identity)(void *tls_identity);
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+#if MQTT_TLS_SESSION_RESUME
+/* Session of the last completed handshake, offered on the next connection */
+static mbedtls_ssl_session cached_session;
+static bool cached_session_valid = false;
+/* Session offered to the handshake in progress */
+static bool session_offered = false;
+#endif
+
+#if MQTT_TLS_IDENTITY_REUSE
+/* Parsed client identity and the credentials it was created from */
+static void *cached_identity = NULL;
+static const char *cached_certificate = NULL;
+static const char *cached_private_key = NULL;
+#endif
+#endif /* !defined(__ICCARM__) */
+
+static tls_cache_stats_t tls_cache_stats;
+
+#if !defined(__ICCARM__)
+/*******************************************************************************
+ * Function Name: mbedtls_ssl_setup wrapper
+ *******************************************************************************
+ * Summary:
+ *   Link-time wrapper of mbedtls_ssl_setup(). Offers the session of the last
+ *   handshake to the new context, the broker either resumes it or falls back
+ *   to a full handshake. The application only connects to the MQTT broker as
+ *   a TLS client, so every context belongs to that connection.
+ *
+ * Parameters:
+ *   ssl: TLS context
+ *   conf: TLS configuration
+ *
+ * Return:
+ *   result of mbedtls_ssl_setup()
+ ******************************************************************************/
+int TLS_CACHE_WRAP(mbedtls_ssl_setup)(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf)
+{
+    int ret = TLS_CACHE_REAL(mbedtls_ssl_setup)(ssl, conf);
+
+#if MQTT_TLS_SESSION_RESUME
+    session_offered = false;
+    if ((ret == 0) && cached_session_valid)
+    {
+        session_offered = (mbedtls_ssl_set_session(ssl, &cached_session) == 0);
+    }
+#endif
+
+    return ret;
+}
+
+/*******************************************************************************
+ * Function Name: mbedtls_ssl_handshake wrapper
+ *******************************************************************************
+ * Summary:
+ *   Link-time wrapper of mbedtls_ssl_handshake(). Keeps the session of a
+ *   completed handshake for the next connection. A failed handshake drops
+ *   the kept session, the next connection then does a full handshake.
+ *
+ * Parameters:
+ *   ssl: TLS context
+ *
+ * Return:
+ *   result of mbedtls_ssl_handshake()
+ ******************************************************************************/
+int TLS_CACHE_WRAP(mbedtls_ssl_handshake)(mbedtls_ssl_context *ssl)
+{
+    int ret = TLS_CACHE_REAL(mbedtls_ssl_handshake)(ssl);
+#if MQTT_TLS_SESSION_RESUME
+    mbedtls_ssl_session session;
+#endif
+
+    if (ret == 0)
+    {
+        tls_cache_stats.handshakes++;
+#if MQTT_TLS_SESSION_RESUME
+        mbedtls_ssl_session_init(&session);
+        if (mbedtls_ssl_get_session(ssl, &session) == 0)
+        {
+            /* A broker resuming the session echoes its ID */
+            if (session_offered)
+            {
+                tls_cache_stats.offered++;
+                if ((session.id_len > 0u) && (session.id_len == cached_session.id_len) &&
+                    (memcmp(session.id, cached_session.id, session.id_len) == 0))
+                {
+                    tls_cache_stats.resumed++;
+                }
+            }
+            mbedtls_ssl_session_free(&cached_session);
+            cached_session = session;
+            cached_session_valid = true;
+        }
+        else
+        {
+            mbedtls_ssl_session_free(&session);
+        }
+        session_offered = false;
+#endif
+    }
+#if MQTT_TLS_SESSION_RESUME
+    else if ((ret != MBEDTLS_ERR_SSL_WANT_READ) && (ret != MBEDTLS_ERR_SSL_WANT_WRITE))
+    {
+        mbedtls_ssl_session_free(&cached_session);
+        cached_session_valid = false;
+        session_offered = false;
+    }
+#endif
+
+    return ret;
+}
+
+/*******************************************************************************
+ * Function Name: cy_tls_create_identity wrapper
+ *******************************************************************************
+ * Summary:
+ *   Link-time wrapper of cy_tls_create_identity(). The identity parsed for
+ *   the first connection is returned again for the same credentials, instead
+ *   of parsing the client certificate and key on every connection.
+ *
+ * Parameters:
+ *   certificate_data: client certificate, PEM or DER
+ *   certificate_len: size of the certificate
+ *   private_key: client private key, PEM or DER
+ *   private_key_len: size of the key
+ *   tls_identity: destination of the identity
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS or the error of cy_tls_create_identity()
+ ******************************************************************************/
+cy_rslt_t TLS_CACHE_WRAP(cy_tls_create_identity)(const char *certificate_data, const uint32_t certificate_len,
+                                                 const char *private_key, uint32_t private_key_len,
+                                                 void **tls_identity)
+{
+    cy_rslt_t result;
+
+#if MQTT_TLS_IDENTITY_REUSE
+    if ((cached_identity != NULL) && (certificate_data == cached_certificate) && (private_key == cached_private_key))
+    {
+        tls_cache_stats.identity_reuses++;
+        *tls_identity = cached_identity;
+        return CY_RSLT_SUCCESS;
+    }
+#endif
+
+    result = TLS_CACHE_REAL(cy_tls_create_identity)(certificate_data, certificate_len,
+                                                    private_key, private_key_len, tls_identity);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        tls_cache_stats.identity_parses++;
+#if MQTT_TLS_IDENTITY_REUSE
+        if (cached_identity == NULL)
+        {
+            cached_identity = *tls_identity;
+            cached_certificate = certificate_data;
+            cached_private_key = private_key;
+        }
+#endif
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: cy_tls_delete_identity wrapper
+ *******************************************************************************
+ * Summary:
+ *   Link-time wrapper of cy_tls_delete_identity(). The cached identity is
+ *   kept across disconnections, tls_cache_release() deletes it.
+ *
+ * Parameters:
+ *   tls_identity: identity to delete
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS or the error of cy_tls_delete_identity()
+ ******************************************************************************/
+cy_rslt_t TLS_CACHE_WRAP(cy_tls_delete_identity)(void *tls_identity)
+{
+#if MQTT_TLS_IDENTITY_REUSE
+    if ((tls_identity != NULL) && (tls_identity == cached_identity))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+#endif
+
+    return TLS_CACHE_REAL(cy_tls_delete_identity)(tls_identity);
+}
+#endif /* !defined(__ICCARM__) */
+
+/*******************************************************************************
+ * Function Name: tls_cache_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the handshake, resumption and identity counters. Called from the
+ *   MQTT client task, which also runs every TLS handshake.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void tls_cache_get_stats(tls_cache_stats_t *stats)
+{
+    *stats = tls_cache_stats;
+}
+
+/*******************************************************************************
+ * Function Name: tls_cache_release
+ *******************************************************************************
+ * Summary:
+ *   Frees the kept session and deletes the kept client identity. Must be
+ *   called after the MQTT instance using them was deleted.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void tls_cache_release(void)
+{
+#if !defined(__ICCARM__)
+#if MQTT_TLS_SESSION_RESUME
+    mbedtls_ssl_session_free(&cached_session);
+    cached_session_valid = false;
+    session_offered = false;
+#endif
+#if MQTT_TLS_IDENTITY_REUSE
+    if (cached_identity != NULL)
+    {
+        (void)TLS_CACHE_REAL(cy_tls_delete_identity)(cached_identity);
+        cached_identity = NULL;
+        cached_certificate = NULL;
+        cached_private_key = NULL;
+    }
+#endif
+#endif
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * File Name:   tls_cache.h
+ *
+ * Description: This file is the public interface of tls_cache.c
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Reuse of TLS state across the broker connections */
+typedef struct
+{
+    uint32_t handshakes;        /* Completed TLS handshakes */
+    uint32_t offered;           /* Handshakes that offered the previous session */
+    uint32_t resumed;           /* Offered sessions the broker accepted */
+    uint32_t identity_parses;   /* Client certificate and key parsed */
+    uint32_t identity_reuses;   /* Connections that reused the parsed client identity */
+} tls_cache_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void tls_cache_get_stats(tls_cache_stats_t *stats);
+void tls_cache_release(void);
+
+/* [] END OF FILE */
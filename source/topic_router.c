@@ -0,0 +1,440 @@
+/******************************************************************************
+ * File Name:   topic_router.c
+ *
+ * Description: This file implements the registry of the subscribed topic
+ *   filters and the dispatch of received messages to their handlers. The
+ *   filters are stored as a trie of topic levels, so a message is matched by
+ *   walking its levels instead of comparing it against every filter. The
+ *   single-level '+' and multi-level '#' wildcards of MQTT are supported.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "topic_router.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Marks a missing child, sibling or filter */
+#define TOPIC_ROUTER_NONE (0xFFu)
+
+#if (TOPIC_ROUTER_MAX_NODES >= TOPIC_ROUTER_NONE) || (TOPIC_ROUTER_MAX_FILTERS >= TOPIC_ROUTER_NONE)
+#error "TOPIC_ROUTER_MAX_NODES and TOPIC_ROUTER_MAX_FILTERS must be below 255."
+#endif
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* One level of one or more filters. The children of a node are chained
+ * through 'next_sibling'. */
+typedef struct
+{
+    const char *level;          /* Points into the filter string, not terminated */
+    uint16_t level_len;
+    uint8_t first_child;
+    uint8_t next_sibling;
+    uint8_t filter;             /* Filter ending at this level */
+} topic_node_t;
+
+/* Handler of one filter */
+typedef struct
+{
+    topic_handler_t handler;
+    void *arg;
+} topic_route_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+/* Node 0 is the root, it holds no level */
+static topic_node_t nodes[TOPIC_ROUTER_MAX_NODES] =
+{
+    { NULL, 0, TOPIC_ROUTER_NONE, TOPIC_ROUTER_NONE, TOPIC_ROUTER_NONE }
+};
+static uint32_t node_count = 1;
+
+/* Filters in order of registration, in the format of the SUBSCRIBE packet */
+static cy_mqtt_subscribe_info_t subscriptions[TOPIC_ROUTER_MAX_FILTERS];
+static topic_route_t routes[TOPIC_ROUTER_MAX_FILTERS];
+static uint32_t filter_count = 0;
+
+static topic_router_stats_t router_stats;
+
+/*******************************************************************************
+ * Function Name: filter_is_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks the wildcards of a topic filter: '+' must fill a whole level, '#'
+ *   must fill the last level.
+ *
+ * Parameters:
+ *   filter: topic filter
+ *   len: length of the filter
+ *
+ * Return:
+ *   true if the filter is valid
+ ******************************************************************************/
+static bool filter_is_valid(const char *filter, size_t len)
+{
+    if ((len == 0) || (len > UINT16_MAX))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        bool level_start = (i == 0) || (filter[i - 1] == '/');
+        bool level_end = ((i + 1) == len) || (filter[i + 1] == '/');
+
+        if ((filter[i] == '+') && !(level_start && level_end))
+        {
+            return false;
+        }
+        if ((filter[i] == '#') && !(level_start && ((i + 1) == len)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: find_or_add_child
+ *******************************************************************************
+ * Summary:
+ *   Returns the child of a node holding the given level, adding it if needed.
+ *
+ * Parameters:
+ *   parent: index of the parent node
+ *   level: level text
+ *   level_len: length of the level
+ *
+ * Return:
+ *   index of the child, TOPIC_ROUTER_NONE if no node is left
+ ******************************************************************************/
+static uint32_t find_or_add_child(uint32_t parent, const char *level, uint16_t level_len)
+{
+    uint32_t child = nodes[parent].first_child;
+
+    while (child != TOPIC_ROUTER_NONE)
+    {
+        if ((nodes[child].level_len == level_len) && (memcmp(nodes[child].level, level, level_len) == 0))
+        {
+            return child;
+        }
+        child = nodes[child].next_sibling;
+    }
+
+    if (node_count >= TOPIC_ROUTER_MAX_NODES)
+    {
+        return TOPIC_ROUTER_NONE;
+    }
+
+    child = node_count++;
+    nodes[child].level = level;
+    nodes[child].level_len = level_len;
+    nodes[child].first_child = TOPIC_ROUTER_NONE;
+    nodes[child].filter = TOPIC_ROUTER_NONE;
+    nodes[child].next_sibling = nodes[parent].first_child;
+    nodes[parent].first_child = (uint8_t)child;
+
+    return child;
+}
+
+/*******************************************************************************
+ * Function Name: remove_nodes_from
+ *******************************************************************************
+ * Summary:
+ *   Removes the nodes added by a failed registration. A new node is the first
+ *   child of its parent as long as no later node was added, so the nodes are
+ *   unlinked from the newest to the oldest.
+ *
+ * Parameters:
+ *   first: index of the first node to remove
+ *
+ * Return:
+ *   void
+ ******************************************************************************/
+static void remove_nodes_from(uint32_t first)
+{
+    while (node_count > first)
+    {
+        uint32_t child = node_count - 1;
+
+        for (uint32_t parent = 0; parent < child; parent++)
+        {
+            if (nodes[parent].first_child == child)
+            {
+                nodes[parent].first_child = nodes[child].next_sibling;
+                break;
+            }
+        }
+        node_count = child;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: topic_router_register
+ *******************************************************************************
+ * Summary:
+ *   Registers a topic filter and its handler. Filters are registered before
+ *   the MQTT client task connects to the broker and are subscribed on every
+ *   connection; a later registration takes effect with the next
+ *   SUBSCRIBE_TO_TOPIC command of the subscriber task. A filter can be
+ *   registered once. A failed registration leaves the trie unchanged.
+ *
+ * Parameters:
+ *   filter: topic filter, must stay valid
+ *   qos: requested QoS of the subscription
+ *   handler: called for every message matching the filter
+ *   arg: passed to the handler
+ *
+ * Return:
+ *   true on success, false if the filter is invalid, already registered or
+ *   the registry is full
+ ******************************************************************************/
+bool topic_router_register(const char *filter, cy_mqtt_qos_t qos, topic_handler_t handler, void *arg)
+{
+    size_t len = strlen(filter);
+    uint32_t node = 0;
+    size_t start = 0;
+    uint32_t first_new;
+    bool result = false;
+
+    if ((handler == NULL) || !filter_is_valid(filter, len))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    first_new = node_count;
+    if (filter_count < TOPIC_ROUTER_MAX_FILTERS)
+    {
+        /* Walk or create one node per level */
+        while (node != TOPIC_ROUTER_NONE)
+        {
+            size_t end = start;
+
+            while ((end < len) && (filter[end] != '/'))
+            {
+                end++;
+            }
+            node = find_or_add_child(node, &filter[start], (uint16_t)(end - start));
+            if (end >= len)
+            {
+                break;
+            }
+            start = end + 1;
+        }
+
+        if ((node != TOPIC_ROUTER_NONE) && (nodes[node].filter == TOPIC_ROUTER_NONE))
+        {
+            routes[filter_count].handler = handler;
+            routes[filter_count].arg = arg;
+            subscriptions[filter_count].qos = qos;
+            subscriptions[filter_count].topic = filter;
+            subscriptions[filter_count].topic_len = (uint16_t)len;
+            nodes[node].filter = (uint8_t)filter_count;
+            filter_count++;
+            result = true;
+        }
+    }
+    if (!result)
+    {
+        remove_nodes_from(first_new);
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: topic_router_get_subscriptions
+ *******************************************************************************
+ * Summary:
+ *   Returns the registered filters for the SUBSCRIBE and UNSUBSCRIBE packets.
+ *
+ * Parameters:
+ *   list: set to the first of the filters
+ *
+ * Return:
+ *   number of filters
+ ******************************************************************************/
+uint32_t topic_router_get_subscriptions(cy_mqtt_subscribe_info_t **list)
+{
+    *list = subscriptions;
+    return filter_count;
+}
+
+/*******************************************************************************
+ * Function Name: deliver
+ *******************************************************************************
+ * Summary:
+ *   Calls the handler of the filter ending at a node, if any.
+ *
+ * Parameters:
+ *   node: index of the node
+ *   message: received message
+ *
+ * Return:
+ *   number of handlers called, 0 or 1
+ ******************************************************************************/
+static uint32_t deliver(uint32_t node, cy_mqtt_publish_info_t *message)
+{
+    uint32_t filter = nodes[node].filter;
+
+    if (filter == TOPIC_ROUTER_NONE)
+    {
+        return 0;
+    }
+    routes[filter].handler(message, routes[filter].arg);
+    return 1;
+}
+
+/*******************************************************************************
+ * Function Name: match_level
+ *******************************************************************************
+ * Summary:
+ *   Matches the remaining topic levels against the children of a node and
+ *   delivers the message to every filter that matches. Wildcards in the first
+ *   level do not match topics starting with '$', as required by MQTT.
+ *
+ * Parameters:
+ *   node: index of the node matched by the previous levels
+ *   level: start of the current topic level
+ *   remaining: characters from 'level' to the end of the topic
+ *   first: 'level' is the first level of the topic
+ *   message: received message
+ *
+ * Return:
+ *   number of handlers called
+ ******************************************************************************/
+static uint32_t match_level(uint32_t node, const char *level, size_t remaining, bool first,
+                            cy_mqtt_publish_info_t *message)
+{
+    size_t level_len = 0;
+    bool last;
+    bool system_topic = first && (remaining > 0) && (level[0] == '$');
+    uint32_t calls = 0;
+
+    while ((level_len < remaining) && (level[level_len] != '/'))
+    {
+        level_len++;
+    }
+    last = (level_len == remaining);
+
+    for (uint32_t child = nodes[node].first_child; child != TOPIC_ROUTER_NONE; child = nodes[child].next_sibling)
+    {
+        const topic_node_t *entry = &nodes[child];
+        bool wildcard = (entry->level_len == 1) && ((entry->level[0] == '+') || (entry->level[0] == '#'));
+
+        if (wildcard && system_topic)
+        {
+            continue;
+        }
+
+        if (wildcard && (entry->level[0] == '#'))
+        {
+            /* Matches this and all following levels */
+            calls += deliver(child, message);
+        }
+        else if ((wildcard && (entry->level[0] == '+')) ||
+                 ((entry->level_len == level_len) && (memcmp(entry->level, level, level_len) == 0)))
+        {
+            if (last)
+            {
+                calls += deliver(child, message);
+
+                /* "a/#" also matches "a" */
+                for (uint32_t next = entry->first_child; next != TOPIC_ROUTER_NONE; next = nodes[next].next_sibling)
+                {
+                    if ((nodes[next].level_len == 1) && (nodes[next].level[0] == '#'))
+                    {
+                        calls += deliver(next, message);
+                    }
+                }
+            }
+            else
+            {
+                calls += match_level(child, &level[level_len + 1], remaining - level_len - 1, false, message);
+            }
+        }
+    }
+
+    return calls;
+}
+
+/*******************************************************************************
+ * Function Name: topic_router_dispatch
+ *******************************************************************************
+ * Summary:
+ *   Hands a received message to the handler of every matching filter.
+ *
+ * Parameters:
+ *   message: received message
+ *
+ * Return:
+ *   number of handlers called
+ ******************************************************************************/
+uint32_t topic_router_dispatch(cy_mqtt_publish_info_t *message)
+{
+    uint32_t calls = match_level(0, message->topic, message->topic_len, true, message);
+
+    taskENTER_CRITICAL();
+    if (calls > 0)
+    {
+        router_stats.dispatched++;
+    }
+    else
+    {
+        router_stats.unmatched++;
+    }
+    taskEXIT_CRITICAL();
+
+    return calls;
+}
+
+/*******************************************************************************
+ * Function Name: topic_router_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the router counters.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void topic_router_get_stats(topic_router_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = router_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
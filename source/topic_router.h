@@ -0,0 +1,66 @@
+/******************************************************************************
+ * File Name:   topic_router.h
+ *
+ * Description: This file contains the function prototypes and constants used
+ *   in topic_router.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_mqtt_api.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Most topic filters, all of them are sent in one SUBSCRIBE packet */
+#define TOPIC_ROUTER_MAX_FILTERS (8u)
+
+/* Most trie nodes, one per distinct filter level */
+#define TOPIC_ROUTER_MAX_NODES   (32u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Handler of the messages matching a filter. Called from the MQTT library
+ * context, it must not block. */
+typedef void (*topic_handler_t)(cy_mqtt_publish_info_t *message, void *arg);
+
+/* Counters of the router */
+typedef struct
+{
+    uint32_t dispatched;        /* Messages handed to at least one handler */
+    uint32_t unmatched;         /* Messages matching no filter */
+} topic_router_stats_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+bool topic_router_register(const char *filter, cy_mqtt_qos_t qos, topic_handler_t handler, void *arg);
+uint32_t topic_router_get_subscriptions(cy_mqtt_subscribe_info_t **list);
+uint32_t topic_router_dispatch(cy_mqtt_publish_info_t *message);
+void topic_router_get_stats(topic_router_stats_t *stats);
+
+/* [] END OF FILE */
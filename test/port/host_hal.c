@@ -0,0 +1,433 @@
+/******************************************************************************
+ * File Name:   host_hal.c
+ *
+ * Description: Board support and HAL services used by the application,
+ *   emulated on the host: GPIO levels and interrupts, the flash rows of the
+ *   store, the timers, the TRNG and the device identifier.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cybsp.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+
+#include "host_port.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define HOST_GPIO_COUNT             (256u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+uint32_t SystemCoreClock = 100000000u;
+
+static bool gpio_level[HOST_GPIO_COUNT];
+static cyhal_gpio_event_t gpio_event[HOST_GPIO_COUNT];
+static cyhal_gpio_callback_data_t *gpio_callback[HOST_GPIO_COUNT];
+static host_gpio_write_hook_t gpio_write_hook;
+
+static uint32_t flash_base;
+static uint8_t *flash_image;
+static size_t flash_size;
+static uint32_t flash_writes;
+static host_flash_write_hook_t flash_write_hook;
+
+static uint32_t timer_frequency = 1000000u;
+static uint64_t unique_id = 0x0123456789ABCDEFull;
+
+/* Heap region of the linker script, which radar_diag.c compares with the heap
+ * statistics of the C library */
+uint8_t host_heap_region[0x40000];
+__asm__(".globl __HeapBase\n.set __HeapBase, host_heap_region\n"
+        ".globl __HeapLimit\n.set __HeapLimit, host_heap_region + 0x40000\n");
+
+/*******************************************************************************
+ * Board
+ ******************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_retarget_io_init(cyhal_gpio_t tx, cyhal_gpio_t rx, uint32_t baudrate)
+{
+    (void)tx;
+    (void)rx;
+    (void)baudrate;
+    return CY_RSLT_SUCCESS;
+}
+
+uint64_t Cy_SysLib_GetUniqueId(void)
+{
+    return unique_id;
+}
+
+void host_set_unique_id(uint64_t id)
+{
+    unique_id = id;
+}
+
+/*******************************************************************************
+ * GPIO
+ ******************************************************************************/
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val)
+{
+    (void)direction;
+    (void)drive_mode;
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    gpio_level[pin] = init_val;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_gpio_free(cyhal_gpio_t pin)
+{
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    gpio_callback[pin] = NULL;
+    gpio_event[pin] = CYHAL_GPIO_IRQ_NONE;
+}
+
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    gpio_level[pin] = value;
+    if (gpio_write_hook != NULL)
+    {
+        gpio_write_hook(pin, value);
+    }
+}
+
+bool cyhal_gpio_read(cyhal_gpio_t pin)
+{
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    return gpio_level[pin];
+}
+
+void cyhal_gpio_toggle(cyhal_gpio_t pin)
+{
+    cyhal_gpio_write(pin, !cyhal_gpio_read(pin));
+}
+
+/* Like the HAL, a pin has a single callback: registering one replaces the
+ * previous registration */
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data)
+{
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    if (callback_data != NULL)
+    {
+        callback_data->pin = pin;
+    }
+    gpio_callback[pin] = callback_data;
+}
+
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable)
+{
+    (void)intr_priority;
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    gpio_event[pin] = enable ? event : CYHAL_GPIO_IRQ_NONE;
+}
+
+void Cy_GPIO_SetSlewRate(void *base, uint32_t pin, uint32_t value)
+{
+    (void)base;
+    (void)pin;
+    (void)value;
+}
+
+void Cy_GPIO_SetDriveSel(void *base, uint32_t pin, uint32_t value)
+{
+    (void)base;
+    (void)pin;
+    (void)value;
+}
+
+void host_gpio_set(cyhal_gpio_t pin, bool level)
+{
+    cyhal_gpio_event_t edge;
+    cyhal_gpio_callback_data_t *callback;
+
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    if (gpio_level[pin] == level)
+    {
+        return;
+    }
+
+    gpio_level[pin] = level;
+    edge = level ? CYHAL_GPIO_IRQ_RISE : CYHAL_GPIO_IRQ_FALL;
+    callback = gpio_callback[pin];
+
+    if (callback != NULL && (gpio_event[pin] == edge || gpio_event[pin] == CYHAL_GPIO_IRQ_BOTH))
+    {
+        callback->callback(callback->callback_arg, edge);
+    }
+}
+
+bool host_gpio_get(cyhal_gpio_t pin)
+{
+    return cyhal_gpio_read(pin);
+}
+
+const cyhal_gpio_callback_data_t *host_gpio_get_callback(cyhal_gpio_t pin)
+{
+    CY_ASSERT(pin < HOST_GPIO_COUNT);
+    return gpio_callback[pin];
+}
+
+void host_gpio_set_write_hook(host_gpio_write_hook_t hook)
+{
+    gpio_write_hook = hook;
+}
+
+/*******************************************************************************
+ * Timer, free running at the configured frequency
+ ******************************************************************************/
+cy_rslt_t cyhal_timer_init(cyhal_timer_t *obj, cyhal_gpio_t pin, const void *clk)
+{
+    (void)obj;
+    (void)pin;
+    (void)clk;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_timer_configure(cyhal_timer_t *obj, const cyhal_timer_cfg_t *cfg)
+{
+    (void)obj;
+    (void)cfg;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_timer_set_frequency(cyhal_timer_t *obj, uint32_t hz)
+{
+    (void)obj;
+    timer_frequency = hz;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_timer_register_callback(cyhal_timer_t *obj, cyhal_timer_event_callback_t callback, void *callback_arg)
+{
+    (void)obj;
+    (void)callback;
+    (void)callback_arg;
+}
+
+void cyhal_timer_enable_event(cyhal_timer_t *obj, cyhal_timer_event_t event, uint8_t intr_priority, bool enable)
+{
+    (void)obj;
+    (void)event;
+    (void)intr_priority;
+    (void)enable;
+}
+
+cy_rslt_t cyhal_timer_start(cyhal_timer_t *obj)
+{
+    (void)obj;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_timer_stop(cyhal_timer_t *obj)
+{
+    (void)obj;
+    return CY_RSLT_SUCCESS;
+}
+
+uint32_t cyhal_timer_read(const cyhal_timer_t *obj)
+{
+    (void)obj;
+    return (uint32_t)((host_time_us() * timer_frequency) / 1000000u);
+}
+
+/*******************************************************************************
+ * SPI
+ ******************************************************************************/
+cy_rslt_t cyhal_spi_init(cyhal_spi_t *obj, cyhal_gpio_t mosi, cyhal_gpio_t miso, cyhal_gpio_t sclk, cyhal_gpio_t ssel,
+                         const void *clk, uint8_t bits, cyhal_spi_mode_t mode, bool is_slave)
+{
+    (void)obj;
+    (void)mosi;
+    (void)miso;
+    (void)sclk;
+    (void)ssel;
+    (void)clk;
+    (void)bits;
+    (void)mode;
+    (void)is_slave;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_spi_set_frequency(cyhal_spi_t *obj, uint32_t hz)
+{
+    (void)obj;
+    (void)hz;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Flash
+ ******************************************************************************/
+/*******************************************************************************
+ * Function Name: flash_at
+ ********************************************************************************
+ * Summary:
+ *  Translates a flash address into the mapped image, the access must stay
+ *  inside the image.
+ *
+ * Parameters:
+ *  address: flash address
+ *  size: bytes accessed
+ *
+ * Return:
+ *  uint8_t *: location in the image
+ ******************************************************************************/
+static uint8_t *flash_at(uint32_t address, size_t size)
+{
+    CY_ASSERT(flash_image != NULL);
+    CY_ASSERT(address >= flash_base && (size_t)(address - flash_base) + size <= flash_size);
+    return &flash_image[address - flash_base];
+}
+
+void host_flash_map(uint32_t address, uint8_t *image, size_t size)
+{
+    flash_base = address;
+    flash_image = image;
+    flash_size = size;
+    flash_writes = 0u;
+}
+
+void host_flash_set_write_hook(host_flash_write_hook_t hook)
+{
+    flash_write_hook = hook;
+}
+
+uint32_t host_flash_write_count(void)
+{
+    return flash_writes;
+}
+
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj)
+{
+    (void)obj;
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_flash_free(cyhal_flash_t *obj)
+{
+    (void)obj;
+}
+
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info)
+{
+    static cyhal_flash_block_info_t block;
+
+    (void)obj;
+    block.start_address = flash_base;
+    block.size = (uint32_t)flash_size;
+    block.sector_size = CY_FLASH_SIZEOF_ROW;
+    block.page_size = CY_FLASH_SIZEOF_ROW;
+    block.erase_value = 0x00u;
+    info->block_count = 1u;
+    info->blocks = &block;
+}
+
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size)
+{
+    (void)obj;
+    memcpy(data, flash_at(address, size), size);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address)
+{
+    (void)obj;
+    memset(flash_at(address, CY_FLASH_SIZEOF_ROW), 0, CY_FLASH_SIZEOF_ROW);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_flash_write(cyhal_flash_t *obj, uint32_t address, const uint32_t *data)
+{
+    uint8_t *row = flash_at(address, CY_FLASH_SIZEOF_ROW);
+
+    (void)obj;
+    CY_ASSERT((address - flash_base) % CY_FLASH_SIZEOF_ROW == 0u);
+    flash_writes++;
+
+    if (flash_write_hook == NULL || !flash_write_hook(address, row, (const uint8_t *)data))
+    {
+        memcpy(row, data, CY_FLASH_SIZEOF_ROW);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data)
+{
+    return cyhal_flash_write(obj, address, data);
+}
+
+/*******************************************************************************
+ * TRNG
+ ******************************************************************************/
+cy_rslt_t cyhal_trng_init(cyhal_trng_t *obj)
+{
+    (void)obj;
+    return CY_RSLT_SUCCESS;
+}
+
+uint32_t cyhal_trng_generate(const cyhal_trng_t *obj)
+{
+    (void)obj;
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+void cyhal_trng_free(cyhal_trng_t *obj)
+{
+    (void)obj;
+}
+
+/*******************************************************************************
+ * Low power timer, a tickless idle period elapses at once
+ ******************************************************************************/
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj)
+{
+    (void)obj;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_syspm_tickless_deepsleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms)
+{
+    (void)obj;
+    *actual_ms = desired_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_syspm_tickless_sleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms)
+{
+    (void)obj;
+    *actual_ms = desired_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,283 @@
+/******************************************************************************
+ * File Name:   host_middleware.c
+ *
+ * Description: Middleware services used by the MQTT client task, emulated on
+ *   the host: the Wi-Fi connection manager, the lwIP address formatting, the
+ *   clock of the MQTT library, the TLS root certificates, and a JSON parser
+ *   for the flat objects of the configuration messages.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "clock.h"
+#include "cy_json_parser.h"
+#include "cy_lwip.h"
+#include "cy_tls.h"
+#include "cy_wcm.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Address handed out by the emulated access point, 192.168.0.2 */
+#define HOST_WIFI_IPV4_ADDRESS      (0x0200A8C0u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static bool wifi_connected;
+
+static cy_JSON_callback_t json_callback;
+static void *json_callback_arg;
+
+/*******************************************************************************
+ * Wi-Fi connection manager
+ ******************************************************************************/
+cy_rslt_t cy_wcm_init(cy_wcm_config_t *config)
+{
+    (void)config;
+    wifi_connected = false;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_wcm_deinit(void)
+{
+    wifi_connected = false;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_wcm_connect_ap(cy_wcm_connect_params_t *connect_params, cy_wcm_ip_address_t *ip_addr)
+{
+    (void)connect_params;
+    memset(ip_addr, 0, sizeof(*ip_addr));
+    ip_addr->version = CY_WCM_IP_VER_V4;
+    ip_addr->ip.v4 = HOST_WIFI_IPV4_ADDRESS;
+    wifi_connected = true;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_wcm_disconnect_ap(void)
+{
+    wifi_connected = false;
+    return CY_RSLT_SUCCESS;
+}
+
+uint8_t cy_wcm_is_connected_to_ap(void)
+{
+    return wifi_connected ? 1u : 0u;
+}
+
+/*******************************************************************************
+ * lwIP
+ ******************************************************************************/
+char *ip4addr_ntoa(const ip4_addr_t *addr)
+{
+    static char text[16];
+    const uint8_t *bytes = (const uint8_t *)&addr->addr;
+
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return text;
+}
+
+char *ip6addr_ntoa(const ip6_addr_t *addr)
+{
+    static char text[40];
+
+    snprintf(text, sizeof(text), "%08X:%08X:%08X:%08X",
+             (unsigned int)addr->addr[0], (unsigned int)addr->addr[1],
+             (unsigned int)addr->addr[2], (unsigned int)addr->addr[3]);
+    return text;
+}
+
+/*******************************************************************************
+ * Clock of the MQTT library
+ ******************************************************************************/
+uint32_t Clock_GetTimeMs(void)
+{
+    return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/*******************************************************************************
+ * TLS, the loopback broker does not authenticate
+ ******************************************************************************/
+cy_rslt_t cy_tls_load_global_root_ca_certificates(const char *trusted_ca_certificates, const uint32_t cert_length)
+{
+    (void)trusted_ca_certificates;
+    (void)cert_length;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_tls_release_global_root_ca_certificates(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * JSON parser. Only objects of keys with a string, number, boolean or null
+ * value are accepted, which is all the configuration messages hold.
+ ******************************************************************************/
+cy_rslt_t cy_JSON_parser_register_callback(cy_JSON_callback_t callback, void *arg)
+{
+    json_callback = callback;
+    json_callback_arg = arg;
+    return CY_RSLT_SUCCESS;
+}
+
+static const char *json_skip_space(const char *cursor, const char *end)
+{
+    while ((cursor < end) && isspace((unsigned char)*cursor))
+    {
+        cursor++;
+    }
+    return cursor;
+}
+
+/* Scans a string starting at its opening quote, returns its closing quote */
+static const char *json_scan_string(const char *cursor, const char *end)
+{
+    for (cursor++; cursor < end; cursor++)
+    {
+        if (*cursor == '\\')
+        {
+            cursor++;
+        }
+        else if (*cursor == '"')
+        {
+            return cursor;
+        }
+    }
+    return NULL;
+}
+
+cy_rslt_t cy_JSON_parser(const char *json_input, uint32_t input_length)
+{
+    const char *end = json_input + input_length;
+    const char *cursor = json_skip_space(json_input, end);
+
+    if ((cursor >= end) || (*cursor != '{'))
+    {
+        return CY_RSLT_JSON_GENERIC_ERROR;
+    }
+    cursor = json_skip_space(cursor + 1, end);
+    if ((cursor < end) && (*cursor == '}'))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    while (cursor < end)
+    {
+        cy_JSON_object_t object = { 0 };
+        const char *key_end;
+        const char *value_end;
+
+        /* Key */
+        if ((*cursor != '"') || ((key_end = json_scan_string(cursor, end)) == NULL) ||
+            ((key_end - cursor - 1) > UINT8_MAX))
+        {
+            return CY_RSLT_JSON_GENERIC_ERROR;
+        }
+        object.object_string = (char *)cursor + 1;
+        object.object_string_length = (uint8_t)(key_end - cursor - 1);
+
+        cursor = json_skip_space(key_end + 1, end);
+        if ((cursor >= end) || (*cursor != ':'))
+        {
+            return CY_RSLT_JSON_GENERIC_ERROR;
+        }
+        cursor = json_skip_space(cursor + 1, end);
+        if (cursor >= end)
+        {
+            return CY_RSLT_JSON_GENERIC_ERROR;
+        }
+
+        /* Value, strings are passed without their quotes */
+        if (*cursor == '"')
+        {
+            if ((value_end = json_scan_string(cursor, end)) == NULL)
+            {
+                return CY_RSLT_JSON_GENERIC_ERROR;
+            }
+            object.value_type = JSON_STRING_TYPE;
+            object.value = (char *)cursor + 1;
+            object.value_length = (uint16_t)(value_end - cursor - 1);
+            cursor = value_end + 1;
+        }
+        else
+        {
+            value_end = cursor;
+            while ((value_end < end) && (*value_end != ',') && (*value_end != '}') &&
+                   !isspace((unsigned char)*value_end))
+            {
+                value_end++;
+            }
+            if ((value_end == cursor) || (*cursor == '{') || (*cursor == '['))
+            {
+                return CY_RSLT_JSON_GENERIC_ERROR;
+            }
+            if ((strncmp(cursor, "true", 4) == 0) || (strncmp(cursor, "false", 5) == 0))
+            {
+                object.value_type = JSON_BOOLEAN_TYPE;
+            }
+            else if (strncmp(cursor, "null", 4) == 0)
+            {
+                object.value_type = JSON_NULL_TYPE;
+            }
+            else
+            {
+                object.value_type = JSON_NUMBER_TYPE;
+            }
+            object.value = (char *)cursor;
+            object.value_length = (uint16_t)(value_end - cursor);
+            cursor = value_end;
+        }
+
+        if (json_callback != NULL)
+        {
+            cy_rslt_t result = json_callback(&object, json_callback_arg);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                return result;
+            }
+        }
+
+        cursor = json_skip_space(cursor, end);
+        if ((cursor < end) && (*cursor == '}'))
+        {
+            return CY_RSLT_SUCCESS;
+        }
+        if ((cursor >= end) || (*cursor != ','))
+        {
+            return CY_RSLT_JSON_GENERIC_ERROR;
+        }
+        cursor = json_skip_space(cursor + 1, end);
+    }
+
+    return CY_RSLT_JSON_GENERIC_ERROR;
+}
+
+/* [] END OF FILE */
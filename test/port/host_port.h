@@ -0,0 +1,85 @@
+/******************************************************************************
+ * File Name:   host_port.h
+ *
+ * Description: Controls of the host port used by the tests: the simulated
+ *   clock, GPIO levels and interrupts, the emulated flash, the timers and the
+ *   device identifier.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* Called for every cyhal_gpio_write(), for example to log LED changes */
+typedef void (*host_gpio_write_hook_t)(cyhal_gpio_t pin, bool value);
+
+/* Called for every cyhal_flash_write() with the row in the emulated flash
+ * and the data to program. Returns true if it took care of the row itself,
+ * for example to emulate a power loss in the middle of the write. */
+typedef bool (*host_flash_write_hook_t)(uint32_t address, uint8_t *row, const uint8_t *data);
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Clock. The tick count follows the monotonic clock of the host until a test
+ * sets it; from then on it only moves with host_tick_set(),
+ * host_tick_advance() and vTaskDelay(). */
+void host_tick_set(TickType_t ticks);
+void host_tick_advance(TickType_t ticks);
+uint64_t host_time_us(void);
+
+/* Tasks. A task created with xTaskCreate() runs on its own thread. */
+const char *host_task_name(TaskHandle_t task);
+bool host_task_is_deleted(TaskHandle_t task);
+
+/* Software timers run only when a test fires them */
+TimerHandle_t host_timer_find(const char *name);
+void host_timer_fire(TimerHandle_t timer);
+
+/* GPIO. Changing the level of an input runs the registered callback in the
+ * calling thread, like an interrupt. */
+void host_gpio_set(cyhal_gpio_t pin, bool level);
+bool host_gpio_get(cyhal_gpio_t pin);
+const cyhal_gpio_callback_data_t *host_gpio_get_callback(cyhal_gpio_t pin);
+void host_gpio_set_write_hook(host_gpio_write_hook_t hook);
+
+/* Flash. A test maps a buffer to the flash addresses the code under test
+ * uses, cyhal_flash_read() and cyhal_flash_write() then work on it. */
+void host_flash_map(uint32_t address, uint8_t *image, size_t size);
+void host_flash_set_write_hook(host_flash_write_hook_t hook);
+uint32_t host_flash_write_count(void);
+
+/* Value returned by Cy_SysLib_GetUniqueId() */
+void host_set_unique_id(uint64_t id);
+
+/* [] END OF FILE */
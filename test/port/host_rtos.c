@@ -0,0 +1,1088 @@
+/******************************************************************************
+ * File Name:   host_rtos.c
+ *
+ * Description: FreeRTOS kernel services used by the application, implemented
+ *   on POSIX threads so that the application modules can be built and tested
+ *   on the host.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include "event_groups.h"
+
+#include "host_port.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define HOST_TASK_NAME_LENGTH       (configMAX_TASK_NAME_LEN)
+#define HOST_TIMER_NAME_LENGTH      (32u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+struct host_task
+{
+    pthread_t thread;
+    TaskFunction_t code;
+    void *parameters;
+    char name[HOST_TASK_NAME_LENGTH];
+    UBaseType_t priority;
+    UBaseType_t number;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify_value;
+    bool notify_pending;
+    bool deleted;
+    struct host_task *next;
+};
+
+struct host_queue
+{
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+struct host_timer
+{
+    char name[HOST_TIMER_NAME_LENGTH];
+    TickType_t period;
+    UBaseType_t auto_reload;
+    void *id;
+    TimerCallbackFunction_t callback;
+    bool active;
+    struct host_timer *next;
+};
+
+struct host_event_group
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static pthread_once_t host_rtos_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t critical_mutex;
+
+/* Protects the task and timer lists */
+static pthread_mutex_t list_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct host_task *task_list;
+static struct host_timer *timer_list;
+static UBaseType_t task_count;
+
+static __thread struct host_task *current_task;
+
+static uint64_t clock_start_us;
+static volatile bool clock_manual;
+static volatile TickType_t clock_manual_ticks;
+
+/*******************************************************************************
+ * Function Name: host_rtos_init
+ ********************************************************************************
+ * Summary:
+ *  Creates the recursive mutex behind the critical sections and records the
+ *  start of the tick count.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ ******************************************************************************/
+static void host_rtos_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    clock_start_us = host_time_us();
+}
+
+/*******************************************************************************
+ * Function Name: init_cond
+ ********************************************************************************
+ * Summary:
+ *  Initializes a condition variable that waits on the monotonic clock.
+ *
+ * Parameters:
+ *  cond: condition variable
+ *
+ * Return:
+ *  void
+ ******************************************************************************/
+static void init_cond(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/*******************************************************************************
+ * Function Name: wait_until
+ ********************************************************************************
+ * Summary:
+ *  Waits on a condition variable for at most the given number of ticks.
+ *
+ * Parameters:
+ *  cond: condition variable
+ *  lock: mutex held by the caller
+ *  timeout: ticks to wait, portMAX_DELAY waits forever
+ *  deadline: absolute deadline, computed by the first call when NULL
+ *
+ * Return:
+ *  bool: false once the deadline has passed
+ ******************************************************************************/
+static bool wait_until(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t timeout, struct timespec *deadline)
+{
+    if (timeout == 0u)
+    {
+        return false;
+    }
+
+    if (timeout == portMAX_DELAY)
+    {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+
+    if (deadline->tv_sec == 0 && deadline->tv_nsec == 0)
+    {
+        uint64_t ns = ((uint64_t)timeout * portTICK_PERIOD_MS) * 1000000u;
+
+        clock_gettime(CLOCK_MONOTONIC, deadline);
+        ns += (uint64_t)deadline->tv_nsec;
+        deadline->tv_sec += (time_t)(ns / 1000000000u);
+        deadline->tv_nsec = (long)(ns % 1000000000u);
+    }
+
+    return (pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT);
+}
+
+/*******************************************************************************
+ * Critical sections
+ ******************************************************************************/
+void host_critical_enter(void)
+{
+    pthread_once(&host_rtos_once, host_rtos_init);
+    pthread_mutex_lock(&critical_mutex);
+}
+
+void host_critical_exit(void)
+{
+    pthread_mutex_unlock(&critical_mutex);
+}
+
+void vTaskSuspendAll(void)
+{
+    host_critical_enter();
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    host_critical_exit();
+    return pdFALSE;
+}
+
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    host_critical_enter();
+    return 0u;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t state)
+{
+    (void)state;
+    host_critical_exit();
+}
+
+uint32_t cyhal_system_critical_section_enter(void)
+{
+    return Cy_SysLib_EnterCriticalSection();
+}
+
+void cyhal_system_critical_section_exit(uint32_t old_state)
+{
+    Cy_SysLib_ExitCriticalSection(old_state);
+}
+
+void __DMB(void)
+{
+    __sync_synchronize();
+}
+
+void __enable_irq(void)
+{
+}
+
+void __WFI(void)
+{
+    sched_yield();
+}
+
+/*******************************************************************************
+ * Clock
+ ******************************************************************************/
+uint64_t host_time_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000u) + ((uint64_t)now.tv_nsec / 1000u);
+}
+
+void host_tick_set(TickType_t ticks)
+{
+    clock_manual_ticks = ticks;
+    clock_manual = true;
+}
+
+void host_tick_advance(TickType_t ticks)
+{
+    if (!clock_manual)
+    {
+        host_tick_set(xTaskGetTickCount());
+    }
+    clock_manual_ticks += ticks;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    pthread_once(&host_rtos_once, host_rtos_init);
+
+    if (clock_manual)
+    {
+        return clock_manual_ticks;
+    }
+
+    return (TickType_t)(((host_time_us() - clock_start_us) / 1000u) / portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec delay;
+
+    /* A test that drives the clock itself does not wait for real time */
+    if (clock_manual)
+    {
+        clock_manual_ticks += ticks;
+        sched_yield();
+        return;
+    }
+
+    delay.tv_sec = (time_t)((ticks * portTICK_PERIOD_MS) / 1000u);
+    delay.tv_nsec = (long)((ticks * portTICK_PERIOD_MS) % 1000u) * 1000000L;
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR)
+    {
+    }
+}
+
+void vTaskStepTick(TickType_t ticks)
+{
+    if (clock_manual)
+    {
+        clock_manual_ticks += ticks;
+    }
+}
+
+/*******************************************************************************
+ * Tasks
+ ******************************************************************************/
+/*******************************************************************************
+ * Function Name: task_new
+ ********************************************************************************
+ * Summary:
+ *  Allocates a task control block and links it into the task list.
+ *
+ * Parameters:
+ *  name: task name
+ *  priority: task priority
+ *
+ * Return:
+ *  struct host_task *: new task
+ ******************************************************************************/
+static struct host_task *task_new(const char *name, UBaseType_t priority)
+{
+    struct host_task *task = calloc(1, sizeof(*task));
+
+    CY_ASSERT(task != NULL);
+    strncpy(task->name, (name != NULL) ? name : "", sizeof(task->name) - 1u);
+    task->priority = priority;
+    pthread_mutex_init(&task->lock, NULL);
+    init_cond(&task->cond);
+
+    pthread_mutex_lock(&list_mutex);
+    task->number = ++task_count;
+    task->next = task_list;
+    task_list = task;
+    pthread_mutex_unlock(&list_mutex);
+
+    return task;
+}
+
+/*******************************************************************************
+ * Function Name: task_self
+ ********************************************************************************
+ * Summary:
+ *  Returns the task of the calling thread. A thread not created by
+ *  xTaskCreate(), like the one running main(), becomes a task on first use.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  struct host_task *: task of the calling thread
+ ******************************************************************************/
+static struct host_task *task_self(void)
+{
+    if (current_task == NULL)
+    {
+        current_task = task_new("main", 0u);
+        current_task->thread = pthread_self();
+    }
+
+    return current_task;
+}
+
+/*******************************************************************************
+ * Function Name: task_entry
+ ********************************************************************************
+ * Summary:
+ *  Thread entry of a task.
+ *
+ * Parameters:
+ *  arg: task
+ *
+ * Return:
+ *  void *: NULL
+ ******************************************************************************/
+static void *task_entry(void *arg)
+{
+    current_task = arg;
+    current_task->code(current_task->parameters);
+
+    /* A FreeRTOS task must not return, handle it like a self-deletion */
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char *name, configSTACK_DEPTH_TYPE stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *handle)
+{
+    struct host_task *task = task_new(name, priority);
+    pthread_attr_t attr;
+
+    (void)stack_depth;
+    task->code = code;
+    task->parameters = parameters;
+
+    if (handle != NULL)
+    {
+        *handle = task;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&task->thread, &attr, task_entry, task) != 0)
+    {
+        pthread_attr_destroy(&attr);
+        task->deleted = true;
+        return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+    }
+    pthread_attr_destroy(&attr);
+
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t code, const char *name, uint32_t stack_depth,
+                               void *parameters, UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb)
+{
+    TaskHandle_t handle = NULL;
+
+    (void)stack;
+    (void)tcb;
+    if (xTaskCreate(code, name, (configSTACK_DEPTH_TYPE)stack_depth, parameters, priority, &handle) != pdPASS)
+    {
+        return NULL;
+    }
+
+    return handle;
+}
+
+/* A thread cannot be stopped from the outside: deleting another task only
+ * marks it, host tasks end when they delete themselves or return. */
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL)
+    {
+        task = task_self();
+    }
+
+    pthread_mutex_lock(&task->lock);
+    task->deleted = true;
+    pthread_mutex_unlock(&task->lock);
+
+    if (task == current_task)
+    {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskSuspend(TaskHandle_t task)
+{
+    if (task == NULL || task == current_task)
+    {
+        for (;;)
+        {
+            pause();
+        }
+    }
+}
+
+void vTaskStartScheduler(void)
+{
+    for (;;)
+    {
+        pause();
+    }
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return task_self();
+}
+
+const char *host_task_name(TaskHandle_t task)
+{
+    return task->name;
+}
+
+bool host_task_is_deleted(TaskHandle_t task)
+{
+    bool deleted;
+
+    pthread_mutex_lock(&task->lock);
+    deleted = task->deleted;
+    pthread_mutex_unlock(&task->lock);
+
+    return deleted;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    UBaseType_t count = 0u;
+
+    pthread_mutex_lock(&list_mutex);
+    for (struct host_task *task = task_list; task != NULL; task = task->next)
+    {
+        count += task->deleted ? 0u : 1u;
+    }
+    pthread_mutex_unlock(&list_mutex);
+
+    return count;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t count, uint32_t *total_run_time)
+{
+    UBaseType_t filled = 0u;
+
+    pthread_mutex_lock(&list_mutex);
+    for (struct host_task *task = task_list; task != NULL && filled < count; task = task->next)
+    {
+        if (!task->deleted)
+        {
+            memset(&status[filled], 0, sizeof(status[filled]));
+            status[filled].xHandle = task;
+            status[filled].pcTaskName = task->name;
+            status[filled].xTaskNumber = task->number;
+            status[filled].eCurrentState = eBlocked;
+            status[filled].uxCurrentPriority = task->priority;
+            status[filled].uxBasePriority = task->priority;
+            filled++;
+        }
+    }
+    pthread_mutex_unlock(&list_mutex);
+
+    if (total_run_time != NULL)
+    {
+        *total_run_time = 0u;
+    }
+
+    return filled;
+}
+
+/* Thread stacks are not instrumented on the host */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    (void)task;
+    return 0u;
+}
+
+eSleepModeStatus eTaskConfirmSleepModeStatus(void)
+{
+    return eStandardSleep;
+}
+
+/*******************************************************************************
+ * Task notifications
+ ******************************************************************************/
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t timeout)
+{
+    struct host_task *task = task_self();
+    struct timespec deadline = { 0 };
+    uint32_t value;
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify_value == 0u && wait_until(&task->cond, &task->lock, timeout, &deadline))
+    {
+    }
+
+    value = task->notify_value;
+    if (value != 0u)
+    {
+        task->notify_value = (clear_on_exit != pdFALSE) ? 0u : (value - 1u);
+    }
+    task->notify_pending = false;
+    pthread_mutex_unlock(&task->lock);
+
+    return value;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    BaseType_t result = pdPASS;
+
+    pthread_mutex_lock(&task->lock);
+    switch (action)
+    {
+        case eSetBits:
+            task->notify_value |= value;
+            break;
+        case eIncrement:
+            task->notify_value++;
+            break;
+        case eSetValueWithOverwrite:
+            task->notify_value = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (task->notify_pending)
+            {
+                result = pdFAIL;
+            }
+            else
+            {
+                task->notify_value = value;
+            }
+            break;
+        case eNoAction:
+        default:
+            break;
+    }
+    task->notify_pending = true;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+
+    return result;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action,
+                              BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken != NULL)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return xTaskNotify(task, 0u, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    (void)xTaskNotifyFromISR(task, 0u, eIncrement, higher_priority_task_woken);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t timeout)
+{
+    struct host_task *task = task_self();
+    struct timespec deadline = { 0 };
+    BaseType_t result = pdFALSE;
+
+    pthread_mutex_lock(&task->lock);
+    if (!task->notify_pending)
+    {
+        task->notify_value &= ~clear_on_entry;
+        while (!task->notify_pending && wait_until(&task->cond, &task->lock, timeout, &deadline))
+        {
+        }
+    }
+
+    if (value != NULL)
+    {
+        *value = task->notify_value;
+    }
+
+    if (task->notify_pending)
+    {
+        task->notify_value &= ~clear_on_exit;
+        task->notify_pending = false;
+        result = pdTRUE;
+    }
+    pthread_mutex_unlock(&task->lock);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Queues and semaphores
+ ******************************************************************************/
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *queue = calloc(1, sizeof(*queue));
+
+    CY_ASSERT(queue != NULL);
+    pthread_mutex_init(&queue->lock, NULL);
+    init_cond(&queue->not_empty);
+    init_cond(&queue->not_full);
+    queue->length = length;
+    queue->item_size = item_size;
+    queue->storage = calloc((length * item_size) + 1u, 1u);
+    CY_ASSERT(queue->storage != NULL);
+
+    return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *queue)
+{
+    (void)storage;
+    (void)queue;
+    return xQueueCreate(length, item_size);
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    free(queue->storage);
+    free(queue);
+}
+
+/*******************************************************************************
+ * Function Name: queue_send
+ ********************************************************************************
+ * Summary:
+ *  Copies an item to the back or the front of a queue.
+ *
+ * Parameters:
+ *  queue: queue
+ *  item: item to copy, may be NULL for a semaphore
+ *  timeout: ticks to wait for space
+ *  front: true to send to the front
+ *  overwrite: true to replace the item of a full queue of length one
+ *
+ * Return:
+ *  BaseType_t: pdPASS or errQUEUE_FULL
+ ******************************************************************************/
+static BaseType_t queue_send(QueueHandle_t queue, const void *item, TickType_t timeout, bool front, bool overwrite)
+{
+    struct timespec deadline = { 0 };
+    UBaseType_t slot;
+
+    pthread_mutex_lock(&queue->lock);
+    if (overwrite && queue->count == queue->length)
+    {
+        queue->count = 0u;
+    }
+
+    while (queue->count == queue->length)
+    {
+        if (!wait_until(&queue->not_full, &queue->lock, timeout, &deadline) && queue->count == queue->length)
+        {
+            pthread_mutex_unlock(&queue->lock);
+            return errQUEUE_FULL;
+        }
+    }
+
+    if (front)
+    {
+        queue->head = (queue->head + queue->length - 1u) % queue->length;
+        slot = queue->head;
+    }
+    else
+    {
+        slot = (queue->head + queue->count) % queue->length;
+    }
+
+    if (queue->item_size > 0u && item != NULL)
+    {
+        memcpy(&queue->storage[slot * queue->item_size], item, queue->item_size);
+    }
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t timeout)
+{
+    return queue_send(queue, item, timeout, false, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t timeout)
+{
+    return queue_send(queue, item, timeout, false, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t timeout)
+{
+    return queue_send(queue, item, timeout, true, false);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken != NULL)
+    {
+        *higher_priority_task_woken = pdFALSE;
+    }
+
+    return queue_send(queue, item, 0u, false, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item)
+{
+    return queue_send(queue, item, 0u, false, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t timeout)
+{
+    struct timespec deadline = { 0 };
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0u)
+    {
+        if (!wait_until(&queue->not_empty, &queue->lock, timeout, &deadline) && queue->count == 0u)
+        {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFALSE;
+        }
+    }
+
+    if (queue->item_size > 0u && item != NULL)
+    {
+        memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+    }
+    queue->head = (queue->head + 1u) % queue->length;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    UBaseType_t count;
+
+    pthread_mutex_lock(&queue->lock);
+    count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+    return queue->length - uxQueueMessagesWaiting(queue);
+}
+
+/* A semaphore is a queue of items without data, a mutex starts given */
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t mutex = xQueueCreate(1u, 0u);
+
+    (void)xSemaphoreGive(mutex);
+    return mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *mutex)
+{
+    (void)mutex;
+    return xSemaphoreCreateMutex();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1u, 0u);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t timeout)
+{
+    return xQueueReceive(semaphore, NULL, timeout);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return xQueueSend(semaphore, NULL, 0u);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    vQueueDelete(semaphore);
+}
+
+/*******************************************************************************
+ * Software timers
+ ******************************************************************************/
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *id,
+                           TimerCallbackFunction_t callback)
+{
+    struct host_timer *timer = calloc(1, sizeof(*timer));
+
+    CY_ASSERT(timer != NULL);
+    strncpy(timer->name, (name != NULL) ? name : "", sizeof(timer->name) - 1u);
+    timer->period = period;
+    timer->auto_reload = auto_reload;
+    timer->id = id;
+    timer->callback = callback;
+
+    pthread_mutex_lock(&list_mutex);
+    timer->next = timer_list;
+    timer_list = timer;
+    pthread_mutex_unlock(&list_mutex);
+
+    return timer;
+}
+
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period, UBaseType_t auto_reload, void *id,
+                                 TimerCallbackFunction_t callback, StaticTimer_t *timer)
+{
+    (void)timer;
+    return xTimerCreate(name, period, auto_reload, id, callback);
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t timeout)
+{
+    (void)timeout;
+    timer->active = true;
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t timeout)
+{
+    (void)timeout;
+    timer->active = false;
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t timeout)
+{
+    return xTimerStart(timer, timeout);
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t timeout)
+{
+    timer->period = period;
+    return xTimerStart(timer, timeout);
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+    return timer->id;
+}
+
+TimerHandle_t host_timer_find(const char *name)
+{
+    struct host_timer *timer;
+
+    pthread_mutex_lock(&list_mutex);
+    for (timer = timer_list; timer != NULL; timer = timer->next)
+    {
+        if (strcmp(timer->name, name) == 0)
+        {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&list_mutex);
+
+    return timer;
+}
+
+/* Runs the callback of an active timer, as the timer service task would when
+ * the period expires */
+void host_timer_fire(TimerHandle_t timer)
+{
+    if (timer->active)
+    {
+        timer->active = (timer->auto_reload != pdFALSE);
+        timer->callback(timer);
+    }
+}
+
+/*******************************************************************************
+ * Event groups
+ ******************************************************************************/
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    struct host_event_group *event_group = calloc(1, sizeof(*event_group));
+
+    CY_ASSERT(event_group != NULL);
+    pthread_mutex_init(&event_group->lock, NULL);
+    init_cond(&event_group->cond);
+
+    return event_group;
+}
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *event_group)
+{
+    (void)event_group;
+    return xEventGroupCreate();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t event_group, EventBits_t bits)
+{
+    EventBits_t result;
+
+    pthread_mutex_lock(&event_group->lock);
+    event_group->bits |= bits;
+    result = event_group->bits;
+    pthread_cond_broadcast(&event_group->cond);
+    pthread_mutex_unlock(&event_group->lock);
+
+    return result;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t event_group, EventBits_t bits)
+{
+    EventBits_t result;
+
+    pthread_mutex_lock(&event_group->lock);
+    result = event_group->bits;
+    event_group->bits &= ~bits;
+    pthread_mutex_unlock(&event_group->lock);
+
+    return result;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t event_group)
+{
+    return xEventGroupClearBits(event_group, 0u);
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t event_group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t timeout)
+{
+    struct timespec deadline = { 0 };
+    EventBits_t result;
+    bool satisfied;
+
+    pthread_mutex_lock(&event_group->lock);
+    for (;;)
+    {
+        satisfied = (wait_for_all != pdFALSE) ? ((event_group->bits & bits) == bits)
+                                              : ((event_group->bits & bits) != 0u);
+        if (satisfied || !wait_until(&event_group->cond, &event_group->lock, timeout, &deadline))
+        {
+            break;
+        }
+    }
+
+    /* Re-evaluate after a timeout, the bits may have been set meanwhile */
+    satisfied = (wait_for_all != pdFALSE) ? ((event_group->bits & bits) == bits)
+                                          : ((event_group->bits & bits) != 0u);
+    result = event_group->bits;
+    if (satisfied && clear_on_exit != pdFALSE)
+    {
+        event_group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&event_group->lock);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Heap. Like heap_3 on the target, the allocator is the C library's, unless
+ * a test links mem_pool.c built with MEM_POOL_ENABLE.
+ ******************************************************************************/
+__attribute__((weak)) void *pvPortMalloc(size_t size)
+{
+    return malloc(size);
+}
+
+__attribute__((weak)) void vPortFree(void *pointer)
+{
+    free(pointer);
+}
+
+__attribute__((weak)) void vApplicationMallocFailedHook(void)
+{
+    CY_ASSERT(0);
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return 0u;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return 0u;
+}
+
+/* [] END OF FILE */
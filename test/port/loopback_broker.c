@@ -0,0 +1,934 @@
+/******************************************************************************
+ * File Name:   loopback_broker.c
+ *
+ * Description: In-process MQTT broker implementing the cy_mqtt API for the
+ *   host tests.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cy_mqtt_api.h"
+
+#include "host_port.h"
+#include "loopback_broker.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define LOOPBACK_CLIENTS            (8u)
+#define LOOPBACK_SESSIONS           (8u)
+#define LOOPBACK_SUBSCRIPTIONS      (16u)
+#define LOOPBACK_OFFLINE_MESSAGES   (32u)
+#define LOOPBACK_LOG_LENGTH         (1024u)
+#define LOOPBACK_DELIVERIES         (LOOPBACK_CLIENTS + LOOPBACK_OFFLINE_MESSAGES)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef struct
+{
+    char filter[LOOPBACK_TOPIC_LENGTH];
+    cy_mqtt_qos_t qos;
+} loopback_subscription_t;
+
+typedef struct
+{
+    bool used;
+    char client_id[LOOPBACK_CLIENT_ID_LENGTH];
+    bool clean;
+    loopback_subscription_t subscriptions[LOOPBACK_SUBSCRIPTIONS];
+    uint32_t subscription_count;
+    loopback_message_t *offline[LOOPBACK_OFFLINE_MESSAGES];
+    uint32_t offline_count;
+} loopback_session_t;
+
+struct loopback_client
+{
+    bool used;
+    bool connected;
+    char client_id[LOOPBACK_CLIENT_ID_LENGTH];
+    loopback_session_t *session;
+    cy_mqtt_callback_t callback;
+    void *user_data;
+    uint16_t next_packet_id;
+    uint32_t outgoing;          /* QoS 1 publishes waiting for the PUBACK */
+};
+
+/* Message handed to a client once the broker lock is released */
+typedef struct
+{
+    struct loopback_client *client;
+    loopback_message_t *message;
+} loopback_delivery_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static pthread_mutex_t broker_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct loopback_client clients[LOOPBACK_CLIENTS];
+static loopback_session_t sessions[LOOPBACK_SESSIONS];
+
+static loopback_message_t *published_log[LOOPBACK_LOG_LENGTH];
+static uint32_t published_total;
+
+static bool last_session_present;
+static uint32_t connect_faults;
+static uint32_t publish_faults;
+static uint32_t subscribe_faults;
+static uint32_t publish_delay_ms;
+static uint32_t publishes_in_progress;
+static uint32_t publishes_in_progress_max;
+static uint32_t protocol_errors;
+
+/*******************************************************************************
+ * Function Name: loopback_topic_matches
+ ********************************************************************************
+ * Summary:
+ *  Matches a topic name against an MQTT topic filter with the '+' and '#'
+ *  wildcards. A wildcard in the first level does not match topics starting
+ *  with '$'.
+ *
+ * Parameters:
+ *  filter: topic filter
+ *  topic: topic name
+ *
+ * Return:
+ *  bool: true if the filter matches the topic
+ ******************************************************************************/
+bool loopback_topic_matches(const char *filter, const char *topic)
+{
+    if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#'))
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        if (filter[0] == '#')
+        {
+            return true;
+        }
+
+        if (filter[0] == '+')
+        {
+            filter++;
+            while (*topic != '\0' && *topic != '/')
+            {
+                topic++;
+            }
+        }
+        else
+        {
+            while (*filter != '\0' && *filter != '/' && *filter == *topic)
+            {
+                filter++;
+                topic++;
+            }
+
+            if ((*filter != '\0' && *filter != '/') || (*topic != '\0' && *topic != '/'))
+            {
+                return false;
+            }
+        }
+
+        if (*filter == '\0' || *topic == '\0')
+        {
+            /* "a/#" also matches "a" */
+            return (*filter == '\0' && *topic == '\0') || (strcmp(filter, "/#") == 0);
+        }
+
+        filter++;
+        topic++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: message_new
+ ********************************************************************************
+ * Summary:
+ *  Copies a PUBLISH into a heap allocated message.
+ *
+ * Parameters:
+ *  client_id: publishing client, "" for an injected message
+ *  info: PUBLISH
+ *  packet_id: packet identifier, 0 for QoS 0
+ *
+ * Return:
+ *  loopback_message_t *: message, owned by the caller
+ ******************************************************************************/
+static loopback_message_t *message_new(const char *client_id, const cy_mqtt_publish_info_t *info, uint16_t packet_id)
+{
+    loopback_message_t *message = calloc(1, sizeof(*message));
+    size_t topic_len = (info->topic_len != 0u) ? info->topic_len : strlen(info->topic);
+
+    CY_ASSERT(message != NULL);
+    CY_ASSERT(topic_len < LOOPBACK_TOPIC_LENGTH && info->payload_len <= LOOPBACK_PAYLOAD_LENGTH);
+
+    strncpy(message->client_id, client_id, sizeof(message->client_id) - 1u);
+    memcpy(message->topic, info->topic, topic_len);
+    memcpy(message->payload, info->payload, info->payload_len);
+    message->payload_len = info->payload_len;
+    message->qos = info->qos;
+    message->retain = info->retain;
+    message->dup = info->dup;
+    message->packet_id = packet_id;
+    message->time_us = host_time_us();
+
+    return message;
+}
+
+/*******************************************************************************
+ * Function Name: message_copy
+ ********************************************************************************
+ * Summary:
+ *  Duplicates a message.
+ *
+ * Parameters:
+ *  message: message to copy
+ *
+ * Return:
+ *  loopback_message_t *: copy, owned by the caller
+ ******************************************************************************/
+static loopback_message_t *message_copy(const loopback_message_t *message)
+{
+    loopback_message_t *copy = malloc(sizeof(*copy));
+
+    CY_ASSERT(copy != NULL);
+    memcpy(copy, message, sizeof(*copy));
+    return copy;
+}
+
+/*******************************************************************************
+ * Function Name: session_find
+ ********************************************************************************
+ * Summary:
+ *  Looks up the session of a client identifier.
+ *
+ * Parameters:
+ *  client_id: client identifier
+ *
+ * Return:
+ *  loopback_session_t *: session, NULL if the broker has none
+ ******************************************************************************/
+static loopback_session_t *session_find(const char *client_id)
+{
+    for (uint32_t i = 0u; i < LOOPBACK_SESSIONS; i++)
+    {
+        if (sessions[i].used && strcmp(sessions[i].client_id, client_id) == 0)
+        {
+            return &sessions[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: session_free
+ ********************************************************************************
+ * Summary:
+ *  Discards a session with its subscriptions and queued messages.
+ *
+ * Parameters:
+ *  session: session
+ *
+ * Return:
+ *  void
+ ******************************************************************************/
+static void session_free(loopback_session_t *session)
+{
+    for (uint32_t i = 0u; i < session->offline_count; i++)
+    {
+        free(session->offline[i]);
+    }
+
+    memset(session, 0, sizeof(*session));
+}
+
+/*******************************************************************************
+ * Function Name: client_close
+ ********************************************************************************
+ * Summary:
+ *  Ends the network connection of a client. A clean session ends with it.
+ *
+ * Parameters:
+ *  client: connected client
+ *
+ * Return:
+ *  void
+ ******************************************************************************/
+static void client_close(struct loopback_client *client)
+{
+    client->connected = false;
+    if (client->session != NULL && client->session->clean)
+    {
+        session_free(client->session);
+    }
+    client->session = NULL;
+}
+
+/*******************************************************************************
+ * Function Name: route
+ ********************************************************************************
+ * Summary:
+ *  Routes a message to the subscribed sessions: connected clients get it
+ *  delivered, offline persistent sessions queue it when the subscription and
+ *  the message are QoS 1.
+ *
+ * Parameters:
+ *  message: message to route
+ *  deliveries: deliveries to make once the lock is released
+ *  delivery_count: number of entries in deliveries, updated
+ *
+ * Return:
+ *  uint32_t: number of sessions the message was routed to
+ ******************************************************************************/
+static uint32_t route(const loopback_message_t *message, loopback_delivery_t *deliveries, uint32_t *delivery_count)
+{
+    uint32_t routed = 0u;
+
+    for (uint32_t i = 0u; i < LOOPBACK_SESSIONS; i++)
+    {
+        loopback_session_t *session = &sessions[i];
+        struct loopback_client *owner = NULL;
+        cy_mqtt_qos_t qos = CY_MQTT_QOS_INVALID;
+
+        if (!session->used)
+        {
+            continue;
+        }
+
+        for (uint32_t s = 0u; s < session->subscription_count; s++)
+        {
+            if (loopback_topic_matches(session->subscriptions[s].filter, message->topic))
+            {
+                qos = (qos == CY_MQTT_QOS_INVALID || session->subscriptions[s].qos > qos)
+                      ? session->subscriptions[s].qos : qos;
+            }
+        }
+
+        if (qos == CY_MQTT_QOS_INVALID)
+        {
+            continue;
+        }
+
+        for (uint32_t c = 0u; c < LOOPBACK_CLIENTS; c++)
+        {
+            if (clients[c].used && clients[c].connected && clients[c].session == session)
+            {
+                owner = &clients[c];
+            }
+        }
+
+        if (owner != NULL && *delivery_count < LOOPBACK_DELIVERIES)
+        {
+            deliveries[*delivery_count].client = owner;
+            deliveries[*delivery_count].message = message_copy(message);
+            deliveries[*delivery_count].message->qos = (message->qos < qos) ? message->qos : qos;
+            (*delivery_count)++;
+            routed++;
+        }
+        else if (owner == NULL && !session->clean && qos != CY_MQTT_QOS0 && message->qos != CY_MQTT_QOS0 &&
+                 session->offline_count < LOOPBACK_OFFLINE_MESSAGES)
+        {
+            session->offline[session->offline_count++] = message_copy(message);
+            routed++;
+        }
+    }
+
+    return routed;
+}
+
+/*******************************************************************************
+ * Function Name: deliver
+ ********************************************************************************
+ * Summary:
+ *  Hands messages to the event callbacks of the clients, without the broker
+ *  lock so that a callback may publish or subscribe.
+ *
+ * Parameters:
+ *  deliveries: deliveries to make, freed
+ *  delivery_count: number of entries in deliveries
+ *
+ * Return:
+ *  void
+ ******************************************************************************/
+static void deliver(loopback_delivery_t *deliveries, uint32_t delivery_count)
+{
+    for (uint32_t i = 0u; i < delivery_count; i++)
+    {
+        struct loopback_client *client = deliveries[i].client;
+        loopback_message_t *message = deliveries[i].message;
+        cy_mqtt_event_t event;
+
+        memset(&event, 0, sizeof(event));
+        event.type = CY_MQTT_EVENT_TYPE_SUBSCRIPTION_MESSAGE_RECEIVE;
+        event.data.pub_msg.packet_id = message->packet_id;
+        event.data.pub_msg.received_message.qos = message->qos;
+        event.data.pub_msg.received_message.retain = message->retain;
+        event.data.pub_msg.received_message.topic = message->topic;
+        event.data.pub_msg.received_message.topic_len = (uint16_t)strlen(message->topic);
+        event.data.pub_msg.received_message.payload = message->payload;
+        event.data.pub_msg.received_message.payload_len = message->payload_len;
+
+        if (client->callback != NULL)
+        {
+            client->callback(client, event, client->user_data);
+        }
+        free(message);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: notify_disconnect
+ ********************************************************************************
+ * Summary:
+ *  Sends the disconnect event to clients whose connection was closed.
+ *
+ * Parameters:
+ *  closed: clients
+ *  count: number of clients
+ *
+ * Return:
+ *  void
+ ******************************************************************************/
+static void notify_disconnect(struct loopback_client **closed, uint32_t count)
+{
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        cy_mqtt_event_t event;
+
+        memset(&event, 0, sizeof(event));
+        event.type = CY_MQTT_EVENT_TYPE_DISCONNECT;
+        event.data.reason = CY_MQTT_DISCONN_TYPE_NETWORK_DOWN;
+        if (closed[i]->callback != NULL)
+        {
+            closed[i]->callback(closed[i], event, closed[i]->user_data);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Test controls
+ ******************************************************************************/
+void loopback_broker_reset(void)
+{
+    pthread_mutex_lock(&broker_lock);
+    for (uint32_t i = 0u; i < LOOPBACK_SESSIONS; i++)
+    {
+        session_free(&sessions[i]);
+    }
+    for (uint32_t i = 0u; i < LOOPBACK_CLIENTS; i++)
+    {
+        clients[i].connected = false;
+        clients[i].session = NULL;
+    }
+    for (uint32_t i = 0u; i < LOOPBACK_LOG_LENGTH; i++)
+    {
+        free(published_log[i]);
+        published_log[i] = NULL;
+    }
+    published_total = 0u;
+    last_session_present = false;
+    connect_faults = 0u;
+    publish_faults = 0u;
+    subscribe_faults = 0u;
+    publish_delay_ms = 0u;
+    publishes_in_progress_max = 0u;
+    protocol_errors = 0u;
+    pthread_mutex_unlock(&broker_lock);
+}
+
+bool loopback_broker_session_present(void)
+{
+    return last_session_present;
+}
+
+void loopback_broker_fail_connects(uint32_t count)
+{
+    pthread_mutex_lock(&broker_lock);
+    connect_faults = count;
+    pthread_mutex_unlock(&broker_lock);
+}
+
+void loopback_broker_fail_publishes(uint32_t count)
+{
+    pthread_mutex_lock(&broker_lock);
+    publish_faults = count;
+    pthread_mutex_unlock(&broker_lock);
+}
+
+void loopback_broker_fail_subscribes(uint32_t count)
+{
+    pthread_mutex_lock(&broker_lock);
+    subscribe_faults = count;
+    pthread_mutex_unlock(&broker_lock);
+}
+
+void loopback_broker_set_publish_delay_ms(uint32_t delay_ms)
+{
+    publish_delay_ms = delay_ms;
+}
+
+void loopback_broker_drop_clients(void)
+{
+    struct loopback_client *closed[LOOPBACK_CLIENTS];
+    uint32_t count = 0u;
+
+    pthread_mutex_lock(&broker_lock);
+    for (uint32_t i = 0u; i < LOOPBACK_CLIENTS; i++)
+    {
+        if (clients[i].used && clients[i].connected)
+        {
+            client_close(&clients[i]);
+            closed[count++] = &clients[i];
+        }
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    notify_disconnect(closed, count);
+}
+
+void loopback_broker_expire_sessions(void)
+{
+    pthread_mutex_lock(&broker_lock);
+    for (uint32_t i = 0u; i < LOOPBACK_SESSIONS; i++)
+    {
+        bool online = false;
+
+        for (uint32_t c = 0u; c < LOOPBACK_CLIENTS; c++)
+        {
+            online = online || (clients[c].connected && clients[c].session == &sessions[i]);
+        }
+
+        if (sessions[i].used && !online)
+        {
+            session_free(&sessions[i]);
+        }
+    }
+    pthread_mutex_unlock(&broker_lock);
+}
+
+uint32_t loopback_broker_inject(const char *topic, const void *payload, size_t payload_len, cy_mqtt_qos_t qos)
+{
+    static uint16_t packet_id;
+    loopback_delivery_t deliveries[LOOPBACK_DELIVERIES];
+    uint32_t delivery_count = 0u;
+    cy_mqtt_publish_info_t info = { 0 };
+    loopback_message_t *message;
+    uint32_t routed;
+
+    info.qos = qos;
+    info.topic = topic;
+    info.topic_len = (uint16_t)strlen(topic);
+    info.payload = payload;
+    info.payload_len = payload_len;
+
+    pthread_mutex_lock(&broker_lock);
+    packet_id = (uint16_t)((packet_id % 0xFFFFu) + 1u);
+    message = message_new("", &info, (qos == CY_MQTT_QOS0) ? 0u : packet_id);
+    routed = route(message, deliveries, &delivery_count);
+    pthread_mutex_unlock(&broker_lock);
+
+    free(message);
+    deliver(deliveries, delivery_count);
+
+    return routed;
+}
+
+uint32_t loopback_broker_published_count(void)
+{
+    return published_total;
+}
+
+bool loopback_broker_get_published(uint32_t index, loopback_message_t *message)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&broker_lock);
+    if (index < published_total && (published_total - index) <= LOOPBACK_LOG_LENGTH)
+    {
+        memcpy(message, published_log[index % LOOPBACK_LOG_LENGTH], sizeof(*message));
+        found = true;
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    return found;
+}
+
+uint32_t loopback_broker_subscription_count(const char *client_id)
+{
+    loopback_session_t *session;
+    uint32_t count;
+
+    pthread_mutex_lock(&broker_lock);
+    session = session_find(client_id);
+    count = (session != NULL) ? session->subscription_count : 0u;
+    pthread_mutex_unlock(&broker_lock);
+
+    return count;
+}
+
+uint32_t loopback_broker_max_concurrent_publishes(void)
+{
+    return publishes_in_progress_max;
+}
+
+uint32_t loopback_broker_protocol_errors(void)
+{
+    return protocol_errors;
+}
+
+/*******************************************************************************
+ * cy_mqtt API
+ ******************************************************************************/
+cy_rslt_t cy_mqtt_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_deinit(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_create(uint8_t *buffer, uint32_t buffer_size, cy_awsport_ssl_credentials_t *security,
+                         cy_mqtt_broker_info_t *broker_info, cy_mqtt_callback_t event_callback,
+                         void *user_data, cy_mqtt_t *mqtt_handle)
+{
+    cy_rslt_t result = CY_RSLT_MODULE_MQTT_ERROR;
+
+    (void)security;
+    (void)broker_info;
+    if (buffer == NULL || buffer_size < CY_MQTT_MIN_NETWORK_BUFFER_SIZE || mqtt_handle == NULL)
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    for (uint32_t i = 0u; i < LOOPBACK_CLIENTS; i++)
+    {
+        if (!clients[i].used)
+        {
+            memset(&clients[i], 0, sizeof(clients[i]));
+            clients[i].used = true;
+            clients[i].callback = event_callback;
+            clients[i].user_data = user_data;
+            *mqtt_handle = &clients[i];
+            result = CY_RSLT_SUCCESS;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    return result;
+}
+
+cy_rslt_t cy_mqtt_connect(cy_mqtt_t mqtt_handle, cy_mqtt_connect_info_t *connect_info)
+{
+    loopback_delivery_t deliveries[LOOPBACK_DELIVERIES];
+    struct loopback_client *closed[1];
+    uint32_t delivery_count = 0u;
+    uint32_t closed_count = 0u;
+    loopback_session_t *session;
+    char client_id[LOOPBACK_CLIENT_ID_LENGTH] = { 0 };
+
+    if (mqtt_handle == NULL || connect_info == NULL || connect_info->client_id_len >= sizeof(client_id))
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+    memcpy(client_id, connect_info->client_id, connect_info->client_id_len);
+
+    pthread_mutex_lock(&broker_lock);
+    if (connect_faults > 0u)
+    {
+        connect_faults--;
+        pthread_mutex_unlock(&broker_lock);
+        return CY_RSLT_MODULE_MQTT_CONNECT_FAIL;
+    }
+
+    /* A second connection with the same client identifier takes the session
+     * over and closes the first one */
+    for (uint32_t i = 0u; i < LOOPBACK_CLIENTS; i++)
+    {
+        if (&clients[i] != mqtt_handle && clients[i].connected && strcmp(clients[i].client_id, client_id) == 0)
+        {
+            clients[i].connected = false;
+            clients[i].session = NULL;
+            closed[closed_count++] = &clients[i];
+        }
+    }
+
+    session = session_find(client_id);
+    if (session != NULL && connect_info->clean_session)
+    {
+        session_free(session);
+        session = NULL;
+    }
+    last_session_present = (session != NULL);
+
+    if (session == NULL)
+    {
+        for (uint32_t i = 0u; i < LOOPBACK_SESSIONS && session == NULL; i++)
+        {
+            session = sessions[i].used ? NULL : &sessions[i];
+        }
+        CY_ASSERT(session != NULL);
+        session->used = true;
+        strcpy(session->client_id, client_id);
+    }
+    session->clean = connect_info->clean_session;
+
+    strcpy(mqtt_handle->client_id, client_id);
+    mqtt_handle->session = session;
+    mqtt_handle->connected = true;
+
+    /* The broker sends the queued messages right after CONNACK */
+    for (uint32_t i = 0u; i < session->offline_count; i++)
+    {
+        deliveries[delivery_count].client = mqtt_handle;
+        deliveries[delivery_count].message = session->offline[i];
+        delivery_count++;
+    }
+    session->offline_count = 0u;
+    pthread_mutex_unlock(&broker_lock);
+
+    notify_disconnect(closed, closed_count);
+    deliver(deliveries, delivery_count);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_publish(cy_mqtt_t mqtt_handle, cy_mqtt_publish_info_t *pub_msg)
+{
+    loopback_delivery_t deliveries[LOOPBACK_DELIVERIES];
+    uint32_t delivery_count = 0u;
+    loopback_message_t *message;
+    uint16_t packet_id = 0u;
+
+    if (mqtt_handle == NULL || pub_msg == NULL || pub_msg->topic == NULL)
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    if (!mqtt_handle->connected)
+    {
+        pthread_mutex_unlock(&broker_lock);
+        return CY_RSLT_MODULE_MQTT_NOT_CONNECTED;
+    }
+
+    /* The library gives every call a new packet identifier, so DUP never
+     * applies to it */
+    if (pub_msg->dup)
+    {
+        protocol_errors++;
+    }
+
+    /* Like the library, refuse a QoS 1 publish once
+     * 'CY_MQTT_MAX_OUTGOING_PUBLISHES' wait for their PUBACK */
+    if (pub_msg->qos != CY_MQTT_QOS0)
+    {
+        if (mqtt_handle->outgoing >= CY_MQTT_MAX_OUTGOING_PUBLISHES)
+        {
+            pthread_mutex_unlock(&broker_lock);
+            return CY_RSLT_MODULE_MQTT_PUBLISH_FAIL;
+        }
+        mqtt_handle->outgoing++;
+        mqtt_handle->next_packet_id = (uint16_t)((mqtt_handle->next_packet_id % 0xFFFFu) + 1u);
+        packet_id = mqtt_handle->next_packet_id;
+    }
+
+    publishes_in_progress++;
+    if (publishes_in_progress > publishes_in_progress_max)
+    {
+        publishes_in_progress_max = publishes_in_progress;
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    /* Round trip to the PUBACK, outside the lock like a network wait */
+    if (publish_delay_ms > 0u && pub_msg->qos != CY_MQTT_QOS0)
+    {
+        vTaskDelay(pdMS_TO_TICKS(publish_delay_ms));
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    publishes_in_progress--;
+    if (pub_msg->qos != CY_MQTT_QOS0)
+    {
+        mqtt_handle->outgoing--;
+    }
+    if (publish_faults > 0u || !mqtt_handle->connected)
+    {
+        publish_faults -= (publish_faults > 0u) ? 1u : 0u;
+        pthread_mutex_unlock(&broker_lock);
+        return CY_RSLT_MODULE_MQTT_PUBLISH_FAIL;
+    }
+
+    message = message_new(mqtt_handle->client_id, pub_msg, packet_id);
+    free(published_log[published_total % LOOPBACK_LOG_LENGTH]);
+    published_log[published_total % LOOPBACK_LOG_LENGTH] = message;
+    published_total++;
+    (void)route(message, deliveries, &delivery_count);
+    pthread_mutex_unlock(&broker_lock);
+
+    deliver(deliveries, delivery_count);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_subscribe(cy_mqtt_t mqtt_handle, cy_mqtt_subscribe_info_t *sub_info, uint8_t sub_count)
+{
+    loopback_session_t *session;
+
+    if (mqtt_handle == NULL || sub_info == NULL || sub_count == 0u)
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    if (!mqtt_handle->connected)
+    {
+        pthread_mutex_unlock(&broker_lock);
+        return CY_RSLT_MODULE_MQTT_NOT_CONNECTED;
+    }
+
+    if (subscribe_faults > 0u)
+    {
+        subscribe_faults--;
+        pthread_mutex_unlock(&broker_lock);
+        return CY_RSLT_MODULE_MQTT_SUBSCRIBE_FAIL;
+    }
+
+    session = mqtt_handle->session;
+    for (uint8_t i = 0u; i < sub_count; i++)
+    {
+        size_t filter_len = (sub_info[i].topic_len != 0u) ? sub_info[i].topic_len : strlen(sub_info[i].topic);
+        loopback_subscription_t *subscription = NULL;
+        char filter[LOOPBACK_TOPIC_LENGTH] = { 0 };
+
+        CY_ASSERT(filter_len < sizeof(filter));
+        memcpy(filter, sub_info[i].topic, filter_len);
+
+        /* Subscribing again to a filter replaces the subscription */
+        for (uint32_t s = 0u; s < session->subscription_count; s++)
+        {
+            if (strcmp(session->subscriptions[s].filter, filter) == 0)
+            {
+                subscription = &session->subscriptions[s];
+            }
+        }
+
+        if (subscription == NULL && session->subscription_count < LOOPBACK_SUBSCRIPTIONS)
+        {
+            subscription = &session->subscriptions[session->subscription_count++];
+        }
+
+        if (subscription == NULL)
+        {
+            pthread_mutex_unlock(&broker_lock);
+            return CY_RSLT_MODULE_MQTT_SUBSCRIBE_FAIL;
+        }
+
+        strcpy(subscription->filter, filter);
+        subscription->qos = (sub_info[i].qos > CY_MQTT_QOS1) ? CY_MQTT_QOS1 : sub_info[i].qos;
+        sub_info[i].allocate_qos = subscription->qos;
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_unsubscribe(cy_mqtt_t mqtt_handle, cy_mqtt_unsubscribe_info_t *unsub_info, uint8_t unsub_count)
+{
+    loopback_session_t *session;
+
+    if (mqtt_handle == NULL || unsub_info == NULL)
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    if (!mqtt_handle->connected)
+    {
+        pthread_mutex_unlock(&broker_lock);
+        return CY_RSLT_MODULE_MQTT_NOT_CONNECTED;
+    }
+
+    session = mqtt_handle->session;
+    for (uint8_t i = 0u; i < unsub_count; i++)
+    {
+        for (uint32_t s = 0u; s < session->subscription_count; s++)
+        {
+            if (strlen(session->subscriptions[s].filter) == unsub_info[i].topic_len &&
+                strncmp(session->subscriptions[s].filter, unsub_info[i].topic, unsub_info[i].topic_len) == 0)
+            {
+                session->subscriptions[s] = session->subscriptions[--session->subscription_count];
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_disconnect(cy_mqtt_t mqtt_handle)
+{
+    if (mqtt_handle == NULL)
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    if (mqtt_handle->connected)
+    {
+        client_close(mqtt_handle);
+    }
+    pthread_mutex_unlock(&broker_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_mqtt_delete(cy_mqtt_t mqtt_handle)
+{
+    if (mqtt_handle == NULL)
+    {
+        return CY_RSLT_MODULE_MQTT_BADARG;
+    }
+
+    pthread_mutex_lock(&broker_lock);
+    if (mqtt_handle->connected)
+    {
+        client_close(mqtt_handle);
+    }
+    mqtt_handle->used = false;
+    pthread_mutex_unlock(&broker_lock);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * File Name:   loopback_broker.h
+ *
+ * Description: In-process MQTT broker behind the cy_mqtt API. It keeps
+ *   sessions, subscriptions and the QoS 1 messages of offline persistent
+ *   sessions like a real broker, logs every PUBLISH and lets a test inject
+ *   messages and faults.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cy_mqtt_api.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define LOOPBACK_TOPIC_LENGTH       (128u)
+#define LOOPBACK_PAYLOAD_LENGTH     (4096u)
+#define LOOPBACK_CLIENT_ID_LENGTH   (64u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* PUBLISH received by the broker */
+typedef struct
+{
+    char client_id[LOOPBACK_CLIENT_ID_LENGTH];
+    char topic[LOOPBACK_TOPIC_LENGTH];
+    uint8_t payload[LOOPBACK_PAYLOAD_LENGTH];
+    size_t payload_len;
+    cy_mqtt_qos_t qos;
+    bool retain;
+    bool dup;
+    uint16_t packet_id;
+    uint64_t time_us;
+} loopback_message_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+/* Forgets every session, the log and the injected faults */
+void loopback_broker_reset(void);
+
+/* Session present flag of the last accepted CONNECT */
+bool loopback_broker_session_present(void);
+
+/* Faults: the next count CONNECT, PUBLISH or SUBSCRIBE requests fail */
+void loopback_broker_fail_connects(uint32_t count);
+void loopback_broker_fail_publishes(uint32_t count);
+void loopback_broker_fail_subscribes(uint32_t count);
+
+/* Time the broker takes to acknowledge a QoS 1 PUBLISH */
+void loopback_broker_set_publish_delay_ms(uint32_t delay_ms);
+
+/* Closes every connection, the clients get a disconnect event */
+void loopback_broker_drop_clients(void);
+
+/* Forgets the persistent sessions, like a broker restart without storage */
+void loopback_broker_expire_sessions(void);
+
+/* Publishes a message from another client, returns the deliveries made */
+uint32_t loopback_broker_inject(const char *topic, const void *payload, size_t payload_len, cy_mqtt_qos_t qos);
+
+/* Messages published by the clients, oldest first */
+uint32_t loopback_broker_published_count(void);
+bool loopback_broker_get_published(uint32_t index, loopback_message_t *message);
+
+/* Subscriptions of a session, 0 when the session does not exist */
+uint32_t loopback_broker_subscription_count(const char *client_id);
+
+/* Highest number of PUBLISH requests the broker handled at the same time */
+uint32_t loopback_broker_max_concurrent_publishes(void);
+
+/* Requests that break the MQTT rules, e.g. DUP set on a new packet */
+uint32_t loopback_broker_protocol_errors(void);
+
+/* MQTT topic filter matching, shared with the tests */
+bool loopback_topic_matches(const char *filter, const char *topic);
+
+/* [] END OF FILE */
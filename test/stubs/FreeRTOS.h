@@ -0,0 +1,90 @@
+/******************************************************************************
+ * File Name:   FreeRTOS.h
+ *
+ * Description: Host stand-in of the FreeRTOS kernel header. It declares the
+ *   subset of the kernel used by the application modules;
+ *   test/port/host_rtos.c implements it on POSIX threads.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOSConfig.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define pdTRUE                      (1)
+#define pdFALSE                     (0)
+#define pdPASS                      (1)
+#define pdFAIL                      (0)
+#define errQUEUE_FULL               (0)
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY (-1)
+
+#define portMAX_DELAY               ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS          (1000u / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000u))
+#define portYIELD_FROM_ISR(woken)   ((void)(woken))
+#define configSTACK_DEPTH_TYPE      uint16_t
+
+/* Critical sections and the scheduler lock share one recursive mutex, an
+ * interrupt simulated by a thread is masked like on the target. */
+#define taskENTER_CRITICAL()                host_critical_enter()
+#define taskEXIT_CRITICAL()                 host_critical_exit()
+#define taskENTER_CRITICAL_FROM_ISR()       (host_critical_enter(), 0u)
+#define taskEXIT_CRITICAL_FROM_ISR(state)   ((void)(state), host_critical_exit())
+#define portENTER_CRITICAL()                host_critical_enter()
+#define portEXIT_CRITICAL()                 host_critical_exit()
+#define taskDISABLE_INTERRUPTS()            ((void)0)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+typedef struct { void *reserved[2]; } StaticTask_t;
+typedef struct { void *reserved[2]; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+typedef struct { void *reserved[2]; } StaticTimer_t;
+typedef struct { void *reserved[2]; } StaticEventGroup_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void host_critical_enter(void);
+void host_critical_exit(void);
+
+void *pvPortMalloc(size_t size);
+void vPortFree(void *pointer);
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+
+/* [] END OF FILE */
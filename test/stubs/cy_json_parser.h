@@ -0,0 +1,73 @@
+/******************************************************************************
+ * File Name:   cy_json_parser.h
+ *
+ * Description: Host stand-in of the JSON parser header. The parser in
+ *   test/port/host_middleware.c handles the flat objects of the configuration
+ *   messages.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "cy_utils.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_RSLT_JSON_GENERIC_ERROR  ((cy_rslt_t)0x0B010001U)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef enum
+{
+    JSON_STRING_TYPE,
+    JSON_NUMBER_TYPE,
+    JSON_VALUE_TYPE,
+    JSON_ARRAY_TYPE,
+    JSON_OBJECT_TYPE,
+    JSON_BOOLEAN_TYPE,
+    JSON_NULL_TYPE,
+    UNKNOWN_JSON_TYPE
+} cy_JSON_type_t;
+
+typedef struct cy_JSON_object
+{
+    char *object_string;
+    uint8_t object_string_length;
+    cy_JSON_type_t value_type;
+    char *value;
+    uint16_t value_length;
+    struct cy_JSON_object *parent_object;
+} cy_JSON_object_t;
+
+typedef cy_rslt_t (*cy_JSON_callback_t)(cy_JSON_object_t *json_object, void *arg);
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+cy_rslt_t cy_JSON_parser_register_callback(cy_JSON_callback_t json_callback, void *arg);
+cy_rslt_t cy_JSON_parser(const char *json_input, uint32_t input_length);
+
+/* [] END OF FILE */
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * File Name:   cy_syslib.h
+ *
+ * Description: Host stand-in of the PDL system library header.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include "cy_utils.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+extern uint32_t SystemCoreClock;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+void __enable_irq(void);
+void __DMB(void);
+void __WFI(void);
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t state);
+uint64_t Cy_SysLib_GetUniqueId(void);
+
+/* [] END OF FILE */
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * File Name:   cy_utils.h
+ *
+ * Description: Host stand-in of the PDL utility header. CY_ASSERT() aborts the
+ *   test with the failing expression.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_RSLT_SUCCESS             ((cy_rslt_t)0x00000000U)
+
+#define CY_UNUSED_PARAMETER(x)      ((void)(x))
+#define CY_HALT()                   abort()
+#define CY_ASSERT(x)                                                            \
+    do                                                                          \
+    {                                                                           \
+        if (!(x))                                                               \
+        {                                                                       \
+            fprintf(stderr, "%s:%d: CY_ASSERT(%s) failed\n", __FILE__, __LINE__, #x); \
+            abort();                                                            \
+        }                                                                       \
+    } while (0)
+
+#define CY_ALIGN(align)             __attribute__((aligned(align)))
+#define CY_SECTION(name)            __attribute__((section(name)))
+#define CY_NOINIT                   __attribute__((section(".noinit")))
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+/* [] END OF FILE */
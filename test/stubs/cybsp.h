@@ -0,0 +1,63 @@
+/******************************************************************************
+ * File Name:   cybsp.h
+ *
+ * Description: Host stand-in of the board support package header. Every pin
+ *   used by the application gets a distinct number.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CYBSP_LED_STATE_ON          (0u)
+#define CYBSP_LED_STATE_OFF         (1u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+enum
+{
+    CYBSP_USER_LED = 1,
+    CYBSP_GPIOA0,
+    CYBSP_GPIOA1,
+    CYBSP_GPIOA2,
+    CYBSP_GPIO5,
+    CYBSP_GPIO10,
+    CYBSP_GPIO11,
+    CYBSP_SPI_CS,
+    CYBSP_SPI_MOSI,
+    CYBSP_SPI_MISO,
+    CYBSP_SPI_CLK,
+    CYBSP_DEBUG_UART_TX,
+    CYBSP_DEBUG_UART_RX
+};
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+cy_rslt_t cybsp_init(void);
+
+/* [] END OF FILE */
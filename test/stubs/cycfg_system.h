@@ -0,0 +1,34 @@
+/******************************************************************************
+ * File Name:   cycfg_system.h
+ *
+ * Description: Host stand-in of the generated system configuration.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#define CY_CFG_PWR_MODE_SLEEP           (1)
+#define CY_CFG_PWR_MODE_DEEPSLEEP       (2)
+#define CY_CFG_PWR_SYS_IDLE_MODE        CY_CFG_PWR_MODE_SLEEP
+#define CY_CFG_PWR_DEEPSLEEP_LATENCY    (0)
+
+/* [] END OF FILE */
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * File Name:   cyhal.h
+ *
+ * Description: Host stand-in of the hardware abstraction layer. The GPIO,
+ *   flash and timer drivers are emulated in test/port/host_hal.c, the other
+ *   drivers only report success.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cy_syslib.h"
+#include "cy_utils.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define NC                          ((cyhal_gpio_t)0xFFu)
+#define CYHAL_ISR_PRIORITY_DEFAULT  (7u)
+
+#define CYHAL_GET_PORTADDR(pin)     ((void *)0)
+#define CYHAL_GET_PIN(pin)          (0u)
+#define CY_GPIO_SLEW_FAST           (0u)
+#define CY_GPIO_DRIVE_1_8           (0u)
+
+/* Size of a flash row, the unit of cyhal_flash_write() */
+#define CY_FLASH_SIZEOF_ROW         (512u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef uint32_t cyhal_gpio_t;
+
+typedef enum { CYHAL_GPIO_DIR_INPUT, CYHAL_GPIO_DIR_OUTPUT } cyhal_gpio_direction_t;
+typedef enum { CYHAL_GPIO_DRIVE_NONE, CYHAL_GPIO_DRIVE_STRONG, CYHAL_GPIO_DRIVE_PULLDOWN } cyhal_gpio_drive_mode_t;
+typedef enum { CYHAL_GPIO_IRQ_NONE, CYHAL_GPIO_IRQ_RISE, CYHAL_GPIO_IRQ_FALL, CYHAL_GPIO_IRQ_BOTH } cyhal_gpio_event_t;
+typedef void (*cyhal_gpio_event_callback_t)(void *callback_arg, cyhal_gpio_event_t event);
+
+typedef struct cyhal_gpio_callback_data_s
+{
+    cyhal_gpio_event_callback_t callback;
+    void *callback_arg;
+    struct cyhal_gpio_callback_data_s *next;
+    cyhal_gpio_t pin;
+} cyhal_gpio_callback_data_t;
+
+typedef struct { int reserved; } cyhal_timer_t;
+typedef struct { int reserved; } cyhal_spi_t;
+typedef struct { int reserved; } cyhal_flash_t;
+typedef struct { int reserved; } cyhal_trng_t;
+typedef struct { int reserved; } cyhal_lptimer_t;
+
+typedef enum { CYHAL_TIMER_DIR_UP } cyhal_timer_direction_t;
+typedef enum { CYHAL_TIMER_IRQ_NONE, CYHAL_TIMER_IRQ_TERMINAL_COUNT } cyhal_timer_event_t;
+typedef void (*cyhal_timer_event_callback_t)(void *callback_arg, cyhal_timer_event_t event);
+
+typedef struct
+{
+    bool is_continuous;
+    cyhal_timer_direction_t direction;
+    bool is_compare;
+    uint32_t period;
+    uint32_t compare_value;
+    uint32_t value;
+} cyhal_timer_cfg_t;
+
+typedef enum { CYHAL_SPI_MODE_00_MSB } cyhal_spi_mode_t;
+
+typedef struct
+{
+    uint32_t start_address;
+    uint32_t size;
+    uint32_t sector_size;
+    uint32_t page_size;
+    uint8_t erase_value;
+} cyhal_flash_block_info_t;
+
+typedef struct
+{
+    uint8_t block_count;
+    const cyhal_flash_block_info_t *blocks;
+} cyhal_flash_info_t;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val);
+void cyhal_gpio_free(cyhal_gpio_t pin);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+bool cyhal_gpio_read(cyhal_gpio_t pin);
+void cyhal_gpio_toggle(cyhal_gpio_t pin);
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable);
+
+void Cy_GPIO_SetSlewRate(void *base, uint32_t pin, uint32_t value);
+void Cy_GPIO_SetDriveSel(void *base, uint32_t pin, uint32_t value);
+
+cy_rslt_t cyhal_timer_init(cyhal_timer_t *obj, cyhal_gpio_t pin, const void *clk);
+cy_rslt_t cyhal_timer_configure(cyhal_timer_t *obj, const cyhal_timer_cfg_t *cfg);
+cy_rslt_t cyhal_timer_set_frequency(cyhal_timer_t *obj, uint32_t hz);
+void cyhal_timer_register_callback(cyhal_timer_t *obj, cyhal_timer_event_callback_t callback, void *callback_arg);
+void cyhal_timer_enable_event(cyhal_timer_t *obj, cyhal_timer_event_t event, uint8_t intr_priority, bool enable);
+cy_rslt_t cyhal_timer_start(cyhal_timer_t *obj);
+cy_rslt_t cyhal_timer_stop(cyhal_timer_t *obj);
+uint32_t cyhal_timer_read(const cyhal_timer_t *obj);
+
+cy_rslt_t cyhal_spi_init(cyhal_spi_t *obj, cyhal_gpio_t mosi, cyhal_gpio_t miso, cyhal_gpio_t sclk, cyhal_gpio_t ssel,
+                         const void *clk, uint8_t bits, cyhal_spi_mode_t mode, bool is_slave);
+cy_rslt_t cyhal_spi_set_frequency(cyhal_spi_t *obj, uint32_t hz);
+
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj);
+void cyhal_flash_free(cyhal_flash_t *obj);
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info);
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size);
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address);
+cy_rslt_t cyhal_flash_write(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+
+cy_rslt_t cyhal_trng_init(cyhal_trng_t *obj);
+uint32_t cyhal_trng_generate(const cyhal_trng_t *obj);
+void cyhal_trng_free(cyhal_trng_t *obj);
+
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj);
+cy_rslt_t cyhal_syspm_tickless_deepsleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms);
+cy_rslt_t cyhal_syspm_tickless_sleep(cyhal_lptimer_t *obj, uint32_t desired_ms, uint32_t *actual_ms);
+uint32_t cyhal_system_critical_section_enter(void);
+void cyhal_system_critical_section_exit(uint32_t old_state);
+
+/* [] END OF FILE */
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * File Name:   ssl.h
+ *
+ * Description: Host stand-in of the mbedtls SSL header, only the session  *
+ *   functions tls_cache.c uses. The test provides their implementations.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define MBEDTLS_ERR_SSL_WANT_READ   (-0x6900)
+#define MBEDTLS_ERR_SSL_WANT_WRITE  (-0x6880)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef struct
+{
+    size_t id_len;
+    unsigned char id[32];
+    unsigned char *ticket;      /* Allocated by mbedtls_ssl_get_session() */
+} mbedtls_ssl_session;
+
+typedef struct
+{
+    int endpoint;
+} mbedtls_ssl_config;
+
+typedef struct
+{
+    const mbedtls_ssl_config *conf;
+    mbedtls_ssl_session session;
+    int offered;                /* mbedtls_ssl_set_session() was called */
+    int state;                  /* Handshake steps done */
+} mbedtls_ssl_context;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+int mbedtls_ssl_setup(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf);
+int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl);
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session *session);
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl, mbedtls_ssl_session *session);
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session);
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session);
+
+/* [] END OF FILE */
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * File Name:   mtb_radar_sensing.h
+ *
+ * Description: Host stand-in of the xensiv-radar-sensing library header. There
+ *   is no sensor on the host, radar_sim.c or a test produces the events.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Polling period of mtb_radar_sensing_process() in ms */
+#define MTB_RADAR_SENSING_PROCESS_DELAY     (2)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef enum
+{
+    MTB_RADAR_SENSING_SUCCESS = 0,
+    MTB_RADAR_SENSING_BAD_PARAM,
+    MTB_RADAR_SENSING_HW_ERROR
+} mtb_radar_sensing_result_t;
+
+typedef enum
+{
+    MTB_RADAR_SENSING_EVENT_COUNTER_IN,
+    MTB_RADAR_SENSING_EVENT_COUNTER_OUT,
+    MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED,
+    MTB_RADAR_SENSING_EVENT_COUNTER_FREE,
+    MTB_RADAR_SENSING_EVENT_PRESENCE_IN,
+    MTB_RADAR_SENSING_EVENT_PRESENCE_OUT
+} mtb_radar_sensing_event_t;
+
+typedef enum
+{
+    MTB_RADAR_SENSING_MASK_PRESENCE_EVENTS,
+    MTB_RADAR_SENSING_MASK_COUNTER_EVENTS
+} mtb_radar_sensing_mask_t;
+
+typedef struct
+{
+    uint64_t timestamp;
+} mtb_radar_sensing_event_info_t;
+
+typedef struct
+{
+    mtb_radar_sensing_event_info_t base;
+    float distance;
+    float accuracy;
+} mtb_radar_sensing_presence_event_info_t;
+
+typedef struct
+{
+    int reserved;
+} mtb_radar_sensing_context_t;
+
+typedef struct
+{
+    cyhal_gpio_t spi_cs;
+    cyhal_gpio_t reset;
+    cyhal_gpio_t ldo_en;
+    cyhal_gpio_t irq;
+    cyhal_spi_t *spi;
+} mtb_radar_sensing_hw_cfg_t;
+
+typedef void (*mtb_radar_sensing_callback_t)(mtb_radar_sensing_context_t *context,
+                                             mtb_radar_sensing_event_t event,
+                                             mtb_radar_sensing_event_info_t *event_info,
+                                             void *data);
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+mtb_radar_sensing_result_t mtb_radar_sensing_init(mtb_radar_sensing_context_t *context,
+                                                  mtb_radar_sensing_hw_cfg_t *hw_cfg,
+                                                  mtb_radar_sensing_mask_t mask);
+mtb_radar_sensing_result_t mtb_radar_sensing_register_callback(mtb_radar_sensing_context_t *context,
+                                                               mtb_radar_sensing_callback_t callback,
+                                                               void *data);
+mtb_radar_sensing_result_t mtb_radar_sensing_set_parameter(mtb_radar_sensing_context_t *context,
+                                                           const char *key, const char *value);
+const char *mtb_radar_sensing_get_parameter(mtb_radar_sensing_context_t *context, const char *key);
+mtb_radar_sensing_result_t mtb_radar_sensing_enable(mtb_radar_sensing_context_t *context);
+mtb_radar_sensing_result_t mtb_radar_sensing_disable(mtb_radar_sensing_context_t *context);
+mtb_radar_sensing_result_t mtb_radar_sensing_process(mtb_radar_sensing_context_t *context, uint64_t time_ms);
+
+/* [] END OF FILE */
@@ -0,0 +1,299 @@
+/******************************************************************************
+ * File Name:   test_loopback_broker.c
+ *
+ * Description: Checks the loopback broker the other host tests rely on: topic
+ *   filter matching, sessions, offline queueing, session takeover and fault
+ *   injection.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "cy_mqtt_api.h"
+#include "loopback_broker.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PUBLISHER_THREADS           (4u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static uint8_t network_buffer[CY_MQTT_MIN_NETWORK_BUFFER_SIZE];
+
+static uint32_t received_count;
+static uint32_t disconnect_count;
+static char received_topic[LOOPBACK_TOPIC_LENGTH];
+
+static cy_mqtt_t concurrent_handle;
+static volatile uint32_t concurrent_done;
+
+/*******************************************************************************
+ * Function Name: event_callback
+ ********************************************************************************
+ * Summary:
+ *  Counts the events of a client.
+ ******************************************************************************/
+static void event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, void *user_data)
+{
+    if (event.type == CY_MQTT_EVENT_TYPE_DISCONNECT)
+    {
+        disconnect_count++;
+    }
+    else
+    {
+        received_count++;
+        memset(received_topic, 0, sizeof(received_topic));
+        memcpy(received_topic, event.data.pub_msg.received_message.topic,
+               event.data.pub_msg.received_message.topic_len);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: connect_client
+ ********************************************************************************
+ * Summary:
+ *  Connects a client handle with the given identifier and session type.
+ ******************************************************************************/
+static cy_rslt_t connect_client(cy_mqtt_t handle, const char *client_id, bool clean_session)
+{
+    cy_mqtt_connect_info_t connect_info = { 0 };
+
+    connect_info.client_id = client_id;
+    connect_info.client_id_len = (uint16_t)strlen(client_id);
+    connect_info.clean_session = clean_session;
+
+    return cy_mqtt_connect(handle, &connect_info);
+}
+
+/*******************************************************************************
+ * Function Name: subscribe_client
+ ********************************************************************************
+ * Summary:
+ *  Subscribes a client to a topic filter.
+ ******************************************************************************/
+static cy_rslt_t subscribe_client(cy_mqtt_t handle, const char *filter, cy_mqtt_qos_t qos)
+{
+    cy_mqtt_subscribe_info_t sub_info = { 0 };
+
+    sub_info.qos = qos;
+    sub_info.topic = filter;
+    sub_info.topic_len = (uint16_t)strlen(filter);
+
+    return cy_mqtt_subscribe(handle, &sub_info, 1u);
+}
+
+/*******************************************************************************
+ * Function Name: publish_client
+ ********************************************************************************
+ * Summary:
+ *  Publishes a short message.
+ ******************************************************************************/
+static cy_rslt_t publish_client(cy_mqtt_t handle, const char *topic, cy_mqtt_qos_t qos, bool dup)
+{
+    cy_mqtt_publish_info_t pub_info = { 0 };
+
+    pub_info.qos = qos;
+    pub_info.dup = dup;
+    pub_info.topic = topic;
+    pub_info.topic_len = (uint16_t)strlen(topic);
+    pub_info.payload = "{}";
+    pub_info.payload_len = 2u;
+
+    return cy_mqtt_publish(handle, &pub_info);
+}
+
+static void test_topic_matching(void)
+{
+    TEST_CHECK(loopback_topic_matches("a/b/c", "a/b/c"));
+    TEST_CHECK(loopback_topic_matches("a/+/c", "a/b/c"));
+    TEST_CHECK(loopback_topic_matches("a/#", "a/b/c"));
+    TEST_CHECK(loopback_topic_matches("a/#", "a"));
+    TEST_CHECK(loopback_topic_matches("#", "a/b"));
+    TEST_CHECK(loopback_topic_matches("+/+", "a/b"));
+    TEST_CHECK(!loopback_topic_matches("a/b", "a/b/c"));
+    TEST_CHECK(!loopback_topic_matches("a/b/c", "a/b"));
+    TEST_CHECK(!loopback_topic_matches("a/+", "a/b/c"));
+    TEST_CHECK(!loopback_topic_matches("a", "ab"));
+    TEST_CHECK(!loopback_topic_matches("#", "$SYS/uptime"));
+    TEST_CHECK(!loopback_topic_matches("+/uptime", "$SYS/uptime"));
+}
+
+static void test_publish_and_deliver(void)
+{
+    cy_mqtt_t handle = NULL;
+
+    loopback_broker_reset();
+    received_count = 0u;
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL,
+                                                     event_callback, NULL, &handle));
+
+    TEST_CHECK_EQUAL(CY_RSLT_MODULE_MQTT_NOT_CONNECTED, publish_client(handle, "radar/out", CY_MQTT_QOS1, false));
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(handle, "device", true));
+    TEST_CHECK(!loopback_broker_session_present());
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, subscribe_client(handle, "radar/+", CY_MQTT_QOS1));
+    TEST_CHECK_EQUAL(1u, loopback_broker_subscription_count("device"));
+
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, publish_client(handle, "radar/out", CY_MQTT_QOS1, false));
+    TEST_CHECK_EQUAL(1u, received_count);
+    TEST_CHECK(strcmp(received_topic, "radar/out") == 0);
+    TEST_CHECK_EQUAL(1u, loopback_broker_inject("radar/in", "{}", 2u, CY_MQTT_QOS0));
+    TEST_CHECK_EQUAL(0u, loopback_broker_inject("other/in", "{}", 2u, CY_MQTT_QOS0));
+    TEST_CHECK_EQUAL(2u, received_count);
+
+    TEST_CHECK_EQUAL(1u, loopback_broker_published_count());
+    TEST_CHECK_EQUAL(0u, loopback_broker_protocol_errors());
+
+    (void)cy_mqtt_disconnect(handle);
+    (void)cy_mqtt_delete(handle);
+}
+
+static void test_persistent_session(void)
+{
+    cy_mqtt_t handle = NULL;
+
+    loopback_broker_reset();
+    received_count = 0u;
+    (void)cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL, event_callback, NULL, &handle);
+
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(handle, "device", false));
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, subscribe_client(handle, "radar/in", CY_MQTT_QOS1));
+    (void)cy_mqtt_disconnect(handle);
+
+    /* QoS 1 is queued for the offline session, QoS 0 is not */
+    TEST_CHECK_EQUAL(1u, loopback_broker_inject("radar/in", "{}", 2u, CY_MQTT_QOS1));
+    TEST_CHECK_EQUAL(0u, loopback_broker_inject("radar/in", "{}", 2u, CY_MQTT_QOS0));
+    TEST_CHECK_EQUAL(0u, received_count);
+
+    /* The queued message arrives with the connection, before any SUBSCRIBE */
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(handle, "device", false));
+    TEST_CHECK(loopback_broker_session_present());
+    TEST_CHECK_EQUAL(1u, received_count);
+    (void)cy_mqtt_disconnect(handle);
+
+    /* A broker that lost its sessions starts over */
+    loopback_broker_expire_sessions();
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(handle, "device", false));
+    TEST_CHECK(!loopback_broker_session_present());
+    TEST_CHECK_EQUAL(0u, loopback_broker_subscription_count("device"));
+    (void)cy_mqtt_disconnect(handle);
+
+    /* A clean session discards the stored one */
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(handle, "device", true));
+    TEST_CHECK(!loopback_broker_session_present());
+    (void)cy_mqtt_delete(handle);
+}
+
+static void test_takeover_and_faults(void)
+{
+    cy_mqtt_t first = NULL;
+    cy_mqtt_t second = NULL;
+
+    loopback_broker_reset();
+    disconnect_count = 0u;
+    (void)cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL, event_callback, NULL, &first);
+    (void)cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL, event_callback, NULL, &second);
+
+    /* Two devices with one client identifier knock each other off */
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(first, "device", true));
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(second, "device", true));
+    TEST_CHECK_EQUAL(1u, disconnect_count);
+    TEST_CHECK_EQUAL(CY_RSLT_MODULE_MQTT_NOT_CONNECTED, publish_client(first, "radar/out", CY_MQTT_QOS1, false));
+
+    loopback_broker_fail_publishes(1u);
+    TEST_CHECK_EQUAL(CY_RSLT_MODULE_MQTT_PUBLISH_FAIL, publish_client(second, "radar/out", CY_MQTT_QOS1, false));
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, publish_client(second, "radar/out", CY_MQTT_QOS1, false));
+
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, publish_client(second, "radar/out", CY_MQTT_QOS1, true));
+    TEST_CHECK_EQUAL(1u, loopback_broker_protocol_errors());
+
+    loopback_broker_fail_connects(1u);
+    loopback_broker_drop_clients();
+    TEST_CHECK_EQUAL(2u, disconnect_count);
+    TEST_CHECK_EQUAL(CY_RSLT_MODULE_MQTT_CONNECT_FAIL, connect_client(second, "device", true));
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, connect_client(second, "device", true));
+
+    (void)cy_mqtt_delete(first);
+    (void)cy_mqtt_delete(second);
+}
+
+/*******************************************************************************
+ * Function Name: concurrent_publisher
+ ********************************************************************************
+ * Summary:
+ *  Task publishing a few QoS 1 messages.
+ ******************************************************************************/
+static void concurrent_publisher(void *arg)
+{
+    for (uint32_t i = 0u; i < 5u; i++)
+    {
+        (void)publish_client(concurrent_handle, "radar/out", CY_MQTT_QOS1, false);
+    }
+
+    taskENTER_CRITICAL();
+    concurrent_done++;
+    taskEXIT_CRITICAL();
+    vTaskDelete(NULL);
+}
+
+static void test_concurrent_publishes(void)
+{
+    loopback_broker_reset();
+    concurrent_done = 0u;
+    (void)cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL, event_callback, NULL,
+                         &concurrent_handle);
+    (void)connect_client(concurrent_handle, "device", true);
+    loopback_broker_set_publish_delay_ms(5u);
+
+    for (uint32_t i = 0u; i < PUBLISHER_THREADS; i++)
+    {
+        (void)xTaskCreate(concurrent_publisher, "Publisher", 1024u, NULL, 1u, NULL);
+    }
+
+    while (concurrent_done < PUBLISHER_THREADS)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1u));
+    }
+
+    TEST_CHECK_EQUAL(PUBLISHER_THREADS * 5u, loopback_broker_published_count());
+    TEST_CHECK(loopback_broker_max_concurrent_publishes() > 1u);
+    TEST_CHECK(loopback_broker_max_concurrent_publishes() <= PUBLISHER_THREADS);
+    (void)cy_mqtt_delete(concurrent_handle);
+}
+
+int main(void)
+{
+    TEST_RUN(test_topic_matching);
+    TEST_RUN(test_publish_and_deliver);
+    TEST_RUN(test_persistent_session);
+    TEST_RUN(test_takeover_and_faults);
+    TEST_RUN(test_concurrent_publishes);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,286 @@
+/******************************************************************************
+ * File Name:   test_mem_pool.c
+ *
+ * Description: Soak test of the fixed-block allocator: 10,000 reconnections
+ *   with  *   the allocation pattern of an mbedTLS handshake, while a second
+ *   task keeps  *   allocating and releasing FreeRTOS sized objects. Every
+ *   block must return  *   to its class, only requests larger than every block
+ *   may reach the C  *   library heap, and the high-water mark of the TLS
+ *   record buffers must not  *   grow.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mem_pool.h"
+
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define RECONNECTIONS               (10000u)
+#define WARM_UP_RECONNECTIONS       (100u)
+
+/* Record buffers of mbedTLS: 16 KB of data plus header, IV and MAC */
+#define TLS_RECORD_BUFFER_SIZE      (16717u)
+
+/* Every this many reconnections, a request larger than every block */
+#define OVERSIZE_PERIOD             (100u)
+#define OVERSIZE_BYTES              (20000u)
+
+/* Short-lived allocations of a handshake: certificate chain, bignums */
+#define HANDSHAKE_TEMPORARIES       (48u)
+
+/* Objects held at the same time by the second task */
+#define CHURN_SLOTS                 (8u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static volatile bool churn_stop;
+static volatile bool churn_done;
+static volatile uint32_t churn_rounds;
+static volatile uint32_t churn_failures;
+
+/*******************************************************************************
+ * Function Name: next_random
+ ********************************************************************************
+ * Summary:
+ *  xorshift32, a reproducible sequence per seed.
+ ******************************************************************************/
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/*******************************************************************************
+ * Function Name: fill
+ ********************************************************************************
+ * Summary:
+ *  Allocates a block and writes a pattern to all requested bytes, so blocks
+ *  handed out twice would overwrite each other.
+ ******************************************************************************/
+static uint8_t *fill(size_t size, uint8_t pattern)
+{
+    uint8_t *block = mem_pool_alloc(size);
+
+    if (block != NULL)
+    {
+        memset(block, pattern, size);
+    }
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: intact
+ ********************************************************************************
+ * Summary:
+ *  Checks that a block still holds its pattern and releases it.
+ ******************************************************************************/
+static bool intact(uint8_t *block, size_t size, uint8_t pattern)
+{
+    bool ok = (block != NULL);
+
+    for (size_t i = 0u; ok && (i < size); i++)
+    {
+        ok = (block[i] == pattern);
+    }
+    mem_pool_free(block);
+    return ok;
+}
+
+/*******************************************************************************
+ * Function Name: churn_task
+ ********************************************************************************
+ * Summary:
+ *  Allocates and releases objects of FreeRTOS sizes (queues, timers, event
+ *  groups, small strings) in random order until it is stopped.
+ ******************************************************************************/
+static void churn_task(void *parameters)
+{
+    static const size_t sizes[] = { 24u, 48u, 80u, 96u, 168u, 200u };
+    uint8_t *blocks[CHURN_SLOTS] = { NULL };
+    size_t block_sizes[CHURN_SLOTS] = { 0u };
+    uint32_t random = 0x1234567u;
+
+    (void)parameters;
+
+    while (!churn_stop)
+    {
+        uint32_t slot = next_random(&random) % CHURN_SLOTS;
+        uint8_t pattern = (uint8_t)(0x80u | slot);
+
+        if (blocks[slot] != NULL)
+        {
+            churn_failures += intact(blocks[slot], block_sizes[slot], pattern) ? 0u : 1u;
+            blocks[slot] = NULL;
+        }
+        else
+        {
+            block_sizes[slot] = sizes[next_random(&random) % (sizeof(sizes) / sizeof(sizes[0]))];
+            blocks[slot] = fill(block_sizes[slot], pattern);
+            churn_failures += (blocks[slot] == NULL) ? 1u : 0u;
+        }
+        churn_rounds++;
+    }
+
+    for (uint32_t slot = 0u; slot < CHURN_SLOTS; slot++)
+    {
+        if (blocks[slot] != NULL)
+        {
+            churn_failures += intact(blocks[slot], block_sizes[slot], (uint8_t)(0x80u | slot)) ? 0u : 1u;
+        }
+    }
+    churn_done = true;
+    vTaskDelete(NULL);
+}
+
+/*******************************************************************************
+ * Function Name: reconnect
+ ********************************************************************************
+ * Summary:
+ *  Allocates and releases the memory of one TLS connection like mbedTLS: the
+ *  contexts and record buffers live for the connection, the handshake
+ *  temporaries are released in a different order than they were allocated.
+ *
+ * Return:
+ *  bool: true if every allocation succeeded and no block was overwritten
+ ******************************************************************************/
+static bool reconnect(uint32_t round, uint32_t *random)
+{
+    uint8_t *context = fill(432u, 1u);
+    uint8_t *config = fill(312u, 2u);
+    uint8_t *in_buffer = fill(TLS_RECORD_BUFFER_SIZE, 3u);
+    uint8_t *out_buffer = fill(TLS_RECORD_BUFFER_SIZE, 4u);
+    uint8_t *handshake = fill(2104u, 5u);
+    uint8_t *session = fill(152u, 6u);
+    uint8_t *temporaries[HANDSHAKE_TEMPORARIES];
+    size_t temporary_sizes[HANDSHAKE_TEMPORARIES];
+    bool ok = true;
+
+    for (uint32_t i = 0u; i < HANDSHAKE_TEMPORARIES; i++)
+    {
+        /* Bignums and name entries, every eighth a certificate copy */
+        temporary_sizes[i] = ((i % 8u) == 7u) ? (512u + (next_random(random) % 512u))
+                                               : (16u + (next_random(random) % 240u));
+        temporaries[i] = fill(temporary_sizes[i], (uint8_t)(0x10u + i));
+    }
+    if ((round % OVERSIZE_PERIOD) == 0u)
+    {
+        ok &= intact(fill(OVERSIZE_BYTES, 7u), OVERSIZE_BYTES, 7u);
+    }
+
+    /* Released in a shuffled order */
+    for (uint32_t i = HANDSHAKE_TEMPORARIES; i > 1u; i--)
+    {
+        uint32_t j = next_random(random) % i;
+        uint8_t *block = temporaries[j];
+        size_t size = temporary_sizes[j];
+
+        temporaries[j] = temporaries[i - 1u];
+        temporary_sizes[j] = temporary_sizes[i - 1u];
+        temporaries[i - 1u] = block;
+        temporary_sizes[i - 1u] = size;
+    }
+    for (uint32_t i = 0u; i < HANDSHAKE_TEMPORARIES; i++)
+    {
+        ok &= intact(temporaries[i], temporary_sizes[i], temporaries[i] != NULL ? temporaries[i][0] : 0u);
+    }
+    ok &= intact(handshake, 2104u, 5u);
+
+    ok &= intact(session, 152u, 6u);
+    ok &= intact(out_buffer, TLS_RECORD_BUFFER_SIZE, 4u);
+    ok &= intact(in_buffer, TLS_RECORD_BUFFER_SIZE, 3u);
+    ok &= intact(config, 312u, 2u);
+    ok &= intact(context, 432u, 1u);
+
+    return ok;
+}
+
+static void test_reconnection_soak(void)
+{
+    mem_pool_stats_t warm;
+    mem_pool_stats_t stats;
+    uint32_t random = 0xC0FFEEu;
+    uint32_t failed_rounds = 0u;
+    uint32_t oversize = 0u;
+
+    TEST_CHECK(xTaskCreate(churn_task, "churn", 1024u, NULL, 1u, NULL) == pdPASS);
+
+    for (uint32_t round = 0u; round < RECONNECTIONS; round++)
+    {
+        failed_rounds += reconnect(round, &random) ? 0u : 1u;
+        oversize += ((round % OVERSIZE_PERIOD) == 0u) ? 1u : 0u;
+        if (round == (WARM_UP_RECONNECTIONS - 1u))
+        {
+            mem_pool_get_stats(&warm);
+        }
+    }
+
+    churn_stop = true;
+    while (!churn_done)
+    {
+        vTaskDelay(1u);
+    }
+
+    mem_pool_get_stats(&stats);
+    TEST_CHECK_EQUAL(0u, failed_rounds);
+    TEST_CHECK_EQUAL(0u, churn_failures);
+    TEST_CHECK(churn_rounds > 0u);
+
+    /* Every block returned to its class */
+    TEST_CHECK_EQUAL(0u, stats.bytes_in_use);
+    TEST_CHECK_EQUAL(0u, stats.requested_in_use);
+    for (uint32_t i = 0u; i < MEM_POOL_CLASS_COUNT; i++)
+    {
+        TEST_CHECK_EQUAL(0u, stats.classes[i].in_use);
+        TEST_CHECK(stats.classes[i].high_water <= stats.classes[i].block_count);
+    }
+
+    /* Only the oversize requests reached the C library heap */
+    TEST_CHECK_EQUAL(oversize, stats.fallbacks);
+    TEST_CHECK_EQUAL(0u, stats.failures);
+
+    /* The record buffers reuse the same two blocks on every connection */
+    TEST_CHECK_EQUAL(2u, stats.classes[MEM_POOL_CLASS_COUNT - 1u].high_water);
+    TEST_CHECK_EQUAL(warm.classes[MEM_POOL_CLASS_COUNT - 1u].high_water,
+                     stats.classes[MEM_POOL_CLASS_COUNT - 1u].high_water);
+}
+
+int main(void)
+{
+    TEST_RUN(test_reconnection_soak);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,398 @@
+/******************************************************************************
+ * File Name:   test_outbox_replay.c
+ *
+ * Description: End-to-end test of the outbox replay on the host. The simulated
+ *   radar replays test/traces/outbox_replay.trace while the loopback broker
+ *   drops the connection and later fails a publish, so that the outbox
+ *   overflows, also while a replay is in flight. Every event must reach the
+ *   broker exactly once, as one event object per message, or be counted as
+ *   dropped.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_boot.h"
+#include "host_port.h"
+#include "loopback_broker.h"
+#include "mqtt_client_config.h"
+#include "mqtt_task.h"
+#include "publish_pool.h"
+#include "publisher_task.h"
+#include "radar_event_ring.h"
+#include "radar_outbox.h"
+#include "radar_sim.h"
+#include "radar_task.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define REPLAY_MAX_EVENTS           (4096u)
+#define REPLAY_TIMEOUT_MS           (60000u)
+
+/* Failed attempts injected so that at least one of the jobs in flight runs
+ * out of retries */
+#define REPLAY_PUBLISH_FAULTS       (MQTT_PUB_INFLIGHT_WINDOW * (PUBLISH_POOL_RETRY_LIMIT + 1u))
+
+/* Round trip of the PUBLISH that probes the link after the failed publish.
+ * At 50 events per second the full outbox drops about ten records while it
+ * is in flight. */
+#define REPLAY_PROBE_DELAY_MS       (200u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static volatile uint32_t callback_count;
+static mtb_radar_sensing_callback_t app_callback;
+
+/* Deliveries per sequence number */
+static uint32_t delivered[REPLAY_MAX_EVENTS];
+static uint32_t delivered_count;
+static uint32_t unexpected_seq;
+
+/* Records the event ring rejected or the outbox overwrote. The outbox also
+ * counts a record it overwrites while a replay carries it, such a record
+ * may arrive as well. */
+static bool dropped[REPLAY_MAX_EVENTS];
+static uint32_t not_single_event;
+static uint32_t next_message;
+static uint32_t waited_ms;
+
+static loopback_message_t message;
+
+/* Defined by main.c in the firmware, stopped by the radar task */
+cyhal_timer_t led_blink_timer;
+
+void __real_radar_sim_init(mtb_radar_sensing_callback_t callback, void *data);
+bool __real_radar_event_ring_push(const radar_event_record_t *record);
+void __real_radar_outbox_put(const radar_event_record_t *record, bool sent);
+
+/*******************************************************************************
+ * Function Name: counted_callback
+ ********************************************************************************
+ * Summary:
+ *  Counts the simulated events and hands them to the sensing callback of the
+ *  radar task. The debounce stage is off by default, so the n-th event
+ *  becomes the record with sequence number n.
+ ******************************************************************************/
+static void counted_callback(mtb_radar_sensing_context_t *context, mtb_radar_sensing_event_t event,
+                             mtb_radar_sensing_event_info_t *event_info, void *data)
+{
+    callback_count++;
+    app_callback(context, event, event_info, data);
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_radar_sim_init
+ ********************************************************************************
+ * Summary:
+ *  Puts counted_callback() between the simulated radar and the radar task.
+ ******************************************************************************/
+void __wrap_radar_sim_init(mtb_radar_sensing_callback_t callback, void *data)
+{
+    app_callback = callback;
+    __real_radar_sim_init(counted_callback, data);
+}
+
+/*******************************************************************************
+ * Function Name: mark_dropped
+ ******************************************************************************/
+static void mark_dropped(uint32_t seq)
+{
+    if (seq < REPLAY_MAX_EVENTS)
+    {
+        dropped[seq] = true;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_radar_event_ring_push
+ ********************************************************************************
+ * Summary:
+ *  Notes the records the event ring rejects.
+ ******************************************************************************/
+bool __wrap_radar_event_ring_push(const radar_event_record_t *record)
+{
+    bool pushed = __real_radar_event_ring_push(record);
+
+    if (!pushed)
+    {
+        mark_dropped(record->seq);
+    }
+
+    return pushed;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_radar_outbox_put
+ ********************************************************************************
+ * Summary:
+ *  Notes the oldest record when the full outbox is about to overwrite it.
+ *  Runs in the publisher task, the only user of the outbox.
+ ******************************************************************************/
+void __wrap_radar_outbox_put(const radar_event_record_t *record, bool sent)
+{
+    radar_event_record_t oldest;
+    bool oldest_sent;
+
+    if ((radar_outbox_count() == RADAR_OUTBOX_LENGTH) && (radar_outbox_peek(&oldest, 1u, &oldest_sent) == 1u))
+    {
+        mark_dropped(oldest.seq);
+    }
+    __real_radar_outbox_put(record, sent);
+}
+
+/*******************************************************************************
+ * Function Name: sleep_ms
+ ******************************************************************************/
+static void sleep_ms(uint32_t ms)
+{
+    struct timespec delay = { (time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: collect_deliveries
+ ********************************************************************************
+ * Summary:
+ *  Reads the radar event messages the broker received since the last call and
+ *  counts their sequence numbers. Batching is off, so every message, live or
+ *  replayed, must hold exactly one event object.
+ ******************************************************************************/
+static void collect_deliveries(void)
+{
+    while (loopback_broker_get_published(next_message, &message))
+    {
+        const char *payload = (const char *)message.payload;
+        const char *cursor;
+        unsigned long seq;
+
+        next_message++;
+        message.payload[(message.payload_len < LOOPBACK_PAYLOAD_LENGTH) ?
+                        message.payload_len : (LOOPBACK_PAYLOAD_LENGTH - 1u)] = '\0';
+        if (strcmp(message.topic, MQTT_PUB_TOPIC) != 0)
+        {
+            continue;
+        }
+
+        cursor = strstr(payload, "\"Seq\":");
+        if ((payload[0] != '{') || (cursor == NULL) || (strstr(cursor + 6, "\"Seq\":") != NULL))
+        {
+            not_single_event++;
+            continue;
+        }
+
+        seq = strtoul(cursor + 6, NULL, 10);
+        if (seq >= REPLAY_MAX_EVENTS)
+        {
+            unexpected_seq++;
+            continue;
+        }
+        if (delivered[seq]++ == 0u)
+        {
+            delivered_count++;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: wait_for
+ ********************************************************************************
+ * Summary:
+ *  Collects the deliveries until 'done' returns true or the test times out.
+ ******************************************************************************/
+static bool wait_for(bool (*done)(void))
+{
+    while (!done() && (waited_ms < REPLAY_TIMEOUT_MS))
+    {
+        sleep_ms(1u);
+        waited_ms++;
+        collect_deliveries();
+    }
+
+    return done();
+}
+
+static bool events_delivered(void)
+{
+    return delivered_count >= 50u;
+}
+
+static bool mqtt_reconnected(void)
+{
+    reconnect_backoff_stats_t mqtt_stats;
+
+    mqtt_task_get_connection_stats(NULL, &mqtt_stats);
+    return mqtt_stats.successes >= 2u;
+}
+
+static bool outbox_overflowing(void)
+{
+    radar_outbox_stats_t outbox;
+
+    radar_outbox_get_stats(&outbox);
+    return outbox.dropped > 0u;
+}
+
+static bool outbox_holding(void)
+{
+    return radar_outbox_count() > 0u;
+}
+
+static bool outbox_empty(void)
+{
+    return radar_outbox_count() == 0u;
+}
+
+/*******************************************************************************
+ * Function Name: unaccounted
+ ********************************************************************************
+ * Summary:
+ *  Returns the number of the first 'events' records neither delivered nor
+ *  dropped yet.
+ ******************************************************************************/
+static uint32_t unaccounted(uint32_t events)
+{
+    uint32_t count = 0u;
+
+    for (uint32_t seq = 0u; seq < events; seq++)
+    {
+        count += ((delivered[seq] == 0u) && !dropped[seq]) ? 1u : 0u;
+    }
+
+    return count;
+}
+
+static void test_replay_after_outage(void)
+{
+    radar_event_ring_stats_t ring;
+    radar_outbox_stats_t outbox;
+    radar_outbox_stats_t before_probe;
+    uint32_t events;
+    uint32_t once = 0u;
+    uint32_t duplicated = 0u;
+    uint32_t missing = 0u;
+    uint32_t lost = 0u;
+    uint32_t drops = 0u;
+
+    TEST_CHECK(radar_sim_load(RADAR_TRACE_DIR "/outbox_replay.trace"));
+
+    loopback_broker_reset();
+    app_boot_init();
+    TEST_CHECK(pdPASS == xTaskCreate(mqtt_client_task, "MQTT Client task", MQTT_CLIENT_TASK_STACK_SIZE, NULL,
+                                     MQTT_CLIENT_TASK_PRIORITY, NULL));
+    TEST_CHECK(wait_for(events_delivered));
+
+    /* The broker drops the connection and refuses the first reconnection:
+     * the events of the outage overflow the outbox, which is replayed once
+     * the client is back */
+    loopback_broker_fail_connects(1u);
+    loopback_broker_drop_clients();
+    TEST_CHECK(wait_for(outbox_overflowing));
+    TEST_CHECK(wait_for(mqtt_reconnected));
+    TEST_CHECK(wait_for(outbox_empty));
+
+    /* A failed publish keeps the connection but parks the events in the
+     * outbox until the probe after 'PUBLISHER_RETRY_INTERVAL_MS'. The outbox
+     * is full by then and drops records while the probe is in flight, the
+     * probe must not remove records it did not carry. */
+    radar_outbox_get_stats(&before_probe);
+    loopback_broker_fail_publishes(REPLAY_PUBLISH_FAULTS);
+    TEST_CHECK(wait_for(outbox_holding));
+    loopback_broker_fail_publishes(0u);
+    loopback_broker_set_publish_delay_ms(REPLAY_PROBE_DELAY_MS);
+    for (uint32_t ms = 0u; ms < (PUBLISHER_RETRY_INTERVAL_MS + 2u * REPLAY_PROBE_DELAY_MS); ms++)
+    {
+        sleep_ms(1u);
+        collect_deliveries();
+    }
+    loopback_broker_set_publish_delay_ms(0u);
+    TEST_CHECK(wait_for(outbox_empty));
+
+    /* Holding the sensing context stops the replay */
+    TEST_CHECK(radar_sensing_context_lock());
+    events = callback_count;
+    TEST_CHECK(events < REPLAY_MAX_EVENTS);
+    if (events > REPLAY_MAX_EVENTS)
+    {
+        events = REPLAY_MAX_EVENTS;
+    }
+
+    /* Wait until every record reached the broker or was dropped on the way */
+    while ((unaccounted(events) > 0u) && (waited_ms < REPLAY_TIMEOUT_MS))
+    {
+        sleep_ms(1u);
+        waited_ms++;
+        collect_deliveries();
+    }
+    radar_event_ring_get_stats(&ring);
+    radar_outbox_get_stats(&outbox);
+
+    for (uint32_t seq = 0u; seq < events; seq++)
+    {
+        once += (delivered[seq] == 1u) ? 1u : 0u;
+        duplicated += (delivered[seq] > 1u) ? 1u : 0u;
+        missing += (delivered[seq] == 0u) ? 1u : 0u;
+        lost += ((delivered[seq] == 0u) && !dropped[seq]) ? 1u : 0u;
+        drops += dropped[seq] ? 1u : 0u;
+    }
+
+    printf("%u events, %u delivered, ring drops %u, outbox drops %u (%u after the failed publish), "
+           "%u replayed (%u resent), %u dropped but delivered, duplicates %u\n",
+           (unsigned)events, (unsigned)delivered_count, (unsigned)ring.dropped, (unsigned)outbox.dropped,
+           (unsigned)(outbox.dropped - before_probe.dropped), (unsigned)outbox.replayed,
+           (unsigned)outbox.resent, (unsigned)(drops - missing), (unsigned)duplicated);
+
+    /* Both outages overflowed the outbox and it was replayed */
+    TEST_CHECK(before_probe.dropped > 0u);
+    TEST_CHECK(outbox.dropped > before_probe.dropped);
+    TEST_CHECK(outbox.replayed > before_probe.replayed);
+
+    /* Every record arrives exactly once as a message of its own, or its drop
+     * is counted. A replay that removed records it did not carry would lose
+     * records nobody dropped. */
+    TEST_CHECK_EQUAL(0u, not_single_event);
+    TEST_CHECK_EQUAL(0u, duplicated);
+    TEST_CHECK_EQUAL(0u, unexpected_seq);
+    TEST_CHECK_EQUAL(0u, lost);
+    TEST_CHECK_EQUAL(ring.dropped + outbox.dropped, drops);
+    TEST_CHECK_EQUAL(events, once + missing);
+    TEST_CHECK_EQUAL(0u, loopback_broker_protocol_errors());
+
+    radar_sensing_context_unlock();
+}
+
+int main(void)
+{
+    TEST_RUN(test_replay_after_outage);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
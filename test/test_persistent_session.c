@@ -0,0 +1,226 @@
+/******************************************************************************
+ * File Name:   test_persistent_session.c
+ *
+ * Description: Test of the persistent MQTT session against the loopback
+ *   broker. The application connects with the clean session flag cleared and a
+ *   client identifier derived from the silicon unique ID. QoS 1 configuration
+ *   messages sent while the device is offline must be delivered after the
+ *   reconnection, and the subscription must survive a broker that lost the
+ *   session.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_boot.h"
+#include "host_port.h"
+#include "loopback_broker.h"
+#include "mqtt_client_config.h"
+#include "mqtt_task.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define SESSION_UNIQUE_ID           (0x0123456789ABCDEFull)
+#define SESSION_TIMEOUT_MS          (30000u)
+
+#if !MQTT_PERSISTENT_SESSION
+#error "test_persistent_session.c needs MQTT_PERSISTENT_SESSION, see test/persistent_session."
+#endif
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static char client_id[MQTT_CLIENT_IDENTIFIER_MAX_LEN + 1];
+static uint32_t next_message;
+static loopback_message_t message;
+
+/* Defined by main.c in the firmware, stopped by the radar task */
+cyhal_timer_t led_blink_timer;
+
+/*******************************************************************************
+ * Function Name: sleep_ms
+ ******************************************************************************/
+static void sleep_ms(uint32_t ms)
+{
+    struct timespec delay = { (time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: expected_client_id
+ ********************************************************************************
+ * Summary:
+ *  Computes the client identifier the device must use: the prefix, then the
+ *  splitmix64 finalizer of the unique ID as base 36 digits, least significant
+ *  first, as many as 'MQTT_CLIENT_IDENTIFIER_MAX_LEN' leaves room for.
+ ******************************************************************************/
+static void expected_client_id(uint64_t unique_id, char *id)
+{
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    size_t prefix_len = strlen(MQTT_CLIENT_IDENTIFIER);
+    uint64_t hash = unique_id;
+
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+
+    strcpy(id, MQTT_CLIENT_IDENTIFIER);
+    for (size_t i = prefix_len; (i < MQTT_CLIENT_IDENTIFIER_MAX_LEN) && (i < (prefix_len + 13u)); i++)
+    {
+        id[i] = digits[hash % 36u];
+        id[i + 1u] = '\0';
+        hash /= 36u;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: wait_for_reply
+ ********************************************************************************
+ * Summary:
+ *  Waits until the device published a reply naming 'key'. The configuration
+ *  task answers an unknown key with '"<key>": invalid entry key.', which
+ *  shows that the message went all the way through the subscription.
+ ******************************************************************************/
+static bool wait_for_reply(const char *key)
+{
+    for (uint32_t waited_ms = 0u; waited_ms < SESSION_TIMEOUT_MS; waited_ms++)
+    {
+        while (loopback_broker_get_published(next_message, &message))
+        {
+            next_message++;
+            message.payload[(message.payload_len < LOOPBACK_PAYLOAD_LENGTH) ?
+                            message.payload_len : (LOOPBACK_PAYLOAD_LENGTH - 1u)] = '\0';
+            if ((strcmp(message.client_id, client_id) == 0) && (strcmp(message.topic, MQTT_PUB_TOPIC) == 0) &&
+                (strstr((const char *)message.payload, key) != NULL) &&
+                (strstr((const char *)message.payload, "invalid entry key") != NULL))
+            {
+                return true;
+            }
+        }
+        sleep_ms(1u);
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: wait_for_connects
+ ********************************************************************************
+ * Summary:
+ *  Waits until the MQTT client task connected 'count' times in total and
+ *  subscribed again.
+ ******************************************************************************/
+static bool wait_for_connects(uint32_t count)
+{
+    reconnect_backoff_stats_t mqtt_stats;
+
+    for (uint32_t waited_ms = 0u; waited_ms < SESSION_TIMEOUT_MS; waited_ms++)
+    {
+        mqtt_task_get_connection_stats(NULL, &mqtt_stats);
+        if ((mqtt_stats.successes >= count) && app_boot_wait(APP_BOOT_BIT(APP_BOOT_SUBSCRIBED), 0) &&
+            (loopback_broker_subscription_count(client_id) == 1u))
+        {
+            return true;
+        }
+        sleep_ms(1u);
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: inject_config
+ ******************************************************************************/
+static uint32_t inject_config(const char *key)
+{
+    char payload[64];
+
+    snprintf(payload, sizeof(payload), "{\"%s\":\"1\"}", key);
+    return loopback_broker_inject(MQTT_SUB_TOPIC, payload, strlen(payload), CY_MQTT_QOS1);
+}
+
+static void test_persistent_session(void)
+{
+    loopback_broker_reset();
+    host_set_unique_id(SESSION_UNIQUE_ID);
+    expected_client_id(SESSION_UNIQUE_ID, client_id);
+
+    /* A fresh persistent session: clean session flag cleared, the client
+     * identifier of this device */
+    app_boot_init();
+    TEST_CHECK(pdPASS == xTaskCreate(mqtt_client_task, "MQTT Client task", MQTT_CLIENT_TASK_STACK_SIZE, NULL,
+                                     MQTT_CLIENT_TASK_PRIORITY, NULL));
+    TEST_CHECK(wait_for_connects(1u));
+    TEST_CHECK(!connection_info.clean_session);
+    TEST_CHECK_EQUAL(MQTT_CLIENT_IDENTIFIER_MAX_LEN, strlen(client_id));
+    TEST_CHECK_EQUAL(strlen(client_id), connection_info.client_id_len);
+    TEST_CHECK(strncmp(connection_info.client_id, client_id, connection_info.client_id_len) == 0);
+    TEST_CHECK(!loopback_broker_session_present());
+
+    TEST_CHECK_EQUAL(1u, inject_config("online_key"));
+    TEST_CHECK(wait_for_reply("online_key"));
+
+    /* While the device is offline the broker keeps the session with its
+     * subscription and queues the QoS 1 messages. The first reconnection
+     * fails so that the device stays offline for a while. */
+    loopback_broker_fail_connects(1u);
+    loopback_broker_drop_clients();
+    TEST_CHECK_EQUAL(1u, loopback_broker_subscription_count(client_id));
+    TEST_CHECK_EQUAL(1u, inject_config("queued_key_1"));
+    TEST_CHECK_EQUAL(1u, inject_config("queued_key_2"));
+
+    /* The reconnection finds the session, the queued messages arrive */
+    TEST_CHECK(wait_for_connects(2u));
+    TEST_CHECK(loopback_broker_session_present());
+    TEST_CHECK(wait_for_reply("queued_key_1"));
+    TEST_CHECK(wait_for_reply("queued_key_2"));
+    TEST_CHECK_EQUAL(1u, loopback_broker_subscription_count(client_id));
+
+    /* A broker that lost the session: the device subscribes again, the
+     * subscription is restored without the flag of a present session */
+    loopback_broker_fail_connects(1u);
+    loopback_broker_drop_clients();
+    loopback_broker_expire_sessions();
+    TEST_CHECK_EQUAL(0u, loopback_broker_subscription_count(client_id));
+    TEST_CHECK(wait_for_connects(3u));
+    TEST_CHECK(!loopback_broker_session_present());
+    TEST_CHECK_EQUAL(1u, inject_config("restored_key"));
+    TEST_CHECK(wait_for_reply("restored_key"));
+
+    TEST_CHECK_EQUAL(0u, loopback_broker_protocol_errors());
+}
+
+int main(void)
+{
+    TEST_RUN(test_persistent_session);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
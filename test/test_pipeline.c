@@ -0,0 +1,264 @@
+/******************************************************************************
+ * File Name:   test_pipeline.c
+ *
+ * Description: End-to-end test of the application on the host. The MQTT client
+ *   task brings up every other task, the simulated radar replays
+ *   test/traces/pipeline.trace, and the events travel through the sensing
+ *   callback, the event ring and the publisher to the loopback broker. The
+ *   test reports the events per second and the latency from the sensing
+ *   callback to the PUBACK.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_boot.h"
+#include "host_port.h"
+#include "loopback_broker.h"
+#include "mqtt_client_config.h"
+#include "mqtt_task.h"
+#include "radar_event_ring.h"
+#include "radar_outbox.h"
+#include "radar_sim.h"
+#include "radar_task.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Events replayed before the radar is stopped */
+#define PIPELINE_EVENTS             (4000u)
+/* The replay may overshoot by one radar_sim_process() call */
+#define PIPELINE_MAX_EVENTS         (PIPELINE_EVENTS + RADAR_SIM_MAX_EVENTS_PER_PROCESS)
+#define PIPELINE_TIMEOUT_MS         (30000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Time of every sensing callback, indexed like the sequence numbers */
+static uint64_t callback_us[PIPELINE_MAX_EVENTS];
+static volatile uint32_t callback_count;
+static mtb_radar_sensing_callback_t app_callback;
+
+/* Deliveries per sequence number and their callback to PUBACK latency */
+static uint32_t delivered[PIPELINE_MAX_EVENTS];
+static uint64_t latency_us[PIPELINE_MAX_EVENTS];
+static uint32_t latency_count;
+static uint32_t unexpected_seq;
+static uint64_t last_delivery_us;
+
+static loopback_message_t message;
+
+/* Defined by main.c in the firmware, stopped by the radar task */
+cyhal_timer_t led_blink_timer;
+
+void __real_radar_sim_init(mtb_radar_sensing_callback_t callback, void *data);
+
+/*******************************************************************************
+ * Function Name: timed_callback
+ ********************************************************************************
+ * Summary:
+ *  Takes the time of a simulated event and hands it to the sensing callback of
+ *  the radar task. The debounce stage is off by default, so the n-th event
+ *  becomes the record with sequence number n.
+ ******************************************************************************/
+static void timed_callback(mtb_radar_sensing_context_t *context, mtb_radar_sensing_event_t event,
+                           mtb_radar_sensing_event_info_t *event_info, void *data)
+{
+    uint32_t index = callback_count;
+
+    if (index < PIPELINE_MAX_EVENTS)
+    {
+        callback_us[index] = host_time_us();
+    }
+    callback_count = index + 1u;
+    app_callback(context, event, event_info, data);
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_radar_sim_init
+ ********************************************************************************
+ * Summary:
+ *  Puts timed_callback() between the simulated radar and the radar task.
+ ******************************************************************************/
+void __wrap_radar_sim_init(mtb_radar_sensing_callback_t callback, void *data)
+{
+    app_callback = callback;
+    __real_radar_sim_init(timed_callback, data);
+}
+
+/*******************************************************************************
+ * Function Name: sleep_ms
+ ******************************************************************************/
+static void sleep_ms(uint32_t ms)
+{
+    struct timespec delay = { (time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: collect_deliveries
+ ********************************************************************************
+ * Summary:
+ *  Reads the radar event messages the broker received since the last call and
+ *  counts every sequence number they hold, single records or replayed arrays.
+ *
+ * Parameters:
+ *  next: index of the first broker message not read yet, updated
+ ******************************************************************************/
+static void collect_deliveries(uint32_t *next)
+{
+    while (loopback_broker_get_published(*next, &message))
+    {
+        const char *cursor = (const char *)message.payload;
+
+        (*next)++;
+        message.payload[(message.payload_len < LOOPBACK_PAYLOAD_LENGTH) ?
+                        message.payload_len : (LOOPBACK_PAYLOAD_LENGTH - 1u)] = '\0';
+        if (strcmp(message.topic, MQTT_PUB_TOPIC) != 0)
+        {
+            continue;
+        }
+
+        while ((cursor = strstr(cursor, "\"Seq\":")) != NULL)
+        {
+            unsigned long seq = strtoul(cursor + 6, NULL, 10);
+
+            cursor += 6;
+            if (seq >= PIPELINE_MAX_EVENTS)
+            {
+                unexpected_seq++;
+                continue;
+            }
+            if (delivered[seq]++ == 0u)
+            {
+                latency_us[latency_count++] = message.time_us - callback_us[seq];
+            }
+            last_delivery_us = message.time_us;
+        }
+    }
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void test_trace_to_broker(void)
+{
+    radar_event_ring_stats_t ring;
+    radar_outbox_stats_t outbox;
+    uint32_t next = 0u;
+    uint32_t events;
+    uint32_t once = 0u;
+    uint32_t duplicated = 0u;
+    uint32_t missing = 0u;
+    uint32_t waited_ms = 0u;
+    double seconds;
+
+    TEST_CHECK(radar_sim_load(RADAR_TRACE_DIR "/pipeline.trace"));
+
+    loopback_broker_reset();
+    app_boot_init();
+    TEST_CHECK(pdPASS == xTaskCreate(mqtt_client_task, "MQTT Client task", MQTT_CLIENT_TASK_STACK_SIZE, NULL,
+                                     MQTT_CLIENT_TASK_PRIORITY, NULL));
+
+    while ((callback_count < PIPELINE_EVENTS) && (waited_ms < PIPELINE_TIMEOUT_MS))
+    {
+        sleep_ms(1u);
+        waited_ms++;
+        collect_deliveries(&next);
+    }
+
+    /* Holding the sensing context stops the replay */
+    TEST_CHECK(radar_sensing_context_lock());
+    events = callback_count;
+    TEST_CHECK(events >= PIPELINE_EVENTS);
+    TEST_CHECK(events <= PIPELINE_MAX_EVENTS);
+    if (events > PIPELINE_MAX_EVENTS)
+    {
+        events = PIPELINE_MAX_EVENTS;
+    }
+
+    /* Wait until every record reached the broker or was dropped on the way */
+    for (;;)
+    {
+        collect_deliveries(&next);
+        radar_event_ring_get_stats(&ring);
+        radar_outbox_get_stats(&outbox);
+        if (((latency_count + ring.dropped + outbox.dropped) >= events) || (waited_ms >= PIPELINE_TIMEOUT_MS))
+        {
+            break;
+        }
+        sleep_ms(1u);
+        waited_ms++;
+    }
+
+    for (uint32_t seq = 0u; seq < events; seq++)
+    {
+        once += (delivered[seq] == 1u) ? 1u : 0u;
+        duplicated += (delivered[seq] > 1u) ? 1u : 0u;
+        missing += (delivered[seq] == 0u) ? 1u : 0u;
+    }
+
+    qsort(latency_us, latency_count, sizeof(latency_us[0]), compare_u64);
+    seconds = (double)(last_delivery_us - callback_us[0]) / 1000000.0;
+    printf("%u events, %u delivered in %.3f s: %.0f events/s\n",
+           (unsigned)events, (unsigned)latency_count, seconds, (seconds > 0.0) ? latency_count / seconds : 0.0);
+    if (latency_count > 0u)
+    {
+        printf("callback to PUBACK: p50 %llu us, p99 %llu us, max %llu us\n",
+               (unsigned long long)latency_us[latency_count / 2u],
+               (unsigned long long)latency_us[(latency_count * 99u) / 100u],
+               (unsigned long long)latency_us[latency_count - 1u]);
+    }
+    printf("ring drops %u, outbox drops %u, duplicates %u\n",
+           (unsigned)ring.dropped, (unsigned)outbox.dropped, (unsigned)duplicated);
+
+    /* Every record arrives exactly once, or its drop is counted */
+    TEST_CHECK_EQUAL(0u, duplicated);
+    TEST_CHECK_EQUAL(0u, unexpected_seq);
+    TEST_CHECK_EQUAL(missing, ring.dropped + outbox.dropped);
+    TEST_CHECK_EQUAL(events, once + missing);
+    TEST_CHECK(once > 0u);
+    TEST_CHECK_EQUAL(0u, loopback_broker_protocol_errors());
+
+    radar_sensing_context_unlock();
+}
+
+int main(void)
+{
+    TEST_RUN(test_trace_to_broker);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
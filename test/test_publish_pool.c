@@ -0,0 +1,248 @@
+/******************************************************************************
+ * File Name:   test_publish_pool.c
+ *
+ * Description: Checks the publish workers against the loopback broker: the
+ *   number  *   of publishes waiting for a PUBACK reaches the window, failed
+ *   publishes  *   are retried as new PUBLISH packets without the DUP flag,
+ *   and stopping  *   the pool waits for the publishes in progress.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mqtt_client_config.h"
+#include "mqtt_task.h"
+#include "publish_pool.h"
+
+#include "loopback_broker.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_TOPIC                  "test/pool"
+#define COLLECT_TIMEOUT_MS          (5000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Provided by mqtt_task.c in the application */
+cy_mqtt_t mqtt_connection;
+
+static uint8_t network_buffer[CY_MQTT_MIN_NETWORK_BUFFER_SIZE];
+static volatile uint32_t done_count;
+
+/*******************************************************************************
+ * Function Name: job_done
+ ********************************************************************************
+ * Summary:
+ *  Counts the finished jobs, like the notification of publisher_task.c.
+ ******************************************************************************/
+static void job_done(void)
+{
+    __atomic_add_fetch(&done_count, 1u, __ATOMIC_SEQ_CST);
+}
+
+/*******************************************************************************
+ * Function Name: submit_jobs
+ ********************************************************************************
+ * Summary:
+ *  Fills and submits 'count' jobs with a short payload.
+ ******************************************************************************/
+static void submit_jobs(uint32_t count)
+{
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        publish_job_t *job = publish_pool_acquire();
+
+        TEST_CHECK(job != NULL);
+        if (job == NULL)
+        {
+            return;
+        }
+        job->topic = TEST_TOPIC;
+        job->payload_len = (size_t)sprintf((char *)job->payload, "{\"job\":%u}", (unsigned)i);
+        publish_pool_submit(job);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: collect_jobs
+ ********************************************************************************
+ * Summary:
+ *  Collects and releases 'count' finished jobs.
+ *
+ * Return:
+ *  uint32_t: number of jobs that were acknowledged
+ ******************************************************************************/
+static uint32_t collect_jobs(uint32_t count)
+{
+    uint32_t acknowledged = 0u;
+
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        publish_job_t *job = publish_pool_collect(pdMS_TO_TICKS(COLLECT_TIMEOUT_MS));
+
+        TEST_CHECK(job != NULL);
+        if (job == NULL)
+        {
+            break;
+        }
+        acknowledged += (job->result == CY_RSLT_SUCCESS) ? 1u : 0u;
+        publish_pool_release(job);
+    }
+
+    return acknowledged;
+}
+
+static void test_setup(void)
+{
+    cy_mqtt_connect_info_t connect_info = { 0 };
+
+    (void)cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL, NULL, NULL, &mqtt_connection);
+    connect_info.client_id = "device";
+    connect_info.client_id_len = 6u;
+    connect_info.clean_session = true;
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, cy_mqtt_connect(mqtt_connection, &connect_info));
+
+    TEST_CHECK(publish_pool_init(job_done));
+}
+
+static void test_window(void)
+{
+    publish_pool_stats_t stats;
+
+    /* Every worker holds its publish until the PUBACK */
+    loopback_broker_set_publish_delay_ms(100u);
+    submit_jobs(MQTT_PUB_INFLIGHT_WINDOW);
+    TEST_CHECK(publish_pool_acquire() == NULL);
+    TEST_CHECK_EQUAL(MQTT_PUB_INFLIGHT_WINDOW, collect_jobs(MQTT_PUB_INFLIGHT_WINDOW));
+    loopback_broker_set_publish_delay_ms(0u);
+
+    TEST_CHECK_EQUAL(MQTT_PUB_INFLIGHT_WINDOW, loopback_broker_max_concurrent_publishes());
+    TEST_CHECK_EQUAL(MQTT_PUB_INFLIGHT_WINDOW, loopback_broker_published_count());
+    /* A worker queues its job before it calls the callback */
+    for (uint32_t i = 0u; (i < 100u) && (done_count < MQTT_PUB_INFLIGHT_WINDOW); i++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1u));
+    }
+    TEST_CHECK_EQUAL(MQTT_PUB_INFLIGHT_WINDOW, done_count);
+
+    publish_pool_get_stats(&stats);
+    TEST_CHECK_EQUAL(MQTT_PUB_INFLIGHT_WINDOW, stats.acknowledged);
+    TEST_CHECK_EQUAL(MQTT_PUB_INFLIGHT_WINDOW, stats.inflight_high_water);
+    TEST_CHECK_EQUAL(0u, stats.inflight);
+}
+
+static void test_retry_without_dup(void)
+{
+    publish_pool_stats_t stats_before;
+    publish_pool_stats_t stats;
+    loopback_message_t message;
+    uint32_t published = loopback_broker_published_count();
+    publish_job_t *job;
+
+    publish_pool_get_stats(&stats_before);
+    loopback_broker_fail_publishes(PUBLISH_POOL_RETRY_LIMIT);
+    submit_jobs(1u);
+
+    job = publish_pool_collect(pdMS_TO_TICKS(COLLECT_TIMEOUT_MS));
+    TEST_CHECK(job != NULL);
+    if (job != NULL)
+    {
+        TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, job->result);
+        TEST_CHECK_EQUAL(PUBLISH_POOL_RETRY_LIMIT + 1u, job->attempts);
+        publish_pool_release(job);
+    }
+
+    publish_pool_get_stats(&stats);
+    TEST_CHECK_EQUAL(stats_before.retries + PUBLISH_POOL_RETRY_LIMIT, stats.retries);
+    TEST_CHECK_EQUAL(published + 1u, loopback_broker_published_count());
+    TEST_CHECK(loopback_broker_get_published(published, &message));
+    TEST_CHECK(!message.dup);
+    TEST_CHECK_EQUAL(0u, loopback_broker_protocol_errors());
+}
+
+static void test_retry_limit(void)
+{
+    publish_pool_stats_t stats_before;
+    publish_pool_stats_t stats;
+
+    publish_pool_get_stats(&stats_before);
+    loopback_broker_fail_publishes(PUBLISH_POOL_RETRY_LIMIT + 1u);
+    submit_jobs(1u);
+    TEST_CHECK_EQUAL(0u, collect_jobs(1u));
+
+    publish_pool_get_stats(&stats);
+    TEST_CHECK_EQUAL(stats_before.failed + 1u, stats.failed);
+    TEST_CHECK_EQUAL(0u, loopback_broker_protocol_errors());
+}
+
+static void test_stop_joins_workers(void)
+{
+    publish_pool_stats_t stats;
+    uint32_t published = loopback_broker_published_count();
+
+    /* Stop while every worker waits for a PUBACK */
+    loopback_broker_set_publish_delay_ms(200u);
+    submit_jobs(MQTT_PUB_INFLIGHT_WINDOW);
+    vTaskDelay(pdMS_TO_TICKS(50u));
+    publish_pool_stop();
+
+    /* All publishes ended before publish_pool_stop() returned */
+    publish_pool_get_stats(&stats);
+    TEST_CHECK_EQUAL(0u, stats.inflight);
+    TEST_CHECK_EQUAL(published + MQTT_PUB_INFLIGHT_WINDOW, loopback_broker_published_count());
+    for (uint32_t i = 0u; i < MQTT_PUB_INFLIGHT_WINDOW; i++)
+    {
+        publish_job_t *job = publish_pool_collect(0u);
+
+        TEST_CHECK(job != NULL);
+        if (job != NULL)
+        {
+            publish_pool_release(job);
+        }
+    }
+
+    /* No worker takes jobs any more */
+    loopback_broker_set_publish_delay_ms(0u);
+    submit_jobs(1u);
+    vTaskDelay(pdMS_TO_TICKS(100u));
+    TEST_CHECK(publish_pool_collect(0u) == NULL);
+    TEST_CHECK_EQUAL(published + MQTT_PUB_INFLIGHT_WINDOW, loopback_broker_published_count());
+}
+
+int main(void)
+{
+    TEST_RUN(test_setup);
+    TEST_RUN(test_window);
+    TEST_RUN(test_retry_without_dup);
+    TEST_RUN(test_retry_limit);
+    TEST_RUN(test_stop_joins_workers);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
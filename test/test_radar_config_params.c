@@ -0,0 +1,271 @@
+/******************************************************************************
+ * File Name:   test_radar_config_params.c
+ *
+ * Description: Tests of the configuration key registry: lookup, validation,
+ *   mode  *   filtering and staged commits.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "publisher_task.h"
+#include "radar_config_params.h"
+#include "radar_counter.h"
+#include "radar_store.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+QueueHandle_t publisher_task_q;
+
+/* Library and store stand-ins, record what the registry hands over */
+static char last_library_key[64];
+static char last_library_value[RADAR_CONFIG_VALUE_LENGTH];
+static uint32_t library_calls;
+static bool library_fails;
+
+static char stored_value[RADAR_CONFIG_VALUE_LENGTH];
+static uint16_t stored_key;
+static uint32_t store_puts;
+static uint32_t store_notifies;
+
+mtb_radar_sensing_result_t mtb_radar_sensing_set_parameter(mtb_radar_sensing_context_t *context,
+                                                           const char *key, const char *value)
+{
+    (void)context;
+    snprintf(last_library_key, sizeof(last_library_key), "%s", key);
+    snprintf(last_library_value, sizeof(last_library_value), "%s", value);
+    library_calls++;
+    return library_fails ? MTB_RADAR_SENSING_BAD_PARAM : MTB_RADAR_SENSING_SUCCESS;
+}
+
+uint16_t radar_store_key(const char *name, size_t name_length)
+{
+    uint16_t key = 0u;
+
+    for (size_t i = 0; i < name_length; i++)
+    {
+        key = (uint16_t)((key * 31u) + (uint8_t)name[i]);
+    }
+    return key;
+}
+
+bool radar_store_get(uint16_t key, char *value, size_t value_size)
+{
+    if ((store_puts == 0u) || (key != stored_key))
+    {
+        return false;
+    }
+    snprintf(value, value_size, "%s", stored_value);
+    return true;
+}
+
+void radar_store_put(uint16_t key, const char *value)
+{
+    stored_key = key;
+    snprintf(stored_value, sizeof(stored_value), "%s", value);
+    store_puts++;
+}
+
+void radar_store_notify(void)
+{
+    store_notifies++;
+}
+
+/*******************************************************************************
+ * Function Name: find
+ ********************************************************************************
+ * Summary:
+ *  Looks up a null terminated key.
+ ******************************************************************************/
+static const radar_config_param_t *find(const char *name)
+{
+    return radar_config_param_find(name, strlen(name));
+}
+
+static void test_find(void)
+{
+    static const char *const keys[] = {
+        "radar_counter_ceiling_height", "radar_counter_entrance_width", "radar_counter_in_number",
+        "radar_counter_installation", "radar_counter_min_person_height", "radar_counter_orientation",
+        "radar_counter_out_number", "radar_counter_reverse", "radar_counter_sensitivity",
+        "radar_counter_traffic_light_zone", "radar_debounce_dwell_ms", "radar_debounce_holdoff_ms",
+        "radar_debounce_suppress", "radar_diag_latency", "radar_presence_range_max",
+        "radar_presence_sensitivity",
+    };
+    static const char *const misses[] = {
+        "", "a", "radar", "radar_counter", "radar_counter_in_numbe", "radar_counter_in_numberx",
+        "radar_presence_range_max ", "Radar_presence_range_max", "zzz",
+    };
+
+    radar_config_params_init();
+
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+    {
+        const radar_config_param_t *param = find(keys[i]);
+
+        TEST_CHECK((param != NULL) && (strcmp(param->name, keys[i]) == 0));
+    }
+    for (size_t i = 0; i < sizeof(misses) / sizeof(misses[0]); i++)
+    {
+        TEST_CHECK(find(misses[i]) == NULL);
+    }
+
+    /* Keys come from a JSON buffer and are not null terminated */
+    TEST_CHECK(radar_config_param_find("radar_diag_latency\"", 18u) == find("radar_diag_latency"));
+    TEST_CHECK(radar_config_param_find("radar_diag_latency\"", 19u) == NULL);
+}
+
+static void test_validate(void)
+{
+    const radar_config_param_t *range = find("radar_presence_range_max");
+    const radar_config_param_t *sensitivity = find("radar_presence_sensitivity");
+    const radar_config_param_t *count = find("radar_counter_in_number");
+
+    TEST_CHECK(radar_config_param_validate(range, "0.66"));
+    TEST_CHECK(radar_config_param_validate(range, "1.5"));
+    TEST_CHECK(radar_config_param_validate(range, "10.2"));
+    TEST_CHECK(!radar_config_param_validate(range, "0.65"));
+    TEST_CHECK(!radar_config_param_validate(range, "11"));
+    TEST_CHECK(!radar_config_param_validate(range, "1.5x"));
+    TEST_CHECK(!radar_config_param_validate(range, ""));
+
+    TEST_CHECK(radar_config_param_validate(sensitivity, "low"));
+    TEST_CHECK(radar_config_param_validate(sensitivity, "high"));
+    TEST_CHECK(!radar_config_param_validate(sensitivity, "High"));
+    TEST_CHECK(!radar_config_param_validate(sensitivity, "highest"));
+    TEST_CHECK(!radar_config_param_validate(sensitivity, ""));
+
+    TEST_CHECK(radar_config_param_validate(count, "0"));
+    TEST_CHECK(radar_config_param_validate(count, "12"));
+    TEST_CHECK(radar_config_param_validate(count, "2147483647"));
+    TEST_CHECK(!radar_config_param_validate(count, "2147483648"));
+    TEST_CHECK(!radar_config_param_validate(count, "99999999999"));
+    TEST_CHECK(!radar_config_param_validate(count, "-1"));
+    TEST_CHECK(!radar_config_param_validate(count, "12a"));
+    TEST_CHECK(!radar_config_param_validate(count, ""));
+}
+
+static void test_modes(void)
+{
+    /* Built for presence detection, see RADAR_ENTRANCE_COUNTER_MODE */
+    TEST_CHECK(radar_config_param_is_active(find("radar_presence_range_max")));
+    TEST_CHECK(radar_config_param_is_active(find("radar_debounce_dwell_ms")));
+    TEST_CHECK(radar_config_param_is_active(find("radar_diag_latency")));
+    TEST_CHECK(!radar_config_param_is_active(find("radar_counter_in_number")));
+    TEST_CHECK(!radar_config_param_is_active(find("radar_counter_sensitivity")));
+}
+
+static void test_stage_commit(void)
+{
+    static radar_config_stage_t stage;
+    radar_counter_snapshot_t snapshot;
+
+    radar_config_stage_reset(&stage);
+    TEST_CHECK(radar_config_stage_add(&stage, find("radar_presence_range_max"), "2.5"));
+    TEST_CHECK(radar_config_stage_add(&stage, find("radar_counter_in_number"), "7"));
+    TEST_CHECK(radar_config_stage_add(&stage, find("radar_debounce_dwell_ms"), "100"));
+    /* A repeated key keeps its last value */
+    TEST_CHECK(radar_config_stage_add(&stage, find("radar_presence_range_max"), "3.5"));
+    TEST_CHECK_EQUAL(3, stage.count);
+
+    library_calls = 0u;
+    store_puts = 0u;
+    store_notifies = 0u;
+    TEST_CHECK_EQUAL(0, radar_config_stage_commit(&stage, NULL));
+    TEST_CHECK_EQUAL(1, library_calls);
+    TEST_CHECK(strcmp(last_library_key, "radar_presence_range_max") == 0);
+    TEST_CHECK(strcmp(last_library_value, "3.5") == 0);
+    TEST_CHECK(stage.entries[0].applied && stage.entries[1].applied && stage.entries[2].applied);
+
+    radar_counter_get_snapshot(&snapshot);
+    TEST_CHECK_EQUAL(7, snapshot.in);
+
+    /* Library and debounce values are kept, the entrance counters are not */
+    TEST_CHECK_EQUAL(2, store_puts);
+    TEST_CHECK_EQUAL(radar_store_key("radar_debounce_dwell_ms", 23u), stored_key);
+    TEST_CHECK(strcmp(stored_value, "100") == 0);
+    TEST_CHECK_EQUAL(1, store_notifies);
+
+    /* A value the library refuses is reported and not kept */
+    radar_config_stage_reset(&stage);
+    TEST_CHECK(radar_config_stage_add(&stage, find("radar_presence_sensitivity"), "high"));
+    library_fails = true;
+    store_puts = 0u;
+    TEST_CHECK_EQUAL(1, radar_config_stage_commit(&stage, NULL));
+    TEST_CHECK(!stage.entries[0].applied);
+    TEST_CHECK_EQUAL(0, store_puts);
+    library_fails = false;
+}
+
+static void test_stage_full(void)
+{
+    static radar_config_stage_t stage;
+    static const char *const keys[] = {
+        "radar_counter_ceiling_height", "radar_counter_entrance_width", "radar_counter_min_person_height",
+        "radar_counter_sensitivity", "radar_counter_traffic_light_zone", "radar_presence_range_max",
+    };
+
+    /* Every key fits at once, a key repeated does not take a new entry */
+    radar_config_stage_reset(&stage);
+    for (uint32_t i = 0; i < RADAR_CONFIG_STAGE_SIZE; i++)
+    {
+        TEST_CHECK(radar_config_stage_add(&stage, find(keys[i % 6u]), "0.7"));
+    }
+    TEST_CHECK_EQUAL(6, stage.count);
+
+    /* The stage holds at most RADAR_CONFIG_STAGE_SIZE distinct keys */
+    stage.count = RADAR_CONFIG_STAGE_SIZE;
+    TEST_CHECK(!radar_config_stage_add(&stage, find("radar_diag_latency"), "report"));
+    TEST_CHECK(radar_config_stage_add(&stage, find(keys[0]), "1.0"));
+}
+
+static void test_restore(void)
+{
+    static radar_config_stage_t stage;
+
+    /* A persistent value put by a commit comes back at boot */
+    radar_config_stage_reset(&stage);
+    TEST_CHECK(radar_config_stage_add(&stage, find("radar_debounce_holdoff_ms"), "250"));
+    TEST_CHECK_EQUAL(0, radar_config_stage_commit(&stage, NULL));
+    TEST_CHECK_EQUAL(1, radar_config_params_restore(NULL));
+
+    /* A stored value that became invalid is rejected */
+    snprintf(stored_value, sizeof(stored_value), "%s", "-5");
+    TEST_CHECK_EQUAL(0, radar_config_params_restore(NULL));
+}
+
+int main(void)
+{
+    TEST_RUN(test_find);
+    TEST_RUN(test_validate);
+    TEST_RUN(test_modes);
+    TEST_RUN(test_stage_commit);
+    TEST_RUN(test_stage_full);
+    TEST_RUN(test_restore);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * File Name:   test_radar_counter.c
+ *
+ * Description: Stress test of the entrance counters: two tasks count people in
+ *   *   and out across the 32-bit boundary while a third reads snapshots and
+ *   *   checks that every snapshot holds both totals of a single update.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_counter.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define UPDATES                 (1000000u)
+
+/* Start of both totals, the updates carry them into the high word */
+#define START_TOTAL             (0xFFFFFFF0ull)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static volatile uint32_t writers_done;
+static volatile bool reader_done;
+
+/* Results of the reader */
+static uint32_t reads;
+static uint32_t errors;
+static radar_counter_snapshot_t last;
+
+/*******************************************************************************
+ * Function Name: sleep_us
+ ******************************************************************************/
+static void sleep_us(uint32_t us)
+{
+    struct timespec delay = { (time_t)(us / 1000000u), (long)(us % 1000000u) * 1000L };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: writer
+ ********************************************************************************
+ * Summary:
+ *  Radar task stand-in: counts UPDATES people in or out.
+ ******************************************************************************/
+static void writer(void *arg)
+{
+    void (*add)(void) = (void (*)(void))arg;
+
+    for (uint32_t i = 0u; i < UPDATES; i++)
+    {
+        add();
+    }
+
+    taskENTER_CRITICAL();
+    writers_done++;
+    taskEXIT_CRITICAL();
+    vTaskDelete(NULL);
+}
+
+/*******************************************************************************
+ * Function Name: reader
+ ********************************************************************************
+ * Summary:
+ *  Publisher stand-in: reads snapshots until both writers are done. Every
+ *  update changes one total by one and the update count, so a snapshot of a
+ *  single update satisfies seq == first seq + the changes of both totals.
+ ******************************************************************************/
+static void reader(void *arg)
+{
+    radar_counter_snapshot_t first;
+    radar_counter_snapshot_t snapshot;
+
+    (void)arg;
+    radar_counter_get_snapshot(&first);
+    last = first;
+    while (writers_done < 2u)
+    {
+        radar_counter_get_snapshot(&snapshot);
+        reads++;
+
+        if ((snapshot.in < last.in) || (snapshot.out < last.out) || (snapshot.seq < last.seq) ||
+            (snapshot.in > (START_TOTAL + UPDATES)) || (snapshot.out > (START_TOTAL + UPDATES)) ||
+            ((snapshot.seq - first.seq) != ((snapshot.in - first.in) + (snapshot.out - first.out))) ||
+            (snapshot.occupancy != 0u && snapshot.occupancy != (snapshot.in - snapshot.out)))
+        {
+            errors++;
+        }
+        last = snapshot;
+    }
+
+    reader_done = true;
+    vTaskDelete(NULL);
+}
+
+static void test_concurrent_updates(void)
+{
+    radar_counter_snapshot_t snapshot;
+
+    radar_counter_set_in(START_TOTAL);
+    radar_counter_set_out(START_TOTAL);
+
+    (void)xTaskCreate(reader, "Reader", 1024u, NULL, 2u, NULL);
+    (void)xTaskCreate(writer, "Writer in", 1024u, (void *)radar_counter_add_in, 3u, NULL);
+    (void)xTaskCreate(writer, "Writer out", 1024u, (void *)radar_counter_add_out, 3u, NULL);
+    while (!reader_done)
+    {
+        sleep_us(1000u);
+    }
+
+    printf("%u snapshots during %u updates\n", (unsigned)reads, 2u * UPDATES);
+    TEST_CHECK(reads > 0u);
+    TEST_CHECK_EQUAL(0u, errors);
+
+    radar_counter_get_snapshot(&snapshot);
+    TEST_CHECK(snapshot.in == (START_TOTAL + UPDATES));
+    TEST_CHECK(snapshot.out == (START_TOTAL + UPDATES));
+    TEST_CHECK(snapshot.occupancy == 0u);
+
+    /* A reset clears both totals in one update */
+    radar_counter_add_in();
+    radar_counter_reset();
+    radar_counter_get_snapshot(&snapshot);
+    TEST_CHECK(snapshot.in == 0u && snapshot.out == 0u);
+}
+
+static void test_format(void)
+{
+    char buffer[RADAR_COUNTER_U64_LENGTH];
+
+    TEST_CHECK_EQUAL(20u, radar_counter_format_u64(UINT64_MAX, buffer, sizeof(buffer)));
+    TEST_CHECK(strcmp(buffer, "18446744073709551615") == 0);
+    TEST_CHECK_EQUAL(10u, radar_counter_format_u64(START_TOTAL + 16u, buffer, sizeof(buffer)));
+    TEST_CHECK(strcmp(buffer, "4294967296") == 0);
+    TEST_CHECK_EQUAL(1u, radar_counter_format_u64(0u, buffer, sizeof(buffer)));
+    TEST_CHECK(strcmp(buffer, "0") == 0);
+    TEST_CHECK_EQUAL(0u, radar_counter_format_u64(12345u, buffer, 5u));
+}
+
+int main(void)
+{
+    TEST_RUN(test_concurrent_updates);
+    TEST_RUN(test_format);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * File Name:   test_radar_debounce.c
+ *
+ * Description: Replays a recorded presence trace of a person at the edge of
+ *   the  *   detection range through the debounce stage. Checks that the
+ *   defaults  *   publish every update unchanged and reports the message
+ *   reduction of the  *   dwell time, the hold-off and the last-value
+ *   suppression.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mtb_radar_sensing.h"
+#include "radar_debounce.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Wake-up period of the radar task without interrupts */
+#define POLL_PERIOD_MS      (100u)
+
+/* End of the replay, after the last update of the trace */
+#define REPLAY_END_MS       (20000u)
+
+#define IN                  (1u)
+#define OUT                 (0u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* One update of the trace */
+typedef struct
+{
+    uint32_t time_ms;
+    uint8_t occupy_status;
+} trace_update_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Presence updates recorded with radar_presence_range_max at the distance of
+ * a person sitting at a desk: flapping until the person leans in, a repeat
+ * after a configuration change, and a short flap when the person leaves. */
+static const trace_update_t trace[] =
+{
+    {     0u, IN  }, {   180u, OUT }, {   310u, IN  }, {   390u, OUT }, {   620u, IN  },
+    {   700u, OUT }, {  1050u, IN  }, {  1290u, OUT }, {  1330u, IN  }, {  1610u, OUT },
+    {  1820u, IN  }, {  1900u, OUT }, {  2240u, IN  }, {  2410u, OUT }, {  2500u, IN  },
+    {  2870u, OUT }, {  3030u, IN  }, {  3120u, OUT }, {  3460u, IN  }, {  3790u, OUT },
+    {  3850u, IN  }, {  4100u, OUT }, {  4420u, IN  }, {  4580u, OUT }, {  4730u, IN  },
+    {  5060u, OUT }, {  5370u, IN  }, {  5440u, OUT }, {  5900u, IN  }, {  9000u, IN  },
+    { 12000u, OUT }, { 12150u, IN  }, { 12300u, OUT },
+};
+
+#define TRACE_LENGTH        (sizeof(trace) / sizeof(trace[0]))
+
+/* Records passed to the publisher by the last replay */
+static radar_event_record_t published[TRACE_LENGTH];
+static uint32_t published_count;
+
+/*******************************************************************************
+ * Function Name: replay
+ ********************************************************************************
+ * Summary:
+ *  Offers the trace to the debounce stage like the radar sensing callback and
+ *  polls it every POLL_PERIOD_MS like the radar task. The sequence number of
+ *  a record is its index in the trace, the timestamp the time it was
+ *  published.
+ ******************************************************************************/
+static void replay(void)
+{
+    radar_event_record_t record = { 0 };
+    radar_event_record_t out;
+    uint32_t next = 0u;
+
+    published_count = 0u;
+    for (uint32_t now_ms = 0u; now_ms <= REPLAY_END_MS; now_ms++)
+    {
+        while ((next < TRACE_LENGTH) && (trace[next].time_ms == now_ms))
+        {
+            record.event = (trace[next].occupy_status == IN) ? MTB_RADAR_SENSING_EVENT_PRESENCE_IN :
+                           MTB_RADAR_SENSING_EVENT_PRESENCE_OUT;
+            record.occupy_status = trace[next].occupy_status;
+            record.seq = next;
+            if (radar_debounce_offer(&record, now_ms, &out))
+            {
+                out.timestamp = now_ms;
+                published[published_count++] = out;
+            }
+            next++;
+        }
+
+        if (((now_ms % POLL_PERIOD_MS) == 0u) && radar_debounce_poll(now_ms, &out))
+        {
+            out.timestamp = now_ms;
+            published[published_count++] = out;
+        }
+    }
+}
+
+static void test_defaults(void)
+{
+    radar_debounce_stats_t stats;
+
+    /* The defaults publish every update when it arrives */
+    replay();
+    TEST_CHECK_EQUAL(TRACE_LENGTH, published_count);
+    for (uint32_t i = 0u; i < published_count; i++)
+    {
+        TEST_CHECK_EQUAL(i, published[i].seq);
+        TEST_CHECK_EQUAL(trace[i].time_ms, published[i].timestamp);
+    }
+
+    radar_debounce_get_stats(&stats);
+    TEST_CHECK_EQUAL(TRACE_LENGTH, stats.offered);
+    TEST_CHECK_EQUAL(TRACE_LENGTH, stats.published);
+    TEST_CHECK_EQUAL(0u, stats.flaps);
+}
+
+static void test_flapping_trace(void)
+{
+    radar_debounce_stats_t before;
+    radar_debounce_stats_t after;
+
+    radar_debounce_set_dwell(500u);
+    radar_debounce_set_holdoff(2000u);
+    radar_debounce_set_suppress(true);
+
+    /* Restart from OUT, the state the defaults replay ended with */
+    radar_debounce_get_stats(&before);
+    replay();
+    radar_debounce_get_stats(&after);
+
+    /* Only the state held after the flapping, once its dwell time passed,
+     * and the final OUT after the short flap are published */
+    TEST_CHECK_EQUAL(2u, published_count);
+    TEST_CHECK_EQUAL(28u, published[0].seq);
+    TEST_CHECK_EQUAL(5900u + 500u, published[0].timestamp);
+    TEST_CHECK_EQUAL(TRACE_LENGTH - 1u, published[1].seq);
+    TEST_CHECK_EQUAL(12300u + 500u, published[1].timestamp);
+
+    TEST_CHECK_EQUAL(TRACE_LENGTH, after.offered - before.offered);
+    TEST_CHECK_EQUAL(published_count, after.published - before.published);
+    TEST_CHECK(after.flaps - before.flaps > 10u);
+
+    printf("Replay of %u updates: %u published, %u flaps, %u repeats\n", (unsigned)TRACE_LENGTH,
+           (unsigned)published_count, (unsigned)(after.flaps - before.flaps),
+           (unsigned)(after.repeats - before.repeats));
+}
+
+int main(void)
+{
+    TEST_RUN(test_defaults);
+    TEST_RUN(test_flapping_trace);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * File Name:   test_radar_event_codec.c
+ *
+ * Description: Round trip and compatibility tests of the binary radar event
+ *   payload format.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "radar_event_codec.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Function Name: records_equal
+ ********************************************************************************
+ * Summary:
+ *  Compares the transmitted fields of two records.
+ ******************************************************************************/
+static bool records_equal(const radar_event_record_t *a, const radar_event_record_t *b)
+{
+    return (a->timestamp == b->timestamp) && (a->count_in == b->count_in) && (a->count_out == b->count_out) &&
+           (a->distance_mm == b->distance_mm) && (a->accuracy_mm == b->accuracy_mm) && (a->event == b->event) &&
+           (a->occupy_status == b->occupy_status) && (a->seq == b->seq);
+}
+
+static void test_round_trip_limits(void)
+{
+    radar_event_record_t in[3] = {
+        { 123456u, 5, -2, 1500u, 100u, 4u, 1u, 7u, 11u, 12u },
+        { 0u, 0, 0, 0u, 0u, 0u, 0u, 0u, 0u, 0u },
+        { 0xFFFFFFFFu, INT32_MAX, INT32_MIN, 0xFFFFu, 0xFFFFu, 0xFFu, 1u, 0xFFFFFFFFu, 0u, 0u },
+    };
+    radar_event_record_t out[3];
+    uint8_t buffer[RADAR_EVENT_CODEC_PAYLOAD_SIZE(3)];
+    size_t length = radar_event_codec_encode(in, 3u, buffer, sizeof(buffer));
+
+    TEST_CHECK_EQUAL(RADAR_EVENT_CODEC_PAYLOAD_SIZE(3), length);
+    TEST_CHECK_EQUAL(RADAR_EVENT_CODEC_SCHEMA_ID, buffer[0]);
+    TEST_CHECK_EQUAL(RADAR_EVENT_CODEC_VERSION, buffer[1]);
+    TEST_CHECK_EQUAL(3, radar_event_codec_decode(buffer, length, out, 3u));
+    for (uint32_t i = 0u; i < 3u; i++)
+    {
+        TEST_CHECK(records_equal(&in[i], &out[i]));
+        /* The latency stamps stay on the device */
+        TEST_CHECK_EQUAL(0u, out[i].callback_ms);
+    }
+
+    /* Little endian on the wire, whatever the host */
+    TEST_CHECK_EQUAL(0x40, buffer[RADAR_EVENT_CODEC_HEADER_SIZE + 0]);
+    TEST_CHECK_EQUAL(0xE2, buffer[RADAR_EVENT_CODEC_HEADER_SIZE + 1]);
+    TEST_CHECK_EQUAL(0x01, buffer[RADAR_EVENT_CODEC_HEADER_SIZE + 2]);
+}
+
+static void test_round_trip_random(void)
+{
+    static radar_event_record_t in[RADAR_EVENT_CODEC_MAX_RECORDS];
+    static radar_event_record_t out[RADAR_EVENT_CODEC_MAX_RECORDS];
+    static uint8_t buffer[RADAR_EVENT_CODEC_PAYLOAD_SIZE(RADAR_EVENT_CODEC_MAX_RECORDS)];
+    uint32_t mismatches = 0u;
+
+    srand(1u);
+    for (uint32_t round = 0u; round < 200u; round++)
+    {
+        uint32_t count = (uint32_t)rand() % (RADAR_EVENT_CODEC_MAX_RECORDS + 1u);
+        size_t length;
+
+        memset(in, 0, sizeof(in));
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            in[i].timestamp = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+            in[i].count_in = (int32_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+            in[i].count_out = (int32_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+            in[i].distance_mm = (uint16_t)rand();
+            in[i].accuracy_mm = (uint16_t)rand();
+            in[i].event = (uint8_t)rand();
+            in[i].occupy_status = (uint8_t)(rand() & 1);
+            in[i].seq = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        }
+
+        length = radar_event_codec_encode(in, count, buffer, sizeof(buffer));
+        if ((length != RADAR_EVENT_CODEC_PAYLOAD_SIZE(count)) ||
+            (radar_event_codec_decode(buffer, length, out, RADAR_EVENT_CODEC_MAX_RECORDS) != (int32_t)count))
+        {
+            mismatches++;
+            continue;
+        }
+
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            mismatches += records_equal(&in[i], &out[i]) ? 0u : 1u;
+        }
+    }
+
+    TEST_CHECK_EQUAL(0u, mismatches);
+}
+
+static void test_other_versions(void)
+{
+    radar_event_record_t in = { 42u, 3, 1, 800u, 50u, 2u, 1u, 99u, 0u, 0u };
+    radar_event_record_t out[2];
+    uint8_t v2[RADAR_EVENT_CODEC_PAYLOAD_SIZE(1)];
+    uint8_t v1[RADAR_EVENT_CODEC_HEADER_SIZE + RADAR_EVENT_CODEC_RECORD_SIZE_V1];
+    uint8_t v3[RADAR_EVENT_CODEC_HEADER_SIZE + (2u * (RADAR_EVENT_CODEC_RECORD_SIZE + 8u))];
+
+    (void)radar_event_codec_encode(&in, 1u, v2, sizeof(v2));
+
+    /* Version 1 records end before the sequence number */
+    memcpy(v1, v2, sizeof(v1));
+    v1[1] = 1u;
+    v1[3] = RADAR_EVENT_CODEC_RECORD_SIZE_V1;
+    TEST_CHECK_EQUAL(1, radar_event_codec_decode(v1, sizeof(v1), out, 2u));
+    TEST_CHECK_EQUAL(800u, out[0].distance_mm);
+    TEST_CHECK_EQUAL(0u, out[0].seq);
+
+    /* A later version with longer records: the appended fields are skipped */
+    memset(v3, 0xEE, sizeof(v3));
+    memcpy(v3, v2, RADAR_EVENT_CODEC_HEADER_SIZE);
+    v3[1] = 3u;
+    v3[2] = 2u;
+    v3[3] = RADAR_EVENT_CODEC_RECORD_SIZE + 8u;
+    for (uint32_t i = 0u; i < 2u; i++)
+    {
+        memcpy(&v3[RADAR_EVENT_CODEC_HEADER_SIZE + (i * (RADAR_EVENT_CODEC_RECORD_SIZE + 8u))],
+               &v2[RADAR_EVENT_CODEC_HEADER_SIZE], RADAR_EVENT_CODEC_RECORD_SIZE);
+    }
+    TEST_CHECK_EQUAL(2, radar_event_codec_decode(v3, sizeof(v3), out, 2u));
+    TEST_CHECK(records_equal(&in, &out[0]));
+    TEST_CHECK(records_equal(&in, &out[1]));
+}
+
+static void test_malformed(void)
+{
+    radar_event_record_t in[2] = { { 1u, 1, 0, 0u, 0u, 0u, 1u, 1u, 0u, 0u }, { 2u, 1, 1, 0u, 0u, 0u, 0u, 2u, 0u, 0u } };
+    radar_event_record_t out[2];
+    uint8_t buffer[RADAR_EVENT_CODEC_PAYLOAD_SIZE(2)];
+    uint8_t copy[sizeof(buffer)];
+    size_t length = radar_event_codec_encode(in, 2u, buffer, sizeof(buffer));
+
+    /* Encoding into a short buffer or of too many records fails */
+    TEST_CHECK_EQUAL(0u, radar_event_codec_encode(in, 2u, buffer, sizeof(buffer) - 1u));
+    TEST_CHECK_EQUAL(0u, radar_event_codec_encode(in, RADAR_EVENT_CODEC_MAX_RECORDS + 1u, NULL, SIZE_MAX));
+
+    TEST_CHECK_EQUAL(-1, radar_event_codec_decode(buffer, RADAR_EVENT_CODEC_HEADER_SIZE - 1u, out, 2u));
+    TEST_CHECK_EQUAL(-1, radar_event_codec_decode(buffer, length - 1u, out, 2u));
+    TEST_CHECK_EQUAL(-1, radar_event_codec_decode(buffer, length, out, 1u));
+
+    memcpy(copy, buffer, length);
+    copy[0] ^= 0xFFu;
+    TEST_CHECK_EQUAL(-1, radar_event_codec_decode(copy, length, out, 2u));
+
+    memcpy(copy, buffer, length);
+    copy[1] = 0u;
+    TEST_CHECK_EQUAL(-1, radar_event_codec_decode(copy, length, out, 2u));
+
+    memcpy(copy, buffer, length);
+    copy[3] = RADAR_EVENT_CODEC_RECORD_SIZE_V1 - 1u;
+    TEST_CHECK_EQUAL(-1, radar_event_codec_decode(copy, length, out, 2u));
+
+    /* An empty payload is valid */
+    TEST_CHECK_EQUAL(RADAR_EVENT_CODEC_HEADER_SIZE, radar_event_codec_encode(in, 0u, buffer, sizeof(buffer)));
+    TEST_CHECK_EQUAL(0, radar_event_codec_decode(buffer, RADAR_EVENT_CODEC_HEADER_SIZE, out, 0u));
+}
+
+int main(void)
+{
+    TEST_RUN(test_round_trip_limits);
+    TEST_RUN(test_round_trip_random);
+    TEST_RUN(test_other_versions);
+    TEST_RUN(test_malformed);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
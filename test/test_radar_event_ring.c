@@ -0,0 +1,226 @@
+/******************************************************************************
+ * File Name:   test_radar_event_ring.c
+ *
+ * Description: Stress test of the radar event ring: a producer task pushes
+ *   10,000 events per second while a consumer task drains the ring like the
+ *   publisher. Checks the ordering, the accounting of drops, and reports the
+ *   queueing latency.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "host_port.h"
+#include "radar_event_ring.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define EVENT_RATE_HZ               (10000u)
+#define EVENT_COUNT                 (10000u)
+#define CONSUMER_BATCH              (8u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static volatile bool producer_done;
+static volatile bool consumer_done;
+static volatile uint32_t consumer_stall_ms;
+
+/* Results of the consumer */
+static uint32_t received;
+static uint32_t order_errors;
+static uint32_t gaps;
+static uint64_t latency_sum_us;
+static uint64_t latency_max_us;
+
+/*******************************************************************************
+ * Function Name: sleep_us
+ ******************************************************************************/
+static void sleep_us(uint32_t us)
+{
+    struct timespec delay = { (time_t)(us / 1000000u), (long)(us % 1000000u) * 1000L };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: producer
+ ********************************************************************************
+ * Summary:
+ *  Radar task stand-in: pushes numbered records at EVENT_RATE_HZ. The
+ *  timestamp field carries the push time in microseconds.
+ ******************************************************************************/
+static void producer(void *arg)
+{
+    uint64_t start_us = host_time_us();
+
+    (void)arg;
+    for (uint32_t seq = 0u; seq < EVENT_COUNT; seq++)
+    {
+        radar_event_record_t record = { 0 };
+        uint64_t due_us = start_us + ((uint64_t)seq * 1000000u) / EVENT_RATE_HZ;
+
+        while (host_time_us() < due_us)
+        {
+            sleep_us(20u);
+        }
+
+        record.seq = seq;
+        record.timestamp = (uint32_t)host_time_us();
+        (void)radar_event_ring_push(&record);
+    }
+
+    producer_done = true;
+    vTaskDelete(NULL);
+}
+
+/*******************************************************************************
+ * Function Name: consumer
+ ********************************************************************************
+ * Summary:
+ *  Publisher task stand-in: pops batches, checks the sequence numbers only
+ *  increase and measures the time each record spent in the ring.
+ ******************************************************************************/
+static void consumer(void *arg)
+{
+    radar_event_record_t records[CONSUMER_BATCH];
+    uint32_t next_seq = 0u;
+
+    (void)arg;
+    while (!producer_done || radar_event_ring_count() > 0u)
+    {
+        uint32_t count = radar_event_ring_pop(records, CONSUMER_BATCH);
+        uint32_t now = (uint32_t)host_time_us();
+
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            uint64_t latency = (uint32_t)(now - records[i].timestamp);
+
+            if (records[i].seq < next_seq)
+            {
+                order_errors++;
+            }
+            gaps += (records[i].seq != next_seq) ? 1u : 0u;
+            next_seq = records[i].seq + 1u;
+
+            latency_sum_us += latency;
+            latency_max_us = (latency > latency_max_us) ? latency : latency_max_us;
+        }
+        received += count;
+
+        if (count == 0u)
+        {
+            sleep_us(50u);
+        }
+
+        if (consumer_stall_ms > 0u)
+        {
+            sleep_us(consumer_stall_ms * 1000u);
+        }
+    }
+
+    consumer_done = true;
+    vTaskDelete(NULL);
+}
+
+/*******************************************************************************
+ * Function Name: run
+ ********************************************************************************
+ * Summary:
+ *  Runs the producer and the consumer until the ring is drained.
+ ******************************************************************************/
+static void run(uint32_t stall_ms, radar_event_ring_stats_t *before, radar_event_ring_stats_t *after)
+{
+    producer_done = false;
+    consumer_done = false;
+    consumer_stall_ms = stall_ms;
+    received = 0u;
+    order_errors = 0u;
+    gaps = 0u;
+    latency_sum_us = 0u;
+    latency_max_us = 0u;
+
+    radar_event_ring_get_stats(before);
+    (void)xTaskCreate(consumer, "Consumer", 1024u, NULL, 2u, NULL);
+    (void)xTaskCreate(producer, "Producer", 1024u, NULL, 3u, NULL);
+    while (!consumer_done)
+    {
+        sleep_us(1000u);
+    }
+    radar_event_ring_get_stats(after);
+}
+
+static void test_drained_ring(void)
+{
+    radar_event_ring_stats_t before;
+    radar_event_ring_stats_t after;
+    uint32_t dropped;
+
+    run(0u, &before, &after);
+    dropped = after.dropped - before.dropped;
+
+    printf("%u events at %u/s: %u received, %u dropped, high water %u/%u, latency avg %.1f us max %llu us\n",
+           EVENT_COUNT, EVENT_RATE_HZ, (unsigned)received, (unsigned)dropped, (unsigned)after.high_water,
+           RADAR_EVENT_RING_LENGTH, (received > 0u) ? (double)latency_sum_us / received : 0.0,
+           (unsigned long long)latency_max_us);
+
+    /* Every record is either delivered in order or counted as dropped */
+    TEST_CHECK_EQUAL(0u, order_errors);
+    TEST_CHECK_EQUAL(EVENT_COUNT, received + dropped);
+    TEST_CHECK_EQUAL(received, after.pushed - before.pushed);
+    TEST_CHECK(after.high_water <= RADAR_EVENT_RING_LENGTH);
+}
+
+static void test_stalled_consumer(void)
+{
+    radar_event_ring_stats_t before;
+    radar_event_ring_stats_t after;
+    uint32_t dropped;
+
+    /* A consumer stalled for 10 ms per batch cannot keep up with 10k/s */
+    run(10u, &before, &after);
+    dropped = after.dropped - before.dropped;
+
+    printf("stalled consumer: %u received, %u dropped in %u gaps\n", (unsigned)received, (unsigned)dropped,
+           (unsigned)gaps);
+
+    TEST_CHECK_EQUAL(0u, order_errors);
+    TEST_CHECK(dropped > 0u);
+    TEST_CHECK(gaps > 0u);
+    TEST_CHECK_EQUAL(EVENT_COUNT, received + dropped);
+    TEST_CHECK_EQUAL(RADAR_EVENT_RING_LENGTH, after.high_water);
+}
+
+int main(void)
+{
+    TEST_RUN(test_drained_ring);
+    TEST_RUN(test_stalled_consumer);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,255 @@
+/******************************************************************************
+ * File Name:   test_radar_irq.c
+ *
+ * Description: Simulated FIFO-ready interrupts of the radar, handled by the
+ *   real radar_task() with a fake RadarSensing library: checks that the
+ *   handler of radar_irq.c chains to the callback the library registered on
+ *   the pin, and measures the wake-ups per second and the interrupt to
+ *   processing latency.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_boot.h"
+#include "host_port.h"
+#include "mtb_radar_sensing.h"
+#include "radar_irq.h"
+#include "radar_task.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define IRQ_PULSES                  (2000u)
+#define IRQ_PERIOD_US               (500u)
+#define START_TIMEOUT_MS            (5000u)
+
+/* Bounds of the interrupt to processing latency. The host schedules the
+ * threads of the tasks freely, so they only catch a task that misses
+ * interrupts or is woken by its idle timeout. */
+#define LATENCY_AVG_LIMIT_US        (2000u)
+#define LATENCY_MAX_LIMIT_US        (RADAR_IRQ_IDLE_TIMEOUT_MS * 1000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Callback the fake RadarSensing library registers on the IRQ pin */
+static cyhal_gpio_callback_data_t library_cb_data;
+static volatile uint32_t library_calls;
+static volatile uint32_t library_calls_before_notify;
+
+/* Rising edges of the IRQ line and the time of the last one */
+static volatile uint32_t edges;
+static volatile uint64_t edge_us;
+/* Periods in which the FIFO was still full, so no edge was raised */
+static uint32_t overruns;
+
+static volatile uint32_t process_calls;
+static volatile uint32_t irq_wakeups;
+static volatile uint64_t latency_sum_us;
+static volatile uint64_t latency_max_us;
+
+/* Defined by main.c in the firmware, stopped by the radar task */
+cyhal_timer_t led_blink_timer;
+
+/*******************************************************************************
+ * Function Name: library_handler
+ ********************************************************************************
+ * Summary:
+ *  Counts the calls of the library callback and checks it runs before the
+ *  radar task is notified.
+ ******************************************************************************/
+static void library_handler(void *callback_arg, cyhal_gpio_event_t event)
+{
+    (void)callback_arg;
+    (void)event;
+
+    if (radar_irq_count() == library_calls)
+    {
+        library_calls_before_notify++;
+    }
+    library_calls++;
+}
+
+/*******************************************************************************
+ * Fake RadarSensing library. Like the real one, it takes the IRQ pin in
+ * mtb_radar_sensing_init(), and processing reads the FIFO, which releases the
+ * IRQ line. It records the latency from the rising edge.
+ ******************************************************************************/
+mtb_radar_sensing_result_t mtb_radar_sensing_init(mtb_radar_sensing_context_t *context,
+                                                  mtb_radar_sensing_hw_cfg_t *hw_cfg,
+                                                  mtb_radar_sensing_mask_t mask)
+{
+    library_cb_data.callback = library_handler;
+    library_cb_data.callback_arg = NULL;
+    cyhal_gpio_register_callback(hw_cfg->irq, &library_cb_data);
+    cyhal_gpio_enable_event(hw_cfg->irq, CYHAL_GPIO_IRQ_RISE, RADAR_IRQ_PRIORITY, true);
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+mtb_radar_sensing_result_t mtb_radar_sensing_register_callback(mtb_radar_sensing_context_t *context,
+                                                               mtb_radar_sensing_callback_t callback,
+                                                               void *data)
+{
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+mtb_radar_sensing_result_t mtb_radar_sensing_set_parameter(mtb_radar_sensing_context_t *context,
+                                                           const char *key, const char *value)
+{
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+const char *mtb_radar_sensing_get_parameter(mtb_radar_sensing_context_t *context, const char *key)
+{
+    return "";
+}
+
+mtb_radar_sensing_result_t mtb_radar_sensing_enable(mtb_radar_sensing_context_t *context)
+{
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+mtb_radar_sensing_result_t mtb_radar_sensing_disable(mtb_radar_sensing_context_t *context)
+{
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+mtb_radar_sensing_result_t mtb_radar_sensing_process(mtb_radar_sensing_context_t *context, uint64_t time_ms)
+{
+    process_calls++;
+    if (host_gpio_get(RADAR_IRQ_PIN))
+    {
+        uint64_t latency = host_time_us() - edge_us;
+
+        latency_sum_us += latency;
+        latency_max_us = (latency > latency_max_us) ? latency : latency_max_us;
+        irq_wakeups++;
+        host_gpio_set(RADAR_IRQ_PIN, false);
+    }
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: sleep_us
+ ******************************************************************************/
+static void sleep_us(uint32_t us)
+{
+    struct timespec delay = { (time_t)(us / 1000000u), (long)(us % 1000000u) * 1000L };
+
+    nanosleep(&delay, NULL);
+}
+
+static void test_library_registration_passes_through(void)
+{
+    app_boot_init();
+    TEST_CHECK(pdPASS == xTaskCreate(radar_task, RADAR_TASK_NAME, RADAR_TASK_STACK_SIZE, NULL,
+                                     RADAR_TASK_PRIORITY, &radar_task_handle));
+    TEST_CHECK(app_boot_wait(APP_BOOT_BIT(APP_BOOT_RADAR_READY), pdMS_TO_TICKS(START_TIMEOUT_MS)));
+
+    /* Until the radar task takes the interrupt, the library owns the pin */
+    TEST_CHECK(host_gpio_get_callback(RADAR_IRQ_PIN) == &library_cb_data);
+}
+
+static void test_chained_interrupts(void)
+{
+    radar_acquisition_stats_t stats;
+    uint64_t start_us;
+    uint64_t elapsed_us;
+    uint32_t waited_ms = 0u;
+    double rate;
+
+    /* The radar task takes the interrupt once the publisher is ready */
+    app_boot_signal(APP_BOOT_PUBLISHER_READY);
+    while ((host_gpio_get_callback(RADAR_IRQ_PIN) == &library_cb_data) && (waited_ms++ < START_TIMEOUT_MS))
+    {
+        sleep_us(1000u);
+    }
+
+    /* The handler of radar_irq.c is installed and chains to the library */
+    TEST_CHECK(host_gpio_get_callback(RADAR_IRQ_PIN) != &library_cb_data);
+
+    /* A late registration of the library does not replace it either */
+    cyhal_gpio_register_callback(RADAR_IRQ_PIN, &library_cb_data);
+    TEST_CHECK(host_gpio_get_callback(RADAR_IRQ_PIN) != &library_cb_data);
+
+    library_calls = 0u;
+    library_calls_before_notify = 0u;
+    start_us = host_time_us();
+    for (uint32_t i = 0u; i < IRQ_PULSES; i++)
+    {
+        /* The sensor raises the line when a frame is ready, unless the
+         * previous frame is still waiting in the FIFO */
+        if (host_gpio_get(RADAR_IRQ_PIN))
+        {
+            overruns++;
+        }
+        else
+        {
+            edge_us = host_time_us();
+            edges++;
+            host_gpio_set(RADAR_IRQ_PIN, true);
+        }
+        sleep_us(IRQ_PERIOD_US);
+    }
+    elapsed_us = host_time_us() - start_us;
+    sleep_us(20000u);
+
+    radar_task_get_acquisition_stats(&stats);
+    rate = (double)irq_wakeups * 1000000.0 / (double)elapsed_us;
+    printf("%u frames, %u interrupts, %u wake-ups in %.3f s: %.0f wake-ups/s, latency avg %.1f us max %llu us\n",
+           (unsigned)IRQ_PULSES, (unsigned)stats.irq_count, (unsigned)irq_wakeups, (double)elapsed_us / 1000000.0, rate,
+           (irq_wakeups > 0u) ? (double)latency_sum_us / irq_wakeups : 0.0, (unsigned long long)latency_max_us);
+    printf("radar task: %u processing passes, %u idle timeouts, max latency %u ms, %u frames overran\n",
+           (unsigned)stats.wakeup_count, (unsigned)stats.idle_timeouts, (unsigned)stats.max_irq_latency,
+           (unsigned)overruns);
+
+    TEST_CHECK_EQUAL(IRQ_PULSES, edges + overruns);
+    TEST_CHECK_EQUAL(edges, library_calls);
+    TEST_CHECK_EQUAL(edges, library_calls_before_notify);
+    TEST_CHECK_EQUAL(edges, stats.irq_count);
+
+    /* Every interrupt woke the task, which read the FIFO once */
+    TEST_CHECK_EQUAL(edges, irq_wakeups);
+    TEST_CHECK(!radar_irq_pending());
+    TEST_CHECK_EQUAL(process_calls, stats.wakeup_count);
+    TEST_CHECK(stats.wakeup_count >= irq_wakeups);
+    TEST_CHECK(stats.wakeup_count <= (irq_wakeups + stats.idle_timeouts + 1u));
+    TEST_CHECK(overruns < (IRQ_PULSES / 10u));
+
+    TEST_CHECK((latency_sum_us / irq_wakeups) < LATENCY_AVG_LIMIT_US);
+    TEST_CHECK(latency_max_us < LATENCY_MAX_LIMIT_US);
+}
+
+int main(void)
+{
+    TEST_RUN(test_library_registration_passes_through);
+    TEST_RUN(test_chained_interrupts);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,212 @@
+/******************************************************************************
+ * File Name:   test_radar_latency.c
+ *
+ * Description: Tests of the latency histograms: percentiles against the exact
+ *   *   values, the diagnostics JSON and concurrent recording.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_latency.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define SAMPLE_COUNT        (5000u)
+#define RECORDER_TASKS      (4u)
+#define SAMPLES_PER_TASK    (20000u)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Bucket bounds of radar_latency.c, a percentile reports the bound above it */
+static const uint32_t bucket_limits[RADAR_LATENCY_BUCKETS] =
+{
+    1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, UINT32_MAX
+};
+
+static volatile uint32_t recorders_done;
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+ * Function Name: bucket_bound
+ ********************************************************************************
+ * Summary:
+ *  Value a percentile summary should report for an exact percentile.
+ ******************************************************************************/
+static uint32_t bucket_bound(uint32_t exact, uint32_t max)
+{
+    uint32_t i = 0;
+
+    while (exact > bucket_limits[i])
+    {
+        i++;
+    }
+    return (bucket_limits[i] < max) ? bucket_limits[i] : max;
+}
+
+static void test_percentiles(void)
+{
+    static uint32_t samples[SAMPLE_COUNT];
+    radar_latency_summary_t summary;
+
+    srand(9);
+    for (uint32_t round = 0; round < 20u; round++)
+    {
+        uint32_t count = 1u + ((uint32_t)rand() % SAMPLE_COUNT);
+
+        radar_latency_reset();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            /* Mostly short, with a long tail */
+            samples[i] = ((rand() % 50) == 0) ? (uint32_t)(rand() % 20000) : (uint32_t)(rand() % 30);
+            radar_latency_record(RADAR_LATENCY_PUBLISH, samples[i]);
+        }
+        qsort(samples, count, sizeof(samples[0]), compare_u32);
+
+        radar_latency_get_summary(RADAR_LATENCY_PUBLISH, &summary);
+        TEST_CHECK_EQUAL(count, summary.count);
+        TEST_CHECK_EQUAL(samples[count - 1u], summary.max);
+        TEST_CHECK_EQUAL(bucket_bound(samples[((count * 50u) + 99u) / 100u - 1u], summary.max), summary.p50);
+        TEST_CHECK_EQUAL(bucket_bound(samples[((count * 99u) + 99u) / 100u - 1u], summary.max), summary.p99);
+    }
+
+    /* Two slow samples in a hundred make the p99, one does not */
+    radar_latency_reset();
+    for (uint32_t i = 0; i < 100u; i++)
+    {
+        radar_latency_record(RADAR_LATENCY_PUBLISH, (i < 98u) ? 3u : 700u);
+    }
+    radar_latency_get_summary(RADAR_LATENCY_PUBLISH, &summary);
+    TEST_CHECK_EQUAL(5, summary.p50);
+    TEST_CHECK_EQUAL(700, summary.p99);
+
+    radar_latency_reset();
+    for (uint32_t i = 0; i < 100u; i++)
+    {
+        radar_latency_record(RADAR_LATENCY_PUBLISH, (i < 99u) ? 3u : 700u);
+    }
+    radar_latency_get_summary(RADAR_LATENCY_PUBLISH, &summary);
+    TEST_CHECK_EQUAL(5, summary.p99);
+    TEST_CHECK_EQUAL(700, summary.max);
+
+    /* Stages are independent and empty ones report zeros */
+    radar_latency_get_summary(RADAR_LATENCY_CALLBACK, &summary);
+    TEST_CHECK_EQUAL(0, summary.count);
+    TEST_CHECK_EQUAL(0, summary.p50);
+    TEST_CHECK_EQUAL(0, summary.max);
+}
+
+static void test_format(void)
+{
+    char buffer[512];
+    size_t length;
+
+    radar_latency_reset();
+    radar_latency_record(RADAR_LATENCY_CALLBACK, 1u);
+    radar_latency_record(RADAR_LATENCY_END_TO_END, 9000u);
+
+    length = radar_latency_format(buffer, sizeof(buffer));
+    TEST_CHECK_EQUAL(strlen(buffer), length);
+    TEST_CHECK(strncmp(buffer, "{\"latency_ms\":{\"callback\":{\"n\":1,\"p50\":1,\"p99\":1,\"max\":1},", 58) == 0);
+    TEST_CHECK(strstr(buffer, "\"end_to_end\":{\"n\":1,\"p50\":9000,\"p99\":9000,\"max\":9000}}}") != NULL);
+    TEST_CHECK_EQUAL('}', buffer[length - 1u]);
+
+    /* Every buffer that is too short fails instead of truncating */
+    for (size_t size = 0; size <= length; size++)
+    {
+        TEST_CHECK_EQUAL(0, radar_latency_format(buffer, size));
+    }
+    TEST_CHECK_EQUAL(length, radar_latency_format(buffer, length + 1u));
+
+    /* The dump must not touch the histograms */
+    radar_latency_dump();
+    TEST_CHECK_EQUAL(length, radar_latency_format(buffer, sizeof(buffer)));
+}
+
+/*******************************************************************************
+ * Function Name: recorder_task
+ ********************************************************************************
+ * Summary:
+ *  Records a fixed number of samples into the publish stage.
+ ******************************************************************************/
+static void recorder_task(void *arg)
+{
+    uint32_t latency = (uint32_t)(uintptr_t)arg;
+
+    for (uint32_t i = 0; i < SAMPLES_PER_TASK; i++)
+    {
+        radar_latency_record(RADAR_LATENCY_PUBLISH, latency);
+    }
+    taskENTER_CRITICAL();
+    recorders_done++;
+    taskEXIT_CRITICAL();
+    vTaskDelete(NULL);
+}
+
+static void test_concurrent(void)
+{
+    radar_latency_summary_t summary;
+
+    radar_latency_reset();
+    recorders_done = 0u;
+    for (uint32_t i = 0; i < RECORDER_TASKS; i++)
+    {
+        TEST_CHECK(xTaskCreate(recorder_task, "recorder", 1024u, (void *)(uintptr_t)(i * 100u),
+                               1u, NULL) == pdPASS);
+    }
+    while (recorders_done < RECORDER_TASKS)
+    {
+        vTaskDelay(1u);
+    }
+
+    /* No sample is lost or torn between count, bucket and maximum */
+    radar_latency_get_summary(RADAR_LATENCY_PUBLISH, &summary);
+    TEST_CHECK_EQUAL(RECORDER_TASKS * SAMPLES_PER_TASK, summary.count);
+    TEST_CHECK_EQUAL((RECORDER_TASKS - 1u) * 100u, summary.max);
+    TEST_CHECK_EQUAL(100, summary.p50);
+}
+
+int main(void)
+{
+    TEST_RUN(test_percentiles);
+    TEST_RUN(test_format);
+    TEST_RUN(test_concurrent);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,281 @@
+/******************************************************************************
+ * File Name:   test_radar_led_task.c
+ *
+ * Description: Checks the LED pattern timing of the radar LED task on the host
+ *   GPIO  *   port: the counter blink sequences have the configured number of
+ *   blinks  *   and step durations without accumulated drift, the traffic
+ *   light colors  *   follow presence events, unchanged pins are not written,
+ *   and the task  *   does not wake up while no pattern runs.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "cybsp.h"
+#include "radar_led_task.h"
+
+#include "host_port.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define LED_RED_PIN                 (CYBSP_GPIOA0)
+#define LED_GREEN_PIN               (CYBSP_GPIOA1)
+#define LED_BLUE_PIN                (CYBSP_GPIOA2)
+
+/* Blink sequences of radar_led_task.c, in ms */
+#define COUNTER_IN_PERIOD_MS        (40u)
+#define COUNTER_IN_ON_MS            (4u)
+#define COUNTER_IN_BLINKS           (7u)
+#define COUNTER_OUT_PERIOD_MS       (100u)
+#define COUNTER_OUT_ON_MS           (4u)
+#define COUNTER_OUT_BLINKS          (4u)
+
+/* Steps are timed in ticks of 1 ms, so an edge may come up to one tick
+ * early; a host thread may also be scheduled late */
+#define EARLY_TOLERANCE_US          (1000u)
+#define LATE_TOLERANCE_US           (5000u)
+
+#define MAX_WRITES                  (128u)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef struct
+{
+    cyhal_gpio_t pin;
+    bool value;
+    uint64_t time_us;
+} gpio_write_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static gpio_write_t writes[MAX_WRITES];
+static volatile uint32_t write_count;
+
+/*******************************************************************************
+ * Function Name: log_write
+ ********************************************************************************
+ * Summary:
+ *  Records every GPIO write with its time.
+ ******************************************************************************/
+static void log_write(cyhal_gpio_t pin, bool value)
+{
+    uint32_t index = __atomic_fetch_add(&write_count, 1u, __ATOMIC_SEQ_CST);
+
+    if (index < MAX_WRITES)
+    {
+        writes[index].pin = pin;
+        writes[index].value = value;
+        writes[index].time_us = host_time_us();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: wait_idle
+ ********************************************************************************
+ * Summary:
+ *  Waits until no GPIO was written for 'quiet_ms'.
+ ******************************************************************************/
+static void wait_idle(uint32_t quiet_ms)
+{
+    uint32_t count;
+
+    do
+    {
+        count = write_count;
+        vTaskDelay(pdMS_TO_TICKS(quiet_ms));
+    } while (count != write_count);
+}
+
+/*******************************************************************************
+ * Function Name: check_blinks
+ ********************************************************************************
+ * Summary:
+ *  Checks the writes logged since 'first' against a blink sequence of the
+ *  base color on 'pin' requested at 'start_us': the LED is on for 'on_ms'
+ *  every 'period_ms', 'blinks' times, and stays on afterwards. The base color
+ *  is already on, so a period writes the pin off and then on again. Every
+ *  edge is measured from the request, a drift of the steps would add up.
+ ******************************************************************************/
+static void check_blinks(uint32_t first, uint64_t start_us, cyhal_gpio_t pin, uint32_t blinks, uint32_t on_ms,
+                         uint32_t period_ms)
+{
+    TEST_CHECK_EQUAL(first + (2u * blinks), write_count);
+    if (write_count != first + (2u * blinks))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0u; i < blinks; i++)
+    {
+        const gpio_write_t *off = &writes[first + (2u * i)];
+        const gpio_write_t *on = &writes[first + (2u * i) + 1u];
+        uint64_t off_at_us = start_us + ((((uint64_t)i * period_ms) + on_ms) * 1000u);
+        uint64_t on_at_us = start_us + ((uint64_t)(i + 1u) * period_ms * 1000u);
+
+        TEST_CHECK_EQUAL(pin, off->pin);
+        TEST_CHECK_EQUAL(pin, on->pin);
+        TEST_CHECK(!off->value);
+        TEST_CHECK(on->value);
+
+        TEST_CHECK(off->time_us + EARLY_TOLERANCE_US >= off_at_us);
+        TEST_CHECK(off->time_us < off_at_us + LATE_TOLERANCE_US);
+        TEST_CHECK(on->time_us + EARLY_TOLERANCE_US >= on_at_us);
+        TEST_CHECK(on->time_us < on_at_us + LATE_TOLERANCE_US);
+    }
+}
+
+static void test_setup(void)
+{
+    host_gpio_set_write_hook(log_write);
+    radar_led_init();
+    TEST_CHECK(pdPASS == xTaskCreate(radar_led_task, RADAR_LED_TASK_NAME, RADAR_LED_TASK_STACK_SIZE, NULL,
+                                     RADAR_LED_TASK_PRIORITY, &radar_led_task_handle));
+    vTaskDelay(pdMS_TO_TICKS(20u));
+
+    /* No color is shown before the first presence event */
+    TEST_CHECK_EQUAL(0u, write_count);
+}
+
+static void test_traffic_light(void)
+{
+    radar_led_stats_t stats;
+    uint32_t first;
+
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_PRESENCE_IN);
+    wait_idle(20u);
+    TEST_CHECK_EQUAL(1u, write_count);
+    TEST_CHECK_EQUAL(LED_RED_PIN, writes[0].pin);
+    TEST_CHECK(writes[0].value);
+
+    /* Red off, green on */
+    first = write_count;
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_PRESENCE_OUT);
+    wait_idle(20u);
+    TEST_CHECK_EQUAL(first + 2u, write_count);
+    TEST_CHECK(!host_gpio_get(LED_RED_PIN));
+    TEST_CHECK(host_gpio_get(LED_GREEN_PIN));
+    TEST_CHECK(!host_gpio_get(LED_BLUE_PIN));
+
+    /* Repeating the color writes nothing */
+    first = write_count;
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_FREE);
+    wait_idle(20u);
+    TEST_CHECK_EQUAL(first, write_count);
+
+    radar_led_get_stats(&stats);
+    TEST_CHECK_EQUAL(3u, stats.wakeups);
+    TEST_CHECK_EQUAL(write_count, stats.pin_writes);
+}
+
+static void test_counter_in_timing(void)
+{
+    radar_led_stats_t before;
+    radar_led_stats_t after;
+    uint32_t first = write_count;
+    uint64_t start_us;
+
+    radar_led_get_stats(&before);
+    start_us = host_time_us();
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_IN);
+    vTaskDelay(pdMS_TO_TICKS((COUNTER_IN_PERIOD_MS * COUNTER_IN_BLINKS) + 50u));
+    radar_led_get_stats(&after);
+
+    /* Green goes dark between the pulses, then stays on */
+    check_blinks(first, start_us, LED_GREEN_PIN, COUNTER_IN_BLINKS, COUNTER_IN_ON_MS, COUNTER_IN_PERIOD_MS);
+    TEST_CHECK(host_gpio_get(LED_GREEN_PIN));
+
+    /* One wake-up for the command and one per step, none afterwards */
+    TEST_CHECK_EQUAL(before.wakeups + 1u + (2u * COUNTER_IN_BLINKS), after.wakeups);
+    vTaskDelay(pdMS_TO_TICKS(100u));
+    radar_led_get_stats(&before);
+    TEST_CHECK_EQUAL(after.wakeups, before.wakeups);
+}
+
+static void test_counter_out_timing(void)
+{
+    uint32_t first;
+    uint64_t start_us;
+
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED);
+    wait_idle(20u);
+    first = write_count;
+
+    start_us = host_time_us();
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_OUT);
+    vTaskDelay(pdMS_TO_TICKS((COUNTER_OUT_PERIOD_MS * COUNTER_OUT_BLINKS) + 50u));
+
+    check_blinks(first, start_us, LED_RED_PIN, COUNTER_OUT_BLINKS, COUNTER_OUT_ON_MS, COUNTER_OUT_PERIOD_MS);
+    TEST_CHECK(host_gpio_get(LED_RED_PIN));
+}
+
+static void test_restart_and_color_change(void)
+{
+    uint32_t first = write_count;
+    uint64_t start_us;
+    uint64_t end_us;
+
+    /* A color change during a sequence applies to the following pulses */
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_IN);
+    vTaskDelay(pdMS_TO_TICKS(COUNTER_IN_PERIOD_MS + 10u));
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_PRESENCE_OUT);
+
+    /* A second counter event restarts the sequence */
+    vTaskDelay(pdMS_TO_TICKS(COUNTER_IN_PERIOD_MS));
+    start_us = host_time_us();
+    radar_led_set_pattern(MTB_RADAR_SENSING_EVENT_COUNTER_IN);
+    wait_idle(COUNTER_IN_PERIOD_MS * 2u);
+
+    TEST_CHECK(write_count > first);
+    TEST_CHECK(write_count <= MAX_WRITES);
+    if ((write_count <= first) || (write_count > MAX_WRITES))
+    {
+        return;
+    }
+    end_us = writes[write_count - 1u].time_us;
+    TEST_CHECK(end_us + EARLY_TOLERANCE_US >= start_us + (COUNTER_IN_PERIOD_MS * COUNTER_IN_BLINKS * 1000u));
+    TEST_CHECK(end_us < start_us + (COUNTER_IN_PERIOD_MS * COUNTER_IN_BLINKS * 1000u) + LATE_TOLERANCE_US);
+
+    /* Pulses use green now and end with green on */
+    TEST_CHECK_EQUAL(LED_GREEN_PIN, writes[write_count - 1u].pin);
+    TEST_CHECK(host_gpio_get(LED_GREEN_PIN));
+    TEST_CHECK(!host_gpio_get(LED_RED_PIN));
+}
+
+int main(void)
+{
+    TEST_RUN(test_setup);
+    TEST_RUN(test_traffic_light);
+    TEST_RUN(test_counter_in_timing);
+    TEST_RUN(test_counter_out_timing);
+    TEST_RUN(test_restart_and_color_change);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
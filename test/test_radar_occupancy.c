@@ -0,0 +1,335 @@
+/******************************************************************************
+ * File Name:   test_radar_occupancy.c
+ *
+ * Description: Checks the windowed occupancy summaries against a brute-force
+ *   *   reference: a random trace of radar events, with long gaps and a wrap
+ *   of  *   the 32-bit tick time, is kept in full and every window of a
+ *   summary is  *   recomputed by scanning all events.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "mtb_radar_sensing.h"
+#include "radar_occupancy.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define EVENT_COUNT             (20000u)
+
+/* Gaps between events, every GAP_LONG_PERIOD events one longer than the ring */
+#define GAP_MAX_MS              (20000u)
+#define GAP_LONG_PERIOD         (500u)
+#define GAP_LONG_MAX_MS         (3u * 3600000u)
+
+/* A summary is checked before one in this many events */
+#define CHECK_PERIOD            (50u)
+
+/* Tick time of the first event, the trace wraps the 32-bit time */
+#define START_MS                (UINT32_MAX - (5u * 3600000u))
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* One event of the trace, with the state after it */
+typedef struct
+{
+    uint64_t time_ms;       /* Not wrapped */
+    uint8_t event;
+    uint32_t level;
+} trace_event_t;
+
+/* Sums of one window */
+typedef struct
+{
+    unsigned long span;
+    unsigned long in;
+    unsigned long out;
+    unsigned long peak;
+    unsigned long occ_s;
+    unsigned long dwell[RADAR_OCCUPANCY_DWELL_BINS];
+} window_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static const struct
+{
+    const char *name;
+    uint32_t buckets;
+} windows[] =
+{
+    { "1m", 1u }, { "15m", 15u }, { "1h", 60u }
+};
+
+static const uint32_t dwell_bounds_s[] = RADAR_OCCUPANCY_DWELL_BOUNDS_S;
+
+static trace_event_t trace[EVENT_COUNT];
+static uint32_t trace_length;
+
+static char summary[1024];
+
+/*******************************************************************************
+ * Function Name: is_start
+ ********************************************************************************
+ * Summary:
+ *  Tells whether an event starts an occupied period.
+ ******************************************************************************/
+static bool is_start(uint8_t event)
+{
+    return (event == MTB_RADAR_SENSING_EVENT_COUNTER_OCCUPIED) || (event == MTB_RADAR_SENSING_EVENT_PRESENCE_IN);
+}
+
+/*******************************************************************************
+ * Function Name: is_end
+ ********************************************************************************
+ * Summary:
+ *  Tells whether an event ends an occupied period.
+ ******************************************************************************/
+static bool is_end(uint8_t event)
+{
+    return (event == MTB_RADAR_SENSING_EVENT_COUNTER_FREE) || (event == MTB_RADAR_SENSING_EVENT_PRESENCE_OUT);
+}
+
+/*******************************************************************************
+ * Function Name: reference
+ ********************************************************************************
+ * Summary:
+ *  Computes a window by scanning the whole trace. The buckets start at the
+ *  first event; the window covers the last 'buckets' complete buckets before
+ *  'now_ms', at most the 60 buckets the ring keeps.
+ ******************************************************************************/
+static void reference(uint64_t now_ms, uint32_t buckets, window_t *window)
+{
+    uint64_t origin_ms = trace[0].time_ms;
+    uint64_t current = (now_ms - origin_ms) / RADAR_OCCUPANCY_BUCKET_MS;
+    uint64_t span = (current < buckets) ? current : buckets;
+    uint64_t low_ms = origin_ms + ((current - span) * RADAR_OCCUPANCY_BUCKET_MS);
+    uint64_t high_ms = origin_ms + (current * RADAR_OCCUPANCY_BUCKET_MS);
+    uint64_t occupied_ms = 0u;
+    uint64_t period_start_ms = 0u;
+    uint32_t level = 0u;
+    bool occupied = false;
+
+    memset(window, 0, sizeof(*window));
+    window->span = (unsigned long)span;
+    if (span == 0u)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0u; i < trace_length; i++)
+    {
+        const trace_event_t *e = &trace[i];
+
+        if (e->time_ms >= high_ms)
+        {
+            break;
+        }
+        if (e->time_ms >= low_ms)
+        {
+            /* The level before the event, held at the start of the window */
+            window->peak = (level > window->peak) ? level : window->peak;
+            window->in += ((e->event == MTB_RADAR_SENSING_EVENT_COUNTER_IN) ||
+                           (e->event == MTB_RADAR_SENSING_EVENT_PRESENCE_IN)) ? 1u : 0u;
+            window->out += ((e->event == MTB_RADAR_SENSING_EVENT_COUNTER_OUT) ||
+                            (e->event == MTB_RADAR_SENSING_EVENT_PRESENCE_OUT)) ? 1u : 0u;
+        }
+        level = e->level;
+        if (e->time_ms >= low_ms)
+        {
+            window->peak = (level > window->peak) ? level : window->peak;
+        }
+
+        if (is_start(e->event) && !occupied)
+        {
+            occupied = true;
+            period_start_ms = e->time_ms;
+        }
+        else if (is_end(e->event) && occupied)
+        {
+            uint32_t bin = 0u;
+
+            occupied = false;
+            if (e->time_ms > low_ms)
+            {
+                occupied_ms += e->time_ms - ((period_start_ms > low_ms) ? period_start_ms : low_ms);
+            }
+            if (e->time_ms >= low_ms)
+            {
+                while ((bin < (RADAR_OCCUPANCY_DWELL_BINS - 1u)) &&
+                       (((e->time_ms - period_start_ms) / 1000u) >= dwell_bounds_s[bin]))
+                {
+                    bin++;
+                }
+                window->dwell[bin]++;
+            }
+        }
+    }
+
+    /* No event in the window: the level carried into it */
+    window->peak = (level > window->peak) ? level : window->peak;
+    if (occupied)
+    {
+        occupied_ms += high_ms - ((period_start_ms > low_ms) ? period_start_ms : low_ms);
+    }
+    window->occ_s = (unsigned long)(occupied_ms / 1000u);
+}
+
+/*******************************************************************************
+ * Function Name: parse_window
+ ********************************************************************************
+ * Summary:
+ *  Reads one window of a summary.
+ ******************************************************************************/
+static bool parse_window(const char *json, const char *name, window_t *window)
+{
+    char key[16];
+    const char *member;
+    int fields;
+
+    (void)snprintf(key, sizeof(key), "\"%s\":{", name);
+    member = strstr(json, key);
+    if (member == NULL)
+    {
+        return false;
+    }
+
+    fields = sscanf(member + strlen(key),
+                    "\"span\":%lu,\"in\":%lu,\"out\":%lu,\"in_ph\":%*u,\"out_ph\":%*u,\"peak\":%lu,"
+                    "\"occ_s\":%lu,\"dwell\":[%lu,%lu,%lu,%lu,%lu,%lu,%lu]}",
+                    &window->span, &window->in, &window->out, &window->peak, &window->occ_s,
+                    &window->dwell[0], &window->dwell[1], &window->dwell[2], &window->dwell[3],
+                    &window->dwell[4], &window->dwell[5], &window->dwell[6]);
+
+    return fields == 12;
+}
+
+/*******************************************************************************
+ * Function Name: check_summary
+ ********************************************************************************
+ * Summary:
+ *  Formats a summary at 'now_ms' and compares every window to the reference.
+ ******************************************************************************/
+static void check_summary(uint64_t now_ms)
+{
+    window_t expected;
+    window_t actual;
+
+    TEST_CHECK(radar_occupancy_format(summary, sizeof(summary), (uint32_t)now_ms) > 0u);
+
+    for (uint32_t w = 0u; w < (sizeof(windows) / sizeof(windows[0])); w++)
+    {
+        reference(now_ms, windows[w].buckets, &expected);
+        if (!parse_window(summary, windows[w].name, &actual))
+        {
+            TEST_CHECK(!"window parsed");
+            continue;
+        }
+        if (memcmp(&expected, &actual, sizeof(expected)) != 0)
+        {
+            printf("Window %s at %llu ms: %s\n", windows[w].name, (unsigned long long)now_ms, summary);
+            TEST_CHECK_EQUAL(expected.span, actual.span);
+            TEST_CHECK_EQUAL(expected.in, actual.in);
+            TEST_CHECK_EQUAL(expected.out, actual.out);
+            TEST_CHECK_EQUAL(expected.peak, actual.peak);
+            TEST_CHECK_EQUAL(expected.occ_s, actual.occ_s);
+            for (uint32_t bin = 0u; bin < RADAR_OCCUPANCY_DWELL_BINS; bin++)
+            {
+                TEST_CHECK_EQUAL(expected.dwell[bin], actual.dwell[bin]);
+            }
+        }
+    }
+}
+
+static void test_random_trace(void)
+{
+    uint64_t time_ms = START_MS;
+    uint64_t inside = 0u;
+    uint32_t checks = 0u;
+
+    srand(1u);
+    for (uint32_t i = 0u; i < EVENT_COUNT; i++)
+    {
+        trace_event_t *e = &trace[i];
+        uint64_t gap_ms = (uint64_t)(rand() % GAP_MAX_MS);
+
+        if ((i > 0u) && ((i % GAP_LONG_PERIOD) == 0u))
+        {
+            gap_ms = (uint64_t)(rand() % GAP_LONG_MAX_MS);
+        }
+
+        /* A summary between two events, the last one may be checked late */
+        if ((i > 0u) && ((rand() % CHECK_PERIOD) == 0))
+        {
+            check_summary(time_ms + (uint64_t)(rand() % ((int)gap_ms + 1)));
+            checks++;
+        }
+        time_ms += gap_ms;
+
+        e->time_ms = time_ms;
+        e->event = (uint8_t)(MTB_RADAR_SENSING_EVENT_COUNTER_IN + (rand() % 6));
+        switch (e->event)
+        {
+            case MTB_RADAR_SENSING_EVENT_COUNTER_IN:
+                inside++;
+                break;
+            case MTB_RADAR_SENSING_EVENT_COUNTER_OUT:
+                inside -= (inside > 0u) ? 1u : 0u;
+                break;
+            case MTB_RADAR_SENSING_EVENT_PRESENCE_IN:
+                inside = 1u;
+                break;
+            case MTB_RADAR_SENSING_EVENT_PRESENCE_OUT:
+                inside = 0u;
+                break;
+            default:
+                break;
+        }
+        e->level = (uint32_t)inside;
+        trace_length = i + 1u;
+
+        radar_occupancy_record(e->event, inside, (uint32_t)e->time_ms);
+    }
+
+    check_summary(time_ms + (30u * RADAR_OCCUPANCY_BUCKET_MS) + 1234u);
+    checks++;
+
+    /* The random trace wrapped the tick time and checked every window */
+    TEST_CHECK(time_ms > UINT32_MAX);
+    TEST_CHECK(checks > (EVENT_COUNT / CHECK_PERIOD / 2u));
+}
+
+int main(void)
+{
+    TEST_RUN(test_random_trace);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
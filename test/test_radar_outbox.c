@@ -0,0 +1,290 @@
+/******************************************************************************
+ * File Name:   test_radar_outbox.c
+ *
+ * Description: Unit test of the outbox that keeps radar events while the
+ *   broker is unreachable: wrap-around of the indices, dropping the oldest
+ *   record when full, the bitmap of records sent before, and the removal of a
+ *   replay that lost records to the outbox while it was in flight.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "radar_outbox.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Sequence number of the next record put into the outbox */
+static uint32_t next_seq;
+
+/*******************************************************************************
+ * Function Name: put_records
+ ********************************************************************************
+ * Summary:
+ *  Puts 'count' numbered records into the outbox.
+ ******************************************************************************/
+static void put_records(uint32_t count, bool sent)
+{
+    radar_event_record_t record = { 0 };
+
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        record.seq = next_seq++;
+        radar_outbox_put(&record, sent);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: oldest_seq
+ ********************************************************************************
+ * Summary:
+ *  Returns the sequence number of the oldest record, the outbox must not be
+ *  empty.
+ ******************************************************************************/
+static uint32_t oldest_seq(void)
+{
+    radar_event_record_t record;
+    bool sent;
+
+    TEST_CHECK_EQUAL(1u, radar_outbox_peek(&record, 1u, &sent));
+
+    return record.seq;
+}
+
+/*******************************************************************************
+ * Function Name: empty_outbox
+ ******************************************************************************/
+static void empty_outbox(void)
+{
+    radar_outbox_consume(radar_outbox_count());
+    TEST_CHECK_EQUAL(0u, radar_outbox_count());
+}
+
+static void test_wrap_around(void)
+{
+    radar_event_record_t records[RADAR_OUTBOX_LENGTH];
+    radar_outbox_stats_t before;
+    radar_outbox_stats_t after;
+    uint32_t first = next_seq;
+    uint32_t expected = first;
+    bool sent;
+
+    radar_outbox_get_stats(&before);
+
+    /* Chunks of 40 records move the indices over the end of the array at a
+     * different slot in every round */
+    for (uint32_t round = 0u; round < 2u * RADAR_OUTBOX_LENGTH; round++)
+    {
+        uint32_t count;
+
+        put_records(40u, false);
+        TEST_CHECK_EQUAL(40u, radar_outbox_count());
+
+        /* Peeking does not remove anything, and the records come in order */
+        count = radar_outbox_peek(records, 25u, &sent);
+        TEST_CHECK_EQUAL(25u, count);
+        TEST_CHECK_EQUAL(25u, radar_outbox_peek(records, 25u, &sent));
+        TEST_CHECK(!sent);
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            TEST_CHECK_EQUAL(expected + i, records[i].seq);
+        }
+        radar_outbox_consume(count);
+        expected += count;
+
+        /* Asking for more than is held returns the rest */
+        count = radar_outbox_peek(records, RADAR_OUTBOX_LENGTH, &sent);
+        TEST_CHECK_EQUAL(15u, count);
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            TEST_CHECK_EQUAL(expected + i, records[i].seq);
+        }
+        radar_outbox_consume(count);
+        expected += count;
+        TEST_CHECK_EQUAL(0u, radar_outbox_count());
+    }
+
+    radar_outbox_get_stats(&after);
+    TEST_CHECK_EQUAL(next_seq - first, after.stored - before.stored);
+    TEST_CHECK_EQUAL(next_seq - first, after.replayed - before.replayed);
+    TEST_CHECK_EQUAL(0u, after.dropped - before.dropped);
+    TEST_CHECK_EQUAL(0u, after.resent - before.resent);
+
+    /* Consuming more than is held removes nothing extra */
+    radar_outbox_consume(5u);
+    TEST_CHECK_EQUAL(0u, radar_outbox_count());
+    radar_outbox_get_stats(&before);
+    TEST_CHECK_EQUAL(after.replayed, before.replayed);
+}
+
+static void test_drop_oldest(void)
+{
+    radar_outbox_stats_t before;
+    radar_outbox_stats_t after;
+    uint32_t first = next_seq;
+
+    radar_outbox_get_stats(&before);
+
+    put_records(RADAR_OUTBOX_LENGTH, false);
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH, radar_outbox_count());
+    TEST_CHECK_EQUAL(first, oldest_seq());
+
+    /* Every further record replaces the oldest one */
+    put_records(10u, false);
+    radar_outbox_get_stats(&after);
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH, radar_outbox_count());
+    TEST_CHECK_EQUAL(10u, after.dropped - before.dropped);
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH, after.high_water);
+    TEST_CHECK_EQUAL(first + 10u, oldest_seq());
+
+    /* The newest record is the last one put */
+    radar_outbox_consume(RADAR_OUTBOX_LENGTH - 1u);
+    TEST_CHECK_EQUAL(next_seq - 1u, oldest_seq());
+
+    empty_outbox();
+}
+
+static void test_sent_bitmap(void)
+{
+    radar_event_record_t records[RADAR_OUTBOX_LENGTH];
+    radar_outbox_stats_t before;
+    radar_outbox_stats_t after;
+    bool sent;
+
+    radar_outbox_get_stats(&before);
+
+    /* Three records not sent, one sent, three not sent */
+    put_records(3u, false);
+    put_records(1u, true);
+    put_records(3u, false);
+
+    TEST_CHECK_EQUAL(3u, radar_outbox_peek(records, 3u, &sent));
+    TEST_CHECK(!sent);
+    TEST_CHECK_EQUAL(4u, radar_outbox_peek(records, 4u, &sent));
+    TEST_CHECK(sent);
+
+    radar_outbox_consume(4u);
+    TEST_CHECK_EQUAL(3u, radar_outbox_peek(records, RADAR_OUTBOX_LENGTH, &sent));
+    TEST_CHECK(!sent);
+    radar_outbox_get_stats(&after);
+    TEST_CHECK_EQUAL(1u, after.resent - before.resent);
+    empty_outbox();
+
+    /* A slot that held a sent record loses the mark when it is reused, in
+     * every word of the bitmap */
+    put_records(RADAR_OUTBOX_LENGTH, true);
+    empty_outbox();
+    put_records(RADAR_OUTBOX_LENGTH, false);
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH, radar_outbox_peek(records, RADAR_OUTBOX_LENGTH, &sent));
+    TEST_CHECK(!sent);
+    radar_outbox_get_stats(&before);
+    empty_outbox();
+    radar_outbox_get_stats(&after);
+    TEST_CHECK_EQUAL(0u, after.resent - before.resent);
+
+    /* Dropping the oldest record overwrites its mark as well */
+    put_records(1u, true);
+    put_records(RADAR_OUTBOX_LENGTH - 1u, false);
+    TEST_CHECK_EQUAL(1u, radar_outbox_peek(records, 1u, &sent));
+    TEST_CHECK(sent);
+    put_records(1u, false);
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH, radar_outbox_peek(records, RADAR_OUTBOX_LENGTH, &sent));
+    TEST_CHECK(!sent);
+    empty_outbox();
+}
+
+/*******************************************************************************
+ * Function Name: complete_replay
+ ********************************************************************************
+ * Summary:
+ *  The bookkeeping of complete_replay() in publisher_task.c: of the 'count'
+ *  records a replay carried, those the outbox dropped meanwhile are gone
+ *  already and must not be removed again. The publisher itself is covered
+ *  by test_outbox_replay.c.
+ ******************************************************************************/
+static void complete_replay(uint32_t count, uint32_t outbox_dropped)
+{
+    radar_outbox_stats_t stats;
+    uint32_t lost;
+
+    radar_outbox_get_stats(&stats);
+    lost = stats.dropped - outbox_dropped;
+    if (lost < count)
+    {
+        radar_outbox_consume(count - lost);
+    }
+}
+
+static void test_drop_during_replay(void)
+{
+    radar_event_record_t records[8];
+    radar_outbox_stats_t stats;
+    uint32_t count;
+    bool sent;
+
+    /* Some of the replayed records are dropped while the replay is in flight:
+     * only the rest is removed, the oldest record left is the first one
+     * after the replay */
+    put_records(RADAR_OUTBOX_LENGTH, false);
+    count = radar_outbox_peek(records, 8u, &sent);
+    radar_outbox_get_stats(&stats);
+    put_records(3u, false);
+    complete_replay(count, stats.dropped);
+    TEST_CHECK_EQUAL(records[7].seq + 1u, oldest_seq());
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH - 5u, radar_outbox_count());
+    empty_outbox();
+
+    /* All replayed records and more are dropped: nothing is removed */
+    put_records(RADAR_OUTBOX_LENGTH, false);
+    count = radar_outbox_peek(records, 8u, &sent);
+    radar_outbox_get_stats(&stats);
+    put_records(12u, false);
+    complete_replay(count, stats.dropped);
+    TEST_CHECK_EQUAL(records[0].seq + 12u, oldest_seq());
+    TEST_CHECK_EQUAL(RADAR_OUTBOX_LENGTH, radar_outbox_count());
+    empty_outbox();
+
+    /* Without drops the replay removes exactly its records */
+    put_records(20u, false);
+    count = radar_outbox_peek(records, 8u, &sent);
+    radar_outbox_get_stats(&stats);
+    put_records(2u, false);
+    complete_replay(count, stats.dropped);
+    TEST_CHECK_EQUAL(records[7].seq + 1u, oldest_seq());
+    TEST_CHECK_EQUAL(14u, radar_outbox_count());
+    empty_outbox();
+}
+
+int main(void)
+{
+    TEST_RUN(test_wrap_around);
+    TEST_RUN(test_drop_oldest);
+    TEST_RUN(test_sent_bitmap);
+    TEST_RUN(test_drop_during_replay);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,335 @@
+/******************************************************************************
+ * File Name:   test_radar_store.c
+ *
+ * Description: Power loss emulation of the radar store journal. Every boot
+ *   runs in a child process on a flash image file shared with the parent: it
+ *   restores the values, commits configuration changes through the store
+ *   task, and may lose power in the middle of a flash row. The next boot
+ *   must restore either the last completely written value or the one being
+ *   written, while the slots wrap around the journal many times.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "host_port.h"
+#include "radar_config_params.h"
+#include "radar_store.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define BOOTS                   (400u)
+#define COMMITS_PER_BOOT        (3u)
+
+/* One in this many boots loses power during one of its first row writes */
+#define POWER_LOSS_PERIOD       (3u)
+#define POWER_LOSS_MAX_ROW      (6u)
+
+/* Exit code of a boot that lost power */
+#define EXIT_POWER_LOSS         (3)
+
+/* Values besides the checked key, so that most slots take two rows */
+#define PAD_KEYS                (15u)
+#define PAD_KEY_FIRST           (0x0100u)
+
+#define CHECKED_KEY             "radar_debounce_holdoff_ms"
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+/* State kept by the parent across the boots */
+typedef struct
+{
+    int32_t committed;          /* Value of the last completed commit, -1 before */
+    int32_t in_flight;          /* Value being committed when power was lost */
+    bool power_lost;            /* The last boot lost power */
+    int32_t power_loss_row;     /* Row write of this boot that loses power, -1 for none */
+    uint32_t max_replayed;      /* Longest chain replayed at a boot */
+    uint32_t slots_written;     /* Slots completed over all boots */
+} journal_state_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Provided by the application */
+QueueHandle_t publisher_task_q;
+
+/* Emulated flash and state, shared with the child processes */
+static uint8_t *flash_image;
+static size_t flash_image_size = RADAR_STORE_SLOTS * RADAR_STORE_SLOT_SIZE;
+static journal_state_t *state;
+
+static bool flash_mapped;
+static int32_t row_writes;
+
+/* Stand-ins of the radar sensing library and the diagnostics timer */
+mtb_radar_sensing_result_t mtb_radar_sensing_set_parameter(mtb_radar_sensing_context_t *context,
+                                                           const char *key, const char *value)
+{
+    (void)context;
+    (void)key;
+    (void)value;
+    return MTB_RADAR_SENSING_SUCCESS;
+}
+
+uint32_t radar_diag_timer_read(void)
+{
+    return 0u;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cyhal_flash_read
+ ********************************************************************************
+ * Summary:
+ *  Maps the emulated flash at the address of the journal, which the first
+ *  read of a boot, slot 0, reveals.
+ ******************************************************************************/
+cy_rslt_t __real_cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size);
+
+cy_rslt_t __wrap_cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size)
+{
+    if (!flash_mapped)
+    {
+        host_flash_map(address, flash_image, flash_image_size);
+        flash_mapped = true;
+    }
+
+    return __real_cyhal_flash_read(obj, address, data, size);
+}
+
+/*******************************************************************************
+ * Function Name: power_loss_hook
+ ********************************************************************************
+ * Summary:
+ *  Programs only the start of the chosen row, leaves the rest undefined and
+ *  ends the boot like a reset.
+ ******************************************************************************/
+static bool power_loss_hook(uint32_t address, uint8_t *row, const uint8_t *data)
+{
+    size_t cut;
+
+    (void)address;
+    if (row_writes++ != state->power_loss_row)
+    {
+        return false;
+    }
+
+    cut = (size_t)rand() % CY_FLASH_SIZEOF_ROW;
+    memcpy(row, data, cut);
+    memset(&row[cut], 0xA5, CY_FLASH_SIZEOF_ROW - cut);
+    _exit(EXIT_POWER_LOSS);
+}
+
+/*******************************************************************************
+ * Function Name: slots_written
+ ********************************************************************************
+ * Summary:
+ *  Number of slots the store task completed in this boot.
+ ******************************************************************************/
+static uint32_t slots_written(void)
+{
+    radar_store_stats_t stats;
+
+    radar_store_get_stats(&stats);
+    return stats.appends + stats.checkpoints;
+}
+
+/*******************************************************************************
+ * Function Name: wait_for_slots
+ ********************************************************************************
+ * Summary:
+ *  Waits until the store task completed 'count' slots in this boot.
+ ******************************************************************************/
+static void wait_for_slots(uint32_t count)
+{
+    struct timespec delay = { 0, 100000L };
+
+    while (slots_written() < count)
+    {
+        nanosleep(&delay, NULL);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: boot
+ ********************************************************************************
+ * Summary:
+ *  One power cycle of the device, run in a child process. Checks the
+ *  restored value, then commits COMMITS_PER_BOOT new values. The store task
+ *  writes an append slot per commit and a checkpoint once the chain reaches
+ *  RADAR_STORE_COMPACT_SLOTS slots. Returns the exit code of the boot.
+ ******************************************************************************/
+static int boot(uint32_t index)
+{
+    static radar_config_stage_t stage;
+    const radar_config_param_t *param = radar_config_param_find(CHECKED_KEY, strlen(CHECKED_KEY));
+    radar_store_stats_t stats;
+    char value[RADAR_STORE_VALUE_LENGTH];
+    int32_t restored = -1;
+    uint32_t chain;
+    uint32_t expected = 0u;
+    uint32_t before;
+
+    srand(index);
+    host_tick_set(0u);
+    host_flash_set_write_hook(power_loss_hook);
+
+    radar_store_restore(NULL);
+    radar_store_get_stats(&stats);
+    if (radar_store_get(radar_store_key(CHECKED_KEY, strlen(CHECKED_KEY)), value, sizeof(value)))
+    {
+        restored = atoi(value);
+    }
+
+    /* A value cut by the power loss may or may not have made it */
+    if (state->power_lost && (restored == state->in_flight))
+    {
+        state->committed = restored;
+    }
+    state->power_lost = false;
+    if (restored != state->committed)
+    {
+        printf("Boot %u: restored %d, expected %d\n", (unsigned)index, (int)restored, (int)state->committed);
+        return 1;
+    }
+    /* The configuration key was applied, its store key is unique */
+    if (stats.restored_keys != ((restored >= 0) ? 1u : 0u))
+    {
+        printf("Boot %u: %u values applied\n", (unsigned)index, (unsigned)stats.restored_keys);
+        return 1;
+    }
+    state->max_replayed = (stats.replayed_slots > state->max_replayed) ? stats.replayed_slots : state->max_replayed;
+
+    radar_store_start();
+    chain = stats.replayed_slots;
+    for (uint32_t commit = 0u; commit < COMMITS_PER_BOOT; commit++)
+    {
+        int32_t next = (int32_t)((index * COMMITS_PER_BOOT) + commit);
+
+        for (uint32_t pad = 0u; pad < PAD_KEYS; pad++)
+        {
+            snprintf(value, sizeof(value), "pad-%08d-%02u-..............", (int)next, (unsigned)pad);
+            radar_store_put((uint16_t)(PAD_KEY_FIRST + pad), value);
+        }
+
+        snprintf(value, sizeof(value), "%d", (int)next);
+        radar_config_stage_reset(&stage);
+        (void)radar_config_stage_add(&stage, param, value);
+        state->in_flight = next;
+        (void)radar_config_stage_commit(&stage, NULL);
+
+        /* The append, and a checkpoint when the chain got long enough */
+        before = expected;
+        chain = (chain == 0u) ? 1u : (chain + 1u);
+        expected++;
+        if (chain >= RADAR_STORE_COMPACT_SLOTS)
+        {
+            chain = 1u;
+            expected++;
+        }
+        wait_for_slots(expected);
+        state->committed = next;
+        state->slots_written += expected - before;
+    }
+
+    return 0;
+}
+
+static void test_power_loss(void)
+{
+    uint32_t power_losses = 0u;
+
+    for (uint32_t index = 0u; index < BOOTS; index++)
+    {
+        pid_t child;
+        int status;
+
+        state->power_loss_row = ((index % POWER_LOSS_PERIOD) == 1u) ? (int32_t)(index % POWER_LOSS_MAX_ROW) : -1;
+
+        fflush(stdout);
+        child = fork();
+        if (child == 0)
+        {
+            int code = boot(index);
+
+            fflush(stdout);
+            _exit(code);
+        }
+        TEST_CHECK(waitpid(child, &status, 0) == child);
+        TEST_CHECK(WIFEXITED(status));
+
+        if (WEXITSTATUS(status) == EXIT_POWER_LOSS)
+        {
+            state->power_lost = true;
+            power_losses++;
+            continue;
+        }
+        TEST_CHECK_EQUAL(0, WEXITSTATUS(status));
+        if (WEXITSTATUS(status) != 0)
+        {
+            break;
+        }
+    }
+
+    printf("%u boots, %u power losses, %u slots written, longest replay %u slots\n", (unsigned)BOOTS,
+           (unsigned)power_losses, (unsigned)state->slots_written, (unsigned)state->max_replayed);
+
+    /* Every boot got far enough to commit, and the journal wrapped */
+    TEST_CHECK(power_losses > (BOOTS / POWER_LOSS_PERIOD / 2u));
+    TEST_CHECK(state->slots_written > (20u * RADAR_STORE_SLOTS));
+    TEST_CHECK(state->max_replayed < RADAR_STORE_SLOTS);
+}
+
+int main(void)
+{
+    FILE *flash_file = tmpfile();
+
+    /* The flash image is a file, written through like the flash rows */
+    TEST_CHECK((flash_file != NULL) && (ftruncate(fileno(flash_file), (off_t)flash_image_size) == 0));
+    flash_image = mmap(NULL, flash_image_size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(flash_file), 0);
+    state = mmap(NULL, sizeof(*state), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if ((flash_image == MAP_FAILED) || (state == MAP_FAILED))
+    {
+        printf("Mapping the flash image failed\n");
+        return 1;
+    }
+    state->committed = -1;
+    state->in_flight = -1;
+
+    TEST_RUN(test_power_loss);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
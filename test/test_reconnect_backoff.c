@@ -0,0 +1,216 @@
+/******************************************************************************
+ * File Name:   test_reconnect_backoff.c
+ *
+ * Description: Tests of the reconnection backoff: delay bounds, reset on
+ *   success,  *   give-up time of the configured retry limits and spread
+ *   across a fleet.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mqtt_client_config.h"
+#include "reconnect_backoff.h"
+#include "test_util.h"
+#include "wifi_config.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Give-up time of the former fixed retry intervals, 120 x 5 s and 150 x 2 s */
+#define WIFI_PREVIOUS_GIVE_UP_MS    (600000u)
+#define MQTT_PREVIOUS_GIVE_UP_MS    (300000u)
+
+#define FLEET_SIZE                  (1000u)
+
+/*******************************************************************************
+ * Function Name: cap_after
+ ********************************************************************************
+ * Summary:
+ *  Delay cap after the given number of consecutive failures.
+ ******************************************************************************/
+static uint32_t cap_after(uint32_t failures, uint32_t base_ms, uint32_t max_ms)
+{
+    uint32_t cap = base_ms;
+
+    for (uint32_t i = 0; i < failures; i++)
+    {
+        cap = ((cap * 2u) < max_ms) ? (cap * 2u) : max_ms;
+    }
+    return cap;
+}
+
+static void test_delay_bounds(void)
+{
+    for (uint32_t seed = 0; seed < 100u; seed++)
+    {
+        reconnect_backoff_t backoff;
+
+        reconnect_backoff_init(&backoff, 2000u, 32000u, seed);
+        for (uint32_t i = 0; i < 20u; i++)
+        {
+            uint32_t cap = cap_after(i, 2000u, 32000u);
+            uint32_t delay = reconnect_backoff_failure(&backoff);
+
+            /* "Equal jitter": never below half of the cap, never above it */
+            TEST_CHECK((delay >= (cap / 2u)) && (delay <= cap));
+        }
+    }
+
+    /* A maximum below the base keeps the base */
+    {
+        reconnect_backoff_t backoff;
+
+        reconnect_backoff_init(&backoff, 5000u, 1000u, 1u);
+        for (uint32_t i = 0; i < 5u; i++)
+        {
+            uint32_t delay = reconnect_backoff_failure(&backoff);
+
+            TEST_CHECK((delay >= 2500u) && (delay <= 5000u));
+        }
+    }
+}
+
+static void test_success_resets(void)
+{
+    reconnect_backoff_t backoff;
+    uint32_t total = 0u;
+
+    reconnect_backoff_init(&backoff, 1000u, 64000u, 42u);
+    for (uint32_t i = 0; i < 6u; i++)
+    {
+        reconnect_backoff_attempt(&backoff);
+        total += reconnect_backoff_failure(&backoff);
+    }
+    reconnect_backoff_attempt(&backoff);
+    reconnect_backoff_success(&backoff);
+
+    /* The next failure starts from the base again */
+    reconnect_backoff_attempt(&backoff);
+    total += reconnect_backoff_failure(&backoff);
+    TEST_CHECK(backoff.stats.last_delay_ms <= 1000u);
+
+    TEST_CHECK_EQUAL(8, backoff.stats.attempts);
+    TEST_CHECK_EQUAL(1, backoff.stats.successes);
+    TEST_CHECK_EQUAL(7, backoff.stats.failures);
+    TEST_CHECK_EQUAL(6, backoff.stats.max_failure_run);
+    TEST_CHECK_EQUAL(total, backoff.stats.total_delay_ms);
+}
+
+/*******************************************************************************
+ * Function Name: check_give_up
+ ********************************************************************************
+ * Summary:
+ *  Sums the delays of 'retries' failed attempts for a fleet of devices and
+ *  checks them against the analytic bounds and the former give-up time.
+ ******************************************************************************/
+static void check_give_up(uint32_t retries, uint32_t base_ms, uint32_t max_ms, uint32_t previous_ms)
+{
+    uint32_t lowest = UINT32_MAX;
+    uint32_t highest = 0u;
+    uint32_t bound = 0u;
+
+    for (uint32_t i = 0; i < retries; i++)
+    {
+        bound += cap_after(i, base_ms, max_ms);
+    }
+
+    for (uint32_t device = 0; device < FLEET_SIZE; device++)
+    {
+        reconnect_backoff_t backoff;
+
+        reconnect_backoff_init(&backoff, base_ms, max_ms, (uint32_t)rand());
+        for (uint32_t i = 0; i < retries; i++)
+        {
+            reconnect_backoff_attempt(&backoff);
+            (void)reconnect_backoff_failure(&backoff);
+        }
+        if (backoff.stats.total_delay_ms < lowest)
+        {
+            lowest = backoff.stats.total_delay_ms;
+        }
+        if (backoff.stats.total_delay_ms > highest)
+        {
+            highest = backoff.stats.total_delay_ms;
+        }
+    }
+
+    printf("  %lu retries: gave up after %lu to %lu ms (bound %lu ms, previously %lu ms)\n",
+           (unsigned long)retries, (unsigned long)lowest, (unsigned long)highest,
+           (unsigned long)bound, (unsigned long)previous_ms);
+    TEST_CHECK(lowest >= (bound / 2u) - retries);
+    TEST_CHECK(highest <= bound);
+    TEST_CHECK(bound <= previous_ms);
+}
+
+static void test_give_up_time(void)
+{
+    srand(11);
+    check_give_up(MAX_WIFI_CONN_RETRIES, WIFI_CONN_RETRY_INTERVAL_MS, WIFI_CONN_RETRY_MAX_INTERVAL_MS,
+                  WIFI_PREVIOUS_GIVE_UP_MS);
+    check_give_up(MAX_MQTT_CONN_RETRIES, MQTT_CONN_RETRY_INTERVAL_MS, MQTT_CONN_RETRY_MAX_INTERVAL_MS,
+                  MQTT_PREVIOUS_GIVE_UP_MS);
+}
+
+static void test_fleet_spread(void)
+{
+    static uint32_t histogram[10];
+    reconnect_backoff_t backoff;
+
+    /* Devices losing the same access point retry at different times: the
+     * first MQTT attempt after Wi-Fi came back is spread over the jitter
+     * range, no tenth of it gets more than twice its share.
+     */
+    memset(histogram, 0, sizeof(histogram));
+    for (uint32_t device = 0; device < FLEET_SIZE; device++)
+    {
+        uint32_t delay;
+
+        reconnect_backoff_init(&backoff, MQTT_CONN_RETRY_INTERVAL_MS, MQTT_CONN_RETRY_MAX_INTERVAL_MS,
+                               0xC0FFEE00u + device);
+        delay = reconnect_backoff_jitter(&backoff, MQTT_RECONNECT_JITTER_MS);
+        TEST_CHECK(delay <= MQTT_RECONNECT_JITTER_MS);
+        histogram[(delay * 10u) / (MQTT_RECONNECT_JITTER_MS + 1u)]++;
+    }
+    for (uint32_t i = 0; i < 10u; i++)
+    {
+        TEST_CHECK(histogram[i] <= (2u * FLEET_SIZE) / 10u);
+    }
+
+    /* No jitter range, no delay; a zero seed still yields random delays */
+    reconnect_backoff_init(&backoff, 1000u, 1000u, 0u);
+    TEST_CHECK_EQUAL(0, reconnect_backoff_jitter(&backoff, 0u));
+    TEST_CHECK(reconnect_backoff_jitter(&backoff, 1000000u) != reconnect_backoff_jitter(&backoff, 1000000u));
+}
+
+int main(void)
+{
+    TEST_RUN(test_delay_bounds);
+    TEST_RUN(test_success_resets);
+    TEST_RUN(test_give_up_time);
+    TEST_RUN(test_fleet_spread);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,266 @@
+/******************************************************************************
+ * File Name:   test_subscriber_task.c
+ *
+ * Description: Checks how the subscriber task hands radar configuration
+ *   messages received from the loopback broker to the radar configuration
+ *   task: whole messages, fragments of large messages, and messages discarded
+ *   as a whole. Also checks that a failed topic filter registration leaves
+ *   no trie nodes behind.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "app_boot.h"
+#include "mqtt_client_config.h"
+#include "mqtt_task.h"
+#include "subscriber_task.h"
+#include "topic_router.h"
+
+#include "loopback_broker.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Provided by mqtt_task.c in the application */
+cy_mqtt_t mqtt_connection;
+QueueHandle_t mqtt_task_q;
+
+static uint8_t network_buffer[CY_MQTT_MIN_NETWORK_BUFFER_SIZE];
+static char message[4096];
+static char filter_text[2][TOPIC_ROUTER_MAX_NODES * 3u];
+
+/*******************************************************************************
+ * Function Name: mqtt_event_callback
+ ********************************************************************************
+ * Summary:
+ *  Passes received messages to the subscriber, like mqtt_task.c.
+ ******************************************************************************/
+static void mqtt_event_callback(cy_mqtt_t mqtt_handle, cy_mqtt_event_t event, void *user_data)
+{
+    if (event.type == CY_MQTT_EVENT_TYPE_SUBSCRIPTION_MESSAGE_RECEIVE)
+    {
+        mqtt_subscription_callback(&event.data.pub_msg.received_message);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: build_message
+ ********************************************************************************
+ * Summary:
+ *  Builds a flat JSON object of 'members' members whose values contain
+ *  characters the splitter must not cut at.
+ ******************************************************************************/
+static size_t build_message(uint32_t members)
+{
+    size_t length = (size_t)sprintf(message, "{");
+
+    for (uint32_t i = 0u; i < members; i++)
+    {
+        length += (size_t)sprintf(&message[length], "%s\"radar_key_%02u\": \"value,with}brace [%u]\"",
+                                  (i > 0u) ? ", " : " ", (unsigned)i, (unsigned)i);
+    }
+    length += (size_t)sprintf(&message[length], " }");
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: receive_all
+ ********************************************************************************
+ * Summary:
+ *  Takes every queued slot, checks the fragments are numbered in order with
+ *  only the last one flagged, and releases them.
+ ******************************************************************************/
+static uint32_t receive_all(uint32_t *members)
+{
+    sub_payload_slot_t *slot;
+    uint32_t count = 0u;
+
+    *members = 0u;
+    while (xQueueReceive(sub_payload_q, &slot, 0u) == pdTRUE)
+    {
+        TEST_CHECK_EQUAL(count, slot->fragment);
+        TEST_CHECK_EQUAL(uxQueueMessagesWaiting(sub_payload_q) == 0u, slot->last_fragment);
+        TEST_CHECK(slot->length <= MQTT_SUB_MSG_MAX_SIZE);
+        TEST_CHECK(slot->data[0] == '{' && slot->data[slot->length - 1u] == '}');
+
+        for (uint32_t i = 0u; i + 10u < slot->length; i++)
+        {
+            *members += (memcmp(&slot->data[i], "\"radar_key", 10u) == 0) ? 1u : 0u;
+        }
+
+        subscriber_payload_release(slot);
+        count++;
+    }
+
+    return count;
+}
+
+static void test_setup(void)
+{
+    cy_mqtt_connect_info_t connect_info = { 0 };
+
+    app_boot_init();
+    TEST_CHECK(subscriber_init());
+    mqtt_task_q = xQueueCreate(4u, sizeof(mqtt_task_cmd_t));
+    (void)cy_mqtt_create(network_buffer, sizeof(network_buffer), NULL, NULL, mqtt_event_callback, NULL,
+                         &mqtt_connection);
+    connect_info.client_id = "device";
+    connect_info.client_id_len = 6u;
+    connect_info.clean_session = true;
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, cy_mqtt_connect(mqtt_connection, &connect_info));
+
+    (void)xTaskCreate(subscriber_task, "Subscriber", 1024u, NULL, 2u, &subscriber_task_handle);
+    TEST_CHECK(app_boot_wait(APP_BOOT_BIT(APP_BOOT_SUBSCRIBED), pdMS_TO_TICKS(5000u)));
+    TEST_CHECK_EQUAL(1u, loopback_broker_subscription_count("device"));
+}
+
+static void test_small_message(void)
+{
+    const char *config = "{\"radar_presence_range_max\": \"2.0\"}";
+    uint32_t members;
+
+    TEST_CHECK_EQUAL(1u, loopback_broker_inject(MQTT_SUB_TOPIC, config, strlen(config), CY_MQTT_QOS1));
+    TEST_CHECK_EQUAL(1u, receive_all(&members));
+}
+
+static void test_fragmented_message(void)
+{
+    size_t length = build_message(30u);
+    uint32_t members;
+    uint32_t fragments;
+
+    TEST_CHECK(length > MQTT_SUB_MSG_MAX_SIZE);
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, message, length, CY_MQTT_QOS1);
+    fragments = receive_all(&members);
+    TEST_CHECK(fragments > 1u && fragments <= MQTT_SUB_SLOT_COUNT);
+    TEST_CHECK_EQUAL(30u, members);
+}
+
+static void test_discarded_messages(void)
+{
+    sub_payload_slot_t *slot;
+    size_t length;
+    uint32_t members;
+
+    /* More fragments than receive slots: nothing is handed over */
+    length = build_message(80u);
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, message, length, CY_MQTT_QOS1);
+    TEST_CHECK_EQUAL(0u, receive_all(&members));
+
+    /* Unterminated after several fragments: nothing is handed over */
+    length = build_message(30u) - 2u;
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, message, length, CY_MQTT_QOS1);
+    TEST_CHECK_EQUAL(0u, receive_all(&members));
+
+    /* Not enough free slots: nothing is handed over */
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, "{\"a\": 1}", 8u, CY_MQTT_QOS1);
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, "{\"b\": 2}", 8u, CY_MQTT_QOS1);
+    length = build_message(30u);
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, message, length, CY_MQTT_QOS1);
+    TEST_CHECK_EQUAL(2u, uxQueueMessagesWaiting(sub_payload_q));
+    while (xQueueReceive(sub_payload_q, &slot, 0u) == pdTRUE)
+    {
+        subscriber_payload_release(slot);
+    }
+
+    /* No slot leaked: a large message still fits afterwards */
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, message, length, CY_MQTT_QOS1);
+    TEST_CHECK(receive_all(&members) > 1u);
+    TEST_CHECK_EQUAL(30u, members);
+}
+
+/*******************************************************************************
+ * Function Name: ignore_message
+ ********************************************************************************
+ * Summary:
+ *  Handler of the filters registered by test_register_rollback.
+ ******************************************************************************/
+static void ignore_message(cy_mqtt_publish_info_t *received, void *arg)
+{
+    (void)received;
+    (void)arg;
+}
+
+/*******************************************************************************
+ * Function Name: build_filter
+ ********************************************************************************
+ * Summary:
+ *  Builds a topic filter of 'levels' levels starting with 'first'.
+ ******************************************************************************/
+static const char *build_filter(char *text, char first, uint32_t levels)
+{
+    size_t length = (size_t)sprintf(text, "%c", first);
+
+    for (uint32_t i = 1u; i < levels; i++)
+    {
+        length += (size_t)sprintf(&text[length], "/%u", (unsigned)i);
+    }
+
+    return text;
+}
+
+static void test_register_rollback(void)
+{
+    cy_mqtt_subscribe_info_t *list;
+    uint32_t free_nodes = TOPIC_ROUTER_MAX_NODES - 2u;
+    uint32_t members;
+
+    /* The root and one node per level of MQTT_SUB_TOPIC are in use */
+    for (const char *c = MQTT_SUB_TOPIC; *c != '\0'; c++)
+    {
+        free_nodes -= (*c == '/') ? 1u : 0u;
+    }
+
+    /* One level too many: fails after adding all free nodes */
+    TEST_CHECK(!topic_router_register(build_filter(filter_text[0], 'y', free_nodes + 1u), CY_MQTT_QOS0,
+                                      ignore_message, NULL));
+    TEST_CHECK_EQUAL(1u, topic_router_get_subscriptions(&list));
+
+    /* The nodes were returned: a filter using all of them fits */
+    TEST_CHECK(topic_router_register(build_filter(filter_text[1], 'z', free_nodes), CY_MQTT_QOS0,
+                                     ignore_message, NULL));
+    TEST_CHECK_EQUAL(2u, topic_router_get_subscriptions(&list));
+
+    /* The filter registered before still routes */
+    (void)loopback_broker_inject(MQTT_SUB_TOPIC, "{\"a\": 1}", 8u, CY_MQTT_QOS1);
+    TEST_CHECK_EQUAL(1u, receive_all(&members));
+}
+
+int main(void)
+{
+    TEST_RUN(test_setup);
+    TEST_RUN(test_small_message);
+    TEST_RUN(test_fragmented_message);
+    TEST_RUN(test_discarded_messages);
+    TEST_RUN(test_register_rollback);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
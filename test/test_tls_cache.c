@@ -0,0 +1,164 @@
+/******************************************************************************
+ * File Name:   test_tls_cache.c
+ *
+ * Description: Tests of the TLS session resumption and client identity reuse
+ *   *   against a simulated broker behind the wrapped mbedtls and secure
+ *   sockets  *   functions.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cy_tls.h"
+#include "fake_tls.h"
+#include "mbedtls/ssl.h"
+#include "mqtt_client_config.h"
+#include "tls_cache.h"
+#include "test_util.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static const char client_certificate[] = "certificate";
+static const char client_private_key[] = "key";
+static const char other_certificate[] = "other certificate";
+
+/*******************************************************************************
+ * Function Name: connect
+ ********************************************************************************
+ * Summary:
+ *  Sets up a TLS connection the way the secure sockets library does: identity,
+ *  context and handshake, then the identity is deleted again when the
+ *  connection closes.
+ ******************************************************************************/
+static int connect(const char *certificate)
+{
+    static const mbedtls_ssl_config conf = { 0 };
+    mbedtls_ssl_context ssl;
+    void *identity = NULL;
+    int ret;
+
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, cy_tls_create_identity(certificate, strlen(certificate),
+                                                             client_private_key, sizeof(client_private_key),
+                                                             &identity));
+    TEST_CHECK_EQUAL(0, mbedtls_ssl_setup(&ssl, &conf));
+
+    /* Handshake loop of cy_tls_connect(), the first step wants to read. A
+     * step that wants to read must not drop the kept session.
+     */
+    do
+    {
+        ret = mbedtls_ssl_handshake(&ssl);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ);
+
+    TEST_CHECK_EQUAL(CY_RSLT_SUCCESS, cy_tls_delete_identity(identity));
+    return ret;
+}
+
+static void test_session_resumption(void)
+{
+    tls_cache_stats_t stats;
+
+    /* First connection: full handshake, nothing to offer */
+    fake_tls.full_handshakes = 0u;
+    TEST_CHECK_EQUAL(0, connect(client_certificate));
+    TEST_CHECK_EQUAL(1, fake_tls.full_handshakes);
+
+    /* Reconnections resume the session */
+    for (int i = 0; i < 5; i++)
+    {
+        TEST_CHECK_EQUAL(0, connect(client_certificate));
+    }
+    TEST_CHECK_EQUAL(1, fake_tls.full_handshakes);
+
+    /* The broker forgot the session: full handshake, then resumed again */
+    fake_tls.broker_session = 0u;
+    TEST_CHECK_EQUAL(0, connect(client_certificate));
+    TEST_CHECK_EQUAL(2, fake_tls.full_handshakes);
+    TEST_CHECK_EQUAL(0, connect(client_certificate));
+    TEST_CHECK_EQUAL(2, fake_tls.full_handshakes);
+
+    /* A failed handshake drops the session, the next one is not offered it */
+    fake_tls.broker_fails = true;
+    TEST_CHECK_EQUAL(FAKE_TLS_HANDSHAKE_FAILURE, connect(client_certificate));
+    fake_tls.broker_fails = false;
+    TEST_CHECK_EQUAL(0, connect(client_certificate));
+    TEST_CHECK_EQUAL(3, fake_tls.full_handshakes);
+
+    tls_cache_get_stats(&stats);
+    TEST_CHECK_EQUAL(9, stats.handshakes);
+    TEST_CHECK_EQUAL(7, stats.offered);
+    TEST_CHECK_EQUAL(6, stats.resumed);
+    /* Only the kept session holds a ticket */
+    TEST_CHECK_EQUAL(1, fake_tls.live_tickets);
+}
+
+static void test_identity_reuse(void)
+{
+    tls_cache_stats_t stats;
+    tls_cache_stats_t before;
+
+    tls_cache_get_stats(&before);
+    fake_tls.identity_parses = 0u;
+    for (int i = 0; i < 10; i++)
+    {
+        TEST_CHECK_EQUAL(0, connect(client_certificate));
+    }
+    /* Parsed by the first test already, kept across the disconnections */
+    TEST_CHECK_EQUAL(0, fake_tls.identity_parses);
+    TEST_CHECK_EQUAL(1, fake_tls.live_identities);
+
+    /* Other credentials are parsed and deleted as before */
+    TEST_CHECK_EQUAL(0, connect(other_certificate));
+    TEST_CHECK_EQUAL(1, fake_tls.identity_parses);
+    TEST_CHECK_EQUAL(1, fake_tls.live_identities);
+
+    tls_cache_get_stats(&stats);
+    TEST_CHECK_EQUAL(10, stats.identity_reuses - before.identity_reuses);
+    TEST_CHECK_EQUAL(1, stats.identity_parses - before.identity_parses);
+
+    /* Released with the MQTT instance, nothing left behind */
+    tls_cache_release();
+    TEST_CHECK_EQUAL(0, fake_tls.live_tickets);
+    TEST_CHECK_EQUAL(0, fake_tls.live_identities);
+
+    /* After the release the identity is parsed and no session is offered */
+    fake_tls.full_handshakes = 0u;
+    TEST_CHECK_EQUAL(0, connect(client_certificate));
+    TEST_CHECK_EQUAL(2, fake_tls.identity_parses);
+    TEST_CHECK_EQUAL(1, fake_tls.full_handshakes);
+    tls_cache_release();
+    TEST_CHECK_EQUAL(0, fake_tls.live_tickets);
+    TEST_CHECK_EQUAL(0, fake_tls.live_identities);
+}
+
+int main(void)
+{
+    TEST_RUN(test_session_resumption);
+    TEST_RUN(test_identity_reuse);
+
+    return test_failures;
+}
+
+/* [] END OF FILE */
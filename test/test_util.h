@@ -0,0 +1,72 @@
+/******************************************************************************
+ * File Name:   test_util.h
+ *
+ * Description: Checks shared by the host tests. A failed check is reported and
+ *   counted, the test returns the number of failures from main().
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define TEST_CHECK(condition)                                                   \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+#define TEST_CHECK_EQUAL(expected, actual)                                      \
+    do                                                                          \
+    {                                                                           \
+        long long test_expected = (long long)(expected);                        \
+        long long test_actual = (long long)(actual);                            \
+        if (test_expected != test_actual)                                       \
+        {                                                                       \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__,    \
+                   #actual, test_actual, test_expected);                        \
+            test_failures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+/* Runs one test case of the file */
+#define TEST_RUN(test)                                                          \
+    do                                                                          \
+    {                                                                           \
+        int test_failures_before = test_failures;                               \
+        test();                                                                 \
+        printf("%s: %s\n", (test_failures == test_failures_before) ? "PASS" : "FAIL", #test); \
+    } while (0)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static int test_failures;
+
+/* [] END OF FILE */
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * File Name:   fake_tls.c
+ *
+ * Description: Stand-ins of the mbedtls and secure sockets functions that  *
+ *   tls_cache.c wraps or calls. They live apart from the test, so that the  *
+ *   calls of the test go through the link-time wrappers. The handshake  *
+ *   resumes an offered session if the broker still knows its ID, like the  *
+ *   session cache of a broker, and otherwise hands out a new ID.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cy_tls.h"
+#include "fake_tls.h"
+#include "mbedtls/ssl.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+fake_tls_t fake_tls = { .next_session = 1u };
+
+int mbedtls_ssl_setup(mbedtls_ssl_context *ssl, const mbedtls_ssl_config *conf)
+{
+    memset(ssl, 0, sizeof(*ssl));
+    ssl->conf = conf;
+    return 0;
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session *session)
+{
+    ssl->offered = 1;
+    ssl->session.id_len = session->id_len;
+    memcpy(ssl->session.id, session->id, session->id_len);
+    return 0;
+}
+
+int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl)
+{
+    /* The first step waits for the ServerHello */
+    if (ssl->state++ == 0)
+    {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    if (fake_tls.broker_fails)
+    {
+        return FAKE_TLS_HANDSHAKE_FAILURE;
+    }
+    if (!ssl->offered || (fake_tls.broker_session == 0u) || (ssl->session.id[0] != fake_tls.broker_session))
+    {
+        fake_tls.full_handshakes++;
+        fake_tls.broker_session = fake_tls.next_session++;
+        ssl->session.id_len = sizeof(ssl->session.id);
+        memset(ssl->session.id, fake_tls.broker_session, sizeof(ssl->session.id));
+    }
+    return 0;
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl, mbedtls_ssl_session *session)
+{
+    *session = ssl->session;
+    session->ticket = malloc(16u);
+    fake_tls.live_tickets++;
+    return 0;
+}
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session)
+{
+    memset(session, 0, sizeof(*session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
+{
+    if (session->ticket != NULL)
+    {
+        free(session->ticket);
+        fake_tls.live_tickets--;
+    }
+    memset(session, 0, sizeof(*session));
+}
+
+cy_rslt_t cy_tls_create_identity(const char *certificate_data, const uint32_t certificate_len,
+                                 const char *private_key, uint32_t private_key_len, void **tls_identity)
+{
+    fake_tls.identity_parses++;
+    fake_tls.live_identities++;
+    *tls_identity = malloc(8u);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_tls_delete_identity(void *tls_identity)
+{
+    free(tls_identity);
+    fake_tls.live_identities--;
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,58 @@
+/******************************************************************************
+ * File Name:   fake_tls.h
+ *
+ * Description: Simulated broker side of the TLS functions wrapped by
+ *   tls_cache.c,  *   see fake_tls.c.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Result of a handshake while 'broker_fails' is set */
+#define FAKE_TLS_HANDSHAKE_FAILURE  (-0x7780)
+
+/*******************************************************************************
+ * Typedefines
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t broker_session;     /* Session ID the broker still knows, 0 if none */
+    uint8_t next_session;       /* ID of the next new session */
+    bool broker_fails;          /* Handshakes fail */
+    uint32_t full_handshakes;   /* Handshakes that created a new session */
+    uint32_t identity_parses;   /* cy_tls_create_identity() calls */
+    int live_tickets;           /* Session copies not yet freed */
+    int live_identities;        /* Identities not yet deleted */
+} fake_tls_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+extern fake_tls_t fake_tls;
+
+/* [] END OF FILE */
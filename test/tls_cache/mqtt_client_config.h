@@ -0,0 +1,38 @@
+/******************************************************************************
+ * File Name:   mqtt_client_config.h
+ *
+ * Description: Builds tls_cache.c for test_tls_cache.c with the session and  *
+ *   identity caches enabled, whatever the defaults of the application.
+ *
+ * Related Document: See README.md
+ *
+ * ===========================================================================
+ * Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+ * ===========================================================================
+ *
+ * ===========================================================================
+ * Infineon Technologies AG (INFINEON) is supplying this file for use
+ * exclusively with Infineon's sensor products. This file can be freely
+ * distributed within development tools and software supporting such
+ * products.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+ * OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+ * INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+ * WHATSOEVER.
+ * ===========================================================================
+ */
+
+#pragma once
+
+#include_next "mqtt_client_config.h"
+
+#undef MQTT_TLS_SESSION_RESUME
+#define MQTT_TLS_SESSION_RESUME           ( 1 )
+
+#undef MQTT_TLS_IDENTITY_REUSE
+#define MQTT_TLS_IDENTITY_REUSE           ( 1 )
+
+/* [] END OF FILE */